@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * Random access to the bytes of an X3P archive stored anywhere.
+ */
+
+#ifndef _OPENGPS_CXX_BYTE_SOURCE_HXX
+#define _OPENGPS_CXX_BYTE_SOURCE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OpenGPS
+{
+	class InputBinaryFileStream;
+
+	/*!
+	 * Provides random access to the bytes of an X3P archive.
+	 *
+	 * Implement this interface to read X3P archives from custom storage, e.g. an object store
+	 * or a caching block device layer. The X3P archive is read through OpenGPS::ByteSource::Read
+	 * only. Reads are issued as large ranges aligned to their size, so implementations may also
+	 * serve to collect metrics about the access pattern.
+	 *
+	 * @see ISO5436_2::ISO5436_2(std::shared_ptr<const ByteSource>, const String&)
+	 */
+	class _OPENGPS_EXPORT ByteSource
+	{
+	public:
+		/*! Destroys this instance. */
+		virtual ~ByteSource();
+
+		/*! Gets the size of the X3P archive in bytes. */
+		virtual unsigned long long GetSize() const = 0;
+
+		/*!
+		 * Reads a range of bytes at an absolute offset.
+		 *
+		 * @remarks Several threads may read at the same time, so implementations must be thread-safe.
+		 *
+		 * @param offset The offset of the first byte to read.
+		 * @param buffer Gets the bytes read.
+		 * @param size The number of bytes to read.
+		 * @returns The number of bytes read. This is less than the size requested only if
+		 * the range exceeds the end of the X3P archive or reading failed.
+		 */
+		virtual size_t Read(unsigned long long offset, void* buffer, size_t size) const = 0;
+
+		/*!
+		 * Gets a name that identifies the X3P archive, e.g. a file path or the key of an object.
+		 * Random-access indices of point data are cached by this name, see ::OGPS_OpenOptions::indexSpan.
+		 * @returns The name or an empty string if indices are not to be cached, which is the default.
+		 */
+		virtual String GetName() const;
+	};
+
+	/*! Reads an X3P archive from a file. */
+	class _OPENGPS_EXPORT FileByteSource : public ByteSource
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param filePath Full path to the X3P archive. If the file cannot be opened, its size is zero.
+		 */
+		FileByteSource(const String& filePath);
+
+		/*! Destroys this instance. */
+		~FileByteSource() override;
+
+		unsigned long long GetSize() const override;
+
+		size_t Read(unsigned long long offset, void* buffer, size_t size) const override;
+
+		/*! Gets the path to the file. */
+		String GetName() const override;
+
+	private:
+		/*! Full path to the X3P archive. */
+		String m_FilePath;
+
+		/*! The file opened. */
+		std::unique_ptr<InputBinaryFileStream> m_File;
+
+		/*! The size of the file. */
+		unsigned long long m_Size{};
+
+		/*! Serializes seeking and reading the file. */
+		mutable std::mutex m_Mutex;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		FileByteSource(const FileByteSource& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		FileByteSource& operator=(const FileByteSource& src) = delete;
+	};
+
+	/*! Reads an X3P archive held in memory. */
+	class _OPENGPS_EXPORT MemoryByteSource : public ByteSource
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param data The content of the X3P archive.
+		 */
+		MemoryByteSource(std::vector<unsigned char> data);
+
+		/*! Destroys this instance. */
+		~MemoryByteSource() override;
+
+		unsigned long long GetSize() const override;
+
+		size_t Read(unsigned long long offset, void* buffer, size_t size) const override;
+
+		/*! Gets the content of the X3P archive. */
+		const std::vector<unsigned char>& GetData() const;
+
+	private:
+		/*! The content of the X3P archive. */
+		std::vector<unsigned char> m_Data;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		MemoryByteSource(const MemoryByteSource& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		MemoryByteSource& operator=(const MemoryByteSource& src) = delete;
+	};
+}
+
+#endif
+
+/*! @} */
@@ -45,7 +45,13 @@
 #include <opengps/cxx/opengps.hxx>
 #include <opengps/cxx/exceptions.hxx>
 #include <opengps/cxx/point_iterator.hxx>
+#include <opengps/cxx/point_partition.hxx>
+#include <opengps/cxx/point_block.hxx>
+#include <opengps/cxx/byte_source.hxx>
+#include <opengps/open_options.h>
+#include <opengps/write_options.h>
 #include <memory>
+#include <vector>
 
 namespace OpenGPS
 {
@@ -109,6 +115,61 @@ namespace OpenGPS
 		ISO5436_2(
 			const String& file);
 
+		/*!
+		* Creates a new instance that operates on an ISO5436-2 XML X3P held in memory.
+		*
+		* The X3P is read from memory directly, nothing gets extracted to the file system.
+		* Point data is only read from the file system if it has been opened with a memory budget
+		* that requires paging.
+		*
+		* @remarks Use either ISO5436_2::Open or ISO5436_2::Create to work on the ISO5436-2 XML X3P file container.
+		* Use ISO5436_2::Write to get the content of the X3P. Point data cannot be streamed with ISO5436_2::CreateStream.
+		*
+		* @param data The content of the ISO5436-2 XML X3P to operate on. This is empty if a new X3P is to be created.
+		* @param temp Specifies a new absolute path to the directory where paged point data gets stored temporarily.
+		*/
+		ISO5436_2(
+			std::vector<unsigned char> data,
+			const String& temp);
+
+		/*!
+		* Creates a new instance that operates on an ISO5436-2 XML X3P held in memory.
+		*
+		* @see ISO5436_2::ISO5436_2(std::vector<unsigned char>, const String&)
+		*
+		* @param data The content of the ISO5436-2 XML X3P to operate on. This is empty if a new X3P is to be created.
+		*/
+		ISO5436_2(
+			std::vector<unsigned char> data);
+
+		/*!
+		* Creates a new instance that operates on an ISO5436-2 XML X3P read from a byte source.
+		*
+		* The X3P is read from the byte source directly in large aligned blocks, nothing gets
+		* extracted to the file system. This allows for X3P held in custom storage.
+		*
+		* @remarks The byte source is never modified. ISO5436_2::Write keeps the X3P in memory
+		* afterwards, use ISO5436_2::Write(std::vector<unsigned char>&, int) to get its content.
+		*
+		* @see ISO5436_2::ISO5436_2(std::vector<unsigned char>, const String&)
+		*
+		* @param source The byte source of the ISO5436-2 XML X3P to operate on.
+		* @param temp Specifies a new absolute path to the directory where paged point data gets stored temporarily.
+		*/
+		ISO5436_2(
+			std::shared_ptr<const ByteSource> source,
+			const String& temp);
+
+		/*!
+		* Creates a new instance that operates on an ISO5436-2 XML X3P read from a byte source.
+		*
+		* @see ISO5436_2::ISO5436_2(std::shared_ptr<const ByteSource>, const String&)
+		*
+		* @param source The byte source of the ISO5436-2 XML X3P to operate on.
+		*/
+		ISO5436_2(
+			std::shared_ptr<const ByteSource> source);
+
 		/*!
 		* Opens an existing ISO5436-2 XML X3P file.
 		*
@@ -118,6 +179,19 @@ namespace OpenGPS
 		*/
 		void Open();
 
+		/*!
+		* Opens an existing ISO5436-2 XML X3P file.
+		*
+		* @see ISO5436_2::Close
+		*
+		* Specific implementations may raise an exception.
+		*
+		* @param options Controls how the file is opened, e.g. whether point data
+		* larger than a given memory budget is paged to a temporary file.
+		* Initialize the options with ::ogps_InitOpenOptions.
+		*/
+		void Open(const OGPS_OpenOptions& options);
+
 		/*!
 		 * Creates a new ISO5436-2 XML X3P file.
 		 *
@@ -154,6 +228,68 @@ namespace OpenGPS
 			size_t listDimension,
 			bool useBinaryData = true);
 
+		/*!
+		 * Creates a new ISO5436-2 XML X3P file whose point data is streamed to the archive.
+		 *
+		 * Instead of buffering the whole surface in memory, every point vector appended by
+		 * ISO5436_2::AppendMatrixPoint is encoded and compressed immediately. Memory usage
+		 * stays constant regardless of the size of the matrix. Point data is stored in binary
+		 * format always. ISO5436_2::Write completes the archive, ISO5436_2::Close
+		 * without writing discards it.
+		 *
+		 * @remarks Random access to point data, e.g. by ISO5436_2::SetMatrixPoint or point
+		 * iterators, is not available for streamed documents.
+		 *
+		 * Specific implementations may raise an exception.
+		 *
+		 * @param record1 The Record1 object defined in the ISO5436_2 XML specification. The given object instance must be valid.
+		 * @param record2 The Record2 object defined in the ISO5436_2 XML specification. This is optional, so the parameter can be nullptr. But if set, it must point to a valid instance.
+		 * @param matrixDimension Specifies the topology for which point measurement data will be processed.
+		 * @param compressionLevel The compression level of the point data which is compressed while being appended. See ISO5436_2::Write for details.
+		 */
+		void CreateStream(
+			const Schemas::ISO5436_2::Record1Type& record1,
+			const Schemas::ISO5436_2::Record2Type* record2,
+			const Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+			int compressionLevel = -1);
+
+		/*!
+		 * Appends the next three-dimensional data point vector to a streamed X3P file.
+		 *
+		 * Point vectors must be appended in storage order: the u-direction runs fastest,
+		 * then the v-direction and then the w-direction. So a surface is appended row by row.
+		 * All point vectors of the matrix must have been appended before ISO5436_2::Write is called.
+		 *
+		 * A specific implementation may throw an OpenGPS::Exception if this operation
+		 * is not permitted due to the current state of the object instance.
+		 *
+		 * @see ISO5436_2::CreateStream
+		 *
+		 * @param vector The point value at the next surface position. If this parameter is set to
+		 * nullptr, this indicates there is no measurement data available for this position.
+		 */
+		void AppendMatrixPoint(const PointVector* vector);
+
+		/*!
+		 * Decodes all point vectors in storage order in a single pass and hands them
+		 * block by block to a visitor.
+		 *
+		 * If the file has been opened with the loadPoints option set to false, point data is
+		 * decompressed directly from the archive while being visited. So memory usage only
+		 * depends on the block size, regardless of the size of the file. Otherwise the
+		 * point data already loaded is visited.
+		 *
+		 * A specific implementation may throw an OpenGPS::Exception if this operation
+		 * is not permitted due to the current state of the object instance.
+		 *
+		 * @see ISO5436_2::Open
+		 *
+		 * @param visitor Receives consecutive blocks of point vectors.
+		 * @param blockSize The maximum number of point vectors of a single block.
+		 * @returns Returns true if all point vectors have been visited or false if the visitor stopped.
+		 */
+		bool Visit(const PointBlockVisitor& visitor, size_t blockSize = OGPS_DEFAULT_POINT_BLOCK_SIZE);
+
 		/*! Destructs this object. */
 		~ISO5436_2();
 
@@ -175,6 +311,41 @@ namespace OpenGPS
 		 */
 		PointIteratorAutoPtr CreatePrevPointIterator();
 
+		/*!
+		 * Splits the point data into partitions to be processed independently.
+		 *
+		 * A matrix is split into bands of consecutive rows along the v-direction, a list into
+		 * ranges of consecutive indexes. The sizes of the partitions differ by one row or index at most.
+		 * There are fewer partitions than requested if there are fewer rows or indexes.
+		 *
+		 * A specific implementation may throw an OpenGPS::Exception if this operation
+		 * is not permitted due to the current state of the object instance.
+		 *
+		 * @see ISO5436_2::ParallelForEach
+		 *
+		 * @param count The number of partitions requested. If this is 0 there is one partition
+		 * per thread, see Scheduler::GetThreadCount.
+		 * @returns Returns the partitions, each with its own cursor, in storage order.
+		 */
+		std::vector<PointPartition> GetPartitions(size_t count) const;
+
+		/*!
+		 * Calls a function for every partition of the point data on the thread pool of the library,
+		 * see OpenGPS::Scheduler.
+		 *
+		 * Idle worker threads steal partitions not yet started from busy ones. The calling thread
+		 * processes partitions as well and returns when all of them have been processed. So this may
+		 * also be called from within a callback. If an executor of the application has been set by
+		 * Scheduler::SetExecutor, the calling thread only waits for the partitions to be processed.
+		 * If a callback throws, the first exception is rethrown after all partitions have been processed.
+		 *
+		 * @see ISO5436_2::GetPartitions
+		 *
+		 * @param callback Called once per partition, possibly by several threads at once.
+		 * @param count The number of partitions requested, see ISO5436_2::GetPartitions.
+		 */
+		void ParallelForEach(const PointPartitionCallback& callback, size_t count = 0) const;
+
 		/*!
 		* Sets the value of a three-dimensional data point vector at a given surface position.
 		*
@@ -219,6 +390,8 @@ namespace OpenGPS
 		 * format for access is revealed by the ISO5436-2 XML document.
 		 * Access to the ISO5436-2 XML document which is part of an X3P file container can be
 		 * obtained through ISO5436_2::GetDocument.
+		 * Components of incremental axes are derived from the point index. They are returned as
+		 * OGPS_Int32 and as OGPS_Double when the index exceeds the range of a signed 32-bit integer.
 		 *
 		 * @see ISO5436_2::GetMatrixCoord, ISO5436_2::GetListPoint
 		 *
@@ -226,12 +399,16 @@ namespace OpenGPS
 		 * @param v The v-direction of the surface position.
 		 * @param w The w-direction of the surface position.
 		 * @param vector Returns the raw point value at the given u,v,w position.
+		 *
+		 * @remarks Reading point data does not change the state of the instance. Several threads may
+		 * read from one opened instance at once, each with its own point vector, as long as no thread
+		 * modifies it. Only point data paged from a temporary file is read in turn.
 		 */
 		void GetMatrixPoint(
 			size_t u,
 			size_t v,
 			size_t w,
-			PointVector& vector);
+			PointVector& vector) const;
 
 		/*!
 		 * Sets the value of a three-dimensional data point vector at a given index position.
@@ -271,16 +448,20 @@ namespace OpenGPS
 		 * format for access is revealed by the ISO5436-2 XML document.
 		 * Access to the ISO5436-2 XML document which is part of an X3P file container can be
 		 * obtained through ISO5436_2::GetDocument.
+		 * Components of incremental axes are derived from the point index. They are returned as
+		 * OGPS_Int32 and as OGPS_Double when the index exceeds the range of a signed 32-bit integer.
 		 *
 		 * @see ISO5436_2::GetListCoord, ISO5436_2::GetMatrixPoint
 		 *
 		 * @param index The index of the surface position.
 		 * @param vector Returns the raw point value at the given position.
 		 * @return Returns true on success, false otherwise.
+		 *
+		 * @remarks Like ISO5436_2::GetMatrixPoint this may be called from several threads at once.
 		 */
 		void GetListPoint(
 			size_t index,
-			PointVector& vector);
+			PointVector& vector) const;
 
 		/*!
 		 * Gets the fully transformed value of a data point vector at a given surface position.
@@ -314,7 +495,7 @@ namespace OpenGPS
 			size_t w,
 			OGPS_Double* x,
 			OGPS_Double* y,
-			OGPS_Double* z);
+			OGPS_Double* z) const;
 
 		/*!
 		 * Asks if there is point vector data stored at the given matrix position.
@@ -335,7 +516,7 @@ namespace OpenGPS
 		bool IsMatrixCoordValid(
 			size_t u,
 			size_t v,
-			size_t w);
+			size_t w) const;
 
 		/*!
 		 * Gets the fully transformed value of a data point vector at a given index position.
@@ -365,13 +546,18 @@ namespace OpenGPS
 			size_t index,
 			OGPS_Double* x,
 			OGPS_Double* y,
-			OGPS_Double* z);
+			OGPS_Double* z) const;
 
 		/*!
 		 * Gets access to the ISO5436_2 XML document.
 		 */
 		Schemas::ISO5436_2::ISO5436_2Type* GetDocument();
 
+		/*!
+		 * Gets read-only access to the ISO5436_2 XML document.
+		 */
+		const Schemas::ISO5436_2::ISO5436_2Type* GetDocument() const;
+
 		/*!
 		 * Gets information on the structure with which the point
 		 * measurement data is stored.
@@ -403,11 +589,30 @@ namespace OpenGPS
 		*/
 		size_t GetListDimension() const;
 
+		/*!
+		 * Gets the amount of memory occupied by the point data loaded.
+		 * Paged point data occupies at most the memory budget it has been opened with.
+		 * @returns Returns the size in bytes or 0 if point data has not been loaded.
+		 */
+		unsigned long long GetPointDataSize() const;
+
+		/*!
+		 * Sets the options point data is written with by ISO5436_2::Write and ISO5436_2::CreateStream.
+		 *
+		 * The options apply to point data written hereafter. A stream of point data keeps
+		 * the options it has been created with. Initialize the options with ::ogps_InitWriteOptions.
+		 */
+		void SetWriteOptions(const OGPS_WriteOptions& options);
+
 		/*!
 		 * Writes any changes back to the X3P file.
 		 *
 		 * Call this function before ISO5436_2::Close if you want to store the changes you have made.
 		 *
+		 * If no point of a binary X3P file opened has been set, its compressed point data is copied
+		 * as it is and only the main xml document gets written. This holds for files opened with the
+		 * loadPoints option set to false, too.
+		 *
 		 * @see ISO5436_2::Create, ISO5436_2::Open, ISO5436_2::Close
 		 *
 		 * Specific implementations may raise an exception.
@@ -416,6 +621,20 @@ namespace OpenGPS
 		 */
 		void Write(int compressionLevel = -1);
 
+		/*!
+		 * Writes the X3P file container to a buffer in memory.
+		 *
+		 * Works the same as ISO5436_2::Write, but neither the X3P file nor the X3P held in
+		 * memory this instance operates on are changed. Point data that has been streamed with
+		 * ISO5436_2::CreateStream can only be written to its file.
+		 *
+		 * Specific implementations may raise an exception.
+		 *
+		 * @param target Gets the content of the X3P file container.
+		 * @param compressionLevel Optionally specifies the compression level, see ISO5436_2::Write.
+		 */
+		void Write(std::vector<unsigned char>& target, int compressionLevel = -1);
+
 		/*!
 		 * Closes an open file handle and frees its resources.
 		 * An explicit call of this method is optional. It is executed implicitly when the object of the current instance gets out of scope.
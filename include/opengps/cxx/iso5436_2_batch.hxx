@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * Opens many X3P files in the background while the files opened so far are processed.
+ */
+
+#ifndef _OPENGPS_CXX_ISO5436_2_BATCH_HXX
+#define _OPENGPS_CXX_ISO5436_2_BATCH_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/iso5436_2.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/open_options.h>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace OpenGPS
+{
+	class BatchOpener;
+
+	/*! An X3P file opened by OpenGPS::ISO5436_2Batch. */
+	struct ISO5436_2BatchResult
+	{
+		/*! The position of the file within the list of files to be opened. */
+		size_t index{};
+
+		/*! The X3P file opened or nullptr if opening failed. */
+		std::unique_ptr<ISO5436_2> document;
+
+		/*! The exception thrown while opening the file or nullptr on success. */
+		std::exception_ptr error;
+	};
+
+	/*!
+	 * Opens a list of X3P files on a pool of worker threads.
+	 *
+	 * At most a limited number of files is in flight, i.e. being opened or opened but
+	 * not yet taken by ISO5436_2Batch::Next. This bounds memory and temporary storage.
+	 * A separate thread asks the system to cache the files following those in flight,
+	 * so the file system cache is warm once a worker thread opens them.
+	 *
+	 * @remarks Files are opened by ISO5436_2::Open(const OGPS_OpenOptions&) and may be
+	 * used like any other instance afterwards.
+	 */
+	class _OPENGPS_EXPORT ISO5436_2Batch
+	{
+	public:
+		/*!
+		 * Creates a new instance and starts opening files in the background.
+		 *
+		 * @param filePaths Full paths to the ISO5436-2 XML X3P files to be opened.
+		 * @param options Controls how the files are opened. If this parameter is set to nullptr the default options are used.
+		 * @param threadCount The number of worker threads opening files. If this is 0 the files are opened by the thread pool of the library, see OpenGPS::Scheduler. Ignored if the scheduler allows no threads of their own.
+		 * @param maxInFlight The maximum number of files in flight. If this is 0 it equals twice the number of worker threads, see Scheduler::GetThreadCount.
+		 * @param temp Specifies a new absolute path to the directory where unpacked X3P data gets stored temporarily.
+		 */
+		ISO5436_2Batch(
+			std::vector<String> filePaths,
+			const OGPS_OpenOptions* options = nullptr,
+			size_t threadCount = 0,
+			size_t maxInFlight = 0,
+			const String& temp = String());
+
+		/*! Destroys this instance. Files not yet opened are skipped, files opened but not taken are closed. */
+		~ISO5436_2Batch();
+
+		/*!
+		 * Waits for the next file to be opened. Files are returned in the order
+		 * they have been opened, which may differ from the order given.
+		 *
+		 * @param result Gets the file opened or the reason why opening failed.
+		 * @returns Returns false if all files have been returned already.
+		 */
+		bool Next(ISO5436_2BatchResult& result);
+
+		/*! Gets the number of files to be opened. */
+		size_t GetCount() const;
+
+	private:
+		/*! Pointer to the internal implementation. */
+		std::unique_ptr<BatchOpener> m_Instance;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ISO5436_2Batch(const ISO5436_2Batch& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ISO5436_2Batch& operator=(const ISO5436_2Batch& src) = delete;
+	};
+}
+
+#endif
+
+/*! @} */
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * Shares X3P files opened repeatedly among their users.
+ */
+
+#ifndef _OPENGPS_CXX_ISO5436_2_CACHE_HXX
+#define _OPENGPS_CXX_ISO5436_2_CACHE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/iso5436_2.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/open_options.h>
+#include <memory>
+
+namespace OpenGPS
+{
+	class ContainerCache;
+
+	/*!
+	 * Keeps X3P files opened recently, so that opening the same file again returns
+	 * the instance already opened.
+	 *
+	 * A file is identified by its path, its size and the time of its last modification.
+	 * If a file has changed since it has been opened, it is opened once more. When the
+	 * memory occupied by the point data of all files kept exceeds a budget, the files
+	 * used least recently are dropped from the cache. Files still in use by any caller
+	 * remain open until the last reference has been released.
+	 *
+	 * The cache may be used by several threads at the same time. If several threads
+	 * request a file that is not yet kept, the file gets opened only once while the
+	 * other threads wait for it.
+	 *
+	 * @remarks Files are shared by all callers and are therefore handed out read-only.
+	 */
+	class _OPENGPS_EXPORT ISO5436_2Cache
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 *
+		 * @param memoryBudget The maximum amount of memory in bytes occupied by the point data
+		 * of the files kept, see ISO5436_2::GetPointDataSize. A single file exceeding the budget
+		 * is returned but not kept.
+		 * @param options Controls how the files are opened. If this parameter is set to nullptr the default options are used.
+		 * @param temp Specifies a new absolute path to the directory where unpacked X3P data gets stored temporarily.
+		 */
+		ISO5436_2Cache(
+			unsigned long long memoryBudget,
+			const OGPS_OpenOptions* options = nullptr,
+			const String& temp = String());
+
+		/*! Destroys this instance. Files still in use remain open. */
+		~ISO5436_2Cache();
+
+		/*!
+		 * Gets an X3P file opened by ISO5436_2::Open(const OGPS_OpenOptions&).
+		 * Opens the file unless it is kept already.
+		 *
+		 * Throws an exception if the file does not exist or could not be opened.
+		 *
+		 * @param file Full path to the ISO5436-2 XML X3P.
+		 * @returns Returns the file opened, which is shared by all callers and may only be read.
+		 */
+		std::shared_ptr<const ISO5436_2> Open(const String& file);
+
+		/*! Drops all files kept. Files still in use remain open. */
+		void Clear();
+
+		/*! Gets the number of files kept. */
+		size_t GetCount() const;
+
+		/*! Gets the amount of memory in bytes occupied by the point data of the files kept. */
+		unsigned long long GetMemoryUsage() const;
+
+	private:
+		/*! Pointer to the internal implementation. */
+		std::unique_ptr<ContainerCache> m_Instance;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ISO5436_2Cache(const ISO5436_2Cache& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ISO5436_2Cache& operator=(const ISO5436_2Cache& src) = delete;
+	};
+}
+
+#endif
+
+/*! @} */
@@ -52,6 +52,7 @@
 #define _OPENGPS_CXX_ISO5436_2_HANDLE_HXX
 
 #include <opengps/cxx/opengps.hxx>
+#include <opengps/write_options.h>
 
 namespace OpenGPS
 {
@@ -114,6 +115,33 @@ _OPENGPS_EXPORT OGPS_ISO5436_2Handle ogps_CreateListISO5436_2(
 	size_t listDimension,
 	bool useBinaryData = true);
 
+/*!
+ * Creates a new ISO5436-2 XML X3P file whose point data is streamed to the archive.
+ *
+ * Point data is not buffered in memory, but appended with ::ogps_AppendMatrixPoint in
+ * storage order and compressed immediately into the binary point data file of the archive.
+ * The archive is completed by ::ogps_WriteISO5436_2.
+ *
+ * @remarks You must release the returned handle object with ::gps_CloseISO5436_2 when done with it.
+ *
+ * @param file Full path to the ISO5436-2 XML X3P to be created.
+ * @param temp Specifies the new absolute path to the directory where unpacked X3P data gets stored temporarily. If set to nullptr the default directory for  temporary files specified by your system is used.
+ * @param record1 The Record1 object defined in the ISO5436_2 XML specification. The given object instance must be valid.
+ * @param record2 The Record2 object defined in the ISO5436_2 XML specification. This is optional, so the parameter can be nullptr. But if set, it must point to a valid instance.
+ * @param matrixDimension Specifies the topology for which point measurement data will be processed.
+ * @param compressionLevel The compression level of the point data which is compressed while being appended. See ::ogps_WriteISO5436_2 for details.
+ * @param options The options the point data is written with, see ::ogps_SetWriteOptions. If set to nullptr the default options are used.
+ * @returns Returns the file handle or nullptr on failure.
+ */
+_OPENGPS_EXPORT OGPS_ISO5436_2Handle ogps_CreateMatrixStreamISO5436_2(
+	const OGPS_Character* file,
+	const OGPS_Character* temp,
+	const OpenGPS::Schemas::ISO5436_2::Record1Type& record1,
+	const OpenGPS::Schemas::ISO5436_2::Record2Type* record2,
+	const OpenGPS::Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+	int compressionLevel = -1,
+	const OGPS_WriteOptions* options = nullptr);
+
 /*!
  * Provides access to the ISO5436_2 XML document.
  *
@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * Read-only access to X3P files without the XML schema runtime.
+ */
+
+#ifndef _OPENGPS_CXX_ISO5436_2_READER_HXX
+#define _OPENGPS_CXX_ISO5436_2_READER_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/byte_source.hxx>
+#include <opengps/cxx/point_vector.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/data_point_type.h>
+#include <array>
+#include <memory>
+
+namespace OpenGPS
+{
+	class ArchiveReader;
+
+	/*!
+	 * Reads the point data of X3P files stored as binary files.
+	 *
+	 * Other than OpenGPS::ISO5436_2 this class is part of the separate iso5436_2_reader
+	 * library, which neither depends on Xerces-C nor on the code generated from the XML
+	 * schema. main.xml is read by a minimal non-validating XML reader, which extracts
+	 * the axis descriptions of Record1, the dimensions and the links to the binary point
+	 * data of Record3 and the checksum file of Record4. Everything else is skipped.
+	 * The binary point data is decoded by the same code as within OpenGPS::ISO5436_2.
+	 *
+	 * Point data listed in main.xml itself is not supported.
+	 *
+	 * @remarks Once opened, an instance may be read by several threads at the same time.
+	 */
+	class _OPENGPS_EXPORT ISO5436_2Reader
+	{
+	public:
+		/*! Describes an axis as declared by Record1 of main.xml. */
+		struct Axis
+		{
+			/*! true if the axis is incremental, false if it is absolute. */
+			bool isIncremental{};
+
+			/*! The data type of the values stored for the axis or OGPS_MissingPointType if there are none. */
+			OGPS_DataPointType dataType{ OGPS_MissingPointType };
+
+			/*! The increment of the axis in metres, which is 1 if none is declared. */
+			OGPS_Double increment{ 1.0 };
+
+			/*! The offset of the axis in metres. */
+			OGPS_Double offset{};
+		};
+
+		/*! The content of main.xml the reader is interested in. */
+		struct Metadata
+		{
+			/*! The revision of the file format. */
+			String revision;
+
+			/*! The feature type, see ::OGPS_FEATURE_TYPE_SURFACE_NAME. */
+			String featureType;
+
+			/*! The description of the x axis. */
+			Axis x;
+
+			/*! The description of the y axis. */
+			Axis y;
+
+			/*! The description of the z axis. */
+			Axis z;
+
+			/*! true if the point data is organized as a matrix, false if it is a list. */
+			bool isMatrix{};
+
+			/*! The size of the matrix in u-direction or the length of the list. */
+			size_t sizeX{};
+
+			/*! The size of the matrix in v-direction or 1 for a list. */
+			size_t sizeY{};
+
+			/*! The size of the matrix in w-direction or 1 for a list. */
+			size_t sizeZ{};
+
+			/*! The name of the archive entry of the binary point data. */
+			String pointDataLink;
+
+			/*! The MD5 checksum of the binary point data. */
+			std::array<unsigned char, 16> pointDataMd5{};
+
+			/*! The name of the archive entry of the binary point validity data or an empty string if there is none. */
+			String validPointsLink;
+
+			/*! The MD5 checksum of the binary point validity data. */
+			std::array<unsigned char, 16> validPointsMd5{};
+
+			/*! The name of the archive entry of the checksum of main.xml. */
+			String checksumFile;
+		};
+
+		/*!
+		 * Creates a new instance.
+		 * @param file Full path to the ISO5436-2 XML X3P to be read.
+		 */
+		ISO5436_2Reader(const String& file);
+
+		/*!
+		 * Creates a new instance.
+		 * @param source The byte source of the X3P archive to be read.
+		 */
+		ISO5436_2Reader(std::shared_ptr<const ByteSource> source);
+
+		/*! Destroys this instance. */
+		~ISO5436_2Reader();
+
+		/*!
+		 * Reads main.xml and decodes the point data.
+		 *
+		 * Throws an OpenGPS::Exception if the file could not be read. An exception of
+		 * type OGPS_ExWarning is thrown if any of the checksums could not be verified.
+		 * The point data can be accessed nevertheless then.
+		 */
+		void Open();
+
+		/*!
+		 * Gets the content of main.xml.
+		 * @remarks Valid once ISO5436_2Reader::Open succeeded.
+		 */
+		const Metadata& GetMetadata() const;
+
+		/*!
+		 * Gets the value of a data point vector at a given matrix position, see ISO5436_2::GetMatrixPoint.
+		 * @param u The u-direction of the surface position.
+		 * @param v The v-direction of the surface position.
+		 * @param w The w-direction of the surface position.
+		 * @param vector Returns the value of the data point vector at the given position.
+		 */
+		void GetMatrixPoint(size_t u, size_t v, size_t w, PointVector& vector) const;
+
+		/*!
+		 * Gets the value of a data point vector at a given index position, see ISO5436_2::GetListPoint.
+		 * @param index The index of the surface position.
+		 * @param vector Returns the value of the data point vector at the given position.
+		 */
+		void GetListPoint(size_t index, PointVector& vector) const;
+
+		/*!
+		 * Gets the fully transformed value of a data point vector at a given matrix position, see ISO5436_2::GetMatrixCoord.
+		 * @param u The u-direction of the surface position.
+		 * @param v The v-direction of the surface position.
+		 * @param w The w-direction of the surface position.
+		 * @param x Returns the x component or NaN if it is invalid. This parameter may be nullptr.
+		 * @param y Returns the y component or NaN if it is invalid. This parameter may be nullptr.
+		 * @param z Returns the z component or NaN if it is invalid. This parameter may be nullptr.
+		 */
+		void GetMatrixCoord(size_t u, size_t v, size_t w, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const;
+
+		/*!
+		 * Gets the fully transformed value of a data point vector at a given index position, see ISO5436_2::GetListCoord.
+		 * @param index The index of the surface position.
+		 * @param x Returns the x component or NaN if it is invalid. This parameter may be nullptr.
+		 * @param y Returns the y component or NaN if it is invalid. This parameter may be nullptr.
+		 * @param z Returns the z component or NaN if it is invalid. This parameter may be nullptr.
+		 */
+		void GetListCoord(size_t index, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const;
+
+		/*!
+		 * Asks if there is point vector data stored at the given matrix position, see ISO5436_2::IsMatrixCoordValid.
+		 * @param u The u-direction of the surface position.
+		 * @param v The v-direction of the surface position.
+		 * @param w The w-direction of the surface position.
+		 */
+		bool IsMatrixCoordValid(size_t u, size_t v, size_t w) const;
+
+	private:
+		/*! Pointer to the internal implementation. */
+		std::unique_ptr<ArchiveReader> m_Instance;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ISO5436_2Reader(const ISO5436_2Reader& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ISO5436_2Reader& operator=(const ISO5436_2Reader& src) = delete;
+	};
+}
+
+#endif
+
+/*! @} */
@@ -0,0 +1,186 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * A part of the point data of an ISO 5436-2 X3P file to be processed independently.
+ */
+
+#ifndef _OPENGPS_CXX_POINT_PARTITION_HXX
+#define _OPENGPS_CXX_POINT_PARTITION_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <functional>
+
+namespace OpenGPS
+{
+	class ISO5436_2;
+	class PointVector;
+
+	/*!
+	 * A band of rows of a matrix or a range of indexes of a list together with a cursor
+	 * traversing its point vectors.
+	 *
+	 * Partitions of the same document do not overlap, so they may be processed by
+	 * several threads at once. Each partition keeps its own cursor, point data is
+	 * read through the const accessors of OpenGPS::ISO5436_2.
+	 *
+	 * @remarks Partitions can be obtained from OpenGPS::ISO5436_2::GetPartitions. The
+	 * document must stay open as long as its partitions are used.
+	 */
+	class _OPENGPS_EXPORT PointPartition
+	{
+	public:
+		/*!
+		 * Creates a new instance. The cursor is placed before the first point vector.
+		 *
+		 * @param document The document whose point data is traversed.
+		 * @param first The first row of a matrix or the first index of a list.
+		 * @param count The number of rows of a matrix or the number of indexes of a list.
+		 */
+		PointPartition(const ISO5436_2& document, size_t first, size_t count);
+
+		/*! Returns true if the partition is a band of rows of a matrix, false if it is a range of indexes of a list. */
+		bool IsMatrix() const;
+
+		/*! Gets the first row of a matrix or the first index of a list. */
+		size_t GetFirst() const;
+
+		/*! Gets the number of rows of a matrix or the number of indexes of a list. */
+		size_t GetCount() const;
+
+		/*! Gets the number of point vectors of the partition. */
+		size_t GetPointCount() const;
+
+		/*!
+		 * Moves the cursor to the next point vector. Within a matrix the u-direction runs
+		 * fastest, then the v-direction and then the w-direction.
+		 *
+		 * @remarks Call this directly after creating or resetting the partition to move to the first point.
+		 *
+		 * @returns Returns true on success, false if there is no point vector left.
+		 */
+		bool MoveNext();
+
+		/*! Places the cursor before the first point vector again. */
+		void Reset();
+
+		/*!
+		 * Gets the raw value of the current point vector, see OpenGPS::ISO5436_2::GetMatrixPoint
+		 * and OpenGPS::ISO5436_2::GetListPoint.
+		 *
+		 * @param vector Gets a copy of the vector at the current cursor position.
+		 */
+		void GetCurrent(PointVector& vector) const;
+
+		/*!
+		 * Gets the fully transformed value of the current point vector, see OpenGPS::ISO5436_2::GetMatrixCoord
+		 * and OpenGPS::ISO5436_2::GetListCoord.
+		 *
+		 * @param x Gets the x component. May be nullptr.
+		 * @param y Gets the y component. May be nullptr.
+		 * @param z Gets the z component. May be nullptr.
+		 */
+		void GetCurrentCoord(
+			OGPS_Double* x,
+			OGPS_Double* y,
+			OGPS_Double* z) const;
+
+		/*!
+		 * Asks if there is point vector data stored at the current cursor position.
+		 * Points of a list are always valid.
+		 */
+		bool IsCurrentValid() const;
+
+		/*!
+		 * Gets the current position of the cursor in topology coordinates.
+		 *
+		 * @param u Gets the position index of the u component of the surface. May be nullptr.
+		 * @param v Gets the position index of the v component of the surface. May be nullptr.
+		 * @param w Gets the position index of the w component of the surface. May be nullptr.
+		 * @returns Returns true on success, false if the partition is not part of a matrix.
+		 */
+		bool GetPosition(
+			size_t* u,
+			size_t* v,
+			size_t* w) const;
+
+		/*!
+		 * Gets the current position of the cursor within a list.
+		 *
+		 * @param index Gets the position index.
+		 * @returns Returns true on success, false if the partition is not part of a list.
+		 */
+		bool GetPosition(size_t* index) const;
+
+	private:
+		/*! The document whose point data is traversed. */
+		const ISO5436_2* m_Document;
+
+		/*! true to use matrix indexes and access methods, but false for the list interface. */
+		bool m_IsMatrix;
+
+		/*! The first row of a matrix or the first index of a list. */
+		size_t m_First;
+
+		/*! The number of rows of a matrix or the number of indexes of a list. */
+		size_t m_Count;
+
+		/*! The number of points along the u-direction of a matrix. */
+		size_t m_SizeU{ 1 };
+
+		/*! The number of points along the w-direction of a matrix. */
+		size_t m_SizeW{ 1 };
+
+		/*! true if the cursor is placed before the first point vector. */
+		bool m_IsReset{ true };
+
+		/*! The current index in X direction or the current index of a list. */
+		size_t m_U{};
+
+		/*! The current index in Y direction. Used with matrices only. */
+		size_t m_V{};
+
+		/*! The current index in Z direction. Used with matrices only. */
+		size_t m_W{};
+	};
+
+	/*!
+	 * Processes a single partition passed by OpenGPS::ISO5436_2::ParallelForEach.
+	 * The cursor of the partition is placed before its first point vector.
+	 */
+	typedef std::function<void(PointPartition& partition)> PointPartitionCallback;
+}
+
+#endif
+
+/*! @} */
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @addtogroup Cpp
+   @{ */
+
+/*! @file
+ * Controls the threads the library executes parallel work on.
+ */
+
+#ifndef _OPENGPS_CXX_SCHEDULER_HXX
+#define _OPENGPS_CXX_SCHEDULER_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <functional>
+
+namespace OpenGPS
+{
+	/*!
+	 * Executes a task of the library on a thread of the application.
+	 * The executor must run the task exactly once, either right away or later on any thread.
+	 *
+	 * @see Scheduler::SetExecutor
+	 */
+	typedef std::function<void(std::function<void()> task)> TaskExecutor;
+
+	/*!
+	 * Controls the threads the library executes parallel work on.
+	 *
+	 * Parallel work of the library, like processing partitions by ISO5436_2::ParallelForEach
+	 * or opening files by OpenGPS::ISO5436_2Batch with its default number of threads, is run by a
+	 * single work-stealing thread pool. Its size can be limited, or an executor of the application
+	 * can take over, so that the library shares the threads of the application instead of
+	 * oversubscribing the processor cores.
+	 *
+	 * Only these threads are started outside of the thread pool:
+	 * - Pipelines of an archive entry, which decompress and verify binary point data while it is
+	 *   loaded if OGPS_OpenOptions::pipelineBuffers is set, or compress and checksum binary point
+	 *   data while it is written, see OGPS_WriteOptions. Each runs two threads.
+	 * - The thread reading files ahead and the worker threads of an explicit number of threads
+	 *   of OpenGPS::ISO5436_2Batch.
+	 *
+	 * If the maximum number of threads is 1 or an executor is set, none of these threads are
+	 * started. Their work is then done single-threaded, and a batch of files is opened by
+	 * the thread pool or the executor alone.
+	 *
+	 * @remarks Change the settings while the library executes no parallel work. Tasks already
+	 * queued are finished by the previous threads.
+	 */
+	class _OPENGPS_EXPORT Scheduler
+	{
+	public:
+		/*!
+		 * Sets the maximum number of worker threads of the thread pool of the library.
+		 * @param count The number of worker threads. If this is 0 there is one thread per processor core, which is the default.
+		 */
+		static void SetMaxThreads(size_t count);
+
+		/*! Gets the maximum number of worker threads as set by Scheduler::SetMaxThreads. */
+		static size_t GetMaxThreads();
+
+		/*!
+		 * Gets the number of threads parallel work is split up for.
+		 * This resolves the default of one thread per processor core.
+		 */
+		static size_t GetThreadCount();
+
+		/*!
+		 * Passes all parallel work of the library to an executor of the application.
+		 * The thread pool of the library is not used then, nor are any threads of its own started.
+		 * Its maximum number of threads still determines how many parts parallel work is split up into.
+		 * @param executor Executes the tasks of the library. If this is empty the thread pool of the library is used again.
+		 */
+		static void SetExecutor(TaskExecutor executor);
+	};
+}
+
+#endif
+
+/*! @} */
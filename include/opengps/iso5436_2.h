@@ -48,6 +48,9 @@
 #include <opengps/opengps.h>
 #include <opengps/point_vector.h>
 #include <opengps/point_iterator.h>
+#include <opengps/open_options.h>
+#include <opengps/write_options.h>
+#include <opengps/point_block.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,11 +83,109 @@ extern "C" {
 		const OGPS_Character* file,
 		const OGPS_Character* temp = NULL);
 
+	/*!
+	 * Opens an existing ISO5436-2 XML X3P file.
+	 *
+	 * @remarks You must free the returned handle by calling ::ogps_CloseISO5436_2 when done with it.
+	 *
+	 * @see ::ogps_OpenISO5436_2, ::ogps_InitOpenOptions
+	 *
+	 * @param file Full path to the ISO5436-2 XML X3P to open.
+	 * @param temp Optionally specifies the new absolute path to the directory where unpacked X3P data gets stored temporarily. If this parameter is set to NULL the default directory for temporary files will be used as specified by your system.
+	 * @param options Controls how the file is opened. If this parameter is set to NULL the default options are used.
+	 * @returns On success returns the handle object to the opened file, otherwise a NULL pointer is returned. You may get further information about the failure by calling ::ogps_GetErrorMessage hereafter.
+	 */
+	_OPENGPS_EXPORT OGPS_ISO5436_2Handle ogps_OpenISO5436_2Ex(
+		const OGPS_Character* file,
+		const OGPS_Character* temp,
+		const OGPS_OpenOptions* options);
+
+	/*!
+	 * Opens an existing ISO5436-2 XML X3P held in memory.
+	 *
+	 * The X3P is read from memory directly, nothing gets extracted to the file system.
+	 *
+	 * @remarks You must free the returned handle by calling ::ogps_CloseISO5436_2 when done with it.
+	 * The data is copied, so the buffer may be released as soon as this function returns.
+	 * Use ::ogps_WriteISO5436_2Buffer to get the content of the X3P after changes have been made.
+	 *
+	 * @see ::ogps_OpenISO5436_2Ex, ::ogps_WriteISO5436_2Buffer
+	 *
+	 * @param data The content of the ISO5436-2 XML X3P to open.
+	 * @param size The size of the data in bytes.
+	 * @param temp Optionally specifies the new absolute path to the directory where paged point data gets stored temporarily. If this parameter is set to NULL the default directory for temporary files will be used as specified by your system.
+	 * @param options Controls how the X3P is opened. If this parameter is set to NULL the default options are used.
+	 * @returns On success returns the handle object to the opened X3P, otherwise a NULL pointer is returned. You may get further information about the failure by calling ::ogps_GetErrorMessage hereafter.
+	 */
+	_OPENGPS_EXPORT OGPS_ISO5436_2Handle ogps_OpenISO5436_2Buffer(
+		const void* data,
+		size_t size,
+		const OGPS_Character* temp,
+		const OGPS_OpenOptions* options);
+
+	/*!
+	 * Receives an X3P file opened by ::ogps_OpenISO5436_2Batch.
+	 *
+	 * @remarks You must free the handle by calling ::ogps_CloseISO5436_2 when done with it.
+	 *
+	 * @param index The position of the file within the list of files to be opened.
+	 * @param handle The handle object to the opened file or NULL if opening failed. You may get further information about the failure by calling ::ogps_GetErrorMessage within the callback.
+	 * @param userData The pointer passed to ::ogps_OpenISO5436_2Batch.
+	 * @returns Return true to continue or false to skip all files not yet received.
+	 */
+	typedef OGPS_Boolean(*OGPS_BatchOpenCallback)(size_t index, OGPS_ISO5436_2Handle handle, void* userData);
+
+	/*!
+	 * Opens a list of existing ISO5436-2 XML X3P files on a pool of worker threads.
+	 *
+	 * The bytes of the next files are read ahead while files are being opened. At most maxInFlight
+	 * files are read ahead, being opened or waiting to be passed to the callback. The callback is
+	 * executed on the calling thread in the order the files have been opened, which may differ
+	 * from the order given.
+	 *
+	 * @see ::ogps_OpenISO5436_2Ex
+	 *
+	 * @param files Full paths to the ISO5436-2 XML X3P files to open.
+	 * @param count The number of files.
+	 * @param temp Optionally specifies the new absolute path to the directory where unpacked X3P data gets stored temporarily. If this parameter is set to NULL the default directory for temporary files will be used as specified by your system.
+	 * @param options Controls how the files are opened. If this parameter is set to NULL the default options are used.
+	 * @param threadCount The number of worker threads. If this is 0 the files are opened by the thread pool of the library, see ::ogps_SetMaxThreads and ::ogps_SetExecutor. Ignored if either allows no threads of their own.
+	 * @param maxInFlight The maximum number of files in flight. If this is 0 it equals twice the number of worker threads.
+	 * @param callback Receives every file opened.
+	 * @param userData Passed to the callback as it is.
+	 * @returns Returns true if all files have been passed to the callback, false if the callback returned false or anything went wrong. You may get further information about the failure by calling ::ogps_GetErrorMessage hereafter.
+	 */
+	_OPENGPS_EXPORT OGPS_Boolean ogps_OpenISO5436_2Batch(
+		const OGPS_Character* const* files,
+		size_t count,
+		const OGPS_Character* temp,
+		const OGPS_OpenOptions* options,
+		size_t threadCount,
+		size_t maxInFlight,
+		OGPS_BatchOpenCallback callback,
+		void* userData);
+
+	/*!
+	 * Sets the options point data is written with by ::ogps_WriteISO5436_2 and ::ogps_WriteISO5436_2Buffer.
+	 *
+	 * The options apply to point data written hereafter.
+	 *
+	 * @see ::ogps_InitWriteOptions
+	 *
+	 * @param handle Operate on this handle object.
+	 * @param options The options point data is written with. If this parameter is set to NULL the default options are used.
+	 */
+	_OPENGPS_EXPORT void ogps_SetWriteOptions(const OGPS_ISO5436_2Handle handle, const OGPS_WriteOptions* options);
+
 	/*!
 	 * Writes any changes back to the X3P file.
 	 *
 	 * Call this function before ::ogps_CloseISO5436_2 if you want to store the changes you have made.
 	 *
+	 * If no point of a binary X3P file opened has been set, its compressed point data is copied
+	 * as it is and only the main xml document gets written. This holds for files opened with the
+	 * loadPoints option set to false, too.
+	 *
 	 * @see ::ogps_CreateMatrixISO5436_2, ::ogps_CreateListISO5436_2, ::ogps_OpenISO5436_2, ::ogps_CloseISO5436_2
 	 *
 	 * @param handle Operate on this handle object.
@@ -93,6 +194,37 @@ extern "C" {
 	 */
 	_OPENGPS_EXPORT void ogps_WriteISO5436_2(const OGPS_ISO5436_2Handle handle, int compressionLevel = -1);
 
+	/*!
+	 * Receives the content of an X3P written by ::ogps_WriteISO5436_2Buffer.
+	 *
+	 * @param data The content of the X3P.
+	 * @param size The size of the data in bytes.
+	 * @param userData The pointer passed to ::ogps_WriteISO5436_2Buffer.
+	 * @returns Return true on success or false if the data could not be stored.
+	 */
+	typedef OGPS_Boolean(*OGPS_WriteCallback)(const void* data, size_t size, void* userData);
+
+	/*!
+	 * Writes the X3P to memory.
+	 *
+	 * Works the same as ::ogps_WriteISO5436_2, but neither the X3P file nor the X3P held in
+	 * memory the handle operates on are changed. Instead the complete X3P is passed to the
+	 * callback once it has been written.
+	 *
+	 * @see ::ogps_WriteISO5436_2, ::ogps_OpenISO5436_2Buffer
+	 *
+	 * @param handle Operate on this handle object.
+	 * @param callback Receives the content of the X3P.
+	 * @param userData Passed to the callback as it is.
+	 * @param compressionLevel Optionally specifies the compression level, see ::ogps_WriteISO5436_2.
+	 * @returns Returns true on success and false if anything went wrong or the callback returned false. You may get further information about the failure by calling ::ogps_GetErrorMessage hereafter.
+	 */
+	_OPENGPS_EXPORT bool ogps_WriteISO5436_2Buffer(
+		const OGPS_ISO5436_2Handle handle,
+		OGPS_WriteCallback callback,
+		void* userData,
+		int compressionLevel = -1);
+
 	/*!
 	 * Closes an ::OGPS_ISO5436_2Handle file handle and releases its resources.
 	 *
@@ -193,6 +325,52 @@ extern "C" {
 		size_t w,
 		const OGPS_PointVectorPtr vector);
 
+	/*!
+	 * Appends the next three-dimensional data point vector to a streamed X3P file.
+	 *
+	 * Point vectors must be appended in storage order: the u-direction runs fastest,
+	 * then the v-direction and then the w-direction. All point vectors of the matrix
+	 * must have been appended before ::ogps_WriteISO5436_2 is called.
+	 *
+	 * @see ::ogps_CreateMatrixStreamISO5436_2
+	 *
+	 * On failure you may get further information by calling ::ogps_GetErrorMessage hereafter.
+	 *
+	 * @param handle Operate on this handle object.
+	 * @param vector The point value at the next surface position. If this parameter is set to
+	 * NULL, this indicates there is no measurement data available for this position.
+	 */
+	_OPENGPS_EXPORT void ogps_AppendMatrixPoint(
+		const OGPS_ISO5436_2Handle handle,
+		const OGPS_PointVectorPtr vector);
+
+	/*!
+	 * Decodes all point vectors in storage order in a single pass and hands them
+	 * block by block to a callback function.
+	 *
+	 * If the file has been opened with the loadPoints option set to false, point data is
+	 * decompressed directly from the archive while being visited. So memory usage only
+	 * depends on the block size, regardless of the size of the file. Otherwise the
+	 * point data already loaded is visited.
+	 *
+	 * @see ::ogps_OpenISO5436_2Ex, ::OGPS_PointBlock
+	 *
+	 * On failure you may get further information by calling ::ogps_GetErrorMessage hereafter.
+	 *
+	 * @param handle Operate on this handle object.
+	 * @param callback Receives consecutive blocks of point vectors.
+	 * @param userData Is passed to the callback function as is.
+	 * @param blockSize The maximum number of point vectors of a single block. If this parameter
+	 * is set to 0, ::OGPS_DEFAULT_POINT_BLOCK_SIZE is used.
+	 * @returns Returns true if all point vectors have been visited, false if the callback
+	 * function stopped or an error occured.
+	 */
+	_OPENGPS_EXPORT bool ogps_VisitPoints(
+		const OGPS_ISO5436_2Handle handle,
+		OGPS_PointBlockCallback callback,
+		void* userData,
+		size_t blockSize = 0);
+
 	/*!
 	 * Gets the raw value of a data point vector at a given surface position.
 	 *
@@ -203,6 +381,8 @@ extern "C" {
 	 * format for access is revealed by the ISO5436-2 XML document.
 	 * Access to the ISO5436-2 XML document which is part of an X3P file container can be
 	 * obtained through ::ogps_GetDocument.
+	 * Components of incremental axes are derived from the point index. They are returned as
+	 * OGPS_Int32 and as OGPS_Double when the index exceeds the range of a signed 32-bit integer.
 	 *
 	 * @see ::ogps_GetMatrixCoord, ::ogps_GetListPoint
 	 *
@@ -258,6 +438,8 @@ extern "C" {
 	 * format for access is revealed by the ISO5436-2 XML document.
 	 * Access to the ISO5436-2 XML document which is part of an X3P file container can be
 	 * obtained through ::ogps_GetDocument.
+	 * Components of incremental axes are derived from the point index. They are returned as
+	 * OGPS_Int32 and as OGPS_Double when the index exceeds the range of a signed 32-bit integer.
 	 *
 	 * @see ::ogps_GetListCoord, ::ogps_GetMatrixPoint
 	 *
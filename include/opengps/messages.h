@@ -36,6 +36,11 @@
  * Global handling of error and warning messages. This wrappes C++ exception
  * handling to be usable in the C interface. See OpenGPS::Exception for
  * details about throwing exceptions in this software library.
+ *
+ * The last error condition is maintained for each thread. The functions
+ * declared here report failures of the preceding call of the C interface
+ * made by the current thread only, so different handles may be used by
+ * different threads without further synchronization.
  */
 
 #ifndef _OPENGPS_MESSAGES_H
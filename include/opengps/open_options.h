@@ -0,0 +1,190 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! \addtogroup C
+ *  @{
+ */
+
+/*! @file
+ * Options that control how an existing X3P file is opened.
+ */
+
+#ifndef _OPENGPS_OPEN_OPTIONS_H
+#define _OPENGPS_OPEN_OPTIONS_H
+
+#include <opengps/opengps.h>
+
+/*! The default size of a single memory page of paged point data in bytes. */
+#define OGPS_DEFAULT_PAGE_SIZE (1024 * 1024)
+
+/*! The default amount of memory pages read ahead when paged point data is accessed sequentially. */
+#define OGPS_DEFAULT_PREFETCH_PAGES 4
+
+/*! The default maximum total size of the files of a cache of decoded point data in bytes. */
+#define OGPS_DEFAULT_CACHE_BUDGET (1024ULL * 1024 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*!
+	 * Options that control how an existing X3P file is opened.
+	 *
+	 * @remarks Always initialize an instance with ::ogps_InitOpenOptions before
+	 * changing single options. Further options may be added in the future.
+	 *
+	 * If only some rows or layers of a matrix are loaded, the matrix dimensions of the
+	 * document opened are reduced accordingly and matrix positions are relative to the
+	 * first row and layer loaded. Such a document cannot be written back and the checksum of
+	 * its binary point data is not verified.
+	 *
+	 * @see ::ogps_OpenISO5436_2Ex
+	 */
+	typedef struct _OGPS_OPEN_OPTIONS {
+		/*!
+		 * The amount of memory in bytes point data may occupy. If the point data
+		 * of the file exceeds this budget, it is kept in memory pages that get
+		 * swapped out to a temporary file. A value of 0 keeps all point data in
+		 * memory, which is the default.
+		 */
+		size_t pagedMemoryBudget;
+
+		/*! The size of a single memory page of paged point data in bytes. */
+		size_t pageSize;
+
+		/*! The amount of memory pages read ahead when paged point data is accessed sequentially. */
+		size_t prefetchPages;
+
+		/*!
+		 * Whether point data is loaded when the file is opened, which is the default.
+		 * If set to false only the XML document is read. Point data then is decoded
+		 * on demand by ::ogps_VisitPoints directly from the archive and cannot be
+		 * accessed otherwise.
+		 */
+		OGPS_Boolean loadPoints;
+
+		/*!
+		 * The first row (v-direction) of every layer of a matrix to be loaded. Rows in
+		 * front of it are skipped. Ignored for point lists or if loadPoints is false.
+		 */
+		size_t firstRow;
+
+		/*!
+		 * The number of rows (v-direction) of a matrix to be loaded, starting with
+		 * firstRow of every layer loaded. A value of 0 loads all remaining rows, which is the default.
+		 * Since point data is stored row by row, decompression stops as soon as the last
+		 * row requested has been read. Ignored for point lists or if loadPoints is false.
+		 */
+		size_t rowCount;
+
+		/*!
+		 * The first layer (w-direction) of a matrix to be loaded. Layers in front of it
+		 * are skipped. Ignored for point lists or if loadPoints is false.
+		 */
+		size_t firstLayer;
+
+		/*!
+		 * The number of layers (w-direction) of a matrix to be loaded, starting with
+		 * firstLayer. A value of 0 loads all remaining layers, which is the default.
+		 * Ignored for point lists or if loadPoints is false.
+		 */
+		size_t layerCount;
+
+		/*!
+		 * The amount of uncompressed binary point data in bytes between two access points
+		 * of a random-access index, e.g. 1MB. If only some rows or layers of a matrix are loaded,
+		 * decompression then starts at the access point nearest to the first row requested instead
+		 * of the beginning of the point data. The index is built by decompressing the point data
+		 * once and is kept in memory for the archives opened most recently, so that subsequent
+		 * partial opens of the same archive start decompressing right away. Each access point
+		 * occupies about 32KB of memory. A value of 0 disables the index, which is the default.
+		 */
+		size_t indexSpan;
+
+		/*!
+		 * The number of buffers of uncompressed binary point data in flight if loading
+		 * point data is pipelined, e.g. 4. One thread then decompresses the point data and
+		 * a second thread verifies its checksum while the thread opening the file decodes
+		 * the points, instead of doing everything one after another. The binary point data
+		 * is read directly from the archive then. Each buffer occupies 256KB of memory.
+		 * A value of 0 disables the pipeline, which is the default. The pipeline is disabled
+		 * as well if the scheduler allows no threads of their own, see ::ogps_SetMaxThreads.
+		 */
+		size_t pipelineBuffers;
+
+		/*!
+		 * An existing directory that keeps the decoded binary point data of the files
+		 * opened, identified by the MD5 checksums declared by their main document. When
+		 * the same point data is opened again, the cached file is mapped into memory instead
+		 * of decompressing and decoding the point data. Point data only gets cached if it is
+		 * loaded as a whole and its checksums have been verified. The string must remain valid
+		 * while the file is opened. A value of NULL disables the cache, which is the default.
+		 */
+		const OGPS_Character* cacheDirectory;
+
+		/*!
+		 * The maximum total size of the files within cacheDirectory in bytes. The files
+		 * used least recently are removed when it is exceeded.
+		 */
+		unsigned long long cacheBudget;
+
+		/*!
+		 * Whether decoded binary point data is cached in named segments of shared memory
+		 * instead of cacheDirectory, which is ignored then. All processes of a machine
+		 * that open the same point data map a single copy of it, including the process
+		 * that has decoded it first. cacheBudget limits the total size of the segments.
+		 * On systems whose segments cannot be enumerated, a segment vanishes as soon as
+		 * no process maps it anymore and cacheBudget limits a single segment. The default is false.
+		 */
+		OGPS_Boolean cacheSharedMemory;
+
+		/*!
+		 * Whether the segments of cacheSharedMemory are shared with all users of the machine.
+		 * By default segments are readable by the user that has created them only and segments
+		 * of other users are ignored, since any user could provide arbitrary point data for a
+		 * file otherwise. Enable this only if all users of the machine are trusted. Segments
+		 * writable by others than their owner are ignored in any case. The default is false.
+		 */
+		OGPS_Boolean cacheSharedWithAllUsers;
+	} OGPS_OpenOptions;
+
+	/*!
+	 * Sets all options to their default values.
+	 *
+	 * @param options The options to be initialized.
+	 */
+	_OPENGPS_EXPORT void ogps_InitOpenOptions(OGPS_OpenOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+/*! @} */
@@ -112,6 +112,7 @@ typedef wchar_t OGPS_Character;
 typedef char OGPS_Character;
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*! Represents measurement data of type short. */
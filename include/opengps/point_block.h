@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! \addtogroup C
+ *  @{
+ */
+
+/*! @file
+ * A block of consecutive point vectors handed to a visitor while point data is
+ * decoded in a single pass. @see ::ogps_VisitPoints
+ */
+
+#ifndef _OPENGPS_POINT_BLOCK_H
+#define _OPENGPS_POINT_BLOCK_H
+
+#include <opengps/opengps.h>
+#include <opengps/data_point_type.h>
+
+/*! The default number of point vectors contained in a single ::OGPS_PointBlock. */
+#define OGPS_DEFAULT_POINT_BLOCK_SIZE (64 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*!
+	 * A block of consecutive point vectors in storage order.
+	 *
+	 * For a matrix the u-direction runs fastest, then the v-direction and then the
+	 * w-direction. So the point vector at position i within the block lies at
+	 * u = (index + i) % size_u, v = (index + i) / size_u % size_v and
+	 * w = (index + i) / (size_u * size_v).
+	 *
+	 * The components of each axis are given as typed arrays of count elements. Axes
+	 * that are defined by an increment rather than by point data are of type
+	 * ::OGPS_MissingPointType and their array pointer is NULL. The values of
+	 * invalid point vectors are undefined.
+	 *
+	 * @remarks All pointers are valid only during the call of the visitor.
+	 */
+	typedef struct _OGPS_POINT_BLOCK {
+		/*! The storage order index of the first point vector of this block. */
+		size_t index;
+
+		/*! The number of point vectors in this block. */
+		size_t count;
+
+		/*! The data type of the components of the x axis. */
+		OGPS_DataPointType xType;
+		/*! The data type of the components of the y axis. */
+		OGPS_DataPointType yType;
+		/*! The data type of the components of the z axis. */
+		OGPS_DataPointType zType;
+
+		/*! Typed array of the components of the x axis or NULL. */
+		const void* x;
+		/*! Typed array of the components of the y axis or NULL. */
+		const void* y;
+		/*! Typed array of the components of the z axis. */
+		const void* z;
+
+		/*! Is true for every point vector that contains measurement data. */
+		const OGPS_Boolean* valid;
+	} OGPS_PointBlock;
+
+	/*!
+	 * Receives blocks of point vectors from ::ogps_VisitPoints.
+	 *
+	 * @param block The current block of point vectors.
+	 * @param userData The pointer passed to ::ogps_VisitPoints.
+	 * @returns Return true to continue with the next block or false to stop.
+	 */
+	typedef OGPS_Boolean(*OGPS_PointBlockCallback)(const OGPS_PointBlock* block, void* userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+/*! @} */
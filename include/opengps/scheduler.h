@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! \addtogroup C
+ *  @{
+ */
+
+/*! @file
+ * Controls the threads the library executes parallel work on.
+ */
+
+#ifndef _OPENGPS_SCHEDULER_H
+#define _OPENGPS_SCHEDULER_H
+
+#include <opengps/opengps.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+	/*!
+	 * Runs a task of the library.
+	 *
+	 * @param task The task passed to ::OGPS_ExecutorCallback.
+	 */
+	typedef void(*OGPS_TaskCallback)(void* task);
+
+	/*!
+	 * Executes a task of the library on a thread of the application.
+	 *
+	 * The executor must call run with the given task exactly once, either right away or later on any thread.
+	 *
+	 * @see ::ogps_SetExecutor
+	 *
+	 * @param run Runs the task.
+	 * @param task The task to be passed to run.
+	 * @param userData The pointer passed to ::ogps_SetExecutor.
+	 */
+	typedef void(*OGPS_ExecutorCallback)(OGPS_TaskCallback run, void* task, void* userData);
+
+	/*!
+	 * Sets the maximum number of worker threads of the thread pool of the library.
+	 *
+	 * Parallel work of the library is run by a single work-stealing thread pool. Only these threads
+	 * are started outside of it:
+	 * - Pipelines of an archive entry, which decompress and verify binary point data while it is
+	 *   loaded if ::OGPS_OpenOptions::pipelineBuffers is set, or compress and checksum binary point
+	 *   data while it is written, see ::OGPS_WriteOptions. Each runs two threads.
+	 * - The thread reading files ahead and the worker threads of an explicit threadCount
+	 *   of ::ogps_OpenISO5436_2Batch.
+	 *
+	 * If count is 1 or an executor is set by ::ogps_SetExecutor, none of these threads are started.
+	 * Their work is then done single-threaded, and a batch of files is opened by the thread pool
+	 * or the executor alone. Change this while the library executes no parallel work.
+	 *
+	 * @param count The number of worker threads. If this is 0 there is one thread per processor core, which is the default.
+	 */
+	_OPENGPS_EXPORT void ogps_SetMaxThreads(size_t count);
+
+	/*!
+	 * Gets the maximum number of worker threads as set by ::ogps_SetMaxThreads.
+	 */
+	_OPENGPS_EXPORT size_t ogps_GetMaxThreads();
+
+	/*!
+	 * Passes all parallel work of the library to an executor of the application.
+	 *
+	 * The thread pool of the library is not used then, so the library shares the threads of the
+	 * application instead of oversubscribing the processor cores. The library does not start any
+	 * threads of its own then, see ::ogps_SetMaxThreads. Change this while the library
+	 * executes no parallel work.
+	 *
+	 * @param executor Executes the tasks of the library. If this is NULL the thread pool of the library is used again.
+	 * @param userData Passed to the executor as it is.
+	 */
+	_OPENGPS_EXPORT void ogps_SetExecutor(OGPS_ExecutorCallback executor, void* userData);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _OPENGPS_SCHEDULER_H */
+
+/*! @} */
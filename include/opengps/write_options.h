@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! \addtogroup C
+ *  @{
+ */
+
+/*! @file
+ * Options that control how an X3P file is written.
+ */
+
+#ifndef _OPENGPS_WRITE_OPTIONS_H
+#define _OPENGPS_WRITE_OPTIONS_H
+
+#include <opengps/opengps.h>
+
+/*! The default number of buffers of the pipeline that compresses binary point data while it is written. */
+#define OGPS_DEFAULT_WRITE_PIPELINE_BUFFERS 4
+
+/*! The default minimum size of binary point data in bytes that is written by a pipeline. */
+#define OGPS_DEFAULT_WRITE_PIPELINE_MINIMUM (4ULL * 1024 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*!
+	 * Options that control how an X3P file is written.
+	 *
+	 * @remarks Always initialize an instance with ::ogps_InitWriteOptions before
+	 * changing single options. Further options may be added in the future.
+	 *
+	 * @see ::ogps_SetWriteOptions
+	 */
+	typedef struct _OGPS_WRITE_OPTIONS {
+		/*!
+		 * The number of buffers of uncompressed binary point data in flight if writing
+		 * point data is pipelined. One thread then checksums the point data and a second
+		 * thread compresses it while the thread writing the file encodes the points, instead
+		 * of doing everything one after another. Each buffer occupies 256KB of memory.
+		 * A value of 0 disables the pipeline. The pipeline is disabled as well if the
+		 * scheduler allows no threads of their own, see ::ogps_SetMaxThreads.
+		 */
+		size_t pipelineBuffers;
+
+		/*!
+		 * The minimum size of the binary point data in bytes that is written by the pipeline.
+		 * Smaller point data is written by the thread writing the file alone, since starting
+		 * the threads of the pipeline would take longer than it saves.
+		 */
+		unsigned long long pipelineMinimum;
+	} OGPS_WriteOptions;
+
+	/*!
+	 * Sets all options to their default values.
+	 *
+	 * @param options The options to be initialized.
+	 */
+	_OPENGPS_EXPORT void ogps_InitWriteOptions(OGPS_WriteOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+/*! @} */
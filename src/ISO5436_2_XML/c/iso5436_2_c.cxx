@@ -31,6 +31,7 @@
 #include <opengps/iso5436_2.h>
 #include <opengps/cxx/iso5436_2.hxx>
 #include <opengps/cxx/iso5436_2_handle.hxx>
+#include <opengps/cxx/iso5436_2_batch.hxx>
 
 #include "iso5436_2_handle_c.hxx"
 #include "point_iterator_c.hxx"
@@ -56,6 +57,108 @@ OGPS_ISO5436_2Handle ogps_OpenISO5436_2(
 	});
 }
 
+OGPS_ISO5436_2Handle ogps_OpenISO5436_2Ex(
+	const OGPS_Character* file,
+	const OGPS_Character* temp,
+	const OGPS_OpenOptions* options)
+{
+	assert(file);
+
+	return HandleExceptionRetval(nullptr, [&]() {
+		OGPS_OpenOptions defaults;
+		ogps_InitOpenOptions(&defaults);
+
+		auto instance{ std::make_unique<ISO5436_2>(file, temp ? temp : _T("")) };
+		instance->Open(options ? *options : defaults);
+		OGPS_ISO5436_2Handle h{ new OGPS_ISO5436_2 };
+		h->instance = std::move(instance);
+		return h;
+	});
+}
+
+OGPS_ISO5436_2Handle ogps_OpenISO5436_2Buffer(
+	const void* data,
+	size_t size,
+	const OGPS_Character* temp,
+	const OGPS_OpenOptions* options)
+{
+	assert(data || size == 0);
+
+	return HandleExceptionRetval(nullptr, [&]() {
+		OGPS_OpenOptions defaults;
+		ogps_InitOpenOptions(&defaults);
+
+		const auto bytes{ static_cast<const unsigned char*>(data) };
+		auto instance{ std::make_unique<ISO5436_2>(std::vector<unsigned char>(bytes, bytes + size), temp ? temp : _T("")) };
+		instance->Open(options ? *options : defaults);
+		OGPS_ISO5436_2Handle h{ new OGPS_ISO5436_2 };
+		h->instance = std::move(instance);
+		return h;
+	});
+}
+
+OGPS_Boolean ogps_OpenISO5436_2Batch(
+	const OGPS_Character* const* files,
+	size_t count,
+	const OGPS_Character* temp,
+	const OGPS_OpenOptions* options,
+	size_t threadCount,
+	size_t maxInFlight,
+	OGPS_BatchOpenCallback callback,
+	void* userData)
+{
+	assert((files || count == 0) && callback);
+
+	return HandleExceptionRetval(false, [&]() {
+		std::vector<String> filePaths(files, files + count);
+		ISO5436_2Batch batch(std::move(filePaths), options, threadCount, maxInFlight, temp ? temp : _T(""));
+
+		ISO5436_2BatchResult result;
+		while (batch.Next(result))
+		{
+			ExceptionHistory::Reset();
+
+			OGPS_ISO5436_2Handle h{};
+			if (result.document)
+			{
+				h = new OGPS_ISO5436_2;
+				h->instance = std::move(result.document);
+			}
+			else
+			{
+				// Make the failure available to the callback.
+				try
+				{
+					std::rethrow_exception(result.error);
+				}
+				catch (const Exception& ex)
+				{
+					ExceptionHistory::SetLastException(ex);
+				}
+				catch (const std::exception& ex)
+				{
+					ExceptionHistory::SetLastException(ex);
+				}
+				catch (...)
+				{
+					ExceptionHistory::SetLastException();
+				}
+			}
+
+			const auto proceed{ callback(result.index, h, userData) };
+
+			ExceptionHistory::Reset();
+
+			if (!proceed)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	});
+}
+
 OGPS_ISO5436_2Handle ogps_CreateMatrixISO5436_2(
 	const OGPS_Character* file,
 	const OGPS_Character* temp,
@@ -76,6 +179,33 @@ OGPS_ISO5436_2Handle ogps_CreateMatrixISO5436_2(
 	});
 }
 
+OGPS_ISO5436_2Handle ogps_CreateMatrixStreamISO5436_2(
+	const OGPS_Character* file,
+	const OGPS_Character* temp,
+	const Schemas::ISO5436_2::Record1Type& record1,
+	const Schemas::ISO5436_2::Record2Type* record2,
+	const Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+	int compressionLevel,
+	const OGPS_WriteOptions* options)
+{
+	assert(file);
+
+	return HandleExceptionRetval(nullptr, [&]() {
+		auto instance{ std::make_unique<ISO5436_2>(file, temp ? temp : _T("")) };
+
+		if (options)
+		{
+			instance->SetWriteOptions(*options);
+		}
+
+		instance->CreateStream(record1, record2, matrixDimension, compressionLevel);
+
+		OGPS_ISO5436_2Handle h{ new OGPS_ISO5436_2 };
+		h->instance = std::move(instance);
+		return h;
+	});
+}
+
 OGPS_ISO5436_2Handle ogps_CreateListISO5436_2(
 	const OGPS_Character* file,
 	const OGPS_Character* temp,
@@ -105,6 +235,18 @@ Schemas::ISO5436_2::ISO5436_2Type* ogps_GetDocument(const OGPS_ISO5436_2Handle h
 	});
 }
 
+void ogps_SetWriteOptions(const OGPS_ISO5436_2Handle handle, const OGPS_WriteOptions* options)
+{
+	assert(handle && handle->instance);
+
+	HandleException([&]() {
+		OGPS_WriteOptions defaults;
+		ogps_InitWriteOptions(&defaults);
+
+		handle->instance->SetWriteOptions(options ? *options : defaults);
+	});
+}
+
 void ogps_WriteISO5436_2(const OGPS_ISO5436_2Handle handle, int compressionLevel)
 {
 	assert(handle && handle->instance);
@@ -114,6 +256,31 @@ void ogps_WriteISO5436_2(const OGPS_ISO5436_2Handle handle, int compressionLevel
 	});
 }
 
+bool ogps_WriteISO5436_2Buffer(
+	const OGPS_ISO5436_2Handle handle,
+	OGPS_WriteCallback callback,
+	void* userData,
+	int compressionLevel)
+{
+	assert(handle && handle->instance && callback);
+
+	return HandleExceptionRetval(false, [&]() {
+		std::vector<unsigned char> target;
+		handle->instance->Write(target, compressionLevel);
+
+		if (!callback(target.data(), target.size(), userData))
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("The X3P could not be written to memory."),
+				_EX_T("The callback that receives the content of the X3P reported a failure."),
+				_EX_T("ogps_WriteISO5436_2Buffer"));
+		}
+
+		return true;
+	});
+}
+
 void ogps_CloseISO5436_2(OGPS_ISO5436_2Handle* handle)
 {
 	if (handle)
@@ -165,6 +332,32 @@ void ogps_SetMatrixPoint(
 	});
 }
 
+void ogps_AppendMatrixPoint(
+	const OGPS_ISO5436_2Handle handle,
+	const OGPS_PointVectorPtr vector)
+{
+	assert(handle && handle->instance);
+
+	HandleException([&]() {
+		handle->instance->AppendMatrixPoint(vector ? &vector->instance : nullptr);
+	});
+}
+
+bool ogps_VisitPoints(
+	const OGPS_ISO5436_2Handle handle,
+	OGPS_PointBlockCallback callback,
+	void* userData,
+	size_t blockSize)
+{
+	assert(handle && handle->instance && callback);
+
+	return HandleExceptionRetval(false, [&]() {
+		return handle->instance->Visit([callback, userData](const OGPS_PointBlock& block) {
+			return callback(&block, userData);
+		}, blockSize);
+	});
+}
+
 void ogps_GetMatrixPoint(
 	const OGPS_ISO5436_2Handle handle,
 	size_t u,
@@ -129,7 +129,7 @@ OGPS_ExceptionId ExceptionHistory::GetLastErrorId()
 	return m_LastErrorId;
 }
 
-String ExceptionHistory::m_LastErrorMessage;
-String ExceptionHistory::m_LastErrorDescription;
-String ExceptionHistory::m_LastErrorSource;
-OGPS_ExceptionId ExceptionHistory::m_LastErrorId = OGPS_ExNone;
+thread_local String ExceptionHistory::m_LastErrorMessage;
+thread_local String ExceptionHistory::m_LastErrorDescription;
+thread_local String ExceptionHistory::m_LastErrorSource;
+thread_local OGPS_ExceptionId ExceptionHistory::m_LastErrorId = OGPS_ExNone;
@@ -43,6 +43,9 @@ namespace OpenGPS
 {
 	/*!
 	 * Maintains a history of exceptions.
+	 *
+	 * Every thread maintains a history of its own, so that failures of
+	 * independent handles used by different threads do not interfere.
 	 */
 	class ExceptionHistory
 	{
@@ -87,17 +90,17 @@ namespace OpenGPS
 		/*! Creates a new instance. */
 		ExceptionHistory() = delete;
 
-		/*! The brief description of the last known failure condition or empty. */
-		static String m_LastErrorMessage;
+		/*! The brief description of the last known failure condition of the current thread or empty. */
+		static thread_local String m_LastErrorMessage;
 
-		/*! The detailed description of the last known failure condition or empty. */
-		static String m_LastErrorDescription;
+		/*! The detailed description of the last known failure condition of the current thread or empty. */
+		static thread_local String m_LastErrorDescription;
 
-		/*! The classifier of the last known failure condition or ::OGPS_ExNone. */
-		static OGPS_ExceptionId m_LastErrorId;
+		/*! The classifier of the last known failure condition of the current thread or ::OGPS_ExNone. */
+		static thread_local OGPS_ExceptionId m_LastErrorId;
 
-		/*! Source of the last error condition. */
-		static String m_LastErrorSource;
+		/*! Source of the last error condition of the current thread. */
+		static thread_local String m_LastErrorSource;
 
 		/*! Dumps a message to the error console. This works if _DEBUG is defined. */
 		static void DumpIt();
@@ -0,0 +1,53 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/open_options.h>
+#include <opengps/cxx/opengps.hxx>
+#include "../cxx/stdafx.hxx"
+
+void ogps_InitOpenOptions(OGPS_OpenOptions* options)
+{
+	assert(options);
+
+	options->pagedMemoryBudget = 0;
+	options->pageSize = OGPS_DEFAULT_PAGE_SIZE;
+	options->prefetchPages = OGPS_DEFAULT_PREFETCH_PAGES;
+	options->loadPoints = true;
+	options->firstRow = 0;
+	options->rowCount = 0;
+	options->firstLayer = 0;
+	options->layerCount = 0;
+	options->indexSpan = 0;
+	options->pipelineBuffers = 0;
+	options->cacheDirectory = nullptr;
+	options->cacheBudget = OGPS_DEFAULT_CACHE_BUDGET;
+	options->cacheSharedMemory = false;
+	options->cacheSharedWithAllUsers = false;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/scheduler.h>
+#include <opengps/cxx/scheduler.hxx>
+#include "messages_c.hxx"
+#include "../cxx/stdafx.hxx"
+
+#include <memory>
+
+/*! Runs a task passed to an executor of the application and releases it. */
+static void RunTask(void* task)
+{
+	assert(task);
+
+	std::unique_ptr<std::function<void()>> function{ static_cast<std::function<void()>*>(task) };
+	(*function)();
+}
+
+void ogps_SetMaxThreads(size_t count)
+{
+	HandleException([&]() {
+		Scheduler::SetMaxThreads(count);
+	});
+}
+
+size_t ogps_GetMaxThreads()
+{
+	return HandleExceptionRetval(0, [&]() {
+		return Scheduler::GetMaxThreads();
+	});
+}
+
+void ogps_SetExecutor(OGPS_ExecutorCallback executor, void* userData)
+{
+	HandleException([&]() {
+		if (!executor)
+		{
+			Scheduler::SetExecutor(nullptr);
+			return;
+		}
+
+		Scheduler::SetExecutor([executor, userData](std::function<void()> task)
+		{
+			executor(&RunTask, new std::function<void()>(std::move(task)), userData);
+		});
+	});
+}
@@ -0,0 +1,673 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "archive_reader.hxx"
+
+#include <opengps/cxx/point_vector.hxx>
+#include <opengps/cxx/data_point.hxx>
+
+#include "xml_reader.hxx"
+
+#include "point_vector_parser_builder.hxx"
+#include "point_vector_parser.hxx"
+
+#include "binary_lsb_point_vector_reader_context.hxx"
+#include "binary_msb_point_vector_reader_context.hxx"
+
+#include "vector_buffer_builder.hxx"
+#include "vector_buffer.hxx"
+#include "valid_buffer.hxx"
+#include "point_validity_provider.hxx"
+
+#include "point_vector_proxy_context_list.hxx"
+#include "point_vector_proxy_context_matrix.hxx"
+#include "incremental_index.hxx"
+
+#include "environment.hxx"
+
+#include "zip_directory.hxx"
+#include "zip_input_stream_buffer.hxx"
+
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+using namespace OpenGPS;
+
+ArchiveReader::ArchiveReader(std::shared_ptr<const ByteSource> source)
+	: m_Source{ std::move(source) }
+{
+}
+
+ArchiveReader::~ArchiveReader() = default;
+
+void ArchiveReader::Open()
+{
+	if (m_VectorBuffer)
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The X3P archive has already been opened."),
+			_EX_T("An instance reads an X3P archive only once. Create another instance to read it again."),
+			_EX_T("OpenGPS::ArchiveReader::Open"));
+	}
+
+	m_Directory = std::make_shared<ZipDirectory>(m_Source);
+
+	const auto mainChecksum{ ReadDocument() };
+	const auto pointsChecksum{ ReadPoints() };
+
+	if (!mainChecksum)
+	{
+		throw Exception(
+			OGPS_ExWarning,
+			_EX_T("The checksum of the main.xml document contained in an X3P archive could not be verified."),
+			_EX_T("Although some data had been extracted there is no guarantee of their integrity."),
+			_EX_T("OpenGPS::ArchiveReader::Open"));
+	}
+
+	if (!pointsChecksum)
+	{
+		throw Exception(
+			OGPS_ExWarning,
+			_EX_T("The checksum of binary point data contained in an X3P archive could not be verified."),
+			_EX_T("Although some data had been extracted there is no guarantee of their integrity."),
+			_EX_T("OpenGPS::ArchiveReader::Open"));
+	}
+}
+
+const ISO5436_2Reader::Metadata& ArchiveReader::GetMetadata() const
+{
+	CheckIsOpen();
+
+	return m_Metadata;
+}
+
+void ArchiveReader::GetMatrixPoint(size_t u, size_t v, size_t w, PointVector& vector) const
+{
+	const auto index{ GetMatrixIndex(u, v, w) };
+
+	if (m_VectorBuffer->IsValid(index))
+	{
+		m_VectorBuffer->GetPoint(index, vector);
+	}
+	else
+	{
+		vector.GetX()->Reset();
+		vector.GetY()->Reset();
+		vector.GetZ()->Reset();
+	}
+
+	if (m_Metadata.x.isIncremental)
+	{
+		SetIncrementalIndex(*vector.GetX(), u);
+	}
+
+	if (m_Metadata.y.isIncremental)
+	{
+		SetIncrementalIndex(*vector.GetY(), v);
+	}
+}
+
+void ArchiveReader::GetListPoint(size_t index, PointVector& vector) const
+{
+	m_VectorBuffer->GetPoint(GetListIndex(index), vector);
+
+	if (m_Metadata.x.isIncremental)
+	{
+		SetIncrementalIndex(*vector.GetX(), index);
+	}
+
+	if (m_Metadata.y.isIncremental)
+	{
+		SetIncrementalIndex(*vector.GetY(), index);
+	}
+}
+
+void ArchiveReader::GetMatrixCoord(size_t u, size_t v, size_t w, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const
+{
+	PointVector vector;
+	GetMatrixPoint(u, v, w, vector);
+	ConvertPointToCoord(vector, x, y, z);
+}
+
+void ArchiveReader::GetListCoord(size_t index, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const
+{
+	PointVector vector;
+	GetListPoint(index, vector);
+	ConvertPointToCoord(vector, x, y, z);
+}
+
+bool ArchiveReader::IsMatrixCoordValid(size_t u, size_t v, size_t w) const
+{
+	return m_VectorBuffer->IsValid(GetMatrixIndex(u, v, w));
+}
+
+bool ArchiveReader::ReadDocument()
+{
+	std::array<unsigned char, 16> md5{};
+	auto isFinished{ false };
+
+	{
+		auto buffer{ OpenArchiveEntry(_OPENGPS_XSD_ISO5436_MAIN_PATH) };
+		std::istream stream(buffer.get());
+
+		ReadMetadata(XmlReader::Read(stream));
+
+		isFinished = buffer->Finish();
+		if (isFinished)
+		{
+			buffer->GetMd5(md5);
+		}
+	}
+
+	// The checksum file holds the MD5 of main.xml as its first token
+	auto buffer{ OpenArchiveEntry(m_Metadata.checksumFile) };
+	std::istream stream(buffer.get());
+
+	std::string text;
+	stream >> text;
+
+	String checksum;
+	checksum.FromChar(text.c_str());
+
+	std::array<unsigned char, 16> expected{};
+	return isFinished && checksum.ConvertToMd5(expected) && md5 == expected;
+}
+
+void ArchiveReader::ReadMetadata(const XmlElement& root)
+{
+	if (root.name != "ISO5436_2")
+	{
+		ThrowInvalidDocument(_EX_T("The root element of main.xml must be ISO5436_2."));
+	}
+
+	ISO5436_2Reader::Metadata metadata;
+
+	const auto& record1{ GetChild(root, "Record1") };
+	metadata.revision = GetChild(record1, "Revision").GetString();
+	metadata.featureType = GetChild(record1, "FeatureType").GetString();
+
+	if (metadata.featureType != OGPS_FEATURE_TYPE_SURFACE_NAME &&
+		metadata.featureType != OGPS_FEATURE_TYPE_PROFILE_NAME &&
+		metadata.featureType != OGPS_FEATURE_TYPE_POINTCLOUD_NAME)
+	{
+		ThrowInvalidDocument(_EX_T("The feature type must be one of SUR, PRF or PCL."));
+	}
+
+	const auto& axes{ GetChild(record1, "Axes") };
+	metadata.x = ReadAxis(GetChild(axes, "CX"), true);
+	metadata.y = ReadAxis(GetChild(axes, "CY"), true);
+	metadata.z = ReadAxis(GetChild(axes, "CZ"), false);
+
+	// Record2 is optional and not read
+	const auto& record3{ GetChild(root, "Record3") };
+
+	if (const auto matrix{ record3.FindChild("MatrixDimension") })
+	{
+		metadata.isMatrix = true;
+		metadata.sizeX = ReadSize(GetChild(*matrix, "SizeX"));
+		metadata.sizeY = ReadSize(GetChild(*matrix, "SizeY"));
+		metadata.sizeZ = ReadSize(GetChild(*matrix, "SizeZ"));
+	}
+	else
+	{
+		metadata.sizeX = ReadSize(GetChild(record3, "ListDimension"));
+		metadata.sizeY = 1;
+		metadata.sizeZ = 1;
+	}
+
+	if (metadata.sizeY > 0 && metadata.sizeZ > 0 &&
+		metadata.sizeX > std::numeric_limits<size_t>::max() / metadata.sizeY / metadata.sizeZ)
+	{
+		throw Exception(OGPS_ExOverflow,
+			_EX_T("An integer overflow occured due to a multiplication operation."),
+			_EX_T("The dimensions given in main.xml exceed the amount of point vectors that can be indexed."),
+			_EX_T("OpenGPS::ArchiveReader::ReadMetadata"));
+	}
+
+	const auto dataLink{ record3.FindChild("DataLink") };
+	if (!dataLink)
+	{
+		if (record3.FindChild("DataList"))
+		{
+			throw Exception(
+				OGPS_ExNotImplemented,
+				_EX_T("Point data stored within main.xml is not supported by the reader."),
+				_EX_T("The reader decodes binary point data only. Use OpenGPS::ISO5436_2 to read point data stored in a DataList element."),
+				_EX_T("OpenGPS::ArchiveReader::ReadMetadata"));
+		}
+
+		ThrowInvalidDocument(_EX_T("Record3 must contain either a DataLink or a DataList element."));
+	}
+
+	metadata.pointDataLink = GetChild(*dataLink, "PointDataLink").GetString();
+	metadata.pointDataMd5 = ReadMd5(GetChild(*dataLink, "MD5ChecksumPointData"));
+
+	if (const auto validPointsLink{ dataLink->FindChild("ValidPointsLink") })
+	{
+		metadata.validPointsLink = validPointsLink->GetString();
+		metadata.validPointsMd5 = ReadMd5(GetChild(*dataLink, "MD5ChecksumValidPoints"));
+	}
+
+	const auto& record4{ GetChild(root, "Record4") };
+	metadata.checksumFile = GetChild(record4, "ChecksumFile").GetString();
+
+	m_Metadata = std::move(metadata);
+}
+
+bool ArchiveReader::ReadPoints()
+{
+	const auto count{ m_Metadata.sizeX * m_Metadata.sizeY * m_Metadata.sizeZ };
+	const auto allowInvalidPoints{ m_Metadata.featureType != OGPS_FEATURE_TYPE_POINTCLOUD_NAME };
+
+	VectorBufferBuilder builder;
+	if (!(builder.BuildBuffer() &&
+		builder.BuildX(m_Metadata.x.dataType, count) &&
+		builder.BuildY(m_Metadata.y.dataType, count) &&
+		builder.BuildZ(m_Metadata.z.dataType, count) &&
+		builder.BuildValidityProvider(allowInvalidPoints)))
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The point buffer could not be created."),
+			_EX_T("Verify the axes definitions given in main.xml."),
+			_EX_T("OpenGPS::ArchiveReader::ReadPoints"));
+	}
+
+	auto vectorBuffer{ builder.GetBuffer() };
+	auto validChecksum{ true };
+
+	if (m_Metadata.validPointsLink.length() > 0)
+	{
+		auto validBuffer{ OpenArchiveEntry(m_Metadata.validPointsLink) };
+
+		if (vectorBuffer->HasValidityBuffer())
+		{
+			std::istream stream(validBuffer.get());
+			vectorBuffer->GetValidityBuffer()->Read(stream);
+		}
+
+		validChecksum = VerifyChecksum(*validBuffer, m_Metadata.validPointsMd5);
+	}
+
+	auto dataBuffer{ OpenArchiveEntry(m_Metadata.pointDataLink) };
+	auto context{ CreateBinaryPointVectorReaderContext(std::make_unique<std::istream>(dataBuffer.get())) };
+
+	PointVectorParserBuilder parserBuilder;
+	parserBuilder.BuildParser();
+	parserBuilder.BuildX(m_Metadata.x.dataType);
+	parserBuilder.BuildY(m_Metadata.y.dataType);
+	parserBuilder.BuildZ(m_Metadata.z.dataType);
+
+	auto parser{ parserBuilder.GetParser() };
+
+	// Matrices are stored in a different order than read from the archive, see ISO5436_2Container::ReadPointBuffer
+	std::shared_ptr<PointVectorProxyContext> proxyContext;
+	if (m_Metadata.isMatrix)
+	{
+		proxyContext = std::make_shared<PointVectorProxyContextMatrix>(m_Metadata.sizeX, m_Metadata.sizeY, m_Metadata.sizeZ);
+	}
+	else
+	{
+		proxyContext = std::make_shared<PointVectorProxyContextList>(count);
+	}
+
+	auto vector{ vectorBuffer->CreatePointVectorProxy(proxyContext) };
+
+	for (size_t index = 0; index < count && context->MoveNext(); ++index)
+	{
+		if (context->IsValid())
+		{
+			parser->Read(*context, *vector);
+		}
+		else
+		{
+			vectorBuffer->GetValidityProvider()->SetValid(proxyContext->GetIndex(), false);
+		}
+
+		proxyContext->IncrementIndex();
+	}
+
+	const auto dataChecksum{ VerifyChecksum(*dataBuffer, m_Metadata.pointDataMd5) };
+
+	// The context reads from the buffer and must be gone first
+	context.reset();
+
+	m_VectorBuffer = std::move(vectorBuffer);
+
+	return validChecksum && dataChecksum;
+}
+
+std::unique_ptr<ZipInputStreamBuffer> ArchiveReader::OpenArchiveEntry(const String& name) const
+{
+	auto buffer{ std::make_unique<ZipInputStreamBuffer>(m_Directory) };
+
+	if (!buffer->Open(name))
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The X3P container document does not contain the supposed resource."),
+			_EX_T("For a X3P archive to be valid all additional resources given in main.xml must be contained herein."),
+			_EX_T("OpenGPS::ArchiveReader::OpenArchiveEntry"));
+	}
+
+	return buffer;
+}
+
+std::unique_ptr<PointVectorReaderContext> ArchiveReader::CreateBinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream)
+{
+	if (Environment::IsLittleEndian())
+	{
+		return std::make_unique<BinaryLSBPointVectorReaderContext>(std::move(stream));
+	}
+
+	return std::make_unique<BinaryMSBPointVectorReaderContext>(std::move(stream));
+}
+
+bool ArchiveReader::VerifyChecksum(ZipInputStreamBuffer& buffer, const std::array<unsigned char, 16>& checksum)
+{
+	if (!buffer.Finish())
+	{
+		return false;
+	}
+
+	std::array<unsigned char, 16> md5{};
+	buffer.GetMd5(md5);
+
+	return md5 == checksum;
+}
+
+void ArchiveReader::CheckIsOpen() const
+{
+	if (!m_VectorBuffer)
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The X3P archive has not been opened."),
+			_EX_T("Call ISO5436_2Reader::Open before accessing its content."),
+			_EX_T("OpenGPS::ArchiveReader::CheckIsOpen"));
+	}
+}
+
+size_t ArchiveReader::GetMatrixIndex(size_t u, size_t v, size_t w) const
+{
+	CheckIsOpen();
+
+	if (!m_Metadata.isMatrix)
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("Attempt to read a data point in matrix format when a point list is supported only."),
+			_EX_T("The X3P archive does not support the matrix topology."),
+			_EX_T("OpenGPS::ArchiveReader::GetMatrixIndex"));
+	}
+
+	if (u >= m_Metadata.sizeX || v >= m_Metadata.sizeY || w >= m_Metadata.sizeZ)
+	{
+		throw Exception(
+			OGPS_ExInvalidArgument,
+			_EX_T("The index of the point vector is out of range."),
+			_EX_T("The indexes must be less than the matrix dimensions given in main.xml."),
+			_EX_T("OpenGPS::ArchiveReader::GetMatrixIndex"));
+	}
+
+	// Storage order of PointVectorProxyContextMatrix, which the point data has been decoded with
+	return v * m_Metadata.sizeX * m_Metadata.sizeZ + u * m_Metadata.sizeZ + w;
+}
+
+size_t ArchiveReader::GetListIndex(size_t index) const
+{
+	CheckIsOpen();
+
+	if (m_Metadata.isMatrix)
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("Attempt to read a data point of a point list when matrix topology is supported only."),
+			_EX_T("Data points of the X3P archive must be accessed in matrix format only."),
+			_EX_T("OpenGPS::ArchiveReader::GetListIndex"));
+	}
+
+	if (index >= m_Metadata.sizeX)
+	{
+		throw Exception(
+			OGPS_ExInvalidArgument,
+			_EX_T("The index of the point vector is out of range."),
+			_EX_T("The index must be less than the list dimension given in main.xml."),
+			_EX_T("OpenGPS::ArchiveReader::GetListIndex"));
+	}
+
+	return index;
+}
+
+void ArchiveReader::ConvertPointToCoord(const PointVector& vector, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const
+{
+	OGPS_Double* myx = vector.GetX()->IsValid() ? x : nullptr;
+	OGPS_Double* myy = vector.GetY()->IsValid() ? y : nullptr;
+	OGPS_Double* myz = vector.GetZ()->IsValid() ? z : nullptr;
+
+	vector.GetXYZ(myx, myy, myz);
+
+	if (myx)
+	{
+		*myx *= m_Metadata.x.increment;
+		*myx += m_Metadata.x.offset;
+	}
+	else if (x)
+	{
+		*x = std::numeric_limits<OGPS_Double>::quiet_NaN();
+	}
+
+	if (myy)
+	{
+		*myy *= m_Metadata.y.increment;
+		*myy += m_Metadata.y.offset;
+	}
+	else if (y)
+	{
+		*y = std::numeric_limits<OGPS_Double>::quiet_NaN();
+	}
+
+	if (myz)
+	{
+		*myz += m_Metadata.z.offset;
+	}
+	else if (z)
+	{
+		*z = std::numeric_limits<OGPS_Double>::quiet_NaN();
+	}
+}
+
+const XmlElement& ArchiveReader::GetChild(const XmlElement& parent, const char* name)
+{
+	const auto child{ parent.FindChild(name) };
+
+	if (!child)
+	{
+		std::ostringstream details;
+		details << "The element " << parent.name << " of main.xml lacks its mandatory child element " << name << ".";
+
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The main.xml document contained in an X3P archive is invalid."),
+			details.str().c_str(),
+			_EX_T("OpenGPS::ArchiveReader::GetChild"));
+	}
+
+	return *child;
+}
+
+ISO5436_2Reader::Axis ArchiveReader::ReadAxis(const XmlElement& element, bool isIncrementalAllowed)
+{
+	ISO5436_2Reader::Axis axis;
+
+	const auto axisType{ GetChild(element, "AxisType").GetTrimmedText() };
+	if (axisType == "I" && isIncrementalAllowed)
+	{
+		axis.isIncremental = true;
+	}
+	else if (axisType != "A")
+	{
+		ThrowInvalidDocument(_EX_T("The axis type must be either I or A and the z axis must be absolute."));
+	}
+
+	// Incremental axes do not have a data type, see ISO5436_2Container::GetAxisDataType
+	const auto dataType{ element.FindChild("DataType") };
+	if (dataType && !axis.isIncremental)
+	{
+		const auto type{ dataType->GetTrimmedText() };
+		if (type == "I")
+		{
+			axis.dataType = OGPS_Int16PointType;
+		}
+		else if (type == "L")
+		{
+			axis.dataType = OGPS_Int32PointType;
+		}
+		else if (type == "F")
+		{
+			axis.dataType = OGPS_FloatPointType;
+		}
+		else if (type == "D")
+		{
+			axis.dataType = OGPS_DoublePointType;
+		}
+		else
+		{
+			ThrowInvalidDocument(_EX_T("The data type of an axis must be one of I, L, F or D."));
+		}
+	}
+	else if (!axis.isIncremental)
+	{
+		ThrowInvalidDocument(_EX_T("Absolute axes must specify their data type."));
+	}
+
+	if (const auto increment{ element.FindChild("Increment") })
+	{
+		axis.increment = ReadDouble(*increment);
+	}
+
+	if (const auto offset{ element.FindChild("Offset") })
+	{
+		axis.offset = ReadDouble(*offset);
+	}
+
+	if (axis.isIncremental && axis.increment == 0.0)
+	{
+		ThrowInvalidDocument(_EX_T("The increment of an incremental axis must not be zero."));
+	}
+
+	return axis;
+}
+
+OGPS_Double ArchiveReader::ReadDouble(const XmlElement& element)
+{
+	const auto text{ element.GetTrimmedText() };
+
+	// Special values of xsd:double, which the stream does not parse
+	if (text == "INF")
+	{
+		return std::numeric_limits<OGPS_Double>::infinity();
+	}
+
+	if (text == "-INF")
+	{
+		return -std::numeric_limits<OGPS_Double>::infinity();
+	}
+
+	if (text == "NaN")
+	{
+		return std::numeric_limits<OGPS_Double>::quiet_NaN();
+	}
+
+	std::istringstream stream(text);
+	stream.imbue(std::locale::classic());
+
+	OGPS_Double value{};
+	stream >> value;
+
+	if (text.empty() || stream.fail() || !stream.eof())
+	{
+		ThrowInvalidDocument(_EX_T("An element of type double has invalid content."));
+	}
+
+	return value;
+}
+
+size_t ArchiveReader::ReadSize(const XmlElement& element)
+{
+	const auto text{ element.GetTrimmedText() };
+
+	if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+	{
+		ThrowInvalidDocument(_EX_T("An element of type unsigned long has invalid content."));
+	}
+
+	std::istringstream stream(text);
+	stream.imbue(std::locale::classic());
+
+	unsigned long long value{};
+	stream >> value;
+
+	if (stream.fail() || value > std::numeric_limits<size_t>::max())
+	{
+		ThrowInvalidDocument(_EX_T("An element of type unsigned long exceeds the range supported."));
+	}
+
+	return static_cast<size_t>(value);
+}
+
+std::array<unsigned char, 16> ArchiveReader::ReadMd5(const XmlElement& element)
+{
+	std::array<unsigned char, 16> md5{};
+
+	if (!element.GetString().ConvertToMd5(md5))
+	{
+		ThrowInvalidDocument(_EX_T("An MD5 checksum must consist of 32 hexadecimal digits."));
+	}
+
+	return md5;
+}
+
+void ArchiveReader::ThrowInvalidDocument(const OGPS_ExceptionChar* details)
+{
+	throw Exception(
+		OGPS_ExGeneral,
+		_EX_T("The main.xml document contained in an X3P archive is invalid."),
+		details,
+		_EX_T("OpenGPS::ArchiveReader::ReadMetadata"));
+}
@@ -0,0 +1,199 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Concrete implementation of the interface of OpenGPS::ISO5436_2Reader.
+ */
+
+#ifndef _OPENGPS_ARCHIVE_READER_HXX
+#define _OPENGPS_ARCHIVE_READER_HXX
+
+#include <array>
+#include <istream>
+#include <memory>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/byte_source.hxx>
+#include <opengps/cxx/iso5436_2_reader.hxx>
+#include <opengps/cxx/string.hxx>
+
+namespace OpenGPS
+{
+	class PointVectorReaderContext;
+	class VectorBuffer;
+	class ZipDirectory;
+	class ZipInputStreamBuffer;
+	struct XmlElement;
+
+	/*!
+	 * Reads X3P archives without the XML schema runtime, see OpenGPS::ISO5436_2Reader.
+	 *
+	 * main.xml is read into a tree of elements by OpenGPS::XmlReader, from which
+	 * the metadata is taken. Binary point data is decoded into a vector buffer the same
+	 * way OpenGPS::ISO5436_2Container does. Reading points does not change any state.
+	 */
+	class ArchiveReader
+	{
+	public:
+		/*! Creates a new instance, see ISO5436_2Reader::ISO5436_2Reader. */
+		ArchiveReader(std::shared_ptr<const ByteSource> source);
+
+		/*! Destroys this instance. */
+		~ArchiveReader();
+
+		/*! Implements ISO5436_2Reader::Open. */
+		void Open();
+
+		/*! Implements ISO5436_2Reader::GetMetadata. */
+		const ISO5436_2Reader::Metadata& GetMetadata() const;
+
+		/*! Implements ISO5436_2Reader::GetMatrixPoint. */
+		void GetMatrixPoint(size_t u, size_t v, size_t w, PointVector& vector) const;
+
+		/*! Implements ISO5436_2Reader::GetListPoint. */
+		void GetListPoint(size_t index, PointVector& vector) const;
+
+		/*! Implements ISO5436_2Reader::GetMatrixCoord. */
+		void GetMatrixCoord(size_t u, size_t v, size_t w, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const;
+
+		/*! Implements ISO5436_2Reader::GetListCoord. */
+		void GetListCoord(size_t index, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const;
+
+		/*! Implements ISO5436_2Reader::IsMatrixCoordValid. */
+		bool IsMatrixCoordValid(size_t u, size_t v, size_t w) const;
+
+	private:
+		/*!
+		 * Reads main.xml and verifies its checksum.
+		 * @returns Returns true if the checksum of main.xml matches, false otherwise.
+		 */
+		bool ReadDocument();
+
+		/*!
+		 * Takes the metadata from the root element of main.xml.
+		 * @param root The root element.
+		 */
+		void ReadMetadata(const XmlElement& root);
+
+		/*!
+		 * Decodes the binary point data and the binary point validity data.
+		 * @returns Returns true if the checksums of both match, false otherwise.
+		 */
+		bool ReadPoints();
+
+		/*!
+		 * Opens an entry of the X3P archive for reading.
+		 * Throws an exception if the entry does not exist.
+		 * @param name The name of the archive entry.
+		 */
+		std::unique_ptr<ZipInputStreamBuffer> OpenArchiveEntry(const String& name) const;
+
+		/*!
+		 * Creates the context decoding binary point data in the byte order of the current machine.
+		 * @param stream The binary point data.
+		 */
+		static std::unique_ptr<PointVectorReaderContext> CreateBinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream);
+
+		/*!
+		 * Reads the rest of an archive entry and compares its checksum.
+		 * @param buffer The archive entry.
+		 * @param checksum The expected MD5 checksum.
+		 * @returns Returns true if the checksums match, false otherwise.
+		 */
+		static bool VerifyChecksum(ZipInputStreamBuffer& buffer, const std::array<unsigned char, 16>& checksum);
+
+		/*! Throws an exception unless the point data has been read. */
+		void CheckIsOpen() const;
+
+		/*! Gets the index of a point vector of a matrix, throws an exception if it is out of range. */
+		size_t GetMatrixIndex(size_t u, size_t v, size_t w) const;
+
+		/*! Gets the index of a point vector of a list, throws an exception if it is out of range. */
+		size_t GetListIndex(size_t index) const;
+
+		/*!
+		 * Applies the axes transformation to a point vector, see ISO5436_2Container::ConvertPointToCoord.
+		 * @param vector The point vector.
+		 * @param x Gets the x component or NaN if it is invalid. May be nullptr.
+		 * @param y Gets the y component or NaN if it is invalid. May be nullptr.
+		 * @param z Gets the z component or NaN if it is invalid. May be nullptr.
+		 */
+		void ConvertPointToCoord(const PointVector& vector, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const;
+
+		/*!
+		 * Gets a mandatory child element.
+		 * Throws an exception if the element is missing.
+		 * @param parent The parent element.
+		 * @param name The name of the child element.
+		 */
+		static const XmlElement& GetChild(const XmlElement& parent, const char* name);
+
+		/*!
+		 * Reads the description of an axis.
+		 * @param element The element of type AxisDescriptionType.
+		 * @param isIncrementalAllowed false for the z axis, which must be absolute.
+		 */
+		static ISO5436_2Reader::Axis ReadAxis(const XmlElement& element, bool isIncrementalAllowed);
+
+		/*! Reads an element of type xsd:double. Throws an exception if its content is invalid. */
+		static OGPS_Double ReadDouble(const XmlElement& element);
+
+		/*! Reads an element of type xsd:unsignedLong. Throws an exception if its content is invalid or exceeds size_t. */
+		static size_t ReadSize(const XmlElement& element);
+
+		/*! Reads an element of type xsd:hexBinary holding an MD5 checksum. Throws an exception if its content is invalid. */
+		static std::array<unsigned char, 16> ReadMd5(const XmlElement& element);
+
+		/*!
+		 * Throws an exception describing invalid content of main.xml.
+		 * @param details The reason.
+		 */
+		static void ThrowInvalidDocument(const OGPS_ExceptionChar* details);
+
+		/*! The byte source of the X3P archive. */
+		std::shared_ptr<const ByteSource> m_Source;
+
+		/*! The directory of the X3P archive. */
+		std::shared_ptr<ZipDirectory> m_Directory;
+
+		/*! The content of main.xml. */
+		ISO5436_2Reader::Metadata m_Metadata;
+
+		/*! The decoded point data or nullptr if it has not been read. */
+		std::shared_ptr<VectorBuffer> m_VectorBuffer;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ArchiveReader(const ArchiveReader& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ArchiveReader& operator=(const ArchiveReader& src) = delete;
+	};
+}
+
+#endif
@@ -0,0 +1,214 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "batch_opener.hxx"
+#include "thread_pool.hxx"
+#include "task_scheduler.hxx"
+#include "environment.hxx"
+#include "stdafx.hxx"
+
+BatchOpener::BatchOpener(
+	std::vector<String> filePaths,
+	const OGPS_OpenOptions& options,
+	size_t threadCount,
+	size_t maxInFlight,
+	const String& temp)
+	:m_FilePaths{ std::move(filePaths) },
+	m_Options(options),
+	m_TempPath{ temp }
+{
+	// The environment must not be created concurrently.
+	Environment::GetInstance();
+
+	// Without threads of its own all files are opened by the scheduler
+	const auto allowsThreads{ TaskScheduler::GetInstance().AllowsDedicatedThreads() };
+
+	if (threadCount > 0 && allowsThreads)
+	{
+		m_Pool = std::make_unique<ThreadPool>(threadCount);
+	}
+
+	const auto workers{ m_Pool ? m_Pool->GetThreadCount() : TaskScheduler::GetInstance().GetThreadCount() };
+	m_MaxInFlight = maxInFlight > 0 ? maxInFlight : 2 * workers;
+
+	Dispatch();
+
+	if (allowsThreads && m_MaxInFlight < m_FilePaths.size())
+	{
+		m_ReadAhead = std::thread(&BatchOpener::ReadAhead, this);
+	}
+}
+
+BatchOpener::~BatchOpener()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsCancelled = true;
+	}
+
+	m_Condition.notify_all();
+
+	if (m_ReadAhead.joinable())
+	{
+		m_ReadAhead.join();
+	}
+
+	// Waits for files being opened.
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_Running == 0; });
+	}
+
+	m_Pool.reset();
+}
+
+bool BatchOpener::Next(ISO5436_2BatchResult& result)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	if (m_Taken == m_FilePaths.size())
+	{
+		return false;
+	}
+
+	m_Condition.wait(lock, [this]() { return !m_Completed.empty(); });
+
+	result = std::move(m_Completed.front());
+	m_Completed.pop_front();
+	++m_Taken;
+
+	lock.unlock();
+	m_Condition.notify_all();
+
+	// Taking a file makes room for the next one
+	Dispatch();
+
+	return true;
+}
+
+size_t BatchOpener::GetCount() const
+{
+	return m_FilePaths.size();
+}
+
+void BatchOpener::ReadAhead()
+{
+	// Files within the window are handed over already, so reading ahead starts behind it
+	for (size_t index = m_MaxInFlight; index < m_FilePaths.size(); ++index)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this, index]() { return m_IsCancelled || index < m_Taken + 2 * m_MaxInFlight; });
+
+			if (m_IsCancelled)
+			{
+				return;
+			}
+		}
+
+		// Opening the file reports any failure
+		Environment::GetInstance()->PrefetchFile(m_FilePaths[index]);
+	}
+}
+
+void BatchOpener::Dispatch()
+{
+	std::vector<size_t> indexes;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (; m_Dispatched < m_FilePaths.size() && m_Dispatched < m_Taken + m_MaxInFlight; ++m_Dispatched)
+		{
+			indexes.push_back(m_Dispatched);
+			++m_Running;
+		}
+	}
+
+	// An executor may run the task right away, so no lock is held here
+	for (const auto index : indexes)
+	{
+		Post(index);
+	}
+}
+
+void BatchOpener::Post(size_t index)
+{
+	auto task{ [this, index]()
+	{
+		Open(index);
+
+		// Notify while locked, the instance may be destroyed as soon as the lock is released
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		--m_Running;
+		m_Condition.notify_all();
+	} };
+
+	if (m_Pool)
+	{
+		m_Pool->Post(task);
+	}
+	else
+	{
+		TaskScheduler::GetInstance().Post(task);
+	}
+}
+
+void BatchOpener::Open(size_t index)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_IsCancelled)
+		{
+			return;
+		}
+	}
+
+	ISO5436_2BatchResult result;
+	result.index = index;
+
+	try
+	{
+		auto document{ std::make_unique<ISO5436_2>(m_FilePaths[index], m_TempPath) };
+		document->Open(m_Options);
+		result.document = std::move(document);
+	}
+	catch (...)
+	{
+		result.error = std::current_exception();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Completed.push_back(std::move(result));
+	}
+
+	m_Condition.notify_all();
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Concrete implementation of the interface of OpenGPS::ISO5436_2Batch.
+ */
+
+#ifndef _OPENGPS_BATCH_OPENER_HXX
+#define _OPENGPS_BATCH_OPENER_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/cxx/iso5436_2_batch.hxx>
+#include <opengps/open_options.h>
+
+namespace OpenGPS
+{
+	class ThreadPool;
+
+	/*!
+	 * Opens a list of X3P files on a pool of worker threads, see OpenGPS::ISO5436_2Batch.
+	 *
+	 * Files are handed over to the worker threads in the order given as soon as fewer
+	 * than the maximum number of files are in flight. A separate thread asks the system
+	 * to read the files behind these ahead, see Environment::PrefetchFile. It waits while
+	 * the files it would read ahead are twice the maximum number in flight away.
+	 * Without an explicit number of threads, files are opened by the OpenGPS::TaskScheduler
+	 * of the library instead of threads of their own. If the scheduler forbids threads of
+	 * their own, no files are read ahead.
+	 */
+	class BatchOpener
+	{
+	public:
+		/*! Creates a new instance, see ISO5436_2Batch::ISO5436_2Batch. */
+		BatchOpener(
+			std::vector<String> filePaths,
+			const OGPS_OpenOptions& options,
+			size_t threadCount,
+			size_t maxInFlight,
+			const String& temp);
+
+		/*! Destroys this instance. Waits for the files being opened. */
+		~BatchOpener();
+
+		/*! Implements ISO5436_2Batch::Next. */
+		bool Next(ISO5436_2BatchResult& result);
+
+		/*! Implements ISO5436_2Batch::GetCount. */
+		size_t GetCount() const;
+
+	private:
+		/*! Asks the system to read the files ahead that follow the files in flight. */
+		void ReadAhead();
+
+		/*! Hands over files to the worker threads until the maximum number of files is in flight. */
+		void Dispatch();
+
+		/*!
+		 * Queues a file to be opened by the worker threads.
+		 * @param index The position of the file within the list of files.
+		 */
+		void Post(size_t index);
+
+		/*!
+		 * Opens a single file. Executed by the worker threads.
+		 * @param index The position of the file within the list of files.
+		 */
+		void Open(size_t index);
+
+		/*! Full paths to the files to be opened. */
+		const std::vector<String> m_FilePaths;
+
+		/*! Controls how the files are opened. */
+		const OGPS_OpenOptions m_Options;
+
+		/*! The path to the directory for temporary files. */
+		const String m_TempPath;
+
+		/*! The maximum number of files in flight. */
+		size_t m_MaxInFlight{};
+
+		/*! Serializes access to the state of the batch. */
+		std::mutex m_Mutex;
+
+		/*! Signals that a file has been opened or taken, or that the batch is cancelled. */
+		std::condition_variable m_Condition;
+
+		/*! Files opened but not yet taken in the order they have been opened. */
+		std::deque<ISO5436_2BatchResult> m_Completed;
+
+		/*! The number of files taken by BatchOpener::Next. */
+		size_t m_Taken{};
+
+		/*! true if files not yet opened are to be skipped. */
+		bool m_IsCancelled{};
+
+		/*! The number of files handed over to the worker threads but not yet opened. */
+		size_t m_Running{};
+
+		/*! The number of files handed over to the worker threads. */
+		size_t m_Dispatched{};
+
+		/*! The worker threads opening files or nullptr to use the OpenGPS::TaskScheduler. */
+		std::unique_ptr<ThreadPool> m_Pool;
+
+		/*! The thread reading files ahead, which is not started if the OpenGPS::TaskScheduler forbids threads of their own or all files fit into the window. */
+		std::thread m_ReadAhead;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		BatchOpener(const BatchOpener& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		BatchOpener& operator=(const BatchOpener& src) = delete;
+	};
+}
+
+#endif
@@ -40,6 +40,11 @@ BinaryPointVectorReaderContext::BinaryPointVectorReaderContext(const String& fil
 {
 }
 
+BinaryPointVectorReaderContext::BinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream)
+	:m_Stream{ std::move(stream) }
+{
+}
+
 BinaryPointVectorReaderContext::~BinaryPointVectorReaderContext()
 {
 	Close();
@@ -47,11 +52,8 @@ BinaryPointVectorReaderContext::~BinaryPointVectorReaderContext()
 
 void BinaryPointVectorReaderContext::Close()
 {
-	if (m_Stream)
-	{
-		m_Stream->close();
-		m_Stream.reset();
-	}
+	// File streams are closed on destruction
+	m_Stream.reset();
 }
 
 void BinaryPointVectorReaderContext::CheckStreamAndThrowException()
@@ -115,7 +117,7 @@ bool BinaryPointVectorReaderContext::HasStream() const
 	return m_Stream != nullptr;
 }
 
-InputBinaryFileStream* BinaryPointVectorReaderContext::GetStream() const
+std::istream* BinaryPointVectorReaderContext::GetStream() const
 {
 	return m_Stream.get();
 }
@@ -37,11 +37,11 @@
 #define _OPENGPS_BINARY_POINT_VECTOR_READER_CONTEXT_HXX
 
 #include "point_vector_reader_context.hxx"
+#include <istream>
 #include <memory>
 
 namespace OpenGPS
 {
-	class InputBinaryFileStream;
 	class String;
 
 	/*!
@@ -60,6 +60,13 @@ namespace OpenGPS
 		 */
 		BinaryPointVectorReaderContext(const String& filePath);
 
+		/*!
+		 * Creates a new instance.
+		 * @param stream The binary stream of point vectors, e.g. an entry of the X3P archive
+		 * that is decompressed while being read.
+		 */
+		BinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream);
+
 		/*! Destroys this instance. */
 		~BinaryPointVectorReaderContext() override;
 
@@ -80,10 +87,10 @@ namespace OpenGPS
 		/*!
 		 * Returns the underlying data stream for read access.
 		 */
-		InputBinaryFileStream* GetStream() const;
+		std::istream* GetStream() const;
 
 		/*!
-		 * Closes the internal handle to the binary file and releases its resources.
+		 * Closes the internal handle to the binary stream and releases its resources.
 		 */
 		void Close();
 
@@ -95,7 +102,7 @@ namespace OpenGPS
 
 	private:
 		/*! Pointer to the underlying data stream of binary point vectors. */
-		std::unique_ptr<InputBinaryFileStream> m_Stream;
+		std::unique_ptr<std::istream> m_Stream;
 	};
 }
 
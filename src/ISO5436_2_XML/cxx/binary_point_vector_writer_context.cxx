@@ -29,13 +29,23 @@
  ***************************************************************************/
 
 #include "binary_point_vector_writer_context.hxx"
+#include "task_scheduler.hxx"
 #include <opengps/cxx/exceptions.hxx>
 #include "stdafx.hxx"
 
-BinaryPointVectorWriterContext::BinaryPointVectorWriterContext(zipFile handle)
-	:m_Buffer{ std::make_unique<ZipStreamBuffer>(handle, true) },
-	m_Stream{ std::make_unique<ZipOutputStream>(*m_Buffer) }
+BinaryPointVectorWriterContext::BinaryPointVectorWriterContext(zipFile handle, const String& name, int compressionLevel, unsigned long long length, size_t pipelineBuffers)
+	:m_Buffer{ std::make_unique<ZipStreamBuffer>(handle, true, TaskScheduler::GetInstance().AllowsDedicatedThreads() ? pipelineBuffers : 0) }
 {
+	if (!m_Buffer->Open(name, compressionLevel, length))
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("Could not write binary point data to the X3P archive."),
+			_EX_T("Zlib could not open the target handle. Check for filesystem permissions and enough space left."),
+			_EX_T("OpenGPS::BinaryPointVectorWriterContext::BinaryPointVectorWriterContext"));
+	}
+
+	m_Stream = std::make_unique<ZipOutputStream>(*m_Buffer);
 }
 
 BinaryPointVectorWriterContext::~BinaryPointVectorWriterContext()
@@ -49,10 +59,19 @@ std::ostream* BinaryPointVectorWriterContext::GetStream()
 	return m_Stream.get();
 }
 
-void BinaryPointVectorWriterContext::Close()
+bool BinaryPointVectorWriterContext::Close()
 {
+	auto success{ true };
+
+	if (m_Buffer)
+	{
+		success = (!m_Stream || IsGood()) && m_Buffer->Close();
+	}
+
 	m_Stream.reset();
 	m_Buffer.reset();
+
+	return success;
 }
 
 bool BinaryPointVectorWriterContext::HasStream() const
@@ -51,17 +51,25 @@ namespace OpenGPS
 	public:
 		/*!
 		 * Creates a new instance.
+		 * Creates a new entry in the zip archive which receives the binary data.
 		 * @param handle The zip-stream where binary data is written to.
+		 * @param name The name of the archive entry to create.
+		 * @param compressionLevel The level of compression as known from zlib.
+		 * @param length The expected size of the binary data.
+		 * @param pipelineBuffers The number of buffers of a pipeline that checksums and compresses
+		 * the binary data on other threads while it is written. If this is 0 or the scheduler allows
+		 * no threads of their own, everything is done by the thread writing the data.
 		 */
-		BinaryPointVectorWriterContext(zipFile handle);
+		BinaryPointVectorWriterContext(zipFile handle, const String& name, int compressionLevel, unsigned long long length = 0, size_t pipelineBuffers = 0);
 
 		/*! Destroys this instance. */
 		~BinaryPointVectorWriterContext() override;
 
 		/*!
 		 * Closes the internal handle to the binary stream and frees its resources.
+		 * @returns Returns true if all data has been written to the archive entry, false otherwise.
 		 */
-		void Close();
+		bool Close();
 
 		void Skip() override;
 		void MoveNext() override;
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/cxx/byte_source.hxx>
+
+#include "point_vector_iostream.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+ByteSource::~ByteSource()
+{
+}
+
+String ByteSource::GetName() const
+{
+	return String();
+}
+
+FileByteSource::FileByteSource(const String& filePath)
+	:m_FilePath{ filePath },
+	m_File{ std::make_unique<InputBinaryFileStream>(filePath) }
+{
+	if (m_File->is_open())
+	{
+		m_File->seekg(0, std::ios::end);
+		const auto size{ m_File->tellg() };
+		m_Size = size > 0 ? static_cast<unsigned long long>(size) : 0;
+	}
+}
+
+FileByteSource::~FileByteSource()
+{
+}
+
+unsigned long long FileByteSource::GetSize() const
+{
+	return m_Size;
+}
+
+size_t FileByteSource::Read(unsigned long long offset, void* buffer, size_t size) const
+{
+	if (offset >= m_Size)
+	{
+		return 0;
+	}
+
+	size = static_cast<size_t>(std::min<unsigned long long>(size, m_Size - offset));
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_File->clear();
+	m_File->seekg(static_cast<std::streamoff>(offset));
+	m_File->read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+
+	return static_cast<size_t>(m_File->gcount());
+}
+
+String FileByteSource::GetName() const
+{
+	return m_FilePath;
+}
+
+MemoryByteSource::MemoryByteSource(std::vector<unsigned char> data)
+	:m_Data{ std::move(data) }
+{
+}
+
+MemoryByteSource::~MemoryByteSource()
+{
+}
+
+unsigned long long MemoryByteSource::GetSize() const
+{
+	return m_Data.size();
+}
+
+size_t MemoryByteSource::Read(unsigned long long offset, void* buffer, size_t size) const
+{
+	if (offset >= m_Data.size())
+	{
+		return 0;
+	}
+
+	size = static_cast<size_t>(std::min<unsigned long long>(size, m_Data.size() - offset));
+	memcpy(buffer, m_Data.data() + offset, size);
+
+	return size;
+}
+
+const std::vector<unsigned char>& MemoryByteSource::GetData() const
+{
+	return m_Data;
+}
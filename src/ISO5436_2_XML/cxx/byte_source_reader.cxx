@@ -0,0 +1,190 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "byte_source_reader.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+#define _OPENGPS_BYTE_SOURCE_BLOCK_SIZE (256*1024)
+
+/*! Creates a reader for a zip archive handle. Implements open64_file_func. */
+static voidpf ZCALLBACK OpenByteSource(voidpf opaque, const void* /* filename */, int mode)
+{
+	// Byte sources are read-only.
+	if ((mode & ZLIB_FILEFUNC_MODE_READWRITEFILTER) != ZLIB_FILEFUNC_MODE_READ)
+	{
+		return nullptr;
+	}
+
+	return new ByteSourceReader(*static_cast<const std::shared_ptr<const ByteSource>*>(opaque));
+}
+
+/*! Reads at the current position. Implements read_file_func. */
+static uLong ZCALLBACK ReadByteSource(voidpf /* opaque */, voidpf stream, void* buf, uLong size)
+{
+	return static_cast<uLong>(static_cast<ByteSourceReader*>(stream)->Read(buf, static_cast<size_t>(size)));
+}
+
+/*! Fails, since byte sources are read-only. Implements write_file_func. */
+static uLong ZCALLBACK WriteByteSource(voidpf /* opaque */, voidpf /* stream */, const void* /* buf */, uLong /* size */)
+{
+	return 0;
+}
+
+/*! Gets the current position. Implements tell64_file_func. */
+static ZPOS64_T ZCALLBACK TellByteSource(voidpf /* opaque */, voidpf stream)
+{
+	return static_cast<ByteSourceReader*>(stream)->Tell();
+}
+
+/*! Moves the current position. Implements seek64_file_func. */
+static long ZCALLBACK SeekByteSource(voidpf /* opaque */, voidpf stream, ZPOS64_T offset, int origin)
+{
+	auto reader{ static_cast<ByteSourceReader*>(stream) };
+
+	switch (origin)
+	{
+	case ZLIB_FILEFUNC_SEEK_SET:
+		reader->Seek(offset);
+		return 0;
+	case ZLIB_FILEFUNC_SEEK_CUR:
+		reader->Seek(reader->Tell() + offset);
+		return 0;
+	case ZLIB_FILEFUNC_SEEK_END:
+		reader->Seek(reader->GetSize() + offset);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+/*! Deletes the reader of a zip archive handle. Implements close_file_func. */
+static int ZCALLBACK CloseByteSource(voidpf /* opaque */, voidpf stream)
+{
+	delete static_cast<ByteSourceReader*>(stream);
+	return 0;
+}
+
+/*! Failed reads are reported by their size only. Implements testerror_file_func. */
+static int ZCALLBACK TestByteSource(voidpf /* opaque */, voidpf /* stream */)
+{
+	return 0;
+}
+
+ByteSourceReader::ByteSourceReader(std::shared_ptr<const ByteSource> source)
+	:m_Source{ std::move(source) },
+	m_Block{ std::make_unique<unsigned char[]>(_OPENGPS_BYTE_SOURCE_BLOCK_SIZE) }
+{
+	assert(m_Source);
+
+	m_Size = m_Source->GetSize();
+}
+
+ByteSourceReader::~ByteSourceReader()
+{
+}
+
+unzFile ByteSourceReader::Open(const std::shared_ptr<const ByteSource>& source)
+{
+	assert(source);
+
+	// The source is referenced by the reader created when opening the archive.
+	zlib_filefunc64_def functions;
+	functions.zopen64_file = OpenByteSource;
+	functions.zread_file = ReadByteSource;
+	functions.zwrite_file = WriteByteSource;
+	functions.ztell64_file = TellByteSource;
+	functions.zseek64_file = SeekByteSource;
+	functions.zclose_file = CloseByteSource;
+	functions.zerror_file = TestByteSource;
+	functions.opaque = const_cast<std::shared_ptr<const ByteSource>*>(&source);
+
+	auto name{ source->GetName() };
+	auto handle{ unzOpen2_64(name.ToChar(), &functions) };
+
+	// Prevent the dangling reference from being used by minizip.
+	if (handle)
+	{
+		functions.opaque = nullptr;
+	}
+
+	return handle;
+}
+
+size_t ByteSourceReader::Read(void* buffer, size_t size)
+{
+	auto target{ static_cast<unsigned char*>(buffer) };
+	size_t count{};
+
+	while (count < size && m_Position < m_Size)
+	{
+		if ((m_Position < m_BlockPosition || m_Position >= m_BlockPosition + m_BlockSize) && !ReadBlock())
+		{
+			break;
+		}
+
+		const auto offset{ static_cast<size_t>(m_Position - m_BlockPosition) };
+		const auto length{ std::min(size - count, m_BlockSize - offset) };
+
+		memcpy(target + count, m_Block.get() + offset, length);
+
+		count += length;
+		m_Position += length;
+	}
+
+	return count;
+}
+
+void ByteSourceReader::Seek(unsigned long long position)
+{
+	m_Position = position;
+}
+
+unsigned long long ByteSourceReader::Tell() const
+{
+	return m_Position;
+}
+
+unsigned long long ByteSourceReader::GetSize() const
+{
+	return m_Size;
+}
+
+bool ByteSourceReader::ReadBlock()
+{
+	m_BlockPosition = m_Position / _OPENGPS_BYTE_SOURCE_BLOCK_SIZE * _OPENGPS_BYTE_SOURCE_BLOCK_SIZE;
+
+	const auto size{ static_cast<size_t>(std::min<unsigned long long>(_OPENGPS_BYTE_SOURCE_BLOCK_SIZE, m_Size - m_BlockPosition)) };
+	m_BlockSize = m_Source->Read(m_BlockPosition, m_Block.get(), size);
+
+	return m_Position < m_BlockPosition + m_BlockSize;
+}
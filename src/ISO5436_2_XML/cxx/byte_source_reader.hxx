@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Reads from an OpenGPS::ByteSource in aligned blocks.
+ */
+
+#ifndef _OPENGPS_BYTE_SOURCE_READER_HXX
+#define _OPENGPS_BYTE_SOURCE_READER_HXX
+
+#include <memory>
+
+/* zlib/minizip */
+#include <unzip.h>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/byte_source.hxx>
+
+namespace OpenGPS
+{
+	/*!
+	 * Reads from an OpenGPS::ByteSource at a current position.
+	 *
+	 * The byte source is always read in blocks of a fixed size aligned to that size,
+	 * regardless of the size of the reads requested. The most recent block is kept,
+	 * so small reads as issued by minizip do not reach the byte source.
+	 */
+	class ByteSourceReader
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param source The byte source to be read.
+		 */
+		ByteSourceReader(std::shared_ptr<const ByteSource> source);
+
+		/*! Destroys this instance. */
+		~ByteSourceReader();
+
+		/*!
+		 * Opens a zip archive read from a byte source.
+		 * @param source The byte source to be read. The handle keeps its own reference.
+		 * @returns The handle to be closed with unzClose or nullptr on failure.
+		 */
+		static unzFile Open(const std::shared_ptr<const ByteSource>& source);
+
+		/*!
+		 * Reads from the current position and advances it.
+		 * @param buffer Gets the bytes read.
+		 * @param size The number of bytes to read.
+		 * @returns The number of bytes read, which is less than the size requested
+		 * at the end of the byte source or if reading failed.
+		 */
+		size_t Read(void* buffer, size_t size);
+
+		/*!
+		 * Sets the current position.
+		 * @param position The absolute position, which may exceed the size of the byte source.
+		 */
+		void Seek(unsigned long long position);
+
+		/*! Gets the current position. */
+		unsigned long long Tell() const;
+
+		/*! Gets the size of the byte source. */
+		unsigned long long GetSize() const;
+
+	private:
+		/*!
+		 * Reads the block that contains the current position.
+		 * @returns Returns false if the current position could not be read.
+		 */
+		bool ReadBlock();
+
+		/*! The byte source to be read. */
+		std::shared_ptr<const ByteSource> m_Source;
+
+		/*! The size of the byte source. */
+		unsigned long long m_Size{};
+
+		/*! The current position. */
+		unsigned long long m_Position{};
+
+		/*! The most recent block. */
+		std::unique_ptr<unsigned char[]> m_Block;
+
+		/*! The position of the most recent block. */
+		unsigned long long m_BlockPosition{};
+
+		/*! The number of bytes of the most recent block. */
+		size_t m_BlockSize{};
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ByteSourceReader(const ByteSourceReader& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ByteSourceReader& operator=(const ByteSourceReader& src) = delete;
+	};
+}
+
+#endif
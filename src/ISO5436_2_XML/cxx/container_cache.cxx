@@ -0,0 +1,192 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "container_cache.hxx"
+#include "environment.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <iterator>
+
+ContainerCache::ContainerCache(
+	unsigned long long memoryBudget,
+	const OGPS_OpenOptions& options,
+	const String& temp)
+	:m_MemoryBudget{ memoryBudget },
+	m_Options(options),
+	m_TempPath{ temp }
+{
+}
+
+std::shared_ptr<const ISO5436_2> ContainerCache::Open(const String& filePath)
+{
+	FileInfo info;
+	if (!Environment::GetInstance()->GetFileInfo(filePath, info))
+	{
+		throw Exception(
+			OGPS_ExInvalidArgument,
+			_EX_T("The X3P file does not exist."),
+			_EX_T("Specify the path of an existing X3P file."),
+			_EX_T("OpenGPS::ContainerCache::Open"));
+	}
+
+	std::promise<std::shared_ptr<const ISO5436_2>> promise;
+	EntryList::iterator opening;
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		const auto found{ m_Index.find(filePath) };
+		if (found != m_Index.end())
+		{
+			const auto entry{ found->second };
+
+			if (entry->size == info.size && entry->modified == info.modified)
+			{
+				m_Entries.splice(m_Entries.begin(), m_Entries, entry);
+
+				// Wait for the file being opened by another thread outside of the lock.
+				const auto document{ entry->document };
+				lock.unlock();
+
+				return document.get();
+			}
+
+			// The file has changed since, callers already waiting still get the former one.
+			Remove(entry);
+		}
+
+		Entry entry;
+		entry.filePath = filePath;
+		entry.size = info.size;
+		entry.modified = info.modified;
+		entry.document = promise.get_future().share();
+
+		opening = m_Entries.insert(m_Entries.begin(), std::move(entry));
+		m_Index[filePath] = opening;
+	}
+
+	std::shared_ptr<ISO5436_2> document;
+
+	try
+	{
+		document = std::make_shared<ISO5436_2>(filePath, m_TempPath);
+		document->Open(m_Options);
+	}
+	catch (...)
+	{
+		promise.set_exception(std::current_exception());
+
+		// Failures are not kept, so the next request tries once more.
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			const auto found{ m_Index.find(filePath) };
+			if (found != m_Index.end() && found->second == opening)
+			{
+				Remove(opening);
+			}
+		}
+
+		throw;
+	}
+
+	promise.set_value(document);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// The entry may have been dropped by ContainerCache::Clear or a newer version of the file meanwhile.
+		const auto found{ m_Index.find(filePath) };
+		if (found != m_Index.end() && found->second == opening)
+		{
+			opening->memory = document->GetPointDataSize();
+			opening->isOpen = true;
+			m_MemoryUsage += opening->memory;
+
+			Evict();
+		}
+	}
+
+	return document;
+}
+
+void ContainerCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Entries.clear();
+	m_Index.clear();
+	m_MemoryUsage = 0;
+}
+
+size_t ContainerCache::GetCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Entries.size();
+}
+
+unsigned long long ContainerCache::GetMemoryUsage() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_MemoryUsage;
+}
+
+void ContainerCache::Remove(EntryList::iterator entry)
+{
+	assert(m_MemoryUsage >= entry->memory);
+
+	m_MemoryUsage -= entry->memory;
+	m_Index.erase(entry->filePath);
+	m_Entries.erase(entry);
+}
+
+void ContainerCache::Evict()
+{
+	// Files being opened are skipped, they are accounted for once they have been opened.
+	auto entry{ m_Entries.end() };
+
+	while (m_MemoryUsage > m_MemoryBudget && entry != m_Entries.begin())
+	{
+		const auto current{ std::prev(entry) };
+
+		if (current->isOpen)
+		{
+			Remove(current);
+		}
+		else
+		{
+			entry = current;
+		}
+	}
+}
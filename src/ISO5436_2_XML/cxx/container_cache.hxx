@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Concrete implementation of the interface of OpenGPS::ISO5436_2Cache.
+ */
+
+#ifndef _OPENGPS_CONTAINER_CACHE_HXX
+#define _OPENGPS_CONTAINER_CACHE_HXX
+
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/cxx/iso5436_2.hxx>
+#include <opengps/open_options.h>
+
+namespace OpenGPS
+{
+	/*!
+	 * Keeps X3P files opened recently, see OpenGPS::ISO5436_2Cache.
+	 *
+	 * Files are opened outside of the lock of the cache. A file being opened is
+	 * kept as a future, which all other threads requesting the same file wait for.
+	 */
+	class ContainerCache
+	{
+	public:
+		/*! Creates a new instance, see ISO5436_2Cache::ISO5436_2Cache. */
+		ContainerCache(
+			unsigned long long memoryBudget,
+			const OGPS_OpenOptions& options,
+			const String& temp);
+
+		/*! Implements ISO5436_2Cache::Open. */
+		std::shared_ptr<const ISO5436_2> Open(const String& filePath);
+
+		/*! Implements ISO5436_2Cache::Clear. */
+		void Clear();
+
+		/*! Implements ISO5436_2Cache::GetCount. */
+		size_t GetCount() const;
+
+		/*! Implements ISO5436_2Cache::GetMemoryUsage. */
+		unsigned long long GetMemoryUsage() const;
+
+	private:
+		/*! A file kept or being opened. */
+		struct Entry
+		{
+			/*! The full path to the file. */
+			String filePath;
+
+			/*! The size of the file in bytes when it has been opened. */
+			unsigned long long size{};
+
+			/*! The time of the last modification of the file when it has been opened. */
+			long long modified{};
+
+			/*! The file opened. */
+			std::shared_future<std::shared_ptr<const ISO5436_2>> document;
+
+			/*! The amount of memory occupied by the point data of the file or 0 while it is being opened. */
+			unsigned long long memory{};
+
+			/*! true once the file has been opened. */
+			bool isOpen{};
+		};
+
+		typedef std::list<Entry> EntryList;
+
+		/*!
+		 * Drops a file from the cache.
+		 * @param entry The file to be dropped.
+		 */
+		void Remove(EntryList::iterator entry);
+
+		/*!
+		 * Drops the files used least recently until the memory occupied fits into the budget.
+		 * Files being opened are never dropped.
+		 */
+		void Evict();
+
+		/*! The maximum amount of memory occupied by the point data of the files kept. */
+		const unsigned long long m_MemoryBudget;
+
+		/*! Controls how the files are opened. */
+		const OGPS_OpenOptions m_Options;
+
+		/*! The path to the directory for temporary files. */
+		const String m_TempPath;
+
+		/*! Serializes access to the state of the cache. */
+		mutable std::mutex m_Mutex;
+
+		/*! The files kept, the most recently used first. */
+		EntryList m_Entries;
+
+		/*! The files kept indexed by their path. */
+		std::map<String, EntryList::iterator> m_Index;
+
+		/*! The amount of memory occupied by the point data of the files kept. */
+		unsigned long long m_MemoryUsage{};
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ContainerCache(const ContainerCache& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ContainerCache& operator=(const ContainerCache& src) = delete;
+	};
+}
+
+#endif
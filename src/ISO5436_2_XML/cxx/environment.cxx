@@ -32,9 +32,12 @@
 #include "stdafx.hxx"
 
 std::unique_ptr<Environment> Environment::m_Instance;
+std::mutex Environment::m_InstanceMutex;
 
 const Environment* Environment::GetInstance()
 {
+	std::lock_guard<std::mutex> lock{ m_InstanceMutex };
+
 	if (!m_Instance)
 	{
 		m_Instance = CreateInstance();
@@ -45,6 +48,8 @@ const Environment* Environment::GetInstance()
 
 void Environment::Reset()
 {
+	std::lock_guard<std::mutex> lock{ m_InstanceMutex };
+
 	m_Instance.reset();
 }
 
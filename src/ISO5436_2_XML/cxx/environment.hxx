@@ -37,11 +37,23 @@
 #define _OPENGPS_ENVIRONMENT_HXX
 
 #include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace OpenGPS
 {
-	class String;
+	/*! Describes a file found by Environment::GetFiles. */
+	struct FileInfo
+	{
+		/*! The name of the file without its directory. */
+		String name;
+		/*! The size of the file in bytes. */
+		unsigned long long size{};
+		/*! The time of the last modification of the file. Its unit depends on the system, but times of different files are comparable. */
+		long long modified{};
+	};
 
 	/*!
 	 * Interface for communicating with the operating system and related subjects.
@@ -118,11 +130,14 @@ namespace OpenGPS
 		/*!
 		 * Deletes a given file.
 		 * @param file The path to the file to be erased.
+		 * @returns Returns true on success, false otherwise.
 		 */
 		virtual bool RemoveFile(const String& file) const = 0;
 
 		/*!
-		 * Gets a random sequence of numeric characters.
+		 * Gets a name for files or directories. It is never returned twice by the current process
+		 * and includes the process id and a random number, so that other processes are unlikely to use it.
+		 * This method is thread-safe.
 		 */
 		virtual String GetUniqueName() const = 0;
 
@@ -134,8 +149,20 @@ namespace OpenGPS
 		virtual bool CreateDir(const String& path) const = 0;
 
 		/*!
-		 * Deletes a given directory.
+		 * Makes a directory of a name that has not been used before.
+		 *
+		 * The directory is created atomically, another name is tried if it already exists.
+		 * Concurrent calls from threads or processes therefore never get the same directory.
+		 *
+		 * @param base The directory to create the new one in.
+		 * @returns Returns the path of the directory created or an empty string on error.
+		 */
+		virtual String CreateUniqueDir(const String& base) const = 0;
+
+		/*!
+		 * Deletes a given directory and its content.
 		 * @param path The path to the directory to be erased.
+		 * @returns Returns true on success, false otherwise.
 		 */
 		virtual bool RemoveDir(const String& path) const = 0;
 
@@ -153,6 +180,99 @@ namespace OpenGPS
 		 */
 		virtual bool RenameFile(const String& src, const String& dst) const = 0;
 
+		/*!
+		 * Gets the regular files contained in a directory.
+		 *
+		 * @param path The path to the directory.
+		 * @param files Gets the name, size and time of last modification of every file.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool GetFiles(const String& path, std::vector<FileInfo>& files) const = 0;
+
+		/*!
+		 * Gets the size and the time of the last modification of a regular file.
+		 *
+		 * @param file The path to the file.
+		 * @param info Gets the name, size and time of last modification of the file.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool GetFileInfo(const String& file, FileInfo& info) const = 0;
+
+		/*!
+		 * Sets the time of the last modification of a file to the current time.
+		 *
+		 * @param file The path to the file.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool TouchFile(const String& file) const = 0;
+
+		/*!
+		 * Maps a file into memory. Pages that get changed become private copies,
+		 * so the file itself is never changed.
+		 *
+		 * @param file The path to the file.
+		 * @param size Gets the size of the file in bytes.
+		 * @returns Returns the memory of the file, which gets unmapped when the last
+		 * reference is released, or nullptr on failure.
+		 */
+		virtual std::shared_ptr<unsigned char> MapFile(const String& file, size_t& size) const = 0;
+
+		/*!
+		 * Asks the system to read a file into its cache in the background, so that
+		 * it is not read from disk once it gets opened. Returns without waiting for
+		 * the file to be read.
+		 *
+		 * @param file The path to the file.
+		 * @returns Returns true if the system has been asked, false otherwise.
+		 */
+		virtual bool PrefetchFile(const String& file) const = 0;
+
+		/*!
+		 * Creates a named segment of shared memory, which other processes can map by its name.
+		 *
+		 * @param name The name of the segment, which must not contain path separators.
+		 * @param size The size of the segment in bytes.
+		 * @param allUsers Whether other users may read the segment. Otherwise only the
+		 * current user has access to it, where the system supports permissions of segments.
+		 * @returns Returns the writable memory of the new segment, which gets unmapped when
+		 * the last reference is released, or nullptr if a segment of the same name exists
+		 * already or on failure.
+		 */
+		virtual std::shared_ptr<unsigned char> CreateSharedMemory(const String& name, size_t size, bool allUsers) const = 0;
+
+		/*!
+		 * Maps an existing named segment of shared memory and marks it as used most recently.
+		 * Pages that get changed become private copies, so the segment itself is never changed.
+		 *
+		 * Segments that others than their owner may change are never mapped, since their
+		 * content cannot be trusted.
+		 *
+		 * @param name The name of the segment.
+		 * @param size Gets the size of the segment in bytes, which may be rounded up to whole pages.
+		 * @param allUsers Whether segments created by other users are mapped. Otherwise
+		 * only segments of the current user are mapped, where the system supports owners of segments.
+		 * @returns Returns the memory of the segment, which gets unmapped when the last
+		 * reference is released, or nullptr on failure.
+		 */
+		virtual std::shared_ptr<unsigned char> MapSharedMemory(const String& name, size_t& size, bool allUsers) const = 0;
+
+		/*!
+		 * Removes a named segment of shared memory. Processes that have mapped the
+		 * segment already keep their memory.
+		 *
+		 * @param name The name of the segment.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool RemoveSharedMemory(const String& name) const = 0;
+
+		/*!
+		 * Gets the named segments of shared memory of the system.
+		 *
+		 * @param segments Gets the name, size and time of last use of every segment.
+		 * @returns Returns true on success, false if the system cannot enumerate its segments.
+		 */
+		virtual bool GetSharedMemory(std::vector<FileInfo>& segments) const = 0;
+
 		/*!
 		 * Gets the value of a named environment variable.
 		 *
@@ -250,6 +370,9 @@ namespace OpenGPS
 	private:
 		/*! Pointer to the environment. */
 		static std::unique_ptr<Environment> m_Instance;
+
+		/*! Serializes creation of the environment from concurrent threads. */
+		static std::mutex m_InstanceMutex;
 	};
 }
 
@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Point data of incremental axes derived from the point index.
+ */
+
+#ifndef _OPENGPS_INCREMENTAL_INDEX_HXX
+#define _OPENGPS_INCREMENTAL_INDEX_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/data_point.hxx>
+#include <limits>
+
+namespace OpenGPS
+{
+	/*!
+	 * Sets point data of an implicit axis, which is derived from the current point index.
+	 * Indexes that fit a signed 32-bit integer are stored as such. Larger indexes are stored
+	 * as double instead, which represents them exactly up to 2^53.
+	 * @param point The component of a point vector to be set.
+	 * @param index The point index.
+	 */
+	inline void SetIncrementalIndex(DataPoint& point, size_t index)
+	{
+		if (index <= static_cast<size_t>(std::numeric_limits<OGPS_Int32>::max()))
+		{
+			point.Set(static_cast<OGPS_Int32>(index));
+		}
+		else
+		{
+			point.Set(static_cast<OGPS_Double>(index));
+		}
+	}
+}
+
+#endif
@@ -31,8 +31,14 @@
 #include <opengps/cxx/iso5436_2.hxx>
 
 #include "iso5436_2_container.hxx"
+#include "task_scheduler.hxx"
 #include "stdafx.hxx"
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
  /* Open. */
 ISO5436_2::ISO5436_2(
 	const String& file,
@@ -46,6 +52,30 @@ ISO5436_2::ISO5436_2(const String& file)
 {
 }
 
+ISO5436_2::ISO5436_2(
+	std::vector<unsigned char> data,
+	const String& temp)
+	:m_Instance{ std::make_shared<ISO5436_2Container>(std::move(data), temp) }
+{
+}
+
+ISO5436_2::ISO5436_2(std::vector<unsigned char> data)
+	:m_Instance{ std::make_shared<ISO5436_2Container>(std::move(data), _T("")) }
+{
+}
+
+ISO5436_2::ISO5436_2(
+	std::shared_ptr<const ByteSource> source,
+	const String& temp)
+	:m_Instance{ std::make_shared<ISO5436_2Container>(std::move(source), temp) }
+{
+}
+
+ISO5436_2::ISO5436_2(std::shared_ptr<const ByteSource> source)
+	:m_Instance{ std::make_shared<ISO5436_2Container>(std::move(source), _T("")) }
+{
+}
+
 ISO5436_2::~ISO5436_2()
 {
 	m_Instance->Close();
@@ -56,6 +86,11 @@ void ISO5436_2::Open()
 	m_Instance->Open();
 }
 
+void ISO5436_2::Open(const OGPS_OpenOptions& options)
+{
+	m_Instance->Open(options);
+}
+
 void ISO5436_2::Create(
 	const Schemas::ISO5436_2::Record1Type& record1,
 	const Schemas::ISO5436_2::Record2Type* record2,
@@ -74,6 +109,25 @@ void ISO5436_2::Create(
 	m_Instance->Create(record1, record2, listDimension, useBinaryData);
 }
 
+void ISO5436_2::CreateStream(
+	const Schemas::ISO5436_2::Record1Type& record1,
+	const Schemas::ISO5436_2::Record2Type* record2,
+	const Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+	int compressionLevel)
+{
+	m_Instance->CreateStream(record1, record2, matrixDimension, compressionLevel);
+}
+
+void ISO5436_2::AppendMatrixPoint(const PointVector* vector)
+{
+	m_Instance->AppendMatrixPoint(vector);
+}
+
+bool ISO5436_2::Visit(const PointBlockVisitor& visitor, size_t blockSize)
+{
+	return m_Instance->Visit(visitor, blockSize);
+}
+
 PointIteratorAutoPtr ISO5436_2::CreateNextPointIterator()
 {
 	return m_Instance->CreateNextPointIterator();
@@ -84,6 +138,105 @@ PointIteratorAutoPtr ISO5436_2::CreatePrevPointIterator()
 	return m_Instance->CreatePrevPointIterator();
 }
 
+std::vector<PointPartition> ISO5436_2::GetPartitions(size_t count) const
+{
+	size_t size{};
+
+	if (IsMatrix())
+	{
+		GetMatrixDimensions(nullptr, &size, nullptr);
+	}
+	else
+	{
+		size = GetListDimension();
+	}
+
+	if (count == 0)
+	{
+		count = TaskScheduler::GetInstance().GetThreadCount();
+	}
+
+	count = std::min(count, size);
+
+	std::vector<PointPartition> partitions;
+	partitions.reserve(count);
+
+	// The first partitions get one row more each until the remainder is used up
+	for (size_t n = 0; n < count; ++n)
+	{
+		const auto first{ n * (size / count) + std::min(n, size % count) };
+		const auto rows{ size / count + (n < size % count ? 1 : 0) };
+
+		partitions.emplace_back(*this, first, rows);
+	}
+
+	return partitions;
+}
+
+void ISO5436_2::ParallelForEach(const PointPartitionCallback& callback, size_t count) const
+{
+	auto partitions{ GetPartitions(count) };
+	auto& scheduler{ TaskScheduler::GetInstance() };
+
+	std::mutex mutex;
+	std::condition_variable finished;
+	auto remaining{ partitions.size() };
+	std::exception_ptr error;
+
+	for (auto& partition : partitions)
+	{
+		scheduler.Post([&callback, &partition, &mutex, &finished, &remaining, &error]()
+		{
+			std::exception_ptr exception;
+
+			try
+			{
+				callback(partition);
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (exception && !error)
+			{
+				error = exception;
+			}
+
+			if (--remaining == 0)
+			{
+				finished.notify_all();
+			}
+		});
+	}
+
+	// Process partitions on the calling thread too, so that waiting never blocks a worker thread.
+	// Partitions passed to an executor of the application are awaited only.
+	for (;;)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (remaining == 0)
+			{
+				break;
+			}
+		}
+
+		if (!scheduler.RunPending())
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [&remaining]() { return remaining == 0; });
+		}
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
 void ISO5436_2::SetMatrixPoint(
 	size_t u,
 	size_t v,
@@ -97,7 +250,7 @@ void ISO5436_2::GetMatrixPoint(
 	size_t u,
 	size_t v,
 	size_t w,
-	PointVector& vector)
+	PointVector& vector) const
 {
 	m_Instance->GetMatrixPoint(u, v, w, vector);
 }
@@ -111,7 +264,7 @@ void ISO5436_2::SetListPoint(
 
 void ISO5436_2::GetListPoint(
 	size_t index,
-	PointVector& vector)
+	PointVector& vector) const
 {
 	m_Instance->GetListPoint(index, vector);
 }
@@ -122,7 +275,7 @@ void ISO5436_2::GetMatrixCoord(
 	size_t w,
 	OGPS_Double* x,
 	OGPS_Double* y,
-	OGPS_Double* z)
+	OGPS_Double* z) const
 {
 	m_Instance->GetMatrixCoord(u, v, w, x, y, z);
 }
@@ -130,7 +283,7 @@ void ISO5436_2::GetMatrixCoord(
 bool ISO5436_2::IsMatrixCoordValid(
 	size_t u,
 	size_t v,
-	size_t w)
+	size_t w) const
 {
 	return m_Instance->IsMatrixCoordValid(u, v, w);
 }
@@ -139,7 +292,7 @@ void ISO5436_2::GetListCoord(
 	size_t index,
 	OGPS_Double* x,
 	OGPS_Double* y,
-	OGPS_Double* z)
+	OGPS_Double* z) const
 {
 	m_Instance->GetListCoord(index, x, y, z);
 }
@@ -149,6 +302,11 @@ Schemas::ISO5436_2::ISO5436_2Type* ISO5436_2::GetDocument()
 	return m_Instance->GetDocument();
 }
 
+const Schemas::ISO5436_2::ISO5436_2Type* ISO5436_2::GetDocument() const
+{
+	return std::const_pointer_cast<const ISO5436_2Container>(m_Instance)->GetDocument();
+}
+
 bool ISO5436_2::IsMatrix() const
 {
 	return m_Instance->IsMatrix();
@@ -167,11 +325,26 @@ size_t ISO5436_2::GetListDimension() const
 	return m_Instance->GetListDimension();
 }
 
+unsigned long long ISO5436_2::GetPointDataSize() const
+{
+	return m_Instance->GetPointDataSize();
+}
+
+void ISO5436_2::SetWriteOptions(const OGPS_WriteOptions& options)
+{
+	m_Instance->SetWriteOptions(options);
+}
+
 void ISO5436_2::Write(int compressionLevel)
 {
 	m_Instance->Write(compressionLevel);
 }
 
+void ISO5436_2::Write(std::vector<unsigned char>& target, int compressionLevel)
+{
+	m_Instance->Write(target, compressionLevel);
+}
+
 void ISO5436_2::Close()
 {
 	m_Instance->Close();
@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/cxx/iso5436_2_batch.hxx>
+
+#include "batch_opener.hxx"
+#include "stdafx.hxx"
+
+ISO5436_2Batch::ISO5436_2Batch(
+	std::vector<String> filePaths,
+	const OGPS_OpenOptions* options,
+	size_t threadCount,
+	size_t maxInFlight,
+	const String& temp)
+{
+	OGPS_OpenOptions defaults;
+	ogps_InitOpenOptions(&defaults);
+
+	m_Instance = std::make_unique<BatchOpener>(std::move(filePaths), options ? *options : defaults, threadCount, maxInFlight, temp);
+}
+
+ISO5436_2Batch::~ISO5436_2Batch()
+{
+}
+
+bool ISO5436_2Batch::Next(ISO5436_2BatchResult& result)
+{
+	return m_Instance->Next(result);
+}
+
+size_t ISO5436_2Batch::GetCount() const
+{
+	return m_Instance->GetCount();
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/cxx/iso5436_2_cache.hxx>
+
+#include "container_cache.hxx"
+#include "stdafx.hxx"
+
+ISO5436_2Cache::ISO5436_2Cache(
+	unsigned long long memoryBudget,
+	const OGPS_OpenOptions* options,
+	const String& temp)
+{
+	OGPS_OpenOptions defaults;
+	ogps_InitOpenOptions(&defaults);
+
+	m_Instance = std::make_unique<ContainerCache>(memoryBudget, options ? *options : defaults, temp);
+}
+
+ISO5436_2Cache::~ISO5436_2Cache()
+{
+}
+
+std::shared_ptr<const ISO5436_2> ISO5436_2Cache::Open(const String& file)
+{
+	return m_Instance->Open(file);
+}
+
+void ISO5436_2Cache::Clear()
+{
+	m_Instance->Clear();
+}
+
+size_t ISO5436_2Cache::GetCount() const
+{
+	return m_Instance->GetCount();
+}
+
+unsigned long long ISO5436_2Cache::GetMemoryUsage() const
+{
+	return m_Instance->GetMemoryUsage();
+}
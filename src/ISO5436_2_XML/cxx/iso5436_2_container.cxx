@@ -56,6 +56,20 @@
 #include "point_vector_iostream.hxx"
 
 #include "zip_stream_buffer.hxx"
+#include "zip_codec.hxx"
+#include "stream_valid_buffer.hxx"
+#include "stream_valid_reader.hxx"
+#include "paged_storage.hxx"
+#include "mapped_storage.hxx"
+#include "surface_cache.hxx"
+#include "valid_buffer.hxx"
+#include "point_block_buffer.hxx"
+#include "zip_input_stream_buffer.hxx"
+#include "zip_entry_index.hxx"
+#include "zip_memory_archive.hxx"
+#include "zip_directory.hxx"
+#include "incremental_index.hxx"
+#include "task_scheduler.hxx"
 
 #include <limits>
 #include <iostream>
@@ -64,6 +78,9 @@
 #include <iomanip>
 #include <sstream>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <mutex>
 
 /* zlib/minizip header files */
 #include <unzip.h>
@@ -75,6 +92,8 @@
 #include "stdafx.hxx"
 
 #define _OPENGPS_ZIP_CHUNK_MAX (256*1024)
+/* Estimated maximum size of a single point vector within the DataList of main.xml. */
+#define _OPENGPS_XML_DATUM_SIZE_MAX 96
 #define _OPENGPS_FILE_URI_PREF _T("file:///")
 #define _OPENGPS_WHITESPACE _T(" ")
 #define _OPENGPS_URI_WHITESPACE _T("%20")
@@ -99,26 +118,6 @@ static inline size_t ConvertToSizeT(T value)
 	return static_cast<size_t>(value);
 }
 
-/*!
- * Converts a value into a smaller type.
- * Throws an exception on overflow, so this conversion is safe.
- * @param value The value to be converted.
- * @returns Returns the same value, but casted to a shorter data type.
- */
-template<typename T>
-static inline OGPS_Int32 ConvertToInt32(T value)
-{
-	if (static_cast<T>(std::numeric_limits<OGPS_Int32>::max()) < value)
-	{
-		throw Exception(OGPS_ExOverflow,
-			_EX_T("An integer overflow occured."),
-			_EX_T("Point data of implicit axes is derived from the current point index. Since point indexes are of unsigned type, very large values can not be converted into a signed integer. But within a point vector the components are of signed integer and therefore the current index value could not be saved in a point vector. In other words: reduce the amount of point data stored to be able to fit the upper bound of a signed integer data type."),
-			_EX_T("ConvertToInt32"));
-	}
-
-	return static_cast<OGPS_Int32>(value);
-}
-
 /*!
  * Multiplication of two values and conversion of the result to a shorter data type.
  * Throws an exception on overflow, so this conversion is safe.
@@ -139,18 +138,216 @@ static inline size_t SafeMultipilcation(unsigned long long value1, unsigned long
 	return static_cast<size_t>(value1 * value2);
 }
 
+/*!
+ * Decompresses the archive entry currently opened in raw mode.
+ * Since Info-Zip does not verify raw data, the crc32 checksum is compared here.
+ * @param handle The handle of the zip archive.
+ * @param inflater Decompresses the raw data of the current archive entry.
+ * @param length The size of the uncompressed data as stored in the zip directory.
+ * @param crc The crc32 checksum as stored in the zip directory.
+ * @param target Receives the uncompressed data.
+ * @returns Returns true if the archive entry has been decompressed completely and correctly, false otherwise.
+ */
+static bool InflateCurrentFile(unzFile handle, ZipInflater& inflater, unsigned long long length, unsigned long crc, std::ostream& target)
+{
+	auto input = std::make_unique<char[]>(_OPENGPS_ZIP_CHUNK_MAX);
+	auto output = std::make_unique<char[]>(_OPENGPS_ZIP_CHUNK_MAX);
+
+	unsigned long long written{};
+	auto checksum{ crc32(0L, Z_NULL, 0) };
+
+	// Don't uncompress this file as a whole, but in loops
+	// of a predefined maximum chunk size. Otherwise we
+	// might get out of memory...
+	while (!inflater.IsFinished())
+	{
+		if (inflater.NeedsInput())
+		{
+			const auto bytesRead{ unzReadCurrentFile(handle, input.get(), _OPENGPS_ZIP_CHUNK_MAX) };
+			if (bytesRead <= 0)
+			{
+				return false;
+			}
+
+			inflater.SetInput(input.get(), static_cast<size_t>(bytesRead));
+		}
+
+		const auto size{ inflater.Read(output.get(), _OPENGPS_ZIP_CHUNK_MAX) };
+		if (!inflater.IsGood() || (size == 0 && !inflater.NeedsInput() && !inflater.IsFinished()))
+		{
+			return false;
+		}
+
+		if (size > 0)
+		{
+			checksum = crc32(checksum, reinterpret_cast<const Bytef*>(output.get()), static_cast<uInt>(size));
+
+			target.write(output.get(), size);
+			written += size;
+
+			if (target.fail() || written > length)
+			{
+				return false;
+			}
+		}
+	}
+
+	return written == length && checksum == crc;
+}
+
+/*!
+ * Compares a computed md5 checksum with the one expected.
+ * @param md5 The computed md5 checksum.
+ * @param checksum The expected md5 checksum.
+ * @param size The size of the expected checksum in bytes.
+ * @returns Returns true if both checksums are equal, false otherwise.
+ */
+static bool CompareChecksum(const std::array<unsigned char, 16>& md5, const unsigned char* checksum, size_t size)
+{
+	if (!checksum || size != md5.size())
+	{
+		return false;
+	}
+
+	for (size_t n = 0; n < md5.size(); ++n)
+	{
+		if (checksum[n] != md5[n])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*!
+ * Hands the current block of point vectors to a visitor and starts the next block.
+ * @param block The current block of point vectors.
+ * @param visitor Receives the current block unless it is empty.
+ * @returns Returns false if the visitor stopped, true otherwise.
+ */
+static bool VisitBlock(PointBlockBuffer& block, const PointBlockVisitor& visitor)
+{
+	if (block.IsEmpty())
+	{
+		return true;
+	}
+
+	const auto proceed{ visitor(block.GetBlock()) };
+	block.Next();
+
+	return proceed;
+}
+
+/*!
+ * Sets the value of a data point that is stored for an invalid point vector.
+ * @param point The data point to be set.
+ * @param type The data type of the corresponding axis.
+ * @param isZ true if this is the Z component of the vector. Only floating point types
+ * of the Z axis have a special value set for beeing "invalid", zero is used otherwise.
+ */
+static void SetInvalidDataPoint(DataPoint& point, OGPS_DataPointType type, bool isZ)
+{
+	switch (type)
+	{
+	case OGPS_Int16PointType:
+		point.Set(static_cast<OGPS_Int16>(0));
+		break;
+	case OGPS_Int32PointType:
+		point.Set(static_cast<OGPS_Int32>(0));
+		break;
+	case OGPS_FloatPointType:
+		point.Set(isZ ? std::numeric_limits<OGPS_Float>::quiet_NaN() : 0.0F);
+		break;
+	case OGPS_DoublePointType:
+		point.Set(isZ ? std::numeric_limits<OGPS_Double>::quiet_NaN() : 0.0);
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+ * Gets the size of a single data point of the given type.
+ * @param type The type of point data.
+ * @returns Returns the size in bytes or 0 if no point data is stored for the given type.
+ */
+static size_t GetDataTypeSize(OGPS_DataPointType type)
+{
+	switch (type)
+	{
+	case OGPS_Int16PointType:
+		return sizeof(OGPS_Int16);
+	case OGPS_Int32PointType:
+		return sizeof(OGPS_Int32);
+	case OGPS_FloatPointType:
+		return sizeof(OGPS_Float);
+	case OGPS_DoublePointType:
+		return sizeof(OGPS_Double);
+	default:
+		return 0;
+	}
+}
+
+/*!
+ * Gets the lock that serializes parsing and serializing XML documents.
+ * Initialization of Xerces is reference counted, but not thread-safe.
+ */
+static std::mutex& GetXercesMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
 ISO5436_2Container::ISO5436_2Container(
 	const String& file,
 	const String& temp)
 	:m_FilePath { file },
-	m_TempPath{ temp },
+	m_TempBasePath{ temp },
 	m_CompressionLevel { Z_DEFAULT_COMPRESSION }
 {
+	ogps_InitOpenOptions(&m_OpenOptions);
+	ogps_InitWriteOptions(&m_WriteOptions);
+}
+
+ISO5436_2Container::ISO5436_2Container(
+	std::vector<unsigned char> data,
+	const String& temp)
+	:m_TempBasePath{ temp },
+	m_Source{ std::make_shared<MemoryByteSource>(std::move(data)) },
+	m_CompressionLevel{ Z_DEFAULT_COMPRESSION }
+{
+	ogps_InitOpenOptions(&m_OpenOptions);
+	ogps_InitWriteOptions(&m_WriteOptions);
 }
 
-ISO5436_2Container::~ISO5436_2Container() = default;
+ISO5436_2Container::ISO5436_2Container(
+	std::shared_ptr<const ByteSource> source,
+	const String& temp)
+	:m_TempBasePath{ temp },
+	m_Source{ std::move(source) },
+	m_CompressionLevel{ Z_DEFAULT_COMPRESSION }
+{
+	assert(m_Source);
+
+	ogps_InitOpenOptions(&m_OpenOptions);
+	ogps_InitWriteOptions(&m_WriteOptions);
+}
+
+ISO5436_2Container::~ISO5436_2Container()
+{
+	CloseStream();
+}
 
 void ISO5436_2Container::Open()
+{
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+
+	Open(options);
+}
+
+void ISO5436_2Container::Open(const OGPS_OpenOptions& options)
 {
 	if (HasDocument())
 	{
@@ -161,23 +358,47 @@ void ISO5436_2Container::Open()
 			_EX_T("OpenGPS::ISO5436_2Container::Open"));
 	}
 
-	try
+	m_OpenOptions = options;
+
+	// The pipeline runs threads of its own, which the scheduler may forbid
+	if (!TaskScheduler::GetInstance().AllowsDedicatedThreads())
 	{
-		CreateTempDir();
+		m_OpenOptions.pipelineBuffers = 0;
+	}
 
-		try
+	try
+	{
+		if (HasByteSource())
 		{
-			Decompress();
-			CreatePointBuffer();
+			ReadByteSource();
+
+			if (m_OpenOptions.loadPoints)
+			{
+				CreatePointBuffer();
+			}
 		}
-		catch (...)
+		else
 		{
-			Reset();
+			CreateTempDir();
+
+			try
+			{
+				Decompress();
+
+				if (m_OpenOptions.loadPoints)
+				{
+					CreatePointBuffer();
+				}
+			}
+			catch (...)
+			{
+				Reset();
+				RemoveTempDir();
+				throw;
+			}
+
 			RemoveTempDir();
-			throw;
 		}
-
-		RemoveTempDir();
 	}
 	catch (...)
 	{
@@ -186,6 +407,7 @@ void ISO5436_2Container::Open()
 	}
 
 	m_IsCreating = false;
+	m_CanCopyPointData = IsBinary() && !IsPartial() && m_DataBinChecksum && m_ValidBinChecksum;
 
 	ValidateDocument();
 	TestChecksums();
@@ -198,7 +420,49 @@ void ISO5436_2Container::Decompress()
 	DecompressMain();
 	ReadDocument();
 	DecompressChecksum();
-	DecompressDataBin();
+
+	// Otherwise point data is decompressed on demand while being visited
+	if (m_OpenOptions.loadPoints)
+	{
+		ApplyOpenWindow();
+
+		// Partial or pipelined point data is decompressed while being loaded,
+		// cached point data is not decompressed at all
+		if (!IsPartial() && !LoadCachedPointBuffer() && m_OpenOptions.pipelineBuffers == 0)
+		{
+			DecompressDataBin();
+		}
+	}
+}
+
+void ISO5436_2Container::ReadByteSource()
+{
+	assert(HasByteSource());
+
+	std::array<unsigned char, 16> md5{};
+
+	{
+		auto buffer{ OpenArchiveEntry(GetMainArchiveName()) };
+		std::istream stream(buffer.get());
+
+		ReadDocument(&stream);
+
+		m_MainChecksum = buffer->Finish();
+		buffer->GetMd5(md5);
+	}
+
+	auto buffer{ OpenArchiveEntry(GetChecksumArchiveName()) };
+	std::istream stream(buffer.get());
+
+	std::array<unsigned char, 16> checksum{};
+	m_MainChecksum = m_MainChecksum && ReadMd5FromStream(stream, checksum) && CompareChecksum(md5, checksum.data(), checksum.size());
+
+	// Point data is decompressed while being loaded unless it has been cached
+	if (m_OpenOptions.loadPoints)
+	{
+		ApplyOpenWindow();
+		LoadCachedPointBuffer();
+	}
 }
 
 bool ISO5436_2Container::VerifyChecksum(const String& filePath, const unsigned char* checksum, size_t size) const
@@ -215,15 +479,7 @@ bool ISO5436_2Container::VerifyChecksum(const String& filePath, const unsigned c
 
 	if (!md5_file(filePathBuffer.ToChar(), md5.data()))
 	{
-		for (size_t n = 0; n < md5.size(); ++n)
-		{
-			if (checksum[n] != md5[n])
-			{
-				return false;
-			}
-		}
-
-		return true;
+		return CompareChecksum(md5, checksum, size);
 	}
 
 	return false;
@@ -234,6 +490,24 @@ bool ISO5436_2Container::VerifyChecksum(const String& filePath, std::array<unsig
 	return VerifyChecksum(filePath, checksum.data(), checksum.size());
 }
 
+bool ISO5436_2Container::VerifyChecksum(ZipInputStreamBuffer& buffer, const unsigned char* checksum, size_t size) const
+{
+	if (!checksum || size != 16)
+	{
+		return false;
+	}
+
+	std::array<unsigned char, 16> md5{};
+
+	if (buffer.Finish())
+	{
+		buffer.GetMd5(md5);
+		return CompareChecksum(md5, checksum, size);
+	}
+
+	return false;
+}
+
 void ISO5436_2Container::VerifyMainChecksum()
 {
 	assert(HasDocument());
@@ -251,34 +525,30 @@ void ISO5436_2Container::VerifyMainChecksum()
 	m_MainChecksum = false;
 }
 
-void ISO5436_2Container::VerifyDataBinChecksum()
+void ISO5436_2Container::VerifyDataBinChecksum(ZipInputStreamBuffer& buffer)
 {
 	assert(HasDocument() && IsBinary());
 
-	const auto file{ GetPointDataFileName() };
-
 	if (m_Document->Record3().DataLink().present())
 	{
 		const auto& md5{ m_Document->Record3().DataLink()->MD5ChecksumPointData() };
-		m_DataBinChecksum = VerifyChecksum(file, reinterpret_cast<const unsigned char*>(md5.data()), md5.size());
+		m_DataBinChecksum = VerifyChecksum(buffer, reinterpret_cast<const unsigned char*>(md5.data()), md5.size());
 		return;
 	}
 
 	m_DataBinChecksum = false;
 }
 
-void ISO5436_2Container::VerifyValidBinChecksum()
+void ISO5436_2Container::VerifyValidBinChecksum(ZipInputStreamBuffer& buffer)
 {
 	assert(HasDocument() && IsBinary() && HasValidPointsLink());
 
-	const auto file{ GetValidPointsFileName() };
-
 	if (m_Document->Record3().DataLink().present())
 	{
 		const auto& md5{ m_Document->Record3().DataLink()->MD5ChecksumValidPoints() };
 		if (md5.present())
 		{
-			m_ValidBinChecksum = VerifyChecksum(file, reinterpret_cast<const unsigned char*>(md5->data()), md5->size());
+			m_ValidBinChecksum = VerifyChecksum(buffer, reinterpret_cast<const unsigned char*>(md5->data()), md5->size());
 			return;
 		}
 	}
@@ -286,6 +556,48 @@ void ISO5436_2Container::VerifyValidBinChecksum()
 	m_ValidBinChecksum = false;
 }
 
+void ISO5436_2Container::VerifyBinChecksums()
+{
+	assert(HasDocument() && IsBinary());
+
+	const auto hasValidPoints{ HasValidPointsLink() };
+
+	m_DataBinChecksum = false;
+	if (hasValidPoints)
+	{
+		m_ValidBinChecksum = false;
+	}
+
+	const auto& dataLink{ m_Document->Record3().DataLink() };
+	if (!dataLink.present())
+	{
+		return;
+	}
+
+	const auto& dataMd5{ dataLink->MD5ChecksumPointData() };
+	const auto& validMd5{ dataLink->MD5ChecksumValidPoints() };
+
+	// Both files are independent of each other, so they are hashed at once
+	String dataFile(GetPointDataFileName());
+	String validFile(hasValidPoints ? GetValidPointsFileName() : String());
+	const char* paths[2]{ dataFile.ToChar(), hasValidPoints ? validFile.ToChar() : nullptr };
+
+	std::array<std::array<unsigned char, 16>, 2> md5{};
+	unsigned char* output[2]{ md5[0].data(), md5[1].data() };
+
+	if (md5_file_multi(paths, output, hasValidPoints ? 2 : 1) != 0)
+	{
+		return;
+	}
+
+	m_DataBinChecksum = CompareChecksum(md5[0], reinterpret_cast<const unsigned char*>(dataMd5.data()), dataMd5.size());
+
+	if (hasValidPoints)
+	{
+		m_ValidBinChecksum = validMd5.present() && CompareChecksum(md5[1], reinterpret_cast<const unsigned char*>(validMd5->data()), validMd5->size());
+	}
+}
+
 bool ISO5436_2Container::ReadMd5FromFile(const String& fileName, std::array<unsigned char, 16>& checksum) const
 {
 #ifdef _UNICODE
@@ -306,6 +618,17 @@ bool ISO5436_2Container::ReadMd5FromFile(const String& fileName, std::array<unsi
 	return md5.ConvertToMd5(checksum);
 }
 
+bool ISO5436_2Container::ReadMd5FromStream(std::istream& stream, std::array<unsigned char, 16>& checksum) const
+{
+	std::string text;
+	stream >> text;
+
+	String md5;
+	md5.FromChar(text.c_str());
+
+	return md5.ConvertToMd5(checksum);
+}
+
 void ISO5436_2Container::Create(
 	const Schemas::ISO5436_2::Record1Type& record1,
 	const Schemas::ISO5436_2::Record2Type* record2,
@@ -321,7 +644,7 @@ void ISO5436_2Container::Create(
 			_EX_T("ISO5436_2Container::Create"));
 	}
 
-	CreateDocument(&record1, record2, &matrixDimension, 0, useBinaryData);
+	CreateDocument(&record1, record2, &matrixDimension, 0, useBinaryData, true);
 }
 
 void ISO5436_2Container::Create(
@@ -339,18 +662,316 @@ void ISO5436_2Container::Create(
 			_EX_T("ISO5436_2Container::Create"));
 	}
 
-	CreateDocument(&record1, record2, nullptr, listDimension, useBinaryData);
+	CreateDocument(&record1, record2, nullptr, listDimension, useBinaryData, true);
+}
+
+void ISO5436_2Container::CreateStream(
+	const Schemas::ISO5436_2::Record1Type& record1,
+	const Schemas::ISO5436_2::Record2Type* record2,
+	const Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+	int compressionLevel)
+{
+	assert(compressionLevel >= Z_DEFAULT_COMPRESSION && compressionLevel <= Z_BEST_COMPRESSION);
+
+	if (HasDocument())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The document already exists."),
+			_EX_T("Close the existing document before you create another."),
+			_EX_T("ISO5436_2Container::CreateStream"));
+	}
+
+	if (HasByteSource())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The X3P archive is read from a byte source."),
+			_EX_T("Point data can be streamed to X3P archive files only. Use ISO5436_2::Create instead."),
+			_EX_T("ISO5436_2Container::CreateStream"));
+	}
+
+	CreateDocument(&record1, record2, &matrixDimension, 0, true, false);
+
+	try
+	{
+		m_CompressionLevel = compressionLevel;
+
+		CreateTempDir();
+
+		m_StreamFilePath = CreateContainerTempFilePath();
+		m_StreamHandle = zipOpen64(m_StreamFilePath.ToChar(), APPEND_STATUS_CREATE);
+
+		if (!m_StreamHandle)
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("The X3P archive could not be written."),
+				_EX_T("Zlib library could not create a handle to the X3P target file. Check your permissions on the temporary directory."),
+				_EX_T("OpenGPS::ISO5436_2Container::CreateStream"));
+		}
+
+		// Create point parser for this document
+		PointVectorParserBuilder p_builder;
+		BuildPointVectorParser(p_builder);
+
+		m_StreamParser = p_builder.GetParser();
+
+		// Creates the binary point data file in the zip container.
+		// Point vectors are compressed as soon as they get appended.
+		m_StreamContext = CreatePointVectorWriterContext(m_StreamHandle);
+		m_StreamIndex = std::make_unique<PointVectorProxyContextMatrix>(GetMaxU(), GetMaxV(), GetMaxW());
+
+		assert(m_StreamContext);
+
+		// Invalid point vectors are stored with zero components. Floating
+		// point types have special values set for beeing "invalid" instead.
+		m_StreamInvalidVector = std::make_unique<PointVector>();
+		SetInvalidDataPoint(*m_StreamInvalidVector->GetX(), GetXaxisDataType(), false);
+		SetInvalidDataPoint(*m_StreamInvalidVector->GetY(), GetYaxisDataType(), false);
+		SetInvalidDataPoint(*m_StreamInvalidVector->GetZ(), GetZaxisDataType(), true);
+
+		// Integer types need an external validity file.
+		const auto zType{ GetZaxisDataType() };
+		if (zType == OGPS_Int16PointType || zType == OGPS_Int32PointType)
+		{
+			m_StreamValidity = std::make_unique<StreamValidBuffer>(CreateContainerTempFilePath(), GetPointCount());
+		}
+	}
+	catch (...)
+	{
+		Reset();
+		RemoveTempDir();
+		throw;
+	}
+}
+
+void ISO5436_2Container::AppendMatrixPoint(const PointVector* vector)
+{
+	CheckDocumentInstance();
+
+	if (!IsStreaming())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("Attempt to append a data point to a document that is not streamed."),
+			_EX_T("Data points can be appended only to documents created with the CreateStream method. Use SetMatrixPoint instead."),
+			_EX_T("OpenGPS::ISO5436_2Container::AppendMatrixPoint"));
+	}
+
+	if (m_StreamCount >= GetPointCount())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("Index out of range."),
+			_EX_T("All data points of the current matrix topology have already been appended."),
+			_EX_T("OpenGPS::ISO5436_2Container::AppendMatrixPoint"));
+	}
+
+	assert(!vector || vector->GetZ()->GetPointType() != OGPS_MissingPointType);
+
+	if (vector)
+	{
+		m_StreamParser->Write(*m_StreamContext, *vector);
+	}
+	else
+	{
+		m_StreamParser->Write(*m_StreamContext, *m_StreamInvalidVector);
+
+		if (m_StreamValidity)
+		{
+			m_StreamValidity->SetValid(m_StreamIndex->GetIndex(), false);
+		}
+	}
+
+	m_StreamContext->MoveNext();
+	m_StreamIndex->IncrementIndex();
+
+	++m_StreamCount;
+}
+
+bool ISO5436_2Container::Visit(const PointBlockVisitor& visitor, size_t blockSize)
+{
+	CheckDocumentInstance();
+
+	if (!HasVectorBuffer() && m_IsCreating)
+	{
+		CheckPointBufferInstance();
+	}
+
+	const auto count{ GetPointCount() };
+	const auto capacity{ std::max<size_t>(std::min(blockSize > 0 ? blockSize : OGPS_DEFAULT_POINT_BLOCK_SIZE, count), 1) };
+
+	PointBlockBuffer block(GetXaxisDataType(), GetYaxisDataType(), GetZaxisDataType(), capacity);
+
+	if (HasVectorBuffer())
+	{
+		return VisitPointBuffer(block, visitor);
+	}
+
+	return VisitArchive(block, visitor);
+}
+
+bool ISO5436_2Container::VisitPointBuffer(PointBlockBuffer& block, const PointBlockVisitor& visitor)
+{
+	auto vectorBuffer{ GetVectorBuffer() };
+	auto context{ CreatePointVectorProxyContext() };
+	auto vector{ vectorBuffer->CreatePointVectorProxy(context) };
+	const auto provider{ vectorBuffer->GetValidityProvider() };
+	const auto count{ GetPointCount() };
+
+	for (size_t n = 0; n < count; ++n)
+	{
+		block.Append(*vector, provider->IsValid(context->GetIndex()));
+
+		if (block.IsFull() && !VisitBlock(block, visitor))
+		{
+			return false;
+		}
+
+		context->IncrementIndex();
+	}
+
+	return VisitBlock(block, visitor);
+}
+
+bool ISO5436_2Container::VisitArchive(PointBlockBuffer& block, const PointBlockVisitor& visitor)
+{
+	assert(HasDocument());
+
+	// Buffers must outlive the streams reading from them
+	std::unique_ptr<ZipInputStreamBuffer> dataBuffer;
+	std::unique_ptr<ZipInputStreamBuffer> validBuffer;
+	std::unique_ptr<std::istream> validStream;
+	std::unique_ptr<StreamValidReader> validity;
+	std::unique_ptr<PointVectorReaderContext> context;
+
+	const auto count{ GetPointCount() };
+	const auto zType{ GetZaxisDataType() };
+	const auto allowInvalidPoints{ !IsPointCloud() };
+	const auto inlineValidity{ zType == OGPS_FloatPointType || zType == OGPS_DoublePointType };
+
+	if (IsBinary())
+	{
+		dataBuffer = OpenArchiveEntry(GetPointDataArchiveName());
+		context = CreateBinaryPointVectorReaderContext(std::make_unique<std::istream>(dataBuffer.get()));
+
+		// Validity of integer types is kept in a separate bit array
+		if (HasValidPointsLink() && allowInvalidPoints && !inlineValidity)
+		{
+			validBuffer = OpenArchiveEntry(GetValidPointsArchiveName());
+			validStream = std::make_unique<std::istream>(validBuffer.get());
+
+			// Storage order equals the order of the bit array unless there are several layers
+			const auto sequential{ !IsMatrix() || GetMaxW() == 1 };
+			validity = std::make_unique<StreamValidReader>(*validStream, count, sequential);
+		}
+	}
+	else
+	{
+		context = CreatePointVectorReaderContext();
+	}
+
+	if (!context)
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The point data of the X3P archive could not be accessed."),
+			_EX_T("The ISO5436-2 XML document neither links to binary point data nor does it contain a list of point data."),
+			_EX_T("OpenGPS::ISO5436_2Container::VisitArchive"));
+	}
+
+	PointVectorParserBuilder builder;
+	BuildPointVectorParser(builder);
+
+	auto parser{ builder.GetParser() };
+	auto proxy_context{ CreatePointVectorProxyContext() };
+
+	PointVector vector;
+
+	for (size_t n = 0; n < count && context->MoveNext(); ++n)
+	{
+		auto valid{ context->IsValid() };
+
+		if (valid)
+		{
+			parser->Read(*context, vector);
+
+			if (allowInvalidPoints)
+			{
+				if (validity)
+				{
+					valid = validity->IsValid(proxy_context->GetIndex());
+				}
+				else if (inlineValidity)
+				{
+					valid = !std::isnan(vector.GetZ()->Get());
+				}
+			}
+		}
+
+		block.Append(vector, valid);
+
+		if (block.IsFull() && !VisitBlock(block, visitor))
+		{
+			return false;
+		}
+
+		proxy_context->IncrementIndex();
+	}
+
+	if (!VisitBlock(block, visitor))
+	{
+		return false;
+	}
+
+	if (!dataBuffer)
+	{
+		return true;
+	}
+
+	const auto dataComplete{ dataBuffer->Finish() };
+	const auto validComplete{ !validBuffer || validBuffer->Finish() };
+
+	if (!dataComplete || !validComplete)
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("A resource contained in an X3P archive could not be decompressed."),
+			_EX_T("Please check whether the X3P archive is corrupted using a zip file utility of your choice, then repair the archive and try again."),
+			_EX_T("OpenGPS::ISO5436_2Container::VisitArchive"));
+	}
+
+	const auto& dataLink{ m_Document->Record3().DataLink() };
+	std::array<unsigned char, 16> md5{};
+
+	dataBuffer->GetMd5(md5);
+	m_DataBinChecksum = dataLink.present() &&
+		CompareChecksum(md5, reinterpret_cast<const unsigned char*>(dataLink->MD5ChecksumPointData().data()), dataLink->MD5ChecksumPointData().size());
+
+	if (validBuffer)
+	{
+		validBuffer->GetMd5(md5);
+		m_ValidBinChecksum = dataLink.present() && dataLink->MD5ChecksumValidPoints().present() &&
+			CompareChecksum(md5, reinterpret_cast<const unsigned char*>(dataLink->MD5ChecksumValidPoints()->data()), dataLink->MD5ChecksumValidPoints()->size());
+	}
+
+	TestChecksums();
+
+	return true;
 }
 
 PointIteratorAutoPtr ISO5436_2Container::CreateNextPointIterator()
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 	return std::make_unique<PointIteratorImpl>(shared_from_this(), true, IsMatrix());
 }
 
 PointIteratorAutoPtr ISO5436_2Container::CreatePrevPointIterator()
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 	return std::make_unique<PointIteratorImpl>(shared_from_this(), false, IsMatrix());
 }
 
@@ -361,26 +982,28 @@ void ISO5436_2Container::SetMatrixPoint(
 	const PointVector* vector)
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 
 	assert(IsMatrix());
 	assert(m_PointVector);
 	assert(m_ProxyContext);
 #ifdef _DEBUG
-	OGPS_Int32 value_x{ -1 }, value_y{ -1 };
+	// Indexes of incremental axes are stored as OGPS_Int32 or OGPS_Double, see SetIncrementalIndex.
+	OGPS_Double value_x{ -1 }, value_y{ -1 };
 	if (vector != nullptr)
 	{
-		if (vector->GetX()->GetPointType() == OGPS_Int32PointType)
+		if (vector->GetX()->GetPointType() == OGPS_Int32PointType || vector->GetX()->GetPointType() == OGPS_DoublePointType)
 		{
-			vector->GetX()->Get(&value_x);
+			value_x = vector->GetX()->Get();
 		}
-		if (vector->GetY()->GetPointType() == OGPS_Int32PointType)
+		if (vector->GetY()->GetPointType() == OGPS_Int32PointType || vector->GetY()->GetPointType() == OGPS_DoublePointType)
 		{
-			vector->GetY()->Get(&value_y);
+			value_y = vector->GetY()->Get();
 		}
 	}
 
-	assert(!vector || (IsIncrementalX() && vector->GetX()->GetPointType() == OGPS_MissingPointType || (value_x >= 0 && u == static_cast<size_t>(value_x))) || (!IsIncrementalX() && vector->GetX()->GetPointType() != OGPS_MissingPointType));
-	assert(!vector || (IsIncrementalY() && vector->GetY()->GetPointType() == OGPS_MissingPointType || (value_y >= 0 && v == static_cast<size_t>(value_y))) || (!IsIncrementalY() && vector->GetY()->GetPointType() != OGPS_MissingPointType));
+	assert(!vector || (IsIncrementalX() && vector->GetX()->GetPointType() == OGPS_MissingPointType || (value_x >= 0 && static_cast<OGPS_Double>(u) == value_x)) || (!IsIncrementalX() && vector->GetX()->GetPointType() != OGPS_MissingPointType));
+	assert(!vector || (IsIncrementalY() && vector->GetY()->GetPointType() == OGPS_MissingPointType || (value_y >= 0 && static_cast<OGPS_Double>(v) == value_y)) || (!IsIncrementalY() && vector->GetY()->GetPointType() != OGPS_MissingPointType));
 	assert(!vector || vector->GetZ()->GetPointType() != OGPS_MissingPointType);
 #endif
 
@@ -395,6 +1018,8 @@ void ISO5436_2Container::SetMatrixPoint(
 
 	std::dynamic_pointer_cast<PointVectorProxyContextMatrix>(m_ProxyContext)->SetIndex(u, v, w);
 
+	m_CanCopyPointData = false;
+
 	if (vector)
 	{
 		m_PointVector->Set(*vector);
@@ -407,12 +1032,12 @@ void ISO5436_2Container::GetMatrixPoint(
 	size_t u,
 	size_t v,
 	size_t w,
-	PointVector& vector)
+	PointVector& vector) const
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 
 	assert(IsMatrix());
-	assert(m_PointVector);
 	assert(m_ProxyContext);
 
 	if (!m_ProxyContext->IsMatrix())
@@ -424,11 +1049,12 @@ void ISO5436_2Container::GetMatrixPoint(
 			_EX_T("OpenGPS::ISO5436_2Container::GetMatrixPoint"));
 	}
 
-	std::dynamic_pointer_cast<PointVectorProxyContextMatrix>(m_ProxyContext)->SetIndex(u, v, w);
+	// Reads must not touch the shared proxy context, so concurrent readers each use their own index
+	const auto index{ dynamic_cast<const PointVectorProxyContextMatrix*>(m_ProxyContext.get())->GetIndex(u, v, w) };
 
-	if (GetVectorBuffer()->GetValidityProvider()->IsValid(m_ProxyContext->GetIndex()))
+	if (m_VectorBuffer->IsValid(index))
 	{
-		m_PointVector->Get(vector);
+		m_VectorBuffer->GetPoint(index, vector);
 	}
 	else
 	{
@@ -441,14 +1067,14 @@ void ISO5436_2Container::GetMatrixPoint(
 	{
 		assert(vector.GetX()->GetPointType() == OGPS_MissingPointType);
 
-		vector.SetX(ConvertToInt32(u));
+		SetIncrementalIndex(*vector.GetX(), u);
 	}
 
 	if (IsIncrementalY())
 	{
 		assert(vector.GetY()->GetPointType() == OGPS_MissingPointType);
 
-		vector.SetY(ConvertToInt32(v));
+		SetIncrementalIndex(*vector.GetY(), v);
 	}
 }
 
@@ -457,13 +1083,14 @@ void ISO5436_2Container::SetListPoint(
 	const PointVector& vector)
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 
 	assert(!IsMatrix());
 	assert(m_PointVector);
 	assert(m_ProxyContext);
 
-	assert((IsIncrementalX() && vector.GetX()->GetPointType() == OGPS_MissingPointType) || (!IsIncrementalX() && vector.GetX()->GetPointType() != OGPS_MissingPointType) || (IsIncrementalX() && vector.GetX()->GetPointType() == OGPS_Int32PointType));
-	assert((IsIncrementalY() && vector.GetY()->GetPointType() == OGPS_MissingPointType) || (!IsIncrementalY() && vector.GetY()->GetPointType() != OGPS_MissingPointType) || (IsIncrementalY() && vector.GetY()->GetPointType() == OGPS_Int32PointType));
+	assert((IsIncrementalX() && vector.GetX()->GetPointType() == OGPS_MissingPointType) || (!IsIncrementalX() && vector.GetX()->GetPointType() != OGPS_MissingPointType) || (IsIncrementalX() && (vector.GetX()->GetPointType() == OGPS_Int32PointType || vector.GetX()->GetPointType() == OGPS_DoublePointType)));
+	assert((IsIncrementalY() && vector.GetY()->GetPointType() == OGPS_MissingPointType) || (!IsIncrementalY() && vector.GetY()->GetPointType() != OGPS_MissingPointType) || (IsIncrementalY() && (vector.GetY()->GetPointType() == OGPS_Int32PointType || vector.GetY()->GetPointType() == OGPS_DoublePointType)));
 	assert(vector.GetZ()->GetPointType() != OGPS_MissingPointType);
 
 	if (m_ProxyContext->IsMatrix())
@@ -477,17 +1104,18 @@ void ISO5436_2Container::SetListPoint(
 
 	std::dynamic_pointer_cast<PointVectorProxyContextList>(m_ProxyContext)->SetIndex(index);
 
+	m_CanCopyPointData = false;
 	m_PointVector->Set(vector);
 }
 
 void ISO5436_2Container::GetListPoint(
 	size_t index,
-	PointVector& vector)
+	PointVector& vector) const
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 
 	assert(!IsMatrix());
-	assert(m_PointVector);
 	assert(m_ProxyContext);
 
 	if (m_ProxyContext->IsMatrix())
@@ -499,22 +1127,20 @@ void ISO5436_2Container::GetListPoint(
 			_EX_T("OpenGPS::ISO5436_2Container::GetListPoint"));
 	}
 
-	std::dynamic_pointer_cast<PointVectorProxyContextList>(m_ProxyContext)->SetIndex(index);
-
-	m_PointVector->Get(vector);
+	m_VectorBuffer->GetPoint(dynamic_cast<const PointVectorProxyContextList*>(m_ProxyContext.get())->GetIndex(index), vector);
 
 	if (IsIncrementalX())
 	{
 		assert(vector.GetX()->GetPointType() == OGPS_MissingPointType);
 
-		vector.SetX(ConvertToInt32(index));
+		SetIncrementalIndex(*vector.GetX(), index);
 	}
 
 	if (IsIncrementalY())
 	{
 		assert(vector.GetY()->GetPointType() == OGPS_MissingPointType);
 
-		vector.SetY(ConvertToInt32(index));
+		SetIncrementalIndex(*vector.GetY(), index);
 	}
 }
 
@@ -524,7 +1150,7 @@ void ISO5436_2Container::GetMatrixCoord(
 	size_t w,
 	OGPS_Double* x,
 	OGPS_Double* y,
-	OGPS_Double* z)
+	OGPS_Double* z) const
 {
 	assert(HasDocument());
 	assert(IsMatrix());
@@ -537,11 +1163,13 @@ void ISO5436_2Container::GetMatrixCoord(
 bool ISO5436_2Container::IsMatrixCoordValid(
 	size_t u,
 	size_t v,
-	size_t w)
+	size_t w) const
 {
 	CheckDocumentInstance();
+	CheckPointBufferInstance();
 
 	assert(IsMatrix());
+	assert(m_ProxyContext);
 
 	if (!m_ProxyContext->IsMatrix())
 	{
@@ -552,16 +1180,14 @@ bool ISO5436_2Container::IsMatrixCoordValid(
 			_EX_T("OpenGPS::ISO5436_2Container::IsMatrixCoordValid"));
 	}
 
-	std::dynamic_pointer_cast<PointVectorProxyContextMatrix>(m_ProxyContext)->SetIndex(u, v, w);
-
-	return GetVectorBuffer()->GetValidityProvider()->IsValid(m_ProxyContext->GetIndex());
+	return m_VectorBuffer->IsValid(dynamic_cast<const PointVectorProxyContextMatrix*>(m_ProxyContext.get())->GetIndex(u, v, w));
 }
 
 void ISO5436_2Container::GetListCoord(
 	size_t index,
 	OGPS_Double* x,
 	OGPS_Double* y,
-	OGPS_Double* z)
+	OGPS_Double* z) const
 {
 	assert(HasDocument());
 	assert(!IsMatrix());
@@ -575,7 +1201,7 @@ void ISO5436_2Container::ConvertPointToCoord(
 	const PointVector& vector,
 	OGPS_Double* x,
 	OGPS_Double* y,
-	OGPS_Double* z)
+	OGPS_Double* z) const
 {
 	OGPS_Double* myx = vector.GetX()->IsValid() ? x : nullptr;
 	OGPS_Double* myy = vector.GetY()->IsValid() ? y : nullptr;
@@ -627,15 +1253,61 @@ Schemas::ISO5436_2::ISO5436_2Type* ISO5436_2Container::GetDocument()
 	return m_Document.get();
 }
 
+const Schemas::ISO5436_2::ISO5436_2Type* ISO5436_2Container::GetDocument() const
+{
+	return m_Document.get();
+}
+
 void ISO5436_2Container::Write(int compressionLevel)
+{
+	WriteArchive(nullptr, compressionLevel);
+}
+
+void ISO5436_2Container::Write(std::vector<unsigned char>& target, int compressionLevel)
+{
+	WriteArchive(&target, compressionLevel);
+}
+
+void ISO5436_2Container::WriteArchive(std::vector<unsigned char>* target, int compressionLevel)
 {
 	assert(compressionLevel >= Z_DEFAULT_COMPRESSION && compressionLevel <= Z_BEST_COMPRESSION);
 
 	CheckDocumentInstance();
 
+	if (IsPartial())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The document has been opened partially."),
+			_EX_T("Only some rows or layers of the matrix have been loaded as requested by the open options, so the X3P archive cannot be written back."),
+			_EX_T("OpenGPS::ISO5436_2Container::Write"));
+	}
+
+	if (target && IsStreaming())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("Point data is streamed to the X3P archive file."),
+			_EX_T("An X3P archive created with ISO5436_2::CreateStream can only be written to its file."),
+			_EX_T("OpenGPS::ISO5436_2Container::Write"));
+	}
+
 	m_CompressionLevel = compressionLevel;
 
-	Compress();
+	if (IsStreaming())
+	{
+		CompressStream();
+	}
+	else
+	{
+		// Unmodified point data needs not be loaded to be written back
+		if (!m_CanCopyPointData)
+		{
+			CheckPointBufferInstance();
+		}
+
+		Compress(target);
+	}
 
 	ValidateDocument();
 }
@@ -770,6 +1442,37 @@ size_t ISO5436_2Container::GetListDimension() const
 	return ConvertToSizeT(m_Document->Record3().ListDimension().get());
 }
 
+unsigned long long ISO5436_2Container::GetPointDataSize() const
+{
+	CheckDocumentInstance();
+
+	if (!HasVectorBuffer())
+	{
+		return 0;
+	}
+
+	const auto count{ static_cast<unsigned long long>(GetPointCount()) };
+	auto size{ count * GetPointVectorSize() };
+
+	if (m_VectorBuffer->HasValidityBuffer())
+	{
+		size += count / 8 + (count % 8 != 0 ? 1 : 0);
+	}
+
+	// Only the resident pages of paged point data occupy memory
+	if (m_OpenOptions.pagedMemoryBudget > 0)
+	{
+		size = std::min<unsigned long long>(size, m_OpenOptions.pagedMemoryBudget);
+	}
+
+	return size;
+}
+
+void ISO5436_2Container::SetWriteOptions(const OGPS_WriteOptions& options)
+{
+	m_WriteOptions = options;
+}
+
 String ISO5436_2Container::CreateContainerTempFilePath() const
 {
 	auto env = Environment::GetInstance();
@@ -777,6 +1480,31 @@ String ISO5436_2Container::CreateContainerTempFilePath() const
 	return env->ConcatPathes(GetTempDir(), env->GetUniqueName());
 }
 
+bool ISO5436_2Container::HasByteSource() const
+{
+	return m_Source != nullptr;
+}
+
+std::shared_ptr<const ByteSource> ISO5436_2Container::GetByteSource() const
+{
+	if (HasByteSource())
+	{
+		return m_Source;
+	}
+
+	return std::make_shared<FileByteSource>(GetFullFilePath());
+}
+
+std::shared_ptr<ZipDirectory> ISO5436_2Container::GetDirectory() const
+{
+	if (!m_Directory)
+	{
+		m_Directory = std::make_shared<ZipDirectory>(GetByteSource());
+	}
+
+	return m_Directory;
+}
+
 String ISO5436_2Container::GetFullFilePath() const
 {
 	// TODO
@@ -877,22 +1605,21 @@ void ISO5436_2Container::DecompressDataBin()
 	if (IsBinary())
 	{
 		_VERIFY(Decompress(GetPointDataArchiveName(), GetPointDataFileName()), true);
-		VerifyDataBinChecksum();
 
 		if (HasValidPointsLink())
 		{
 			_VERIFY(Decompress(GetValidPointsArchiveName(), GetValidPointsFileName()), true);
-			VerifyValidBinChecksum();
 		}
+
+		VerifyBinChecksums();
 	}
 }
 
 bool ISO5436_2Container::Decompress(const String& src, const String& dst, const bool fileNotFoundAllowed) const
 {
-	auto filePath{ GetFullFilePath() };
-	auto handle{ unzOpen(filePath.ToChar()) };
+	const auto directory{ GetDirectory() };
 
-	if (!handle)
+	if (directory->GetSource()->GetSize() == 0)
 	{
 		/* Todo: Wiora: Should provide information about filename */
 		throw Exception(
@@ -902,6 +1629,9 @@ bool ISO5436_2Container::Decompress(const String& src, const String& dst, const
 			_EX_T("OpenGPS::ISO5436_2Container::Decompress"));
 	}
 
+	// Locate the document/file to be decompressed in the archive.
+	auto handle{ directory->Open(src) };
+
 	bool fileNotFound{};
 	bool fileNotOpened{};
 	bool targetNotWritten{};
@@ -909,52 +1639,26 @@ bool ISO5436_2Container::Decompress(const String& src, const String& dst, const
 
 	try
 	{
-		// Locate the document/file to be decompressed in the archive.
-		String srcbuf(src);
-		if (unzLocateFile(handle, srcbuf.ToChar(), 2 /* case insensitive search */) == UNZ_OK)
+		if (handle)
 		{
-			// Open the current file for reading.
-			if (unzOpenCurrentFile(handle) == UNZ_OK)
+			// Open the current file for reading raw data. Decompression is done by the codec.
+			int method{};
+			int level{};
+			if (unzOpenCurrentFile2(handle, &method, &level, 1) == UNZ_OK)
 			{
 				// Need information about file size
-				unz_file_info fileInfo;
-				if (unzGetCurrentFileInfo(handle, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK)
-				{
-					// Open binary target stream for uncompressed data
-					OutputBinaryFileStream binaryTarget(dst);
-
-					if (!binaryTarget.fail())
-					{
-						uLong written{ 0 };
-						const auto length{ fileInfo.uncompressed_size };
-
-						// Don't uncompress this file as a whole, but in loops
-						// of a predefined maximum chunk size. Otherwise we
-						// might get out of memory...
-						while (written < length)
-						{
-							auto size{ static_cast<int>(std::min(length - written, static_cast<uLong>(_OPENGPS_ZIP_CHUNK_MAX))) };
-
-							assert(size > 0);
-
-							auto buffer = std::make_unique<char[]>(size);
-							auto bytesCopied{ unzReadCurrentFile(handle, buffer.get(), size) };
-
-							if (bytesCopied == size)
-							{
-								binaryTarget.write(buffer.get(), bytesCopied);
-							}
-
-							if (bytesCopied != size || binaryTarget.fail())
-							{
-								written = 0;
-								break;
-							}
+				unz_file_info64 fileInfo;
+				auto inflater{ unzGetCurrentFileInfo64(handle, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK ?
+					ZipCodec::CreateEntryInflater(method, fileInfo.compressed_size, fileInfo.uncompressed_size) : nullptr };
 
-							written += size;
-						}
+				if (inflater)
+				{
+					// Open binary target stream for uncompressed data
+					OutputBinaryFileStream binaryTarget(dst);
 
-						success = (written == length);
+					if (!binaryTarget.fail())
+					{
+						success = InflateCurrentFile(handle, *inflater, fileInfo.uncompressed_size, fileInfo.crc, binaryTarget);
 					}
 					else
 					{
@@ -982,11 +1686,11 @@ bool ISO5436_2Container::Decompress(const String& src, const String& dst, const
 	}
 	catch (...)
 	{
-		_VERIFY(unzClose(handle), UNZ_OK);
+		directory->Close(handle);
 		throw;
 	}
 
-	_VERIFY(unzClose(handle), UNZ_OK);
+	directory->Close(handle);
 
 	if (fileNotFound && !fileNotFoundAllowed)
 	{
@@ -1030,7 +1734,7 @@ bool ISO5436_2Container::Decompress(const String& src, const String& dst, const
 	return success;
 }
 
-void ISO5436_2Container::Compress()
+void ISO5436_2Container::Compress(std::vector<unsigned char>* target)
 {
 	bool noHandleCreated{};
 	bool vendorfilesAdded{ true };
@@ -1038,10 +1742,26 @@ void ISO5436_2Container::Compress()
 
 	String systemErrorMessage;
 
-	CreateTempDir();
+	// Archives written to memory replace their target when complete,
+	// since unmodified point data may be copied from the current archive.
+	String targetZip;
+	std::unique_ptr<ZipMemoryArchive> targetMemory;
+	zipFile handle{};
+
+	if (target || HasByteSource())
+	{
+		zlib_filefunc64_def functions;
+		targetMemory = std::make_unique<ZipMemoryArchive>();
+		targetMemory->Fill(functions);
+		handle = zipOpen2_64(targetZip.ToChar(), APPEND_STATUS_CREATE, nullptr, &functions);
+	}
+	else
+	{
+		CreateTempDir();
 
-	auto targetZip{ CreateContainerTempFilePath() };
-	auto handle{ zipOpen(targetZip.ToChar(), APPEND_STATUS_CREATE) };
+		targetZip = CreateContainerTempFilePath();
+		handle = zipOpen64(targetZip.ToChar(), APPEND_STATUS_CREATE);
+	}
 
 	try
 	{
@@ -1049,9 +1769,18 @@ void ISO5436_2Container::Compress()
 		{
 			try
 			{
-				SavePointBuffer(handle);
-				vendorfilesAdded = WriteVendorSpecific(handle);
-				SaveValidPointsLink(handle);
+				if (m_CanCopyPointData)
+				{
+					CopyPointData(handle);
+					vendorfilesAdded = WriteVendorSpecific(handle);
+				}
+				else
+				{
+					SavePointBuffer(handle);
+					vendorfilesAdded = WriteVendorSpecific(handle);
+					SaveValidPointsLink(handle);
+				}
+
 				SaveXmlDocument(handle);
 
 				success = true;
@@ -1070,7 +1799,18 @@ void ISO5436_2Container::Compress()
 
 		if (success)
 		{
-			if (!Environment::GetInstance()->RenameFile(targetZip, GetFullFilePath()))
+			// The directory refers to the archive being replaced.
+			m_Directory.reset();
+
+			if (target)
+			{
+				target->swap(targetMemory->GetData());
+			}
+			else if (HasByteSource())
+			{
+				m_Source = std::make_shared<MemoryByteSource>(std::move(targetMemory->GetData()));
+			}
+			else if (!Environment::GetInstance()->RenameFile(targetZip, GetFullFilePath()))
 			{
 				systemErrorMessage = Environment::GetInstance()->GetLastErrorMessage();
 			}
@@ -1112,12 +1852,131 @@ void ISO5436_2Container::Compress()
 	}
 }
 
+void ISO5436_2Container::CompressStream()
+{
+	assert(IsStreaming());
+
+	if (m_StreamCount != GetPointCount())
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("The X3P archive could not be written."),
+			_EX_T("Not all data points of the current matrix topology have been appended yet. Append the missing data points before writing the X3P archive."),
+			_EX_T("OpenGPS::ISO5436_2Container::CompressStream"));
+	}
+
+	bool vendorfilesAdded{ true };
+
+	String systemErrorMessage;
+
+	try
+	{
+		auto binaryContext{ dynamic_cast<BinaryPointVectorWriterContext*>(m_StreamContext.get()) };
+
+		assert(binaryContext);
+
+		std::array<unsigned char, 16> md5{};
+		binaryContext->GetMd5(md5);
+		const Schemas::ISO5436_2::DataLinkType::MD5ChecksumPointData_type checksum(md5.data(), md5.size());
+		m_Document->Record3().DataLink()->MD5ChecksumPointData(checksum);
+
+		if (!binaryContext->Close())
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("Could not write binary point data to the X3P archive."),
+				_EX_T("The compressed point data could not be stored completely. Check for filesystem permissions and enough space left."),
+				_EX_T("OpenGPS::ISO5436_2Container::CompressStream"));
+		}
+
+		ResetValidPointsLink();
+
+		vendorfilesAdded = WriteVendorSpecific(m_StreamHandle);
+		SaveValidPointsLink(m_StreamHandle);
+		SaveXmlDocument(m_StreamHandle);
+
+		const auto handle{ m_StreamHandle };
+		m_StreamHandle = nullptr;
+
+		_VERIFY(zipClose(handle, nullptr), ZIP_OK);
+
+		m_Directory.reset();
+
+		if (!Environment::GetInstance()->RenameFile(m_StreamFilePath, GetFullFilePath()))
+		{
+			systemErrorMessage = Environment::GetInstance()->GetLastErrorMessage();
+		}
+	}
+	catch (...)
+	{
+		CloseStream();
+		RemoveTempDir();
+		throw;
+	}
+
+	CloseStream();
+	RemoveTempDir();
+
+	if (!systemErrorMessage.empty())
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The X3P archive could not be copied from the temporary directory to its target filename."),
+			systemErrorMessage.ToChar(),
+			_EX_T("OpenGPS::ISO5436_2Container::CompressStream"));
+	}
+
+	if (!vendorfilesAdded)
+	{
+		throw Exception(
+			OGPS_ExWarning,
+			_EX_T("At least some of the vendorspecific files supplied could not be added to the X3P archive."),
+			_EX_T("Please verify that the files containing additional data still exist on the filesystem at this time. Also check for enuogh file system space left and permissions."),
+			_EX_T("OpenGPS::ISO5436_2Container::CompressStream"));
+	}
+}
+
+void ISO5436_2Container::CloseStream()
+{
+	m_StreamValidity.reset();
+	m_StreamInvalidVector.reset();
+	m_StreamIndex.reset();
+
+	// Closes the point data file before the archive itself.
+	m_StreamContext.reset();
+	m_StreamParser.reset();
+	m_StreamCount = 0;
+
+	if (m_StreamHandle)
+	{
+		zipClose(m_StreamHandle, nullptr);
+		m_StreamHandle = nullptr;
+	}
+
+	if (!m_StreamFilePath.empty())
+	{
+		const auto env{ Environment::GetInstance() };
+		if (env->PathExists(m_StreamFilePath))
+		{
+			env->RemoveFile(m_StreamFilePath);
+		}
+
+		m_StreamFilePath.clear();
+	}
+}
+
+bool ISO5436_2Container::IsStreaming() const
+{
+	return m_StreamHandle != nullptr;
+}
+
 void ISO5436_2Container::CreateDocument(
 	const Schemas::ISO5436_2::Record1Type* record1,
 	const Schemas::ISO5436_2::Record2Type* record2,
 	const Schemas::ISO5436_2::MatrixDimensionType* matrixDimension,
 	size_t listDimension,
-	bool useBinaryData)
+	bool useBinaryData,
+	bool createPointBuffer)
 {
 	assert(!HasDocument());
 	assert(record1);
@@ -1156,13 +2015,16 @@ void ISO5436_2Container::CreateDocument(
 		}
 
 		// Build and setup internal point buffer
-		VectorBufferBuilder v_builder;
-		if (BuildVectorBuffer(v_builder))
+		if (createPointBuffer)
 		{
-			m_VectorBuffer = v_builder.GetBuffer();
+			VectorBufferBuilder v_builder;
+			if (BuildVectorBuffer(v_builder))
+			{
+				m_VectorBuffer = v_builder.GetBuffer();
+			}
+			m_ProxyContext = CreatePointVectorProxyContext();
+			m_PointVector = GetVectorBuffer()->CreatePointVectorProxy(m_ProxyContext);
 		}
-		m_ProxyContext = CreatePointVectorProxyContext();
-		m_PointVector = GetVectorBuffer()->CreatePointVectorProxy(m_ProxyContext);
 	}
 	catch (...)
 	{
@@ -1173,16 +2035,16 @@ void ISO5436_2Container::CreateDocument(
 	m_IsCreating = true;
 }
 
-void ISO5436_2Container::ReadDocument()
+void ISO5436_2Container::ReadDocument(std::istream* stream)
 {
 	assert(!HasDocument());
 
-	ReadXmlDocument();
+	ReadXmlDocument(stream);
 
 	assert(HasDocument());
 }
 
-void ISO5436_2Container::ReadXmlDocument()
+void ISO5436_2Container::ReadXmlDocument(std::istream* stream)
 {
 	xml_schema::properties props;
 	if (!ConfigureNamespaceMap(props))
@@ -1194,11 +2056,19 @@ void ISO5436_2Container::ReadXmlDocument()
 			_EX_T("OpenGPS::ISO5436_2Container::ReadXmlDocument"));
 	}
 
-	String xmlFilePath = GetMainFileName();
-
 	try
 	{
-		m_Document = Schemas::ISO5436_2::ISO5436_2(xmlFilePath, 0, props);
+		std::lock_guard<std::mutex> lock(GetXercesMutex());
+
+		if (stream)
+		{
+			m_Document = Schemas::ISO5436_2::ISO5436_2(*stream, 0, props);
+		}
+		else
+		{
+			String xmlFilePath = GetMainFileName();
+			m_Document = Schemas::ISO5436_2::ISO5436_2(xmlFilePath, 0, props);
+		}
 	}
 	catch (const xml_schema::exception& e)
 	{
@@ -1208,57 +2078,351 @@ void ISO5436_2Container::ReadXmlDocument()
 		std::ostringstream dump;
 #endif
 
-		dump << e;
+		dump << e;
+
+		String m(dump.str());
+
+		throw Exception(
+			OGPS_ExGeneral,
+			e.what(),
+			m.ToChar(),
+			nullptr);
+	}
+}
+
+void ISO5436_2Container::CreatePointBuffer()
+{
+	assert(HasDocument());
+
+	// Cached point data has been mapped already
+	if (!HasVectorBuffer())
+	{
+		DecodePointBuffer();
+		StoreCachedPointBuffer();
+	}
+
+	// When the point buffer has been created,
+	// we can savely drop the original xml content
+	ResetXmlPointList();
+
+	// initialize global vector proxy
+	m_ProxyContext = CreatePointVectorProxyContext();
+	m_PointVector = GetVectorBuffer()->CreatePointVectorProxy(m_ProxyContext);
+}
+
+void ISO5436_2Container::DecodePointBuffer()
+{
+	assert(!HasVectorBuffer());
+	assert(HasDocument());
+
+	// Build and setup internal point buffer
+	VectorBufferBuilder v_builder;
+	if (BuildVectorBuffer(v_builder))
+	{
+		m_VectorBuffer = v_builder.GetBuffer();
+	}
+
+	auto vectorBuffer{ GetVectorBuffer() };
+
+	if (IsPartial() && IsBinary())
+	{
+		// Position of the first point vector requested within the source matrix
+		auto position{ SafeMultipilcation(m_OpenOptions.firstLayer * m_SourceMaxV + m_OpenOptions.firstRow, GetMaxU()) };
+
+		// Buffers must outlive the streams reading from them
+		std::shared_ptr<const ZipEntryIndex> index;
+		std::unique_ptr<std::streambuf> dataBuffer;
+		std::unique_ptr<ZipInputStreamBuffer> validBuffer;
+		std::unique_ptr<std::istream> validStream;
+		std::unique_ptr<StreamValidReader> validity;
+
+		if (HasValidPointsLink() && vectorBuffer->HasValidityBuffer())
+		{
+			validBuffer = OpenArchiveEntry(GetValidPointsArchiveName());
+			validStream = std::make_unique<std::istream>(validBuffer.get());
+
+			// Storage order equals the order of the bit array unless there are several layers
+			const auto sourceCount{ SafeMultipilcation(SafeMultipilcation(GetMaxU(), m_SourceMaxV), m_SourceMaxW) };
+			validity = std::make_unique<StreamValidReader>(*validStream, sourceCount, m_SourceMaxW == 1);
+		}
+
+		// Start decompressing at the access point nearest to the first row requested.
+		// The index reads compressed data from the byte source directly.
+		const auto directory{ GetDirectory() };
+		if (position > 0 && m_OpenOptions.indexSpan > 0)
+		{
+			index = ZipEntryIndex::Get(*directory, GetPointDataArchiveName(), m_OpenOptions.indexSpan);
+		}
+
+		if (index)
+		{
+			dataBuffer = index->CreateStreamBuffer(directory->GetSource(), SafeMultipilcation(position, GetPointVectorSize()));
+		}
+
+		if (!dataBuffer)
+		{
+			position = 0;
+			dataBuffer = OpenArchiveEntry(GetPointDataArchiveName());
+		}
+
+		// Only the archive entry up to the last row requested gets decompressed
+		auto context{ CreateBinaryPointVectorReaderContext(std::make_unique<std::istream>(dataBuffer.get())) };
+		ReadPointBuffer(*context, validity.get(), position);
+	}
+	else if ((HasByteSource() || m_OpenOptions.pipelineBuffers > 0) && IsBinary())
+	{
+		// Binary point data is decompressed from the archive while being read,
+		// pipelined decompression already starts while valid points are read.
+		auto dataBuffer{ OpenArchiveEntry(GetPointDataArchiveName(), m_OpenOptions.pipelineBuffers) };
+
+		if (HasValidPointsLink())
+		{
+			auto validBuffer{ OpenArchiveEntry(GetValidPointsArchiveName()) };
+
+			if (vectorBuffer->HasValidityBuffer())
+			{
+				std::istream vstream(validBuffer.get());
+				vectorBuffer->GetValidityBuffer()->Read(vstream);
+			}
+
+			VerifyValidBinChecksum(*validBuffer);
+		}
+
+		auto context{ CreateBinaryPointVectorReaderContext(std::make_unique<std::istream>(dataBuffer.get())) };
+		ReadPointBuffer(*context, nullptr, 0);
+
+		VerifyDataBinChecksum(*dataBuffer);
+	}
+	else
+	{
+		// read valid points file
+		if (HasValidPointsLink() && vectorBuffer->HasValidityBuffer())
+		{
+			InputBinaryFileStream vstream(GetValidPointsFileName());
+			vectorBuffer->GetValidityBuffer()->Read(vstream);
+		}
+
+		auto context{ CreatePointVectorReaderContext() };
+
+		assert(context);
+
+		ReadPointBuffer(*context, nullptr, 0);
+	}
+}
+
+std::unique_ptr<SurfaceCache> ISO5436_2Container::CreateSurfaceCache() const
+{
+	if (m_OpenOptions.cacheBudget == 0)
+	{
+		return nullptr;
+	}
+
+	if (m_OpenOptions.cacheSharedMemory)
+	{
+		return std::make_unique<SurfaceCache>(m_OpenOptions.cacheBudget, m_OpenOptions.cacheSharedWithAllUsers);
+	}
+
+	if (!m_OpenOptions.cacheDirectory)
+	{
+		return nullptr;
+	}
+
+	const String directory{ m_OpenOptions.cacheDirectory };
+	if (directory.length() == 0 || !Environment::GetInstance()->PathExists(directory))
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<SurfaceCache>(directory, m_OpenOptions.cacheBudget);
+}
+
+bool ISO5436_2Container::GetSurfaceCacheKey(std::array<unsigned char, 16>& dataMd5, std::array<unsigned char, 16>& validMd5) const
+{
+	assert(HasDocument());
+
+	dataMd5.fill(0);
+	validMd5.fill(0);
+
+	if (!IsBinary() || IsPartial() || !m_Document->Record3().DataLink().present())
+	{
+		return false;
+	}
+
+	const auto& dataLink{ m_Document->Record3().DataLink() };
+	const auto& dataChecksum{ dataLink->MD5ChecksumPointData() };
+
+	if (dataChecksum.size() != dataMd5.size())
+	{
+		return false;
+	}
+
+	memcpy(dataMd5.data(), dataChecksum.data(), dataMd5.size());
+
+	if (HasValidPointsLink())
+	{
+		if (!dataLink->MD5ChecksumValidPoints().present() || dataLink->MD5ChecksumValidPoints()->size() != validMd5.size())
+		{
+			return false;
+		}
+
+		memcpy(validMd5.data(), dataLink->MD5ChecksumValidPoints()->data(), validMd5.size());
+	}
+
+	return true;
+}
+
+bool ISO5436_2Container::LoadCachedPointBuffer()
+{
+	assert(!HasVectorBuffer());
+
+	const auto cache{ CreateSurfaceCache() };
+
+	std::array<unsigned char, 16> dataMd5;
+	std::array<unsigned char, 16> validMd5;
+
+	if (!cache || !GetSurfaceCacheKey(dataMd5, validMd5))
+	{
+		return false;
+	}
+
+	const std::array<OGPS_DataPointType, 3> types{ GetXaxisDataType(), GetYaxisDataType(), GetZaxisDataType() };
+
+	size_t validSize{};
+	return UseCachedPointBuffer(cache->Load(dataMd5, validMd5, GetPointCount(), types, validSize), validSize);
+}
+
+bool ISO5436_2Container::UseCachedPointBuffer(std::shared_ptr<MappedStorage> mapped, size_t validSize)
+{
+	assert(!HasVectorBuffer());
+
+	if (!mapped)
+	{
+		return false;
+	}
+
+	VectorBufferBuilder v_builder;
+	if (!BuildVectorBuffer(v_builder, mapped))
+	{
+		return false;
+	}
+
+	const auto vectorBuffer{ v_builder.GetBuffer() };
+
+	if (validSize > 0)
+	{
+		if (!vectorBuffer->HasValidityBuffer())
+		{
+			return false;
+		}
+
+		vectorBuffer->GetValidityBuffer()->Read(mapped->Reserve(validSize), validSize);
+	}
 
-		String m(dump.str());
+	m_VectorBuffer = vectorBuffer;
 
-		throw Exception(
-			OGPS_ExGeneral,
-			e.what(),
-			m.ToChar(),
-			nullptr);
-	}
+	// Point data is cached only after its checksums have been verified
+	m_DataBinChecksum = true;
+	m_ValidBinChecksum = true;
+
+	return true;
 }
 
-void ISO5436_2Container::CreatePointBuffer()
+void ISO5436_2Container::StoreCachedPointBuffer()
 {
-	assert(!HasVectorBuffer());
-	assert(HasDocument());
+	assert(HasVectorBuffer());
 
-	// Build and setup internal point buffer
-	VectorBufferBuilder v_builder;
-	if (BuildVectorBuffer(v_builder))
+	// Only point data that has been verified gets cached
+	if (!m_DataBinChecksum || !m_ValidBinChecksum)
 	{
-		m_VectorBuffer = v_builder.GetBuffer();
+		return;
 	}
 
-	auto vectorBuffer{ GetVectorBuffer() };
+	const auto cache{ CreateSurfaceCache() };
 
-	// read valid points file
-	if (HasValidPointsLink() && vectorBuffer->HasValidityBuffer())
+	std::array<unsigned char, 16> dataMd5;
+	std::array<unsigned char, 16> validMd5;
+
+	if (cache && GetSurfaceCacheKey(dataMd5, validMd5))
 	{
-		InputBinaryFileStream vstream(GetValidPointsFileName());
-		vectorBuffer->GetValidityBuffer()->Read(vstream);
+		size_t validSize{};
+		const auto mapped{ cache->Store(dataMd5, validMd5, *GetVectorBuffer(), validSize) };
+
+		// Keep a single copy of the point data
+		if (mapped)
+		{
+			auto decoded{ std::move(m_VectorBuffer) };
+			if (!UseCachedPointBuffer(mapped, validSize))
+			{
+				m_VectorBuffer = std::move(decoded);
+			}
+		}
 	}
+}
+
+void ISO5436_2Container::ReadPointBuffer(PointVectorReaderContext& context, StreamValidReader* validity, size_t position)
+{
+	assert(!validity || IsPartial());
+	assert(position == 0 || IsPartial());
+
+	auto vectorBuffer{ GetVectorBuffer() };
 
 	// Create point parser for this document
 	PointVectorParserBuilder p_builder;
 	BuildPointVectorParser(p_builder);
 
 	auto parser{ p_builder.GetParser() };
-	auto context{ CreatePointVectorReaderContext() };
 	auto proxy_context{ CreatePointVectorProxyContext() };
 
-	assert(context);
 	assert(proxy_context);
 
 	auto vector{ vectorBuffer->CreatePointVectorProxy(proxy_context) };
 
-	while (context->MoveNext())
+	// Point vectors of rows and layers not requested are read into here
+	PointVector skipped;
+
+	const auto sizeU{ GetMaxU() };
+	const auto firstRow{ m_OpenOptions.firstRow };
+	const auto lastRow{ firstRow + GetMaxV() };
+	const auto lastPosition{ ((m_OpenOptions.firstLayer + GetMaxW() - 1) * m_SourceMaxV + lastRow) * sizeU };
+
+	for (; context.MoveNext(); ++position)
 	{
-		if (context->IsValid())
+		// Position within the matrix stored in the archive
+		size_t sourceIndex{};
+
+		if (IsPartial())
+		{
+			// Stop decompressing as soon as all rows requested have been read
+			if (position >= lastPosition)
+			{
+				break;
+			}
+
+			const auto u{ position % sizeU };
+			const auto v{ position / sizeU % m_SourceMaxV };
+			const auto w{ position / sizeU / m_SourceMaxV };
+
+			if (w < m_OpenOptions.firstLayer || v < firstRow || v >= lastRow)
+			{
+				if (context.IsValid())
+				{
+					parser->Read(context, skipped);
+				}
+
+				continue;
+			}
+
+			sourceIndex = (v * sizeU + u) * m_SourceMaxW + w;
+		}
+
+		if (context.IsValid())
 		{
-			parser->Read(*context, *vector);
+			parser->Read(context, *vector);
+
+			if (validity && !validity->IsValid(sourceIndex))
+			{
+				vectorBuffer->GetValidityProvider()->SetValid(proxy_context->GetIndex(), false);
+			}
 		}
 		else
 		{
@@ -1270,14 +2434,51 @@ void ISO5436_2Container::CreatePointBuffer()
 
 		proxy_context->IncrementIndex();
 	}
+}
 
-	// When the point buffer has been created,
-	// we can savely drop the original xml content
-	ResetXmlPointList();
+void ISO5436_2Container::ApplyOpenWindow()
+{
+	assert(HasDocument() && !IsPartial());
 
-	// initialize global vector proxy
-	m_ProxyContext = CreatePointVectorProxyContext();
-	m_PointVector = vectorBuffer->CreatePointVectorProxy(m_ProxyContext);
+	if (!IsMatrix())
+	{
+		return;
+	}
+
+	auto& dimension{ *m_Document->Record3().MatrixDimension() };
+
+	const auto sizeV{ ConvertToSizeT(dimension.SizeY()) };
+	const auto sizeW{ ConvertToSizeT(dimension.SizeZ()) };
+	const auto firstRow{ m_OpenOptions.firstRow };
+	const auto firstLayer{ m_OpenOptions.firstLayer };
+
+	if (firstRow >= sizeV || firstLayer >= sizeW)
+	{
+		throw Exception(
+			OGPS_ExInvalidArgument,
+			_EX_T("Index out of range."),
+			_EX_T("The first row or layer to be loaded as given by the open options lies outside the scope of the current matrix topology."),
+			_EX_T("OpenGPS::ISO5436_2Container::ApplyOpenWindow"));
+	}
+
+	const auto rows{ m_OpenOptions.rowCount > 0 ? std::min(m_OpenOptions.rowCount, sizeV - firstRow) : sizeV - firstRow };
+	const auto layers{ m_OpenOptions.layerCount > 0 ? std::min(m_OpenOptions.layerCount, sizeW - firstLayer) : sizeW - firstLayer };
+
+	if (rows == sizeV && layers == sizeW)
+	{
+		return;
+	}
+
+	m_SourceMaxV = sizeV;
+	m_SourceMaxW = sizeW;
+
+	dimension.SizeY(rows);
+	dimension.SizeZ(layers);
+}
+
+bool ISO5436_2Container::IsPartial() const
+{
+	return m_SourceMaxV > 0;
 }
 
 void ISO5436_2Container::ResetXmlPointList()
@@ -1294,7 +2495,7 @@ void ISO5436_2Container::ResetValidPointsLink()
 {
 	assert(HasDocument());
 
-	if (!IsBinary() || !GetVectorBuffer()->HasValidityBuffer() || !GetVectorBuffer()->GetValidityBuffer()->IsAllocated() || !GetVectorBuffer()->GetValidityBuffer()->HasInvalidMarks())
+	if (!IsBinary() || !HasInvalidMarks())
 	{
 		// no, we do not need an external validity file
 		if (m_Document->Record3().DataLink().present() && m_Document->Record3().DataLink()->ValidPointsLink().present())
@@ -1325,18 +2526,9 @@ void ISO5436_2Container::SaveChecksumFile(zipFile handle, const std::array<unsig
 	bool retval{};
 
 	String section(GetChecksumArchiveName());
-	if (zipOpenNewFileInZip(handle,
-		section.ToChar(),
-		nullptr,
-		nullptr,
-		0,
-		nullptr,
-		0,
-		nullptr,
-		Z_DEFLATED,
-		m_CompressionLevel) == ZIP_OK)
-	{
-		ZipStreamBuffer buffer(handle, false);
+	ZipStreamBuffer buffer(handle, false);
+	if (buffer.Open(section, m_CompressionLevel))
+	{
 		ZipOutputStream zipOut(buffer);
 
 		if (!zipOut.fail())
@@ -1355,9 +2547,9 @@ void ISO5436_2Container::SaveChecksumFile(zipFile handle, const std::array<unsig
 			}
 		}
 
-		if (zipCloseFileInZip(handle) == ZIP_OK)
+		if (!buffer.Close())
 		{
-			retval = retval && true;
+			retval = false;
 		}
 	}
 
@@ -1380,16 +2572,9 @@ void ISO5436_2Container::SaveXmlDocument(zipFile handle)
 
 	// Creates new file in the zip container.
 	String mainDocument(GetMainArchiveName());
-	if (zipOpenNewFileInZip(handle,
-		mainDocument.ToChar(),
-		nullptr,
-		nullptr,
-		0,
-		nullptr,
-		0,
-		nullptr,
-		Z_DEFLATED,
-		m_CompressionLevel) != ZIP_OK)
+	const auto length{ IsBinary() ? 0ULL : static_cast<unsigned long long>(GetPointCount()) * _OPENGPS_XML_DATUM_SIZE_MAX };
+	ZipStreamBuffer buffer(handle, true);
+	if (!buffer.Open(mainDocument, m_CompressionLevel, length))
 	{
 		throw Exception(
 			OGPS_ExGeneral,
@@ -1398,13 +2583,14 @@ void ISO5436_2Container::SaveXmlDocument(zipFile handle)
 			_EX_T("OpenGPS::ISO5436_2Container::SaveXmlDocument"));
 	}
 
-	ZipStreamBuffer buffer(handle, true);
 	ZipOutputStream zipOut(buffer);
 
 	if (!zipOut.fail())
 	{
 		try
 		{
+			std::lock_guard<std::mutex> lock(GetXercesMutex());
+
 			xercesc::XMLPlatformUtils::Initialize();
 			try
 			{
@@ -1419,7 +2605,7 @@ void ISO5436_2Container::SaveXmlDocument(zipFile handle)
 		}
 		catch (const xml_schema::exception& e)
 		{
-			_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+			buffer.Close();
 
 #ifdef _UNICODE
 			std::wostringstream dump;
@@ -1439,10 +2625,18 @@ void ISO5436_2Container::SaveXmlDocument(zipFile handle)
 		}
 		catch (...)
 		{
-			_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+			buffer.Close();
 			throw;
 		}
-		_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+
+		if (!buffer.Close())
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("The main ISO5436-2 XML document could not be written to the X3P file container."),
+				_EX_T("The compressed document could not be stored completely. Check your permissions and that there is enough space left on your filesystem."),
+				_EX_T("OpenGPS::ISO5436_2Container::SaveXmlDocument"));
+		}
 	}
 
 	std::array<unsigned char, 16> md5{};
@@ -1486,22 +2680,14 @@ bool ISO5436_2Container::ConfigureNamespaceMap(xml_schema::properties& props) co
 
 void ISO5436_2Container::SaveValidPointsLink(zipFile handle)
 {
-	if (HasValidPointsLink() || (HasVectorBuffer() && GetVectorBuffer()->HasValidityBuffer() && GetVectorBuffer()->GetValidityBuffer()->IsAllocated() && GetVectorBuffer()->GetValidityBuffer()->HasInvalidMarks()))
+	if (HasValidPointsLink() || HasInvalidMarks())
 	{
 		assert(IsBinary());
 
 		// Creates new file in the zip container.
 		String section(GetValidPointsArchiveName());
-		if (zipOpenNewFileInZip(handle,
-			section.ToChar(),
-			nullptr,
-			nullptr,
-			0,
-			nullptr,
-			0,
-			nullptr,
-			Z_DEFLATED,
-			m_CompressionLevel) != ZIP_OK)
+		ZipStreamBuffer vbuffer(handle, true);
+		if (!vbuffer.Open(section, m_CompressionLevel, GetPointCount() / 8 + 1))
 		{
 			throw Exception(
 				OGPS_ExGeneral,
@@ -1510,25 +2696,40 @@ void ISO5436_2Container::SaveValidPointsLink(zipFile handle)
 				_EX_T("OpenGPS::ISO5436_2Container::SaveValidPointsLink"));
 		}
 
-		auto vectorBuffer{ GetVectorBuffer() };
-
-		ZipStreamBuffer vbuffer(handle, true);
 		ZipOutputStream vstream(vbuffer);
 
 		try
 		{
 			if (!vstream.fail())
 			{
-				assert(vectorBuffer->HasValidityBuffer());
-				vectorBuffer->GetValidityBuffer()->Write(vstream);
+				if (IsStreaming())
+				{
+					assert(m_StreamValidity);
+					m_StreamValidity->Write(vstream);
+				}
+				else
+				{
+					auto vectorBuffer{ GetVectorBuffer() };
+
+					assert(vectorBuffer->HasValidityBuffer());
+					vectorBuffer->GetValidityBuffer()->Write(vstream);
+				}
 			}
 		}
 		catch (...)
 		{
-			_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+			vbuffer.Close();
 			throw;
 		}
-		_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+
+		if (!vbuffer.Close())
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("The binary point validity file could not be written to the X3P archive."),
+				_EX_T("The compressed data could not be stored completely. Check your permissions and that there is enough space left on your filesystem."),
+				_EX_T("OpenGPS::ISO5436_2Container::SaveValidPointsLink"));
+		}
 
 		// Add Checksum for valid.bin
 		std::array<unsigned char, 16> md5{};
@@ -1545,88 +2746,62 @@ void ISO5436_2Container::SavePointBuffer(zipFile handle)
 
 	const auto isBinary{ IsBinary() };
 
-	if (isBinary)
-	{
-		// Creates new file in the zip container.
-		String section(GetPointDataArchiveName());
-		if (zipOpenNewFileInZip(handle,
-			section.ToChar(),
-			nullptr,
-			nullptr,
-			0,
-			nullptr,
-			0,
-			nullptr,
-			Z_DEFLATED,
-			m_CompressionLevel) != ZIP_OK)
-		{
-			throw Exception(
-				OGPS_ExGeneral,
-				_EX_T("Could not write binary point data to the X3P archive."),
-				_EX_T("Zlib could not open the target handle. Check for filesystem permissions and enough space left."),
-				_EX_T("OpenGPS::ISO5436_2Container::SavePointBuffer"));
-		}
-	}
-
-	try
-	{
-		assert(HasDocument() && HasVectorBuffer());
+	assert(HasDocument() && HasVectorBuffer());
 
-		// Before we start: reset changes made to the
-		// point list xml tag. Points will be replaced
-		// with those vlaues in the current vector buffer.
-		ResetXmlPointList();
-		ResetValidPointsLink();
+	// Before we start: reset changes made to the
+	// point list xml tag. Points will be replaced
+	// with those vlaues in the current vector buffer.
+	ResetXmlPointList();
+	ResetValidPointsLink();
 
-		// Create point parser for this document
-		PointVectorParserBuilder p_builder;
-		BuildPointVectorParser(p_builder);
+	// Create point parser for this document
+	PointVectorParserBuilder p_builder;
+	BuildPointVectorParser(p_builder);
 
-		auto parser{ p_builder.GetParser() };
-		auto context{ CreatePointVectorWriterContext(handle) };
+	auto parser{ p_builder.GetParser() };
 
-		assert(context);
+	// Creates new file in the zip container if needed.
+	auto context{ CreatePointVectorWriterContext(handle) };
 
-		auto vectorBuffer{ GetVectorBuffer() };
+	assert(context);
 
-		auto proxy_context{ CreatePointVectorProxyContext() };
+	auto vectorBuffer{ GetVectorBuffer() };
 
-		assert(proxy_context);
+	auto proxy_context{ CreatePointVectorProxyContext() };
 
-		auto vector{ vectorBuffer->CreatePointVectorProxy(proxy_context) };
+	assert(proxy_context);
 
-		if (proxy_context->CanIncrementIndex())
-		{
-			do
-			{
-				if (isBinary || vectorBuffer->GetValidityProvider()->IsValid(proxy_context->GetIndex()))
-				{
-					parser->Write(*context, *vector);
-				}
-				context->MoveNext();
-			} while (proxy_context->IncrementIndex());
-		}
+	auto vector{ vectorBuffer->CreatePointVectorProxy(proxy_context) };
 
-		if (isBinary)
-		{
-			std::array<unsigned char, 16> md5{};
-			dynamic_cast<BinaryPointVectorWriterContext*>(context.get())->GetMd5(md5);
-			const Schemas::ISO5436_2::DataLinkType::MD5ChecksumPointData_type checksum(md5.data(), md5.size());
-			m_Document->Record3().DataLink()->MD5ChecksumPointData(checksum);
-		}
-	}
-	catch (...)
+	if (proxy_context->CanIncrementIndex())
 	{
-		if (isBinary)
+		do
 		{
-			_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
-		}
-		throw;
+			if (isBinary || vectorBuffer->GetValidityProvider()->IsValid(proxy_context->GetIndex()))
+			{
+				parser->Write(*context, *vector);
+			}
+			context->MoveNext();
+		} while (proxy_context->IncrementIndex());
 	}
 
 	if (isBinary)
 	{
-		_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+		auto binaryContext{ dynamic_cast<BinaryPointVectorWriterContext*>(context.get()) };
+
+		std::array<unsigned char, 16> md5{};
+		binaryContext->GetMd5(md5);
+		const Schemas::ISO5436_2::DataLinkType::MD5ChecksumPointData_type checksum(md5.data(), md5.size());
+		m_Document->Record3().DataLink()->MD5ChecksumPointData(checksum);
+
+		if (!binaryContext->Close())
+		{
+			throw Exception(
+				OGPS_ExGeneral,
+				_EX_T("Could not write binary point data to the X3P archive."),
+				_EX_T("The compressed point data could not be stored completely. Check for filesystem permissions and enough space left."),
+				_EX_T("OpenGPS::ISO5436_2Container::SavePointBuffer"));
+		}
 	}
 }
 
@@ -1638,7 +2813,7 @@ void ISO5436_2Container::BuildPointVectorParser(PointVectorParserBuilder& builde
 	builder.BuildZ(GetZaxisDataType());
 }
 
-bool ISO5436_2Container::BuildVectorBuffer(VectorBufferBuilder& builder) const
+bool ISO5436_2Container::BuildVectorBuffer(VectorBufferBuilder& builder, std::shared_ptr<MappedStorage> mapped) const
 {
 	assert(HasDocument());
 
@@ -1646,13 +2821,44 @@ bool ISO5436_2Container::BuildVectorBuffer(VectorBufferBuilder& builder) const
 
 	const auto allowInvalidPoints{ !IsPointCloud() };
 
-	return (builder.BuildBuffer() &&
+	return ((mapped ? builder.BuildBuffer(mapped) : builder.BuildBuffer(CreatePagedStorage(size))) &&
 		builder.BuildX(GetXaxisDataType(), size) &&
 		builder.BuildY(GetYaxisDataType(), size) &&
 		builder.BuildZ(GetZaxisDataType(), size) &&
 		builder.BuildValidityProvider(allowInvalidPoints));
 }
 
+std::shared_ptr<PagedStorage> ISO5436_2Container::CreatePagedStorage(size_t size) const
+{
+	const auto budget{ m_OpenOptions.pagedMemoryBudget };
+
+	if (budget == 0)
+	{
+		return nullptr;
+	}
+
+	// Keep point data in memory if it fits into the budget anyway.
+	if (SafeMultipilcation(size, GetPointVectorSize()) <= budget)
+	{
+		return nullptr;
+	}
+
+	return std::make_shared<PagedStorage>(CreateSpillFilePath(), m_OpenOptions.pageSize, budget, m_OpenOptions.prefetchPages);
+}
+
+String ISO5436_2Container::CreateSpillFilePath() const
+{
+	const auto env{ Environment::GetInstance() };
+
+	const auto base{ m_TempBasePath.length() > 0 && env->PathExists(m_TempBasePath) ? m_TempBasePath : env->GetTempDir() };
+
+	String name{ _T("x3p") };
+	name += env->GetUniqueName();
+	name += _T(".pages");
+
+	return env->ConcatPathes(base, name);
+}
+
 std::unique_ptr<PointVectorReaderContext> ISO5436_2Container::CreatePointVectorReaderContext()
 {
 	// instantiate binary reader context
@@ -1662,14 +2868,7 @@ std::unique_ptr<PointVectorReaderContext> ISO5436_2Container::CreatePointVectorR
 		const auto binaryFilePath = GetPointDataFileName();
 		if (binaryFilePath.length() > 0)
 		{
-			// find out if we are on lsb or msb
-			// hardware and create appropriate context
-			if (Environment::IsLittleEndian())
-			{
-				return std::make_unique<BinaryLSBPointVectorReaderContext>(binaryFilePath);
-			}
-
-			return std::make_unique<BinaryMSBPointVectorReaderContext>(binaryFilePath);
+			return CreateBinaryPointVectorReaderContext(std::make_unique<InputBinaryFileStream>(binaryFilePath));
 		}
 
 		return nullptr;
@@ -1687,6 +2886,100 @@ std::unique_ptr<PointVectorReaderContext> ISO5436_2Container::CreatePointVectorR
 	return nullptr;
 }
 
+std::unique_ptr<PointVectorReaderContext> ISO5436_2Container::CreateBinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream) const
+{
+	// find out if we are on lsb or msb
+	// hardware and create appropriate context
+	if (Environment::IsLittleEndian())
+	{
+		return std::make_unique<BinaryLSBPointVectorReaderContext>(std::move(stream));
+	}
+
+	return std::make_unique<BinaryMSBPointVectorReaderContext>(std::move(stream));
+}
+
+std::unique_ptr<ZipInputStreamBuffer> ISO5436_2Container::OpenArchiveEntry(const String& name, size_t pipelineDepth) const
+{
+	auto buffer{ std::make_unique<ZipInputStreamBuffer>(GetDirectory(), pipelineDepth) };
+
+	if (!buffer->Open(name))
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The X3P container document does not contain the supposed resource."),
+			_EX_T("For a X3P archive to be valid all additional resources given in main.xml must be contained herein. Also verify whether the file exists and if you have sufficient access privilegs."),
+			_EX_T("OpenGPS::ISO5436_2Container::OpenArchiveEntry"));
+	}
+
+	return buffer;
+}
+
+bool ISO5436_2Container::CopyArchiveEntry(zipFile handle, const String& name) const
+{
+	assert(handle);
+
+	auto entryName{ name };
+
+	const auto directory{ GetDirectory() };
+	auto src{ directory->Open(name) };
+	if (!src)
+	{
+		return false;
+	}
+
+	// Read and write raw data, so nothing gets decompressed.
+	int method{};
+	int level{};
+	unz_file_info64 fileInfo;
+	auto success{ unzOpenCurrentFile2(src, &method, &level, 1) == UNZ_OK };
+
+	if (success)
+	{
+		success = unzGetCurrentFileInfo64(src, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+			zipOpenNewFileInZip2_64(handle, entryName.ToChar(), nullptr, nullptr, 0, nullptr, 0, nullptr, method, level, 1,
+				ZipStreamBuffer::RequiresZip64(std::max(fileInfo.uncompressed_size, fileInfo.compressed_size)) ? 1 : 0) == ZIP_OK;
+
+		if (success)
+		{
+			auto chunk = std::make_unique<char[]>(_OPENGPS_ZIP_CHUNK_MAX);
+
+			int bytesRead{};
+			while ((bytesRead = unzReadCurrentFile(src, chunk.get(), _OPENGPS_ZIP_CHUNK_MAX)) > 0)
+			{
+				if (zipWriteInFileInZip(handle, chunk.get(), static_cast<unsigned int>(bytesRead)) != ZIP_OK)
+				{
+					success = false;
+					break;
+				}
+			}
+
+			success = success && bytesRead == 0;
+			success = zipCloseFileInZipRaw64(handle, fileInfo.uncompressed_size, fileInfo.crc) == ZIP_OK && success;
+		}
+	}
+
+	directory->Close(src);
+
+	return success;
+}
+
+void ISO5436_2Container::CopyPointData(zipFile handle) const
+{
+	assert(handle);
+	assert(m_CanCopyPointData && IsBinary());
+
+	// The document still links to the point data and keeps its checksums.
+	if (!CopyArchiveEntry(handle, GetPointDataArchiveName()) ||
+		(HasValidPointsLink() && !CopyArchiveEntry(handle, GetValidPointsArchiveName())))
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("Could not copy binary point data to the X3P archive."),
+			_EX_T("The unmodified point data of the X3P archive opened could not be copied completely. Check whether the archive still exists, for filesystem permissions and enough space left."),
+			_EX_T("OpenGPS::ISO5436_2Container::CopyPointData"));
+	}
+}
+
 std::unique_ptr<PointVectorWriterContext> ISO5436_2Container::CreatePointVectorWriterContext(zipFile handle) const
 {
 	assert(handle);
@@ -1694,14 +2987,17 @@ std::unique_ptr<PointVectorWriterContext> ISO5436_2Container::CreatePointVectorW
 	// instantiate binary writer context
 	if (IsBinary())
 	{
+		const auto length{ static_cast<unsigned long long>(GetPointCount()) * GetPointVectorSize() };
+		const auto pipelineBuffers{ length >= m_WriteOptions.pipelineMinimum ? m_WriteOptions.pipelineBuffers : 0 };
+
 		// find out if we are on lsb or msb
 		// hardware and create appropriate context
 		if (Environment::IsLittleEndian())
 		{
-			return std::make_unique<BinaryLSBPointVectorWriterContext>(handle);
+			return std::make_unique<BinaryLSBPointVectorWriterContext>(handle, GetPointDataArchiveName(), m_CompressionLevel, length, pipelineBuffers);
 		}
 
-		return std::make_unique<BinaryMSBPointVectorWriterContext>(handle);
+		return std::make_unique<BinaryMSBPointVectorWriterContext>(handle, GetPointDataArchiveName(), m_CompressionLevel, length, pipelineBuffers);
 	}
 
 	// instantiate xml string reader context...
@@ -1768,6 +3064,11 @@ OGPS_DataPointType ISO5436_2Container::GetAxisDataType(const Schemas::ISO5436_2:
 	return OGPS_MissingPointType;
 }
 
+size_t ISO5436_2Container::GetPointVectorSize() const
+{
+	return GetDataTypeSize(GetXaxisDataType()) + GetDataTypeSize(GetYaxisDataType()) + GetDataTypeSize(GetZaxisDataType());
+}
+
 size_t ISO5436_2Container::GetPointCount() const
 {
 	assert(HasDocument());
@@ -1848,9 +3149,14 @@ bool ISO5436_2Container::HasValidPointsLink() const
 
 void ISO5436_2Container::Reset()
 {
+	CloseStream();
+	m_Directory.reset();
 	m_MainChecksum = true;
 	m_DataBinChecksum = true;
 	m_ValidBinChecksum = true;
+	m_SourceMaxV = 0;
+	m_SourceMaxW = 0;
+	m_CanCopyPointData = false;
 	m_Document.reset();
 	m_VectorBuffer.reset();
 	m_PointVector.reset();
@@ -1859,6 +3165,7 @@ void ISO5436_2Container::Reset()
 	m_ValidPointsFileName.clear();
 	m_VendorURI.clear();
 	m_VendorSpecific.clear();
+	ogps_InitOpenOptions(&m_OpenOptions);
 }
 
 bool ISO5436_2Container::HasDocument() const
@@ -1871,42 +3178,39 @@ bool ISO5436_2Container::HasVectorBuffer() const
 	return m_VectorBuffer != nullptr;
 }
 
+bool ISO5436_2Container::HasInvalidMarks() const
+{
+	if (IsStreaming())
+	{
+		return m_StreamValidity && m_StreamValidity->HasInvalidMarks();
+	}
+
+	return HasVectorBuffer() && m_VectorBuffer->HasValidityBuffer() && m_VectorBuffer->GetValidityBuffer()->IsAllocated() && m_VectorBuffer->GetValidityBuffer()->HasInvalidMarks();
+}
+
 void ISO5436_2Container::CreateTempDir()
 {
 	assert(!HasTempDir());
 
 	const auto env{ Environment::GetInstance() };
-	const auto uniqueDirectory{ env->GetUniqueName() };
 
+	// The directory is created atomically, so concurrent instances never share it.
 	String temp;
-	bool created{};
 	if (m_TempBasePath.length() > 0 && env->PathExists(m_TempBasePath))
 	{
-		temp = env->ConcatPathes(m_TempBasePath, uniqueDirectory);
-
-		// TODO: try new random
-		if (!env->PathExists(temp))
-		{
-			created = env->CreateDir(temp);
-		}
+		temp = env->CreateUniqueDir(m_TempBasePath);
 	}
 
-	if (!created)
+	if (temp.empty())
 	{
 		const auto sysTemp{ env->GetTempDir() };
-		if (env->PathExists(sysTemp))
+		if (sysTemp.length() > 0 && env->PathExists(sysTemp))
 		{
-			temp = env->ConcatPathes(sysTemp, uniqueDirectory);
-
-			// TODO: try new random
-			if (!env->PathExists(temp))
-			{
-				created = env->CreateDir(temp);
-			}
+			temp = env->CreateUniqueDir(sysTemp);
 		}
 	}
 
-	if (created)
+	if (!temp.empty())
 	{
 		m_TempPath = temp;
 	}
@@ -2282,16 +3586,10 @@ bool ISO5436_2Container::WriteVendorSpecific(zipFile handle)
 			// Creates new file in the zip container.
 			String vendor = m_VendorSpecific[n];
 			String avname = Environment::GetInstance()->GetFileName(vendor);
-			if (zipOpenNewFileInZip(handle,
-				avname.ToChar(),
-				nullptr,
-				nullptr,
-				0,
-				nullptr,
-				0,
-				nullptr,
-				Z_DEFLATED,
-				m_CompressionLevel) != ZIP_OK)
+			std::ifstream src(vendor.ToChar(), std::ios::in | std::ios::binary | std::ios::ate);
+			const auto size{ src.is_open() ? static_cast<unsigned long long>(std::max<std::streamoff>(src.tellg(), 0)) : 0ULL };
+			ZipStreamBuffer vbuffer(handle, false);
+			if (!vbuffer.Open(avname, m_CompressionLevel, size))
 			{
 				// zip file could not be created
 				success = false;
@@ -2300,11 +3598,6 @@ bool ISO5436_2Container::WriteVendorSpecific(zipFile handle)
 			{
 				try
 				{
-					ZipStreamBuffer vbuffer(handle, false);
-					ZipOutputStream vstream(vbuffer);
-
-					std::ifstream src(vendor.ToChar(), std::ios::in | std::ios::binary | std::ios::ate);
-
 					if (!src.is_open())
 					{
 						success = false;
@@ -2349,7 +3642,7 @@ bool ISO5436_2Container::WriteVendorSpecific(zipFile handle)
 											}
 										}
 
-										if (zipWriteInFileInZip(handle, (voidp)buffer, static_cast<unsigned int>(chunk)) != ZIP_OK)
+										if (vbuffer.sputn(static_cast<const char*>(buffer), static_cast<std::streamsize>(chunk)) != static_cast<std::streamsize>(chunk))
 										{
 											throw Exception(
 												OGPS_ExInvalidOperation,
@@ -2381,11 +3674,14 @@ bool ISO5436_2Container::WriteVendorSpecific(zipFile handle)
 				}
 				catch (...)
 				{
-					_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+					vbuffer.Close();
 					throw;
 				}
 
-				_VERIFY(zipCloseFileInZip(handle), ZIP_OK);
+				if (!vbuffer.Close())
+				{
+					success = false;
+				}
 			}
 		}
 	}
@@ -2411,3 +3707,15 @@ void ISO5436_2Container::CheckDocumentInstance() const
 			_EX_T("ISO5436_2Container::CheckDocument"));
 	}
 }
+
+void ISO5436_2Container::CheckPointBufferInstance() const
+{
+	if (!m_VectorBuffer)
+	{
+		throw Exception(
+			OGPS_ExInvalidOperation,
+			_EX_T("There is no point data buffered in memory."),
+			_EX_T("Point data of documents created with the CreateStream method is written to the X3P archive directly. It can not be accessed randomly. Use AppendMatrixPoint instead. Point data of documents opened with the loadPoints option set to false can only be accessed by the Visit method."),
+			_EX_T("ISO5436_2Container::CheckPointBufferInstance"));
+	}
+}
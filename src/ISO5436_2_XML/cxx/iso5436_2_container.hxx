@@ -37,22 +37,37 @@
 
 #include <opengps/cxx/exceptions.hxx>
 #include <opengps/data_point_type.h>
+#include <opengps/open_options.h>
+#include <opengps/write_options.h>
+#include <opengps/cxx/point_block.hxx>
 #include "auto_ptr_types.hxx"
 #include "point_vector_proxy_context.hxx"
 #include <opengps/cxx/point_iterator.hxx>
 #include <opengps/cxx/string.hxx>
 #include <opengps/cxx/iso5436_2_xsd.hxx>
+#include <opengps/cxx/byte_source.hxx>
 #include <zip.h>
+#include <unzip.h>
+#include <vector>
 
 namespace OpenGPS
 {
 	class PointVectorBase;
 	class PointVectorParser;
+	class PointVectorProxyContextMatrix;
 	class PointVectorParserBuilder;
 	class VectorBufferBuilder;
 	class PointVectorReaderContext;
 	class PointVectorWriterContext;
 	class VectorBuffer;
+	class StreamValidBuffer;
+	class StreamValidReader;
+	class PagedStorage;
+	class MappedStorage;
+	class SurfaceCache;
+	class PointBlockBuffer;
+	class ZipInputStreamBuffer;
+	class ZipDirectory;
 
 	/*! This is the main gate to this software library. It provides all manipulation
 	 * methods to handle X3P archive files.
@@ -77,6 +92,30 @@ namespace OpenGPS
 			const String& file,
 			const String& temp);
 
+		/*!
+		 * Creates a new instance that serves an X3P archive held in memory.
+		 * The archive is read from and written to memory without being extracted.
+		 * @param data The content of the X3P archive. This may be empty if a new
+		 * X3P archive is to be created.
+		 * @param temp If not empty this specifies an alternativ directory path
+		 * to save temporary files, see ISO5436_2Container::ISO5436_2Container.
+		 */
+		ISO5436_2Container(
+			std::vector<unsigned char> data,
+			const String& temp);
+
+		/*!
+		 * Creates a new instance that serves an X3P archive read from a byte source.
+		 * The archive is read without being extracted. When written it is held in
+		 * memory, the byte source itself is never modified.
+		 * @param source The byte source of the X3P archive.
+		 * @param temp If not empty this specifies an alternativ directory path
+		 * to save temporary files, see ISO5436_2Container::ISO5436_2Container.
+		 */
+		ISO5436_2Container(
+			std::shared_ptr<const ByteSource> source,
+			const String& temp);
+
 		/*! Destroys this instance. This closes all open file handles and all
 		changes you may have made to an X3P document get lost unless you
 		previously saved them by executing ISO5436_2Container::Write. */
@@ -86,6 +125,8 @@ namespace OpenGPS
 
 		void Open();
 
+		void Open(const OGPS_OpenOptions& options);
+
 		void Create(
 			const Schemas::ISO5436_2::Record1Type& record1,
 			const Schemas::ISO5436_2::Record2Type* record2,
@@ -98,6 +139,16 @@ namespace OpenGPS
 			size_t listDimension,
 			bool useBinaryData = true);
 
+		void CreateStream(
+			const Schemas::ISO5436_2::Record1Type& record1,
+			const Schemas::ISO5436_2::Record2Type* record2,
+			const Schemas::ISO5436_2::MatrixDimensionType& matrixDimension,
+			int compressionLevel = Z_DEFAULT_COMPRESSION);
+
+		void AppendMatrixPoint(const PointVector* vector);
+
+		bool Visit(const PointBlockVisitor& visitor, size_t blockSize);
+
 		PointIteratorAutoPtr CreateNextPointIterator();
 		PointIteratorAutoPtr CreatePrevPointIterator();
 
@@ -111,7 +162,7 @@ namespace OpenGPS
 			size_t u,
 			size_t v,
 			size_t w,
-			PointVector& vector);
+			PointVector& vector) const;
 
 		void SetListPoint(
 			size_t index,
@@ -119,7 +170,7 @@ namespace OpenGPS
 
 		void GetListPoint(
 			size_t index,
-			PointVector& vector);
+			PointVector& vector) const;
 
 		void GetMatrixCoord(
 			size_t u,
@@ -127,20 +178,21 @@ namespace OpenGPS
 			size_t w,
 			OGPS_Double* x,
 			OGPS_Double* y,
-			OGPS_Double* z);
+			OGPS_Double* z) const;
 
 		bool IsMatrixCoordValid(
 			size_t u,
 			size_t v,
-			size_t w);
+			size_t w) const;
 
 		void GetListCoord(
 			size_t index,
 			OGPS_Double* x,
 			OGPS_Double* y,
-			OGPS_Double* z);
+			OGPS_Double* z) const;
 
 		Schemas::ISO5436_2::ISO5436_2Type* GetDocument();
+		const Schemas::ISO5436_2::ISO5436_2Type* GetDocument() const;
 
 		bool IsMatrix() const;
 
@@ -151,8 +203,14 @@ namespace OpenGPS
 
 		size_t GetListDimension() const;
 
+		unsigned long long GetPointDataSize() const;
+
+		void SetWriteOptions(const OGPS_WriteOptions& options);
+
 		void Write(int compressionLevel = Z_DEFAULT_COMPRESSION);
 
+		void Write(std::vector<unsigned char>& target, int compressionLevel = Z_DEFAULT_COMPRESSION);
+
 		void Close();
 
 		void AppendVendorSpecific(const String& vendorURI, const String& filePath);
@@ -291,10 +349,64 @@ namespace OpenGPS
 		void DecompressDataBin();
 
 
+		/*!
+		 * Writes the X3P archive, see ISO5436_2::Write.
+		 * @param target If not nullptr the X3P archive is written to this buffer instead
+		 * of its file or the byte source it is read from.
+		 * @param compressionLevel The compression level of the X3P archive.
+		 */
+		void WriteArchive(std::vector<unsigned char>* target, int compressionLevel);
+
 		/*!
 		 * (Over)writes the current X3P archive file with the actual content.
+		 * @param target If not nullptr the X3P archive is written to this buffer instead.
 		 */
-		void Compress();
+		void Compress(std::vector<unsigned char>* target = nullptr);
+
+		/*!
+		 * Reads the X3P archive from its byte source. Archive entries are decompressed
+		 * while being read instead of being extracted to the temporary directory.
+		 * @remarks If this throws an exception there may exist incorrect and incomplete data.
+		 * Do call ISO5436_2Container::Reset to avoid an inconsistent state.
+		 */
+		void ReadByteSource();
+
+		/*!
+		 * Checks whether the X3P archive is served by a byte source instead of a file.
+		 * @returns Returns true if the X3P archive is read from a byte source, false if it is a file.
+		 */
+		bool HasByteSource() const;
+
+		/*!
+		 * Gets the byte source the X3P archive is read from.
+		 * @returns The byte source of the current instance or the file of the X3P archive.
+		 */
+		std::shared_ptr<const ByteSource> GetByteSource() const;
+
+		/*!
+		 * Gets the directory of the X3P archive read from its byte source.
+		 * The directory is kept until the X3P archive gets written or closed.
+		 * @returns The directory of the X3P archive.
+		 */
+		std::shared_ptr<ZipDirectory> GetDirectory() const;
+
+		/*!
+		 * Completes the X3P archive that point data has been streamed to and
+		 * moves it to its final location.
+		 * @see ISO5436_2Container::CreateStream
+		 */
+		void CompressStream();
+
+		/*!
+		 * Releases the resources of a streamed X3P archive. Any data streamed so far gets discarded.
+		 */
+		void CloseStream();
+
+		/*!
+		 * Returns true if point data is appended to the X3P archive directly instead of being
+		 * buffered in memory, false otherwise. @see ISO5436_2Container::CreateStream
+		 */
+		bool IsStreaming() const;
 
 		/*!
 		 * Creates the internal XML document tree structure.
@@ -309,19 +421,24 @@ namespace OpenGPS
 		 * @param useBinaryData Set this to true to store the point
 		 * data within an external binary file. If set to false point vectors
 		 * will get storead within the ISO5436-2 XML document directly.
+		 * @param createPointBuffer Set this to true to allocate the internal
+		 * memory storage of point data. If set to false point data is not
+		 * buffered but streamed to the archive.
 		 */
 		void CreateDocument(
 			const Schemas::ISO5436_2::Record1Type* record1,
 			const Schemas::ISO5436_2::Record2Type* record2,
 			const Schemas::ISO5436_2::MatrixDimensionType* matrixDimension,
 			size_t listDimension,
-			bool useBinaryData);
+			bool useBinaryData,
+			bool createPointBuffer);
 
 		/*!
 		 * Creates an instance of the internal ISO5436-2 XML document tree.
 		 * An instance is created from the decompressed main xml document file.
+		 * @param stream If not nullptr the main xml document is read from this stream instead.
 		 */
-		void ReadDocument();
+		void ReadDocument(std::istream* stream = nullptr);
 
 		/*!
 		 * Assembles a new OpenGPS::PointVectorParser object using the OpenGPS::PointVectorParserBuilder.
@@ -347,12 +464,27 @@ namespace OpenGPS
 		 */
 		OGPS_DataPointType GetAxisDataType(const Schemas::ISO5436_2::AxisDescriptionType& axis, const bool incremental) const;
 
+		/*! Gets the size in bytes of a single point vector stored in binary format. */
+		size_t GetPointVectorSize() const;
+
 		/*!
 		 * Assembles a new OpenGPS::VectorBuffer object using the OpenGPS::VectorBufferBuilder.
 		 * @param builder The instance of the builder that is used to create the vector buffer.
+		 * @param mapped The storage of point data mapped from a cached file or nullptr
+		 * if point data is to be decoded.
 		 * @returns Returns true on success, false otherwise.
 		 */
-		bool BuildVectorBuffer(VectorBufferBuilder& builder) const;
+		bool BuildVectorBuffer(VectorBufferBuilder& builder, std::shared_ptr<MappedStorage> mapped = nullptr) const;
+
+		/*!
+		 * Creates the storage of paged point data if the current options require so.
+		 * @param size The amount of point vectors to be stored.
+		 * @returns Returns the storage or nullptr if point data is to be kept in memory as a whole.
+		 */
+		std::shared_ptr<PagedStorage> CreatePagedStorage(size_t size) const;
+
+		/*! Creates a unique file path for a temporary file that outlives the temporary directory. */
+		String CreateSpillFilePath() const;
 
 		/*!
 		 * Sets up the internal memory storage of point data.
@@ -361,6 +493,66 @@ namespace OpenGPS
 		 */
 		void CreatePointBuffer();
 
+		/*!
+		 * Allocates the internal vector buffer and decodes point data from either the ISO5436-2
+		 * main xml document or from an external binary file.
+		 */
+		void DecodePointBuffer();
+
+		/*!
+		 * Creates the cache of decoded point data if the current options require so.
+		 * @returns Returns the cache or nullptr if point data is not to be cached.
+		 */
+		std::unique_ptr<SurfaceCache> CreateSurfaceCache() const;
+
+		/*!
+		 * Gets the checksums that identify the binary point data of the current document within the cache.
+		 * @param dataMd5 Gets the checksum of the binary point data.
+		 * @param validMd5 Gets the checksum of the binary point validity data or zeros if there is none.
+		 * @returns Returns true if all of the point data is loaded from binary files whose checksums are declared.
+		 */
+		bool GetSurfaceCacheKey(std::array<unsigned char, 16>& dataMd5, std::array<unsigned char, 16>& validMd5) const;
+
+		/*!
+		 * Sets up the internal vector buffer from the cache of decoded point data.
+		 * @returns Returns true if the point data has been cached, false if it has to be decoded.
+		 */
+		bool LoadCachedPointBuffer();
+
+		/*!
+		 * Adds the point data just decoded to the cache of decoded point data and
+		 * continues with the cached copy instead, which may be shared with others.
+		 */
+		void StoreCachedPointBuffer();
+
+		/*!
+		 * Sets up the internal vector buffer from cached point data mapped into memory.
+		 * @param mapped The storage of the cached point data or nullptr.
+		 * @param validSize The size of the bit array of valid points in bytes, which follows the Z axis.
+		 * @returns Returns true on success, false if the point data has to be decoded.
+		 */
+		bool UseCachedPointBuffer(std::shared_ptr<MappedStorage> mapped, size_t validSize);
+
+		/*!
+		 * Reads point data into the internal memory storage that has just been allocated.
+		 * @param context Reads point data in storage order.
+		 * @param validity The validity of integer point data if it is not yet contained in the internal memory storage.
+		 * Point vectors are indexed as in the source matrix.
+		 * @param position The position of the first point vector read by the context within the source matrix.
+		 */
+		void ReadPointBuffer(PointVectorReaderContext& context, StreamValidReader* validity, size_t position);
+
+		/*!
+		 * Reduces the matrix dimensions of the document just read to the rows and
+		 * layers requested by the current open options.
+		 */
+		void ApplyOpenWindow();
+
+		/*!
+		 * Returns true if only some rows or layers of the matrix of the archive have been loaded.
+		 */
+		bool IsPartial() const;
+
 		/*!
 		 * Saves the current state of internal memory storage of point data either to the zip archive
 		 * as an external binary point file or directly into the actual tree structure of the internal
@@ -369,6 +561,14 @@ namespace OpenGPS
 		 */
 		void SavePointBuffer(zipFile handle);
 
+		/*!
+		 * Copies the binary point data and point validity data of the X3P archive opened
+		 * to the zip archive as they are, without decompressing and compressing them again.
+		 * @remarks Point data may only be copied if it has not been modified since it has been opened.
+		 * @param handle The handle to the zip archive where the data is to be stored.
+		 */
+		void CopyPointData(zipFile handle) const;
+
 		/*!
 		 * Removes the point list xml tag and its content from the xml document handle.
 		 */
@@ -400,11 +600,53 @@ namespace OpenGPS
 		 */
 		std::unique_ptr<PointVectorReaderContext> CreatePointVectorReaderContext();
 
+		/*!
+		 * Creates an instance of access methods to read binary point data in the byte order of the current machine.
+		 * @param stream The binary stream of point data.
+		 * @returns An instance to access raw point data for reading.
+		 */
+		std::unique_ptr<PointVectorReaderContext> CreateBinaryPointVectorReaderContext(std::unique_ptr<std::istream> stream) const;
+
+		/*!
+		 * Opens an entry of the X3P archive to be decompressed while being read.
+		 * Throws an exception if the entry does not exist.
+		 * @param name The name of the archive entry.
+		 * @param pipelineDepth The number of buffers if decompression is to be pipelined or 0.
+		 * @returns The buffer to read the archive entry from.
+		 */
+		std::unique_ptr<ZipInputStreamBuffer> OpenArchiveEntry(const String& name, size_t pipelineDepth = 0) const;
+
+		/*!
+		 * Copies the compressed data of an entry of the X3P archive opened to another zip archive.
+		 * @param handle The handle to the zip archive where the data is to be stored.
+		 * @param name The name of the archive entry.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool CopyArchiveEntry(zipFile handle, const String& name) const;
+
+		/*!
+		 * Visits point data buffered in memory.
+		 * @param block Collects the point vectors of a single block.
+		 * @param visitor Receives consecutive blocks of point vectors.
+		 * @returns Returns true if all point vectors have been visited or false if the visitor stopped.
+		 */
+		bool VisitPointBuffer(PointBlockBuffer& block, const PointBlockVisitor& visitor);
+
+		/*!
+		 * Visits point data while it is decompressed from the X3P archive. The checksums
+		 * of binary point data are verified once all point vectors have been visited.
+		 * @param block Collects the point vectors of a single block.
+		 * @param visitor Receives consecutive blocks of point vectors.
+		 * @returns Returns true if all point vectors have been visited or false if the visitor stopped.
+		 */
+		bool VisitArchive(PointBlockBuffer& block, const PointBlockVisitor& visitor);
+
 		/*!
 		 * Creates an instance of appropriate access methods to write point data depending on
 		 * the current configuration of the main ISO5436-2 XML document.
 		 * @param handle The handle to the zip archive is needed by the special implementation
-		 * of the context for writing point data to an external binary file.
+		 * of the context for writing point data to an external binary file. That context
+		 * creates the archive entry of the point data itself.
 		 * @returns An instance to write raw point data or nullptr on failure.
 		 * The pointer returned must be released by the caller.
 		 */
@@ -431,11 +673,19 @@ namespace OpenGPS
 		 */
 		bool HasVectorBuffer() const;
 
+		/*!
+		 * Returns true if point data of integer type has been marked as invalid, which
+		 * requires an external binary point validity file, or false otherwise.
+		 */
+		bool HasInvalidMarks() const;
+
 		/*!
 		 * Reads the main ISO5436-2 XML document contained in an X3P archive to the internal
 		 * document handle as a tree structure.
+		 * @param stream If not nullptr the main xml document is read from this stream
+		 * instead of the decompressed file.
 		 */
-		void ReadXmlDocument();
+		void ReadXmlDocument(std::istream* stream);
 
 		/*!
 		 * Writes the content of the internal document handle to the main XML document present in an X3P archive.
@@ -456,6 +706,13 @@ namespace OpenGPS
 		 */
 		void CheckDocumentInstance() const;
 
+		/*!
+		 * Checks for the internal memory storage of point data and raises an exception if it is not allocated.
+		 * This is the case when point data is streamed to the archive or the archive has been opened
+		 * without loading point data. @see ISO5436_2Container::CreateStream, ISO5436_2Container::Visit
+		 */
+		void CheckPointBufferInstance() const;
+
 
 	private:
 		/*! The path of the X3P archive handles. */
@@ -467,6 +724,12 @@ namespace OpenGPS
 		/*! The path to the global directory for temporary files. */
 		String m_TempBasePath;
 
+		/*! The byte source of the X3P archive if it is not a file. */
+		std::shared_ptr<const ByteSource> m_Source;
+
+		/*! The directory of the X3P archive shared by all reads of archive entries. */
+		mutable std::shared_ptr<ZipDirectory> m_Directory;
+
 		/*! true if an X3P archive is to be created, false if an existing archive has been opened.
 		 * The value is undefined if nothing happened so far.
 		 */
@@ -481,6 +744,18 @@ namespace OpenGPS
 		/*! The level of compression of the zip archive. */
 		int m_CompressionLevel;
 
+		/*! The options of the X3P archive currently opened. */
+		OGPS_OpenOptions m_OpenOptions;
+
+		/*! The options point data is written with. */
+		OGPS_WriteOptions m_WriteOptions;
+
+		/*! The number of rows of the matrix stored in the archive if only some have been loaded, 0 otherwise. */
+		size_t m_SourceMaxV{};
+
+		/*! The number of layers of the matrix stored in the archive if only some have been loaded, 0 otherwise. */
+		size_t m_SourceMaxW{};
+
 		/*! The handle to a tree strucure corresponding to an ISO5436-2 XML document file. */
 		std::unique_ptr<Schemas::ISO5436_2::ISO5436_2Type> m_Document;
 
@@ -493,6 +768,30 @@ namespace OpenGPS
 		/*! A point vector which serves as a temporary buffer. */
 		std::shared_ptr<PointVectorBase> m_PointVector;
 
+		/*! The handle of the temporary zip archive point data is streamed to or nullptr. */
+		zipFile m_StreamHandle{};
+
+		/*! The temporary path of the zip archive point data is streamed to. */
+		String m_StreamFilePath;
+
+		/*! Encodes point vectors that are streamed to the archive. */
+		std::unique_ptr<PointVectorParser> m_StreamParser;
+
+		/*! The binary point data file of the archive point data is streamed to. */
+		std::unique_ptr<PointVectorWriterContext> m_StreamContext;
+
+		/*! The index of the next point vector to be streamed. */
+		std::unique_ptr<PointVectorProxyContextMatrix> m_StreamIndex;
+
+		/*! The amount of point vectors streamed so far. */
+		size_t m_StreamCount{};
+
+		/*! The placeholder written for point vectors that have been marked as invalid. */
+		std::unique_ptr<PointVector> m_StreamInvalidVector;
+
+		/*! Tracks invalid point vectors of integer data types while streaming or nullptr. */
+		std::unique_ptr<StreamValidBuffer> m_StreamValidity;
+
 		/*! Creates a temporary directory in the file system and sets ISO5436_2Container::m_TempPath. */
 		void CreateTempDir();
 
@@ -514,6 +813,12 @@ namespace OpenGPS
 		/*! false, if the md5 checksum could not be verified after reading. */
 		bool m_ValidBinChecksum{ true };
 
+		/*!
+		 * true, if binary point data has been read from the X3P archive and has not been
+		 * modified since, so that it may be copied as it is when the archive is written.
+		 */
+		bool m_CanCopyPointData{};
+
 		/*! ID of vendorspecific data or empty. @see ISO5436_2Container::m_VendorSpecific. */
 		String m_VendorURI;
 
@@ -560,20 +865,37 @@ namespace OpenGPS
 		 */
 		bool VerifyChecksum(const String& filePath, std::array<unsigned char, 16>& checksum) const;
 
+		/*!
+		 * Verifies an 128bit md5 checksum of an archive entry that has been read.
+		 * @param buffer The archive entry which checksum is to be verified. Any data not read so far is skipped.
+		 * @param checksum The expected checksum to verify.
+		 * @param size The size of the checksum buffer in bytes. This must be equal to 16 always as it is a 128bit md5 sum.
+		 * @returns Returns true when the checksum could be verified, false otherwise.
+		 */
+		bool VerifyChecksum(ZipInputStreamBuffer& buffer, const unsigned char* checksum, size_t size) const;
+
 		/*!
 		 * Verifies the checksum of the main document ISO5436-2 XML file.
 		 */
 		void VerifyMainChecksum();
 
 		/*!
-		 * Verifies the checksum of the binary point data file.
+		 * Verifies the checksum of the binary point data archive entry.
+		 * @param buffer The archive entry which has been read.
 		 */
-		void VerifyDataBinChecksum();
+		void VerifyDataBinChecksum(ZipInputStreamBuffer& buffer);
 
 		/*!
-		 * Verifies the checksum of the binary point validity data file.
+		 * Verifies the checksum of the binary point validity data archive entry.
+		 * @param buffer The archive entry which has been read.
 		 */
-		void VerifyValidBinChecksum();
+		void VerifyValidBinChecksum(ZipInputStreamBuffer& buffer);
+
+		/*!
+		 * Verifies the checksums of the unpacked binary point data file and
+		 * of the point validity data file if there is one. Both files are hashed at once.
+		 */
+		void VerifyBinChecksums();
 
 		/*!
 		 * Check if all checksums were verified.
@@ -609,6 +931,14 @@ namespace OpenGPS
 		 */
 		bool ReadMd5FromFile(const String& fileName, std::array<unsigned char, 16>& checksum) const;
 
+		/*!
+		 * Reads the first md5 checksum from a stream that contains md5 checksums of files.
+		 * @param stream The stream that contains md5 checksums.
+		 * @param checksum Target of the extracted checksum.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool ReadMd5FromStream(std::istream& stream, std::array<unsigned char, 16>& checksum) const;
+
 		/*!
 		 * Extracts the three components of a point vector.
 		 *
@@ -625,7 +955,7 @@ namespace OpenGPS
 			const PointVector& vector,
 			OGPS_Double* x,
 			OGPS_Double* y,
-			OGPS_Double* z);
+			OGPS_Double* z) const;
 
 		/*! Returns true if the axis has an incremental axis definition, false otherwise. If true point data of that axis is known implicitly. */
 		bool IsIncrementalAxis(Schemas::ISO5436_2::AxisType axis) const;
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/cxx/iso5436_2_reader.hxx>
+
+#include "archive_reader.hxx"
+#include "stdafx.hxx"
+
+ISO5436_2Reader::ISO5436_2Reader(const String& file)
+{
+	m_Instance = std::make_unique<ArchiveReader>(std::make_shared<FileByteSource>(file));
+}
+
+ISO5436_2Reader::ISO5436_2Reader(std::shared_ptr<const ByteSource> source)
+{
+	m_Instance = std::make_unique<ArchiveReader>(std::move(source));
+}
+
+ISO5436_2Reader::~ISO5436_2Reader()
+{
+}
+
+void ISO5436_2Reader::Open()
+{
+	m_Instance->Open();
+}
+
+const ISO5436_2Reader::Metadata& ISO5436_2Reader::GetMetadata() const
+{
+	return m_Instance->GetMetadata();
+}
+
+void ISO5436_2Reader::GetMatrixPoint(size_t u, size_t v, size_t w, PointVector& vector) const
+{
+	m_Instance->GetMatrixPoint(u, v, w, vector);
+}
+
+void ISO5436_2Reader::GetListPoint(size_t index, PointVector& vector) const
+{
+	m_Instance->GetListPoint(index, vector);
+}
+
+void ISO5436_2Reader::GetMatrixCoord(size_t u, size_t v, size_t w, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const
+{
+	m_Instance->GetMatrixCoord(u, v, w, x, y, z);
+}
+
+void ISO5436_2Reader::GetListCoord(size_t index, OGPS_Double* x, OGPS_Double* y, OGPS_Double* z) const
+{
+	m_Instance->GetListCoord(index, x, y, z);
+}
+
+bool ISO5436_2Reader::IsMatrixCoordValid(size_t u, size_t v, size_t w) const
+{
+	return m_Instance->IsMatrixCoordValid(u, v, w);
+}
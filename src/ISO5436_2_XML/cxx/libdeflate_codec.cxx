@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#ifdef _OPENGPS_HAVE_LIBDEFLATE
+
+#include "libdeflate_codec.hxx"
+#include "zlib_codec.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+/* libdeflate */
+#include <libdeflate.h>
+
+#include "stdafx.hxx"
+
+/*
+ * Maximum amount of data libdeflate handles in memory at once.
+ * Larger archive entries and entries of unknown size are streamed through zlib instead.
+ */
+#define _OPENGPS_LIBDEFLATE_MAX_BUFFER (4*1024*1024)
+
+/*
+ * The default level of zlib, which is also the default used by libdeflate.
+ */
+#define _OPENGPS_LIBDEFLATE_DEFAULT_LEVEL 6
+
+LibdeflateDeflater::LibdeflateDeflater(int level, size_t length, ZipCodecSink sink)
+	:m_Level{ level },
+	m_Sink{ std::move(sink) }
+{
+	m_Buffer.reserve(length);
+}
+
+LibdeflateDeflater::~LibdeflateDeflater() = default;
+
+bool LibdeflateDeflater::Write(const char* data, size_t size)
+{
+	if (m_Fallback)
+	{
+		return m_Fallback->Write(data, size);
+	}
+
+	if (m_Buffer.size() + size > _OPENGPS_LIBDEFLATE_MAX_BUFFER)
+	{
+		m_Fallback = std::make_unique<ZlibDeflater>(m_Level, m_Sink);
+
+		const auto success{ m_Fallback->Write(m_Buffer.data(), m_Buffer.size()) };
+
+		std::vector<char>().swap(m_Buffer);
+
+		return success && m_Fallback->Write(data, size);
+	}
+
+	m_Buffer.insert(m_Buffer.end(), data, data + size);
+
+	return true;
+}
+
+bool LibdeflateDeflater::Finish()
+{
+	if (m_Fallback)
+	{
+		return m_Fallback->Finish();
+	}
+
+	const auto level{ m_Level < 0 ? _OPENGPS_LIBDEFLATE_DEFAULT_LEVEL : m_Level };
+
+	auto compressor{ libdeflate_alloc_compressor(level) };
+	if (!compressor)
+	{
+		return false;
+	}
+
+	std::vector<char> output(libdeflate_deflate_compress_bound(compressor, m_Buffer.size()));
+	const auto size{ libdeflate_deflate_compress(compressor, m_Buffer.data(), m_Buffer.size(), output.data(), output.size()) };
+
+	libdeflate_free_compressor(compressor);
+
+	std::vector<char>().swap(m_Buffer);
+
+	return size > 0 && m_Sink(output.data(), size);
+}
+
+LibdeflateInflater::LibdeflateInflater(size_t compressedSize, size_t uncompressedSize)
+	:m_CompressedSize{ compressedSize },
+	m_Output(uncompressedSize)
+{
+	m_Input.reserve(compressedSize);
+}
+
+LibdeflateInflater::~LibdeflateInflater() = default;
+
+void LibdeflateInflater::SetInput(const char* data, size_t size)
+{
+	assert(NeedsInput());
+
+	const auto chunk{ std::min(size, m_CompressedSize - m_Input.size()) };
+	m_Input.insert(m_Input.end(), data, data + chunk);
+}
+
+bool LibdeflateInflater::NeedsInput() const
+{
+	return !m_IsDecompressed && m_Input.size() < m_CompressedSize;
+}
+
+void LibdeflateInflater::Decompress()
+{
+	assert(!m_IsDecompressed && m_Input.size() == m_CompressedSize);
+
+	m_IsDecompressed = true;
+
+	auto decompressor{ libdeflate_alloc_decompressor() };
+	if (!decompressor)
+	{
+		m_IsGood = false;
+		return;
+	}
+
+	// Without a pointer to the actual size libdeflate verifies that
+	// the uncompressed data fills the target buffer exactly.
+	const auto result{ libdeflate_deflate_decompress(decompressor, m_Input.data(), m_Input.size(), m_Output.data(), m_Output.size(), nullptr) };
+
+	libdeflate_free_decompressor(decompressor);
+
+	std::vector<char>().swap(m_Input);
+
+	m_IsGood = (result == LIBDEFLATE_SUCCESS);
+}
+
+size_t LibdeflateInflater::Read(char* data, size_t size)
+{
+	if (!m_IsDecompressed)
+	{
+		if (NeedsInput())
+		{
+			return 0;
+		}
+
+		Decompress();
+	}
+
+	if (!m_IsGood)
+	{
+		return 0;
+	}
+
+	const auto chunk{ std::min(size, m_Output.size() - m_Position) };
+	memcpy(data, m_Output.data() + m_Position, chunk);
+	m_Position += chunk;
+
+	return chunk;
+}
+
+bool LibdeflateInflater::IsFinished() const
+{
+	return m_IsDecompressed && m_IsGood && m_Position == m_Output.size();
+}
+
+bool LibdeflateInflater::IsGood() const
+{
+	return m_IsGood;
+}
+
+LibdeflateCodec::~LibdeflateCodec() = default;
+
+const OGPS_Character* LibdeflateCodec::GetName() const
+{
+	return _T("libdeflate");
+}
+
+std::unique_ptr<ZipDeflater> LibdeflateCodec::CreateDeflater(int level, unsigned long long length, ZipCodecSink sink) const
+{
+	if (length == 0 || length > _OPENGPS_LIBDEFLATE_MAX_BUFFER)
+	{
+		return std::make_unique<ZlibDeflater>(level, std::move(sink));
+	}
+
+	return std::make_unique<LibdeflateDeflater>(level, static_cast<size_t>(length), std::move(sink));
+}
+
+std::unique_ptr<ZipInflater> LibdeflateCodec::CreateInflater(unsigned long long compressedSize, unsigned long long uncompressedSize) const
+{
+	if (compressedSize > _OPENGPS_LIBDEFLATE_MAX_BUFFER || uncompressedSize > _OPENGPS_LIBDEFLATE_MAX_BUFFER)
+	{
+		return std::make_unique<ZlibInflater>();
+	}
+
+	return std::make_unique<LibdeflateInflater>(static_cast<size_t>(compressedSize), static_cast<size_t>(uncompressedSize));
+}
+
+#endif /* _OPENGPS_HAVE_LIBDEFLATE */
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Implementation of the deflate codec based on libdeflate.
+ */
+
+#ifndef _OPENGPS_LIBDEFLATE_CODEC_HXX
+#define _OPENGPS_LIBDEFLATE_CODEC_HXX
+
+#ifdef _OPENGPS_HAVE_LIBDEFLATE
+
+#include "zip_codec.hxx"
+
+#include <vector>
+
+namespace OpenGPS
+{
+	/*!
+	 * Implements OpenGPS::ZipDeflater based on libdeflate.
+	 *
+	 * libdeflate compresses whole buffers only, which is considerably faster than
+	 * streaming. Therefore data is collected in memory until OpenGPS::ZipDeflater::Finish
+	 * is called. It is used for small entries of a known size only. If more data than
+	 * a fixed limit is written nevertheless, compression falls back to OpenGPS::ZlibDeflater
+	 * to keep memory usage bounded.
+	 */
+	class LibdeflateDeflater : public ZipDeflater
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param level The level of compression, i.e. 0 to 9 or Z_DEFAULT_COMPRESSION.
+		 * @param length The expected size of the uncompressed data, which is reserved in advance.
+		 * @param sink Receives the compressed data.
+		 */
+		LibdeflateDeflater(int level, size_t length, ZipCodecSink sink);
+
+		/*! Destroys this instance. */
+		~LibdeflateDeflater() override;
+
+		bool Write(const char* data, size_t size) override;
+		bool Finish() override;
+
+	private:
+		/*! The level of compression. */
+		int m_Level;
+
+		/*! Target of compressed data. */
+		ZipCodecSink m_Sink;
+
+		/*! Uncompressed data collected so far. */
+		std::vector<char> m_Buffer;
+
+		/*! Streaming compressor used when the limit of the buffer is exceeded. */
+		std::unique_ptr<ZipDeflater> m_Fallback;
+	};
+
+	/*!
+	 * Implements OpenGPS::ZipInflater based on libdeflate.
+	 * All compressed data is collected before it is decompressed at once.
+	 */
+	class LibdeflateInflater : public ZipInflater
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param compressedSize The exact size of the compressed data.
+		 * @param uncompressedSize The exact size of the uncompressed data.
+		 */
+		LibdeflateInflater(size_t compressedSize, size_t uncompressedSize);
+
+		/*! Destroys this instance. */
+		~LibdeflateInflater() override;
+
+		void SetInput(const char* data, size_t size) override;
+		bool NeedsInput() const override;
+		size_t Read(char* data, size_t size) override;
+		bool IsFinished() const override;
+		bool IsGood() const override;
+
+	private:
+		/*! Decompresses the collected input. */
+		void Decompress();
+
+		/*! The exact size of the compressed data. */
+		size_t m_CompressedSize;
+
+		/*! The compressed data collected so far. */
+		std::vector<char> m_Input;
+
+		/*! The decompressed data. */
+		std::vector<char> m_Output;
+
+		/*! The amount of decompressed data already read. */
+		size_t m_Position{};
+
+		/*! true if the input has been decompressed. */
+		bool m_IsDecompressed{};
+
+		/*! false if the compressed data is corrupted. */
+		bool m_IsGood{ true };
+	};
+
+	/*!
+	 * Creates instances of the libdeflate based codec.
+	 * Archive entries larger than a few MB and entries of unknown size are
+	 * handled by zlib to keep memory usage bounded.
+	 */
+	class LibdeflateCodec : public ZipCodec
+	{
+	public:
+		/*! Destroys this instance. */
+		~LibdeflateCodec() override;
+
+		const OGPS_Character* GetName() const override;
+		std::unique_ptr<ZipDeflater> CreateDeflater(int level, unsigned long long length, ZipCodecSink sink) const override;
+		std::unique_ptr<ZipInflater> CreateInflater(unsigned long long compressedSize, unsigned long long uncompressedSize) const override;
+	};
+}
+
+#endif /* _OPENGPS_HAVE_LIBDEFLATE */
+
+#endif
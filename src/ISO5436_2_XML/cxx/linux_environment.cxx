@@ -35,6 +35,9 @@
 #include <assert.h>
 #include <stdio.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <utime.h>
 #include <errno.h>
 #include <dirent.h>
 #include <string.h>
@@ -43,7 +46,10 @@
 
 #include <opengps/cxx/string.hxx>
 
+#include <atomic>
+#include <random>
 #include <sstream>
+#include <string>
 
 #ifdef _UNICODE
 
@@ -114,8 +120,6 @@ LinuxEnvironment::~LinuxEnvironment()
 {
 }
 
-bool LinuxEnvironment::m_InitRandom = true;
-
 OGPS_Character LinuxEnvironment::GetDirectorySeparator() const
 {
 	return _T('/');
@@ -333,24 +337,18 @@ bool LinuxEnvironment::RemoveFile(const String& file) const
 
 	//   return (DeleteFile(file.c_str()) != 0);
 	String tempFile(file.c_str());
-	return (remove(tempFile.ToChar()) != 0);
+	return (remove(tempFile.ToChar()) == 0);
 }
 
-#define GETRANDOM(min, max) ((rand()%(int)(((max) + 1)-(min)))+ (min))
-
 String LinuxEnvironment::GetUniqueName() const
 {
-	if (m_InitRandom)
-	{
-		srand((unsigned int)time(nullptr));
-		m_InitRandom = false;
-	}
-
-	// random positive number with max. 8 digits
-	int randNum = GETRANDOM(0, 10000000);
+	// The counter makes names unique within this process, the process id and
+	// a random number distinguish them from names used by other processes.
+	static std::atomic<unsigned long long> counter{};
+	thread_local std::mt19937 random{ std::random_device{}() };
 
 	OutStringStream os;
-	os << randNum;
+	os << getpid() << _T('-') << ++counter << _T('-') << random() % 10000000;
 
 	return os.str();
 }
@@ -367,6 +365,26 @@ bool LinuxEnvironment::CreateDir(const String& path) const
 	return (mkdir(tempPath.ToChar(), 0755) == 0);
 }
 
+String LinuxEnvironment::CreateUniqueDir(const String& base) const
+{
+	assert(base.length() > 0);
+
+	ResetLastErrorCode();
+
+	// mkdtemp tries other names until it creates a directory that did not exist
+	String pattern{ ConcatPathes(base, _T("x3pXXXXXX")) };
+	std::string path{ pattern.ToChar() };
+
+	if (!mkdtemp(&path[0]))
+	{
+		return String();
+	}
+
+	String uniquePath;
+	uniquePath.FromChar(path.c_str());
+	return uniquePath;
+}
+
 bool LinuxEnvironment::RemoveDir(const String& path) const
 {
 	DIR* dir;
@@ -378,27 +396,31 @@ bool LinuxEnvironment::RemoveDir(const String& path) const
 	String tempPath(path.c_str());
 	dir = opendir(tempPath.ToChar());
 	if (dir == nullptr)
-		return 0;
+		return false;
+
+	bool success = true;
 	while ((entry = readdir(dir)) != nullptr)
 	{
 		if ((strcmp(entry->d_name, ".") == 0) || (strcmp(entry->d_name, "..") == 0))
 			continue;
-		else if (entry->d_type == DT_DIR)
+
+		// Entries are named relative to the directory being read
+		String name;
+		name.FromChar(entry->d_name);
+		String entryPath(ConcatPathes(path, name));
+
+		if (entry->d_type == DT_DIR)
 		{
-			String subdir;
-			subdir.FromChar(entry->d_name);
-			RemoveDir(subdir);
+			success = RemoveDir(entryPath) && success;
 		}
 		else
 		{
-			remove(entry->d_name);
+			success = (remove(entryPath.ToChar()) == 0) && success;
 		}
 	}
 	closedir(dir);
 
-	remove(tempPath.ToChar());
-
-	return (errno != 0);
+	return (rmdir(tempPath.ToChar()) == 0) && success;
 }
 
 String LinuxEnvironment::GetTempDir() const
@@ -435,6 +457,15 @@ bool LinuxEnvironment::RenameFile(const String& src, const String& dst) const
 
 	String tempSrc(src.c_str());
 	String tempDst(dst.c_str());
+
+	// Renaming within a file system is atomic, copy across file systems only.
+	if (rename(tempSrc.ToChar(), tempDst.ToChar()) == 0)
+	{
+		return true;
+	}
+
+	ResetLastErrorCode();
+
 	//   ret = copy(tempSrc.ToChar(), tempDst.ToChar());
 	ret = copyFile(tempSrc.ToChar(), tempDst.ToChar());
 	ret += unlink(tempSrc.ToChar());
@@ -443,6 +474,208 @@ bool LinuxEnvironment::RenameFile(const String& src, const String& dst) const
 	//   return (MoveFileEx(src.c_str(), dst.c_str(), MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
 }
 
+bool LinuxEnvironment::GetFiles(const String& path, std::vector<FileInfo>& files) const
+{
+	assert(path.length() > 0);
+
+	ResetLastErrorCode();
+
+	String tempPath(path.c_str());
+	DIR* dir = opendir(tempPath.ToChar());
+	if (dir == nullptr)
+	{
+		return false;
+	}
+
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != nullptr)
+	{
+		String name;
+		name.FromChar(entry->d_name);
+
+		FileInfo info;
+		if (GetFileInfo(ConcatPathes(path, name), info))
+		{
+			files.push_back(info);
+		}
+	}
+	closedir(dir);
+
+	ResetLastErrorCode();
+
+	return true;
+}
+
+bool LinuxEnvironment::GetFileInfo(const String& file, FileInfo& info) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	String tempFile(file.c_str());
+	struct stat fileStat;
+	if (stat(tempFile.ToChar(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+	{
+		return false;
+	}
+
+	info.name = GetFileName(file);
+	info.size = fileStat.st_size;
+	info.modified = static_cast<long long>(fileStat.st_mtim.tv_sec) * 1000000000LL + fileStat.st_mtim.tv_nsec;
+
+	return true;
+}
+
+bool LinuxEnvironment::TouchFile(const String& file) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	String tempFile(file.c_str());
+	return (utime(tempFile.ToChar(), nullptr) == 0);
+}
+
+std::shared_ptr<unsigned char> LinuxEnvironment::MapFile(const String& file, size_t& size) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	size = 0;
+
+	String tempFile(file.c_str());
+	const int fd = open(tempFile.ToChar(), O_RDONLY);
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+
+	struct stat fileStat;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+	{
+		data = mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	}
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	const size_t length = fileStat.st_size;
+	size = length;
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [length](unsigned char* p) { munmap(p, length); });
+}
+
+bool LinuxEnvironment::PrefetchFile(const String& file) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	String tempFile(file.c_str());
+	const int fd = open(tempFile.ToChar(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	// The pages read stay in the page cache after the file is closed
+	const bool success = (posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0);
+	close(fd);
+
+	return success;
+}
+
+std::shared_ptr<unsigned char> LinuxEnvironment::CreateSharedMemory(const String& name, size_t size, bool allUsers) const
+{
+	assert(name.length() > 0 && size > 0);
+
+	ResetLastErrorCode();
+
+	String tempName(_T("/"));
+	tempName += name;
+	const int fd = shm_open(tempName.ToChar(), O_CREAT | O_EXCL | O_RDWR, allUsers ? S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH : S_IRUSR | S_IWUSR);
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+
+	void* data = MAP_FAILED;
+	if (ftruncate(fd, size) == 0)
+	{
+		data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		shm_unlink(tempName.ToChar());
+		return nullptr;
+	}
+
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [size](unsigned char* p) { munmap(p, size); });
+}
+
+std::shared_ptr<unsigned char> LinuxEnvironment::MapSharedMemory(const String& name, size_t& size, bool allUsers) const
+{
+	assert(name.length() > 0);
+
+	ResetLastErrorCode();
+
+	size = 0;
+
+	String tempName(_T("/"));
+	tempName += name;
+	const int fd = shm_open(tempName.ToChar(), O_RDONLY, 0);
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+
+	// Anyone may create a segment of any name, so its owner and permissions are verified.
+	struct stat segmentStat;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &segmentStat) == 0 && segmentStat.st_size > 0 &&
+		(allUsers || segmentStat.st_uid == geteuid()) && (segmentStat.st_mode & (S_IWGRP | S_IWOTH)) == 0)
+	{
+		data = mmap(nullptr, segmentStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+		// Segments are removed in the order of their last use.
+		// Only possible if the segment belongs to the current user.
+		futimens(fd, nullptr);
+	}
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	const size_t length = segmentStat.st_size;
+	size = length;
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [length](unsigned char* p) { munmap(p, length); });
+}
+
+bool LinuxEnvironment::RemoveSharedMemory(const String& name) const
+{
+	assert(name.length() > 0);
+
+	ResetLastErrorCode();
+
+	String tempName(_T("/"));
+	tempName += name;
+	return (shm_unlink(tempName.ToChar()) == 0);
+}
+
+bool LinuxEnvironment::GetSharedMemory(std::vector<FileInfo>& segments) const
+{
+	// Named segments are files of the tmpfs mounted here.
+	return GetFiles(_T("/dev/shm"), segments);
+}
+
 bool LinuxEnvironment::GetVariable(const String& varName, String& value) const
 {
 	ResetLastErrorCode();
@@ -63,18 +63,25 @@ namespace OpenGPS
 		bool RemoveFile(const String& file) const override;
 		String GetUniqueName() const override;
 		bool CreateDir(const String& path) const override;
+		String CreateUniqueDir(const String& base) const override;
 		bool RemoveDir(const String& path) const override;
 		String GetTempDir() const override;
 		bool RenameFile(const String& src, const String& dst) const override;
+		bool GetFiles(const String& path, std::vector<FileInfo>& files) const override;
+		bool GetFileInfo(const String& file, FileInfo& info) const override;
+		bool TouchFile(const String& file) const override;
+		std::shared_ptr<unsigned char> MapFile(const String& file, size_t& size) const override;
+		bool PrefetchFile(const String& file) const override;
+		std::shared_ptr<unsigned char> CreateSharedMemory(const String& name, size_t size, bool allUsers) const override;
+		std::shared_ptr<unsigned char> MapSharedMemory(const String& name, size_t& size, bool allUsers) const override;
+		bool RemoveSharedMemory(const String& name) const override;
+		bool GetSharedMemory(std::vector<FileInfo>& segments) const override;
 		bool GetVariable(const String& varName, String& value) const override;
 		String GetLastErrorMessage() const override;
 
 	private:
 		/*! Resets the last system error API code. */
 		void ResetLastErrorCode() const;
-
-		/*! Tracks whether the sofware randomization API still needs to be initialized before its usage. */
-		static bool m_InitRandom;
 	};
 }
 
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Access point data kept in a file mapped into memory.
+ */
+
+#ifndef _OPENGPS_MAPPED_POINT_BUFFER_HXX
+#define _OPENGPS_MAPPED_POINT_BUFFER_HXX
+
+#include "point_buffer.hxx"
+#include "mapped_storage.hxx"
+
+namespace OpenGPS
+{
+	/*!
+	 * Manages typesafe access to point data kept by an OpenGPS::MappedStorage.
+	 * Values are accessed where the file has been mapped to without being copied.
+	 * Changes are private to this process and never written back to the file.
+	 */
+	template<typename TValue, OGPS_DataPointType TType> class MappedPointBufferT : public PointBuffer
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param storage The storage shared by all point buffers of a vector buffer.
+		 */
+		MappedPointBufferT(std::shared_ptr<MappedStorage> storage)
+			:m_Storage{ storage }
+		{
+			assert(m_Storage);
+		}
+
+		void Allocate(size_t size) override
+		{
+			m_Values = reinterpret_cast<TValue*>(m_Storage->Reserve(size * sizeof(TValue)));
+			SetSize(size);
+		}
+
+		void Set(size_t index, TValue value) override
+		{
+			assert(index < GetSize() && m_Values);
+
+			m_Values[index] = value;
+		}
+
+		void Get(size_t index, TValue& value) const override
+		{
+			assert(index < GetSize() && m_Values);
+
+			value = m_Values[index];
+		}
+
+		OGPS_DataPointType GetPointType() const override
+		{
+			return TType;
+		}
+
+	private:
+		/*! The storage of point data. */
+		std::shared_ptr<MappedStorage> m_Storage;
+
+		/*! The values within the region reserved. */
+		TValue* m_Values{};
+	};
+
+	typedef MappedPointBufferT<OGPS_Int16, OGPS_Int16PointType> Int16MappedPointBuffer;
+	typedef MappedPointBufferT<OGPS_Int32, OGPS_Int32PointType> Int32MappedPointBuffer;
+	typedef MappedPointBufferT<OGPS_Float, OGPS_FloatPointType> FloatMappedPointBuffer;
+	typedef MappedPointBufferT<OGPS_Double, OGPS_DoublePointType> DoubleMappedPointBuffer;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "mapped_storage.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+MappedStorage::MappedStorage(std::shared_ptr<unsigned char> data, size_t size, size_t offset, size_t alignment)
+	:m_Data{ data },
+	m_Size{ size },
+	m_Offset{ offset },
+	m_Alignment{ alignment }
+{
+	assert(m_Data && m_Alignment > 0);
+}
+
+unsigned char* MappedStorage::Reserve(size_t size)
+{
+	const auto offset{ Align(m_Offset, m_Alignment) };
+
+	if (offset > m_Size || size > m_Size - offset)
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The file of mapped point data is too small."),
+			_EX_T("The file does not contain all point data expected. It may have been truncated."),
+			_EX_T("OpenGPS::MappedStorage::Reserve"));
+	}
+
+	m_Offset = offset + size;
+
+	return m_Data.get() + offset;
+}
+
+size_t MappedStorage::Align(size_t offset, size_t alignment)
+{
+	assert(alignment > 0);
+
+	return (offset + alignment - 1) / alignment * alignment;
+}
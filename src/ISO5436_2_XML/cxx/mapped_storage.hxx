@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Point data kept in a file mapped into memory.
+ */
+
+#ifndef _OPENGPS_MAPPED_STORAGE_HXX
+#define _OPENGPS_MAPPED_STORAGE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <memory>
+
+namespace OpenGPS
+{
+	/*!
+	 * Provides storage of point data within memory mapped from a file.
+	 *
+	 * Point data is not copied but accessed where the file has been mapped to.
+	 * Several instances of OpenGPS::PointBuffer share one instance, each of them
+	 * reserving its own region by MappedStorage::Reserve. Regions follow each other
+	 * in the order reserved, each of them starting at an aligned offset.
+	 */
+	class MappedStorage
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param data The memory the file has been mapped to.
+		 * @param size The size of the memory mapped in bytes.
+		 * @param offset The offset of the first region in bytes.
+		 * @param alignment The alignment of the offset of every region in bytes.
+		 */
+		MappedStorage(std::shared_ptr<unsigned char> data, size_t size, size_t offset, size_t alignment);
+
+		/*!
+		 * Reserves the next region of the storage.
+		 * Throws an exception if the region exceeds the memory mapped.
+		 * @param size The size of the region in bytes.
+		 * @returns Returns the memory of the region.
+		 */
+		unsigned char* Reserve(size_t size);
+
+		/*!
+		 * Rounds up an offset to the next multiple of an alignment.
+		 * @param offset The offset in bytes.
+		 * @param alignment The alignment in bytes.
+		 */
+		static size_t Align(size_t offset, size_t alignment);
+
+	private:
+		/*! The memory the file has been mapped to. */
+		std::shared_ptr<unsigned char> m_Data;
+
+		/*! The size of the memory mapped in bytes. */
+		size_t m_Size;
+
+		/*! The offset of the end of the region reserved last in bytes. */
+		size_t m_Offset;
+
+		/*! The alignment of the offset of every region in bytes. */
+		size_t m_Alignment;
+	};
+}
+
+#endif
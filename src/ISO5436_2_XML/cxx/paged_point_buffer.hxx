@@ -0,0 +1,136 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Store point data in memory pages that get swapped out to a temporary file.
+ */
+
+#ifndef _OPENGPS_PAGED_POINT_BUFFER_HXX
+#define _OPENGPS_PAGED_POINT_BUFFER_HXX
+
+#include "point_buffer.hxx"
+#include "paged_storage.hxx"
+
+namespace OpenGPS
+{
+	/*!
+	 * Manages typesafe access to point data kept by an OpenGPS::PagedStorage.
+	 * Point data need not fit into memory as a whole, since only the pages
+	 * recently used are resident.
+	 */
+	template<typename TValue, OGPS_DataPointType TType> class PagedPointBufferT : public PointBuffer
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param storage The storage shared by all point buffers of a vector buffer.
+		 */
+		PagedPointBufferT(std::shared_ptr<PagedStorage> storage)
+			:m_Storage{ storage }
+		{
+			assert(m_Storage);
+		}
+
+		void Allocate(size_t size) override
+		{
+			m_Offset = m_Storage->Reserve(size * sizeof(TValue));
+			SetSize(size);
+		}
+
+		void Set(size_t index, TValue value) override
+		{
+			assert(index < GetSize());
+
+			*Access(index, true) = value;
+		}
+
+		void Get(size_t index, TValue& value) const override
+		{
+			assert(index < GetSize());
+
+			value = *Access(index, false);
+		}
+
+		OGPS_DataPointType GetPointType() const override
+		{
+			return TType;
+		}
+
+	private:
+		/*!
+		 * Gets the memory location of a value.
+		 * The page most recently used is remembered to avoid lookups
+		 * when neighbouring values are accessed.
+		 * @param index The index of the value.
+		 * @param write true if the value is going to be changed.
+		 */
+		TValue* Access(size_t index, bool write) const
+		{
+			const auto pageSize{ m_Storage->GetPageSize() };
+			const auto position{ m_Offset + index * sizeof(TValue) };
+			const auto page{ position / pageSize };
+
+			if (!m_Page || page != m_PageIndex || m_Generation != m_Storage->GetGeneration() || (write && !m_IsWritable))
+			{
+				m_Page = m_Storage->Lock(page, write);
+				m_PageIndex = page;
+				m_Generation = m_Storage->GetGeneration();
+				m_IsWritable = write;
+			}
+
+			return reinterpret_cast<TValue*>(m_Page + position % pageSize);
+		}
+
+		/*! The storage of point data. */
+		std::shared_ptr<PagedStorage> m_Storage;
+
+		/*! The offset of the region reserved within the storage in bytes. */
+		size_t m_Offset{};
+
+		/*! The memory of the page most recently used or nullptr. */
+		mutable unsigned char* m_Page{};
+
+		/*! The index of the page most recently used. */
+		mutable size_t m_PageIndex{};
+
+		/*! The generation of the storage when the page most recently used was locked. */
+		mutable size_t m_Generation{};
+
+		/*! true if the page most recently used has been locked for writing. */
+		mutable bool m_IsWritable{};
+	};
+
+	typedef PagedPointBufferT<OGPS_Int16, OGPS_Int16PointType> Int16PagedPointBuffer;
+	typedef PagedPointBufferT<OGPS_Int32, OGPS_Int32PointType> Int32PagedPointBuffer;
+	typedef PagedPointBufferT<OGPS_Float, OGPS_FloatPointType> FloatPagedPointBuffer;
+	typedef PagedPointBufferT<OGPS_Double, OGPS_DoublePointType> DoublePagedPointBuffer;
+}
+
+#endif
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "paged_storage.hxx"
+#include "environment.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <algorithm>
+#include <cstring>
+
+PagedStorage::PagedStorage(const String& filePath, size_t pageSize, size_t memoryBudget, size_t prefetchPages)
+	:m_FilePath{ filePath },
+	// Pages must hold whole values of every data type.
+	m_PageSize{ std::max(pageSize / sizeof(OGPS_Double), static_cast<size_t>(1)) * sizeof(OGPS_Double) },
+	m_MaxPages{ std::max(memoryBudget / m_PageSize, prefetchPages + 2) },
+	m_PrefetchPages{ prefetchPages }
+{
+}
+
+PagedStorage::~PagedStorage()
+{
+	if (m_File.is_open())
+	{
+		m_File.close();
+		Environment::GetInstance()->RemoveFile(m_FilePath);
+	}
+}
+
+size_t PagedStorage::GetPageSize() const
+{
+	return m_PageSize;
+}
+
+size_t PagedStorage::Reserve(size_t size)
+{
+	const auto offset{ m_PageCount * m_PageSize };
+
+	m_PageCount += size / m_PageSize + (size % m_PageSize != 0 ? 1 : 0);
+
+	return offset;
+}
+
+unsigned char* PagedStorage::Lock(size_t page, bool write)
+{
+	assert(page < m_PageCount);
+
+	auto found{ m_Pages.find(page) };
+
+	if (found == m_Pages.end())
+	{
+		found = Load(page);
+	}
+
+	m_Recent.splice(m_Recent.begin(), m_Recent, found->second.recent);
+
+	if (write)
+	{
+		found->second.isDirty = true;
+	}
+
+	return found->second.data.get();
+}
+
+size_t PagedStorage::GetGeneration() const
+{
+	return m_Generation;
+}
+
+PagedStorage::PageMap::iterator PagedStorage::Load(size_t page)
+{
+	// Read ahead if pages are accessed in ascending order.
+	size_t count{ 1 };
+	if (page == m_LastLoaded + 1)
+	{
+		while (count <= m_PrefetchPages && page + count < m_PageCount && m_Pages.find(page + count) == m_Pages.end())
+		{
+			++count;
+		}
+	}
+
+	// Make room first, since writing to the spill file moves its position.
+	while (m_Pages.size() + count > m_MaxPages)
+	{
+		Evict();
+	}
+
+	const auto offset{ static_cast<unsigned long long>(page) * m_PageSize };
+	if (m_File.is_open() && offset < m_FileSize)
+	{
+		m_File.seekg(offset);
+	}
+
+	PageMap::iterator requested;
+
+	for (size_t n = 0; n < count; ++n)
+	{
+		Page entry{ std::make_unique<unsigned char[]>(m_PageSize), m_Recent.end(), false };
+
+		// Pages which have never been written are zero.
+		const auto position{ offset + static_cast<unsigned long long>(n) * m_PageSize };
+		const auto available{ position < m_FileSize ? static_cast<size_t>(std::min<unsigned long long>(m_FileSize - position, m_PageSize)) : 0 };
+
+		if (available > 0)
+		{
+			m_File.read(reinterpret_cast<char*>(entry.data.get()), available);
+
+			CheckFileAndThrowException();
+		}
+
+		memset(entry.data.get() + available, 0, m_PageSize - available);
+
+		// Pages read ahead are the first to be dropped if they are never used.
+		const auto inserted{ m_Pages.emplace(page + n, std::move(entry)).first };
+		inserted->second.recent = m_Recent.insert(n == 0 ? m_Recent.begin() : m_Recent.end(), page + n);
+
+		if (n == 0)
+		{
+			requested = inserted;
+		}
+	}
+
+	m_LastLoaded = page + count - 1;
+
+	return requested;
+}
+
+void PagedStorage::Evict()
+{
+	assert(!m_Recent.empty());
+
+	const auto page{ m_Recent.back() };
+	const auto found{ m_Pages.find(page) };
+
+	assert(found != m_Pages.end());
+
+	if (found->second.isDirty)
+	{
+		if (!m_File.is_open())
+		{
+			m_File.open(m_FilePath.ToChar(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+			CheckFileAndThrowException();
+		}
+
+		const auto offset{ static_cast<unsigned long long>(page) * m_PageSize };
+
+		// Fill any gap with zeros, since seeking beyond the end of a file is not portable.
+		if (offset > m_FileSize)
+		{
+			m_File.seekp(m_FileSize);
+
+			const auto zeros{ std::make_unique<char[]>(m_PageSize) };
+			memset(zeros.get(), 0, m_PageSize);
+
+			while (m_FileSize < offset)
+			{
+				const auto size{ static_cast<size_t>(std::min<unsigned long long>(offset - m_FileSize, m_PageSize)) };
+				m_File.write(zeros.get(), size);
+				m_FileSize += size;
+			}
+		}
+
+		m_File.seekp(offset);
+		m_File.write(reinterpret_cast<const char*>(found->second.data.get()), m_PageSize);
+		m_File.flush();
+
+		CheckFileAndThrowException();
+
+		m_FileSize = std::max(m_FileSize, offset + m_PageSize);
+	}
+
+	m_Recent.pop_back();
+	m_Pages.erase(found);
+
+	++m_Generation;
+}
+
+void PagedStorage::CheckFileAndThrowException()
+{
+	if (m_File.fail())
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("Could not access the temporary file of paged point data."),
+			_EX_T("Check for filesystem permissions and enough space in the directory for temporary files."),
+			_EX_T("OpenGPS::PagedStorage::CheckFileAndThrowException"));
+	}
+}
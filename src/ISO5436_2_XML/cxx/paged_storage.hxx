@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Memory pages of point data swapped out to a temporary file.
+ */
+
+#ifndef _OPENGPS_PAGED_STORAGE_HXX
+#define _OPENGPS_PAGED_STORAGE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace OpenGPS
+{
+	/*!
+	 * Provides storage of point data that does not need to fit into memory.
+	 *
+	 * The storage is split into pages of fixed size. At most a configurable amount
+	 * of memory is occupied by resident pages. When more pages are needed, the least
+	 * recently used page gets written to a temporary spill file and is dropped from
+	 * memory. Pages which have never been written are read as zeros. When pages are
+	 * accessed in ascending order, subsequent pages are read ahead within a single
+	 * read operation.
+	 *
+	 * Several instances of OpenGPS::PointBuffer share one instance, each of them
+	 * reserving its own region by PagedStorage::Reserve. Then the memory budget
+	 * applies to all axes of a vector buffer.
+	 */
+	class PagedStorage
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param filePath The path of the temporary spill file. The file is not created
+		 * unless pages need to be swapped out.
+		 * @param pageSize The size of a single page in bytes.
+		 * @param memoryBudget The amount of memory in bytes occupied by resident pages.
+		 * @param prefetchPages The amount of pages to be read ahead on sequential access.
+		 */
+		PagedStorage(const String& filePath, size_t pageSize, size_t memoryBudget, size_t prefetchPages);
+
+		/*! Destroys this instance and removes the spill file. */
+		~PagedStorage();
+
+		/*! Gets the size of a single page in bytes. */
+		size_t GetPageSize() const;
+
+		/*!
+		 * Reserves a region of the storage that starts at a page boundary.
+		 * @param size The size of the region in bytes.
+		 * @returns Returns the offset of the region in bytes.
+		 */
+		size_t Reserve(size_t size);
+
+		/*!
+		 * Makes a page resident and marks it as the most recently used.
+		 * @param page The index of the page.
+		 * @param write true if the content of the page is going to be changed.
+		 * @returns Returns the memory of the page. It remains valid until
+		 * PagedStorage::GetGeneration changes.
+		 */
+		unsigned char* Lock(size_t page, bool write);
+
+		/*! Gets a counter that changes whenever a page is dropped from memory. */
+		size_t GetGeneration() const;
+
+	private:
+		/*! A page resident in memory. */
+		struct Page
+		{
+			/*! The content of the page. */
+			std::unique_ptr<unsigned char[]> data;
+
+			/*! The position of the page within PagedStorage::m_Recent. */
+			std::list<size_t>::iterator recent;
+
+			/*! true if the content differs from the spill file. */
+			bool isDirty;
+		};
+
+		typedef std::unordered_map<size_t, Page> PageMap;
+
+		/*!
+		 * Reads a page and possibly its successors from the spill file.
+		 * @param page The index of the page requested.
+		 * @returns Returns the resident page requested.
+		 */
+		PageMap::iterator Load(size_t page);
+
+		/*! Drops the least recently used page and writes it to the spill file if needed. */
+		void Evict();
+
+		/*! Throws an exception if the spill file could not be accessed. */
+		void CheckFileAndThrowException();
+
+		/*! The path of the spill file. */
+		String m_FilePath;
+
+		/*! The spill file. */
+		std::fstream m_File;
+
+		/*! The amount of bytes written to the spill file. */
+		unsigned long long m_FileSize{};
+
+		/*! The size of a single page in bytes. */
+		size_t m_PageSize;
+
+		/*! The maximum amount of resident pages. */
+		size_t m_MaxPages;
+
+		/*! The amount of pages to be read ahead. */
+		size_t m_PrefetchPages;
+
+		/*! The amount of pages reserved. */
+		size_t m_PageCount{};
+
+		/*! The index of the page most recently read from the spill file. */
+		size_t m_LastLoaded{ static_cast<size_t>(-1) };
+
+		/*! Changes whenever a page is dropped from memory. */
+		size_t m_Generation{};
+
+		/*! The resident pages. */
+		PageMap m_Pages;
+
+		/*! Indexes of resident pages, the most recently used first. */
+		std::list<size_t> m_Recent;
+	};
+}
+
+#endif
@@ -0,0 +1,157 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "point_block_buffer.hxx"
+#include <opengps/cxx/point_vector_base.hxx>
+#include <opengps/cxx/data_point.hxx>
+#include "stdafx.hxx"
+
+PointBlockBuffer::PointBlockBuffer(OGPS_DataPointType xType, OGPS_DataPointType yType, OGPS_DataPointType zType, size_t capacity)
+	:m_Capacity{ capacity },
+	m_Valid{ std::make_unique<OGPS_Boolean[]>(capacity) },
+	m_Block{}
+{
+	assert(capacity > 0);
+
+	if (xType != OGPS_MissingPointType)
+	{
+		m_X = std::make_unique<unsigned char[]>(capacity * GetDataTypeSize(xType));
+	}
+
+	if (yType != OGPS_MissingPointType)
+	{
+		m_Y = std::make_unique<unsigned char[]>(capacity * GetDataTypeSize(yType));
+	}
+
+	if (zType != OGPS_MissingPointType)
+	{
+		m_Z = std::make_unique<unsigned char[]>(capacity * GetDataTypeSize(zType));
+	}
+
+	m_Block.xType = xType;
+	m_Block.yType = yType;
+	m_Block.zType = zType;
+	m_Block.x = m_X.get();
+	m_Block.y = m_Y.get();
+	m_Block.z = m_Z.get();
+	m_Block.valid = m_Valid.get();
+}
+
+size_t PointBlockBuffer::GetDataTypeSize(OGPS_DataPointType type)
+{
+	switch (type)
+	{
+	case OGPS_Int16PointType:
+		return sizeof(OGPS_Int16);
+	case OGPS_Int32PointType:
+		return sizeof(OGPS_Int32);
+	case OGPS_FloatPointType:
+		return sizeof(OGPS_Float);
+	case OGPS_DoublePointType:
+		return sizeof(OGPS_Double);
+	default:
+		return 0;
+	}
+}
+
+void PointBlockBuffer::Copy(const DataPoint* src, OGPS_DataPointType type, unsigned char* dst) const
+{
+	assert(src);
+
+	const auto count{ m_Block.count };
+
+	// Components of invalid point vectors may be empty.
+	if (src->GetPointType() != type)
+	{
+		return;
+	}
+
+	switch (type)
+	{
+	case OGPS_Int16PointType:
+		src->Get(reinterpret_cast<OGPS_Int16*>(dst) + count);
+		break;
+	case OGPS_Int32PointType:
+		src->Get(reinterpret_cast<OGPS_Int32*>(dst) + count);
+		break;
+	case OGPS_FloatPointType:
+		src->Get(reinterpret_cast<OGPS_Float*>(dst) + count);
+		break;
+	case OGPS_DoublePointType:
+		src->Get(reinterpret_cast<OGPS_Double*>(dst) + count);
+		break;
+	default:
+		break;
+	}
+}
+
+void PointBlockBuffer::Append(const PointVectorBase& vector, bool valid)
+{
+	assert(!IsFull());
+
+	if (m_X)
+	{
+		Copy(vector.GetX(), m_Block.xType, m_X.get());
+	}
+
+	if (m_Y)
+	{
+		Copy(vector.GetY(), m_Block.yType, m_Y.get());
+	}
+
+	if (m_Z)
+	{
+		Copy(vector.GetZ(), m_Block.zType, m_Z.get());
+	}
+
+	m_Valid[m_Block.count] = valid;
+	++m_Block.count;
+}
+
+bool PointBlockBuffer::IsFull() const
+{
+	return m_Block.count == m_Capacity;
+}
+
+bool PointBlockBuffer::IsEmpty() const
+{
+	return m_Block.count == 0;
+}
+
+const OGPS_PointBlock& PointBlockBuffer::GetBlock() const
+{
+	return m_Block;
+}
+
+void PointBlockBuffer::Next()
+{
+	m_Block.index += m_Block.count;
+	m_Block.count = 0;
+}
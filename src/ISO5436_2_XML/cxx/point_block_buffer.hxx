@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Collects consecutive point vectors into typed arrays handed to a visitor.
+ */
+
+#ifndef _OPENGPS_POINT_BLOCK_BUFFER_HXX
+#define _OPENGPS_POINT_BLOCK_BUFFER_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/point_block.h>
+#include <memory>
+
+namespace OpenGPS
+{
+	class PointVectorBase;
+	class DataPoint;
+
+	/*!
+	 * Buffers a block of consecutive point vectors as typed arrays
+	 * and describes them by an ::OGPS_PointBlock.
+	 */
+	class PointBlockBuffer
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param xType The data type of the x axis.
+		 * @param yType The data type of the y axis.
+		 * @param zType The data type of the z axis.
+		 * @param capacity The maximum number of point vectors of a single block.
+		 */
+		PointBlockBuffer(OGPS_DataPointType xType, OGPS_DataPointType yType, OGPS_DataPointType zType, size_t capacity);
+
+		/*!
+		 * Appends a point vector to the current block.
+		 * @param vector The point vector to be copied.
+		 * @param valid true if the point vector contains measurement data.
+		 */
+		void Append(const PointVectorBase& vector, bool valid);
+
+		/*! Returns true if no more point vectors can be appended to the current block. */
+		bool IsFull() const;
+
+		/*! Returns true if no point vector has been appended to the current block yet. */
+		bool IsEmpty() const;
+
+		/*! Gets the description of the current block. */
+		const OGPS_PointBlock& GetBlock() const;
+
+		/*! Empties the buffer to collect the block that follows the current one. */
+		void Next();
+
+	private:
+		/*! Gets the size of a single component of the given type in bytes. */
+		static size_t GetDataTypeSize(OGPS_DataPointType type);
+
+		/*! Copies a single component to the array at the current position. */
+		void Copy(const DataPoint* src, OGPS_DataPointType type, unsigned char* dst) const;
+
+		/*! The maximum number of point vectors of a single block. */
+		size_t m_Capacity;
+
+		/*! The typed array of the x axis. */
+		std::unique_ptr<unsigned char[]> m_X;
+
+		/*! The typed array of the y axis. */
+		std::unique_ptr<unsigned char[]> m_Y;
+
+		/*! The typed array of the z axis. */
+		std::unique_ptr<unsigned char[]> m_Z;
+
+		/*! The validity of the point vectors. */
+		std::unique_ptr<OGPS_Boolean[]> m_Valid;
+
+		/*! Describes the current block. */
+		OGPS_PointBlock m_Block;
+	};
+}
+
+#endif
@@ -113,6 +113,13 @@ size_t PointBuffer::GetSize() const
    return m_Size;
 }
 
+void PointBuffer::SetSize(size_t size)
+{
+   assert(m_Size == 0);
+
+   m_Size = size;
+}
+
 void PointBuffer::Allocate(size_t)
 {
    throw Exception(
@@ -183,6 +183,12 @@ namespace OpenGPS
 		 */
 		template<typename T> std::unique_ptr<T[]> AllocateT(size_t size);
 
+		/*!
+		 * Sets the logical size of implementations that manage their memory without PointBuffer::AllocateT.
+		 * @param size Amount of point data to be stored.
+		 */
+		void SetSize(size_t size);
+
 	private:
 		/*! Logical size or amount of point data that can be stored. */
 		size_t m_Size{};
@@ -0,0 +1,227 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include <opengps/cxx/point_partition.hxx>
+#include <opengps/cxx/iso5436_2.hxx>
+#include <opengps/cxx/point_vector.hxx>
+
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+PointPartition::PointPartition(const ISO5436_2& document, size_t first, size_t count)
+	:m_Document{ &document },
+	m_IsMatrix{ document.IsMatrix() },
+	m_First{ first },
+	m_Count{ count }
+{
+	size_t size{};
+
+	if (m_IsMatrix)
+	{
+		document.GetMatrixDimensions(&m_SizeU, &size, &m_SizeW);
+	}
+	else
+	{
+		size = document.GetListDimension();
+	}
+
+	if (first > size || count > size - first)
+	{
+		throw Exception(
+			OGPS_ExInvalidArgument,
+			_EX_T("The partition lies outside the point data."),
+			_EX_T("The rows of a matrix or the indexes of a list addressed by a partition must exist within the document."),
+			_EX_T("OpenGPS::PointPartition::PointPartition"));
+	}
+
+	Reset();
+}
+
+bool PointPartition::IsMatrix() const
+{
+	return m_IsMatrix;
+}
+
+size_t PointPartition::GetFirst() const
+{
+	return m_First;
+}
+
+size_t PointPartition::GetCount() const
+{
+	return m_Count;
+}
+
+size_t PointPartition::GetPointCount() const
+{
+	return m_SizeU * m_Count * m_SizeW;
+}
+
+bool PointPartition::MoveNext()
+{
+	if (GetPointCount() == 0)
+	{
+		return false;
+	}
+
+	if (m_IsReset)
+	{
+		m_IsReset = false;
+
+		return true;
+	}
+
+	if (m_IsMatrix)
+	{
+		if (m_U + 1 < m_SizeU)
+		{
+			++m_U;
+
+			return true;
+		}
+
+		if (m_V + 1 < m_First + m_Count)
+		{
+			++m_V;
+			m_U = 0;
+
+			return true;
+		}
+
+		if (m_W + 1 < m_SizeW)
+		{
+			++m_W;
+			m_U = 0;
+			m_V = m_First;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	if (m_U + 1 < m_First + m_Count)
+	{
+		++m_U;
+
+		return true;
+	}
+
+	return false;
+}
+
+void PointPartition::Reset()
+{
+	m_IsReset = true;
+	m_U = m_IsMatrix ? 0 : m_First;
+	m_V = m_IsMatrix ? m_First : 0;
+	m_W = 0;
+}
+
+void PointPartition::GetCurrent(PointVector& vector) const
+{
+	assert(!m_IsReset);
+
+	if (m_IsMatrix)
+	{
+		m_Document->GetMatrixPoint(m_U, m_V, m_W, vector);
+	}
+	else
+	{
+		m_Document->GetListPoint(m_U, vector);
+	}
+}
+
+void PointPartition::GetCurrentCoord(
+	OGPS_Double* x,
+	OGPS_Double* y,
+	OGPS_Double* z) const
+{
+	assert(!m_IsReset);
+
+	if (m_IsMatrix)
+	{
+		m_Document->GetMatrixCoord(m_U, m_V, m_W, x, y, z);
+	}
+	else
+	{
+		m_Document->GetListCoord(m_U, x, y, z);
+	}
+}
+
+bool PointPartition::IsCurrentValid() const
+{
+	assert(!m_IsReset);
+
+	return !m_IsMatrix || m_Document->IsMatrixCoordValid(m_U, m_V, m_W);
+}
+
+bool PointPartition::GetPosition(
+	size_t* u,
+	size_t* v,
+	size_t* w) const
+{
+	if (!m_IsMatrix)
+	{
+		return false;
+	}
+
+	if (u)
+	{
+		*u = m_U;
+	}
+
+	if (v)
+	{
+		*v = m_V;
+	}
+
+	if (w)
+	{
+		*w = m_W;
+	}
+
+	return true;
+}
+
+bool PointPartition::GetPosition(size_t* index) const
+{
+	assert(index);
+
+	if (m_IsMatrix)
+	{
+		return false;
+	}
+
+	*index = m_U;
+
+	return true;
+}
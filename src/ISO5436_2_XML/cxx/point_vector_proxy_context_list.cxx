@@ -39,18 +39,21 @@ PointVectorProxyContextList::PointVectorProxyContextList(size_t maxIndex)
 
 void PointVectorProxyContextList::SetIndex(size_t index)
 {
-	if (index < m_MaxIndex)
-	{
-		m_Index = index;
-	}
-	else
+	m_Index = GetIndex(index);
+}
+
+size_t PointVectorProxyContextList::GetIndex(size_t index) const
+{
+	if (index >= m_MaxIndex)
 	{
 		throw Exception(
 			OGPS_ExInvalidOperation,
 			_EX_T("Index out of range."),
 			_EX_T("The data point addessed lies outside the point list."),
-			_EX_T("OpenGPS::PointVectorProxyContextList::SetIndex"));
+			_EX_T("OpenGPS::PointVectorProxyContextList::GetIndex"));
 	}
+
+	return index;
 }
 
 size_t PointVectorProxyContextList::GetIndex() const
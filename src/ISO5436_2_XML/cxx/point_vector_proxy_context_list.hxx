@@ -62,6 +62,14 @@ namespace OpenGPS
 		 */
 		void SetIndex(size_t index);
 
+		/*!
+		 * Checks an index without changing the current one.
+		 * Throws an exception if the index is out of range.
+		 * @param index The arbitrary index to check.
+		 * @returns Returns the index of the point vector.
+		 */
+		size_t GetIndex(size_t index) const;
+
 		size_t GetIndex() const override;
 		bool CanIncrementIndex() const override;
 		bool IncrementIndex() override;
@@ -47,20 +47,28 @@ void PointVectorProxyContextMatrix::SetIndex(
 	size_t v,
 	size_t w)
 {
-	if (u < m_MaxU && v < m_MaxV && w < m_MaxW)
-	{
-		m_U = u;
-		m_V = v;
-		m_W = w;
-	}
-	else
+	GetIndex(u, v, w);
+
+	m_U = u;
+	m_V = v;
+	m_W = w;
+}
+
+size_t PointVectorProxyContextMatrix::GetIndex(
+	size_t u,
+	size_t v,
+	size_t w) const
+{
+	if (u >= m_MaxU || v >= m_MaxV || w >= m_MaxW)
 	{
 		throw Exception(
 			OGPS_ExInvalidOperation,
 			_EX_T("Index out of range."),
 			_EX_T("The data point addressed lies outside the scope of the current matrix topology."),
-			_EX_T("OpenGPS::PointVectorProxyContextMatrix::SetIndex"));
+			_EX_T("OpenGPS::PointVectorProxyContextMatrix::GetIndex"));
 	}
+
+	return v * m_MaxU * m_MaxW + u * m_MaxW + w;
 }
 
 size_t PointVectorProxyContextMatrix::GetIndex() const
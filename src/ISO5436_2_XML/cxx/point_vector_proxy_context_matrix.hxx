@@ -71,6 +71,19 @@ namespace OpenGPS
 			size_t v,
 			size_t w);
 
+		/*!
+		 * Calculates the index of a point vector without changing the current index.
+		 * Throws an exception if the index is out of range.
+		 * @param u The arbitrary index in X direction of the topology mapping.
+		 * @param v The arbitrary index in Y direction of the topology mapping.
+		 * @param w The arbitrary index in Z direction of the topology mapping.
+		 * @returns Returns the index of the point vector.
+		 */
+		size_t GetIndex(
+			size_t u,
+			size_t v,
+			size_t w) const;
+
 		size_t GetIndex() const override;
 		bool CanIncrementIndex() const override;
 		bool IncrementIndex() override;
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Lock-free queue connecting a single producer thread with a single consumer thread.
+ */
+
+#ifndef _OPENGPS_SPSC_QUEUE_HXX
+#define _OPENGPS_SPSC_QUEUE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace OpenGPS
+{
+	/*!
+	 * Bounded queue of a fixed capacity that is lock-free as long as exactly one
+	 * thread pushes and exactly one other thread pops.
+	 *
+	 * The blocking operations spin for a while and then sleep for short periods,
+	 * so stages of a pipeline waiting for each other do not occupy a core.
+	 */
+	template<typename T> class SpscQueueT
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param capacity The maximum number of elements queued.
+		 */
+		SpscQueueT(size_t capacity);
+
+		/*!
+		 * Appends an element unless the queue is full. Called by the producer only.
+		 * @param value The element to be appended. It is moved from on success only.
+		 * @returns Returns false if the queue is full.
+		 */
+		bool TryPush(T& value);
+
+		/*!
+		 * Removes the first element unless the queue is empty. Called by the consumer only.
+		 * @param value Gets the element removed.
+		 * @returns Returns false if the queue is empty.
+		 */
+		bool TryPop(T& value);
+
+		/*!
+		 * Appends an element and waits while the queue is full.
+		 * @param value The element to be appended.
+		 * @param cancel Waiting stops as soon as this is set.
+		 * @returns Returns false if waiting has been cancelled.
+		 */
+		bool Push(T& value, const std::atomic<bool>& cancel);
+
+		/*!
+		 * Removes the first element and waits while the queue is empty.
+		 * @param value Gets the element removed.
+		 * @param cancel Waiting stops as soon as this is set.
+		 * @returns Returns false if waiting has been cancelled.
+		 */
+		bool Pop(T& value, const std::atomic<bool>& cancel);
+
+	private:
+		/*! Waits a little longer every time this is called with an increasing number of attempts. */
+		static void Wait(unsigned int attempt);
+
+		/*! Ring of elements, one more than the capacity to distinguish a full from an empty queue. */
+		std::vector<T> m_Slots;
+
+		/*! Position of the next element to be popped. Written by the consumer only. */
+		alignas(64) std::atomic<size_t> m_Head{};
+
+		/*! Position of the next element to be pushed. Written by the producer only. */
+		alignas(64) std::atomic<size_t> m_Tail{};
+
+		/*! Not implemented. */
+		SpscQueueT(const SpscQueueT& src) = delete;
+		SpscQueueT& operator=(const SpscQueueT& src) = delete;
+	};
+
+	template<typename T>
+	inline SpscQueueT<T>::SpscQueueT(size_t capacity)
+		:m_Slots(capacity + 1)
+	{
+		assert(capacity > 0);
+	}
+
+	template<typename T>
+	inline bool SpscQueueT<T>::TryPush(T& value)
+	{
+		const auto tail{ m_Tail.load(std::memory_order_relaxed) };
+		const auto next{ tail + 1 == m_Slots.size() ? 0 : tail + 1 };
+
+		if (next == m_Head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		m_Slots[tail] = std::move(value);
+		m_Tail.store(next, std::memory_order_release);
+
+		return true;
+	}
+
+	template<typename T>
+	inline bool SpscQueueT<T>::TryPop(T& value)
+	{
+		const auto head{ m_Head.load(std::memory_order_relaxed) };
+
+		if (head == m_Tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = std::move(m_Slots[head]);
+		m_Head.store(head + 1 == m_Slots.size() ? 0 : head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	template<typename T>
+	inline bool SpscQueueT<T>::Push(T& value, const std::atomic<bool>& cancel)
+	{
+		for (unsigned int attempt = 0; !TryPush(value); ++attempt)
+		{
+			if (cancel.load(std::memory_order_relaxed))
+			{
+				return false;
+			}
+
+			Wait(attempt);
+		}
+
+		return true;
+	}
+
+	template<typename T>
+	inline bool SpscQueueT<T>::Pop(T& value, const std::atomic<bool>& cancel)
+	{
+		for (unsigned int attempt = 0; !TryPop(value); ++attempt)
+		{
+			if (cancel.load(std::memory_order_relaxed))
+			{
+				return false;
+			}
+
+			Wait(attempt);
+		}
+
+		return true;
+	}
+
+	template<typename T>
+	inline void SpscQueueT<T>::Wait(unsigned int attempt)
+	{
+		if (attempt < 64)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(attempt < 1024 ? 10 : 100));
+		}
+	}
+}
+
+#endif
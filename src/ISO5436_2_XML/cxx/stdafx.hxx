@@ -59,6 +59,7 @@ using namespace OpenGPS;
 
 // TODO: Unix? / Mac?
 #define _OPENGPS_ENV_OPENGPS_LOCATION _T("OPENGPS_LOCATION")
+#define _OPENGPS_ENV_ZIP_CODEC _T("OPENGPS_ZIP_CODEC")
 #define _OPENGPS_ISO5436_LOCATION _T("iso5436_2.xsd")
 
 #include <cassert>
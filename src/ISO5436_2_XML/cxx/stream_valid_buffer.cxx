@@ -0,0 +1,187 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "stream_valid_buffer.hxx"
+#include "environment.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <algorithm>
+#include <memory>
+
+#define _OPENGPS_STREAM_VALID_CHUNK_MAX (64*1024)
+
+StreamValidBuffer::StreamValidBuffer(const String& filePath, size_t size)
+	:m_FilePath{ filePath },
+	m_RawSize{ size / 8 + (size % 8 != 0 ? 1 : 0) }
+{
+}
+
+StreamValidBuffer::~StreamValidBuffer()
+{
+	if (m_File.is_open())
+	{
+		m_File.close();
+		Environment::GetInstance()->RemoveFile(m_FilePath);
+	}
+}
+
+void StreamValidBuffer::Allocate()
+{
+	assert(!m_File.is_open());
+
+	m_File.open(m_FilePath.ToChar(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+	CheckFileAndThrowException();
+
+	// Initially all point vectors are assumed to be valid.
+	const auto chunk{ std::make_unique<char[]>(_OPENGPS_STREAM_VALID_CHUNK_MAX) };
+	std::fill_n(chunk.get(), _OPENGPS_STREAM_VALID_CHUNK_MAX, static_cast<char>(255));
+
+	size_t length{ m_RawSize };
+	while (length > 0)
+	{
+		const auto size{ std::min(length, static_cast<size_t>(_OPENGPS_STREAM_VALID_CHUNK_MAX)) };
+		m_File.write(chunk.get(), size);
+		length -= size;
+	}
+
+	CheckFileAndThrowException();
+
+	m_Byte = 255;
+	m_BytePosition = 0;
+	m_IsDirty = false;
+}
+
+void StreamValidBuffer::Flush()
+{
+	if (m_IsDirty)
+	{
+		m_File.seekp(m_BytePosition);
+		m_File.put(static_cast<char>(m_Byte));
+
+		CheckFileAndThrowException();
+
+		m_IsDirty = false;
+	}
+}
+
+void StreamValidBuffer::SetValid(size_t index, bool value)
+{
+	assert(index / 8 < m_RawSize);
+
+	// Everything is valid by default as long as the file has not been created.
+	if (value && !m_File.is_open())
+	{
+		return;
+	}
+
+	if (!m_File.is_open())
+	{
+		Allocate();
+	}
+
+	const size_t bytePosition{ index / 8 };
+	const size_t bitPosition{ index % 8 };
+
+	if (bytePosition != m_BytePosition)
+	{
+		Flush();
+
+		m_File.seekg(bytePosition);
+		m_Byte = static_cast<unsigned char>(m_File.get());
+		m_BytePosition = bytePosition;
+
+		CheckFileAndThrowException();
+	}
+
+	const auto bitValue{ static_cast<unsigned char>(static_cast<unsigned char>(1) << bitPosition) };
+
+	if (value)
+	{
+		m_Byte |= bitValue;
+	}
+	else
+	{
+		m_Byte &= ~bitValue;
+	}
+
+	m_IsDirty = true;
+}
+
+bool StreamValidBuffer::HasInvalidMarks() const
+{
+	return m_File.is_open();
+}
+
+void StreamValidBuffer::Write(std::ostream& stream)
+{
+	assert(m_File.is_open());
+
+	Flush();
+
+	m_File.seekg(0);
+
+	const auto chunk{ std::make_unique<char[]>(_OPENGPS_STREAM_VALID_CHUNK_MAX) };
+
+	size_t length{ m_RawSize };
+	while (length > 0 && !stream.fail())
+	{
+		const auto size{ std::min(length, static_cast<size_t>(_OPENGPS_STREAM_VALID_CHUNK_MAX)) };
+		m_File.read(chunk.get(), size);
+
+		CheckFileAndThrowException();
+
+		stream.write(chunk.get(), size);
+		length -= size;
+	}
+
+	if (stream.fail())
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("Failed to write to the point validity stream."),
+			_EX_T("Check for filesystem permissions and enough space."),
+			_EX_T("OpenGPS::StreamValidBuffer::Write"));
+	}
+}
+
+void StreamValidBuffer::CheckFileAndThrowException()
+{
+	if (m_File.fail())
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("Could not access the temporary point validity file."),
+			_EX_T("Check for filesystem permissions and enough space in the directory for temporary files."),
+			_EX_T("OpenGPS::StreamValidBuffer::CheckFileAndThrowException"));
+	}
+}
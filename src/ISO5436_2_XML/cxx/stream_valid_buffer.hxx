@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Point validity of streamed point data kept in a temporary file.
+ */
+
+#ifndef _OPENGPS_STREAM_VALID_BUFFER_HXX
+#define _OPENGPS_STREAM_VALID_BUFFER_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <fstream>
+#include <iostream>
+
+namespace OpenGPS
+{
+	/*!
+	 * Tracks the validity of point vectors that are not buffered in memory.
+	 *
+	 * The bit layout equals that of OpenGPS::ValidBuffer: if the bit at a given
+	 * index is on (set to one) the point vector is valid, otherwise the point
+	 * vector at the corresponding location has invalid data. The bit array is
+	 * kept in a temporary file which is created when the first point vector is
+	 * marked as invalid. Only the byte currently modified is held in memory.
+	 */
+	class StreamValidBuffer
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param filePath The path of the temporary file that stores the bit array.
+		 * @param size The amount of point vectors to be tracked.
+		 */
+		StreamValidBuffer(const String& filePath, size_t size);
+
+		/*! Destroys this instance and removes the temporary file. */
+		~StreamValidBuffer();
+
+		/*!
+		 * Sets the validity of a point vector.
+		 * @param index The index of the point vector.
+		 * @param value true if the point vector is valid, false otherwise.
+		 */
+		void SetValid(size_t index, bool value);
+
+		/*!
+		 * Checks whether any point vector has been marked as invalid.
+		 * @returns false if all point vectors are valid, otherwise true.
+		 */
+		bool HasInvalidMarks() const;
+
+		/*!
+		 * Copies the bit array to a binary stream.
+		 * @param stream The bit array gets written to the given stream.
+		 */
+		void Write(std::ostream& stream);
+
+	private:
+		/*! Creates the temporary file with all point vectors marked as valid. */
+		void Allocate();
+
+		/*! Writes the cached byte back to the temporary file. */
+		void Flush();
+
+		/*! Throws an exception if the temporary file could not be accessed. */
+		void CheckFileAndThrowException();
+
+		/*! The path of the temporary file. */
+		String m_FilePath;
+
+		/*! The temporary file that stores the bit array. */
+		std::fstream m_File;
+
+		/*! Size of the bit array in bytes. */
+		size_t m_RawSize;
+
+		/*! The byte of the bit array currently modified. */
+		unsigned char m_Byte{ 255 };
+
+		/*! The position of OpenGPS::StreamValidBuffer::m_Byte within the bit array. */
+		size_t m_BytePosition{};
+
+		/*! true if OpenGPS::StreamValidBuffer::m_Byte differs from the temporary file. */
+		bool m_IsDirty{};
+	};
+}
+
+#endif
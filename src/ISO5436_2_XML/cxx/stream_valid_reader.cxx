@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "stream_valid_reader.hxx"
+#include <opengps/cxx/exceptions.hxx>
+#include "stdafx.hxx"
+
+StreamValidReader::StreamValidReader(std::istream& stream, size_t size, bool sequential)
+	:m_Stream(stream),
+	m_IsSequential{ sequential }
+{
+	if (!m_IsSequential)
+	{
+		m_Bits.resize(size / 8 + 1);
+
+		for (auto& bits : m_Bits)
+		{
+			bits = ReadByte();
+		}
+	}
+}
+
+unsigned char StreamValidReader::ReadByte()
+{
+	const auto c{ m_Stream.get() };
+
+	if (m_Stream.eof())
+	{
+		return 255;
+	}
+
+	if (m_Stream.fail())
+	{
+		throw Exception(
+			OGPS_ExGeneral,
+			_EX_T("The binary point validity data could not be read."),
+			_EX_T("The X3P archive may be corrupted. Please check it using a zip file utility of your choice."),
+			_EX_T("OpenGPS::StreamValidReader::ReadByte"));
+	}
+
+	++m_BytesRead;
+
+	return static_cast<unsigned char>(c);
+}
+
+bool StreamValidReader::IsValid(size_t index)
+{
+	const size_t bytePosition{ index / 8 };
+	const size_t bitPosition{ index % 8 };
+
+	const auto bitValue{ static_cast<unsigned char>(static_cast<unsigned char>(1) << bitPosition) };
+
+	if (!m_IsSequential)
+	{
+		assert(bytePosition < m_Bits.size());
+		return ((m_Bits[bytePosition] & bitValue) != 0);
+	}
+
+	assert(bytePosition + 1 >= m_BytesRead);
+
+	while (m_BytesRead <= bytePosition && !m_Stream.eof())
+	{
+		m_Byte = ReadByte();
+	}
+
+	if (m_BytesRead <= bytePosition)
+	{
+		return true;
+	}
+
+	return ((m_Byte & bitValue) != 0);
+}
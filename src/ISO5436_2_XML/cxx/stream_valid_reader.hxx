@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Point validity read from a bit array stream that is not buffered in memory.
+ */
+
+#ifndef _OPENGPS_STREAM_VALID_READER_HXX
+#define _OPENGPS_STREAM_VALID_READER_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <istream>
+#include <vector>
+
+namespace OpenGPS
+{
+	/*!
+	 * Reads the validity of point vectors from a binary stream.
+	 *
+	 * The bit layout equals that of OpenGPS::ValidBuffer. If point vectors are
+	 * queried in ascending order of their indexes, the stream is read byte by
+	 * byte while being queried. Otherwise the whole bit array is read into memory
+	 * first. Missing bytes at the end of the stream mark point vectors as valid.
+	 */
+	class StreamValidReader
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param stream The binary stream of the bit array.
+		 * @param size The amount of point vectors to be tracked.
+		 * @param sequential true if point vectors will be queried in ascending order only.
+		 */
+		StreamValidReader(std::istream& stream, size_t size, bool sequential);
+
+		/*!
+		 * Gets the validity of a point vector.
+		 * @param index The index of the point vector.
+		 * @returns Returns true if the point vector is valid, false otherwise.
+		 */
+		bool IsValid(size_t index);
+
+	private:
+		/*! Reads the next byte of the bit array. Returns 255 beyond its end. */
+		unsigned char ReadByte();
+
+		/*! The binary stream of the bit array. */
+		std::istream& m_Stream;
+
+		/*! true if point vectors are queried in ascending order. */
+		bool m_IsSequential;
+
+		/*! The whole bit array if point vectors are not queried sequentially. */
+		std::vector<unsigned char> m_Bits;
+
+		/*! The byte of the bit array read last. */
+		unsigned char m_Byte{ 255 };
+
+		/*! The amount of bytes read so far. */
+		size_t m_BytesRead{};
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		StreamValidReader(const StreamValidReader& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		StreamValidReader& operator=(const StreamValidReader& src) = delete;
+	};
+}
+
+#endif
@@ -0,0 +1,561 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "surface_cache.hxx"
+#include "mapped_storage.hxx"
+#include "vector_buffer.hxx"
+#include "valid_buffer.hxx"
+#include "point_buffer.hxx"
+#include "environment.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <streambuf>
+#include <vector>
+
+/* Identifies a cached file. */
+#define _OPENGPS_SURFACE_CACHE_MAGIC "X3PCACHE"
+
+/* The version of the format of cached files. */
+#define _OPENGPS_SURFACE_CACHE_VERSION 2
+
+/* Written in the byte order of the machine, read back on a machine of the same byte order only. */
+#define _OPENGPS_SURFACE_CACHE_BYTE_ORDER 0x01020304
+
+/* Typed arrays start at page boundaries, so that they can be mapped efficiently. */
+#define _OPENGPS_SURFACE_CACHE_ALIGNMENT 4096
+
+/* The extension of cached files. */
+#define _OPENGPS_SURFACE_CACHE_EXTENSION _T(".x3pcache")
+
+/* The prefix of the names of cached segments of shared memory. */
+#define _OPENGPS_SURFACE_CACHE_SEGMENT_PREFIX _T("x3p-")
+
+/* The amount of values written at once. */
+#define _OPENGPS_SURFACE_CACHE_CHUNK 65536
+
+/* Seconds after which a segment that has not been published completely is considered abandoned. */
+#define _OPENGPS_SURFACE_CACHE_STALE_SECONDS 60
+
+namespace
+{
+	/* Writes to memory of a fixed size, fails when it is exceeded. */
+	class SegmentStreamBuffer : public std::streambuf
+	{
+	public:
+		SegmentStreamBuffer(unsigned char* data, size_t size)
+		{
+			const auto begin{ reinterpret_cast<char*>(data) };
+			setp(begin, begin + size);
+		}
+	};
+
+	/* The magic at the beginning of a segment, which is published last. */
+	typedef std::atomic<unsigned long long> SegmentMagic;
+
+	// Processes only agree on the magic if it is accessed without a lock.
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The magic of a segment must be lock-free.");
+	static_assert(sizeof(SegmentMagic) == sizeof(unsigned long long), "The magic of a segment must not occupy more than 8 bytes.");
+}
+
+SurfaceCache::SurfaceCache(const String& directory, unsigned long long budget)
+	:m_Directory{ directory },
+	m_Budget{ budget }
+{
+	assert(m_Directory.length() > 0);
+}
+
+SurfaceCache::SurfaceCache(unsigned long long budget, bool allUsers)
+	:m_Budget{ budget },
+	m_AllUsers{ allUsers }
+{
+}
+
+std::shared_ptr<MappedStorage> SurfaceCache::Load(const Md5& dataMd5, const Md5& validMd5, size_t count, const std::array<OGPS_DataPointType, 3>& types, size_t& validSize) const
+{
+	validSize = 0;
+
+	const auto env{ Environment::GetInstance() };
+	const auto name{ GetEntryName(dataMd5, validMd5) };
+
+	size_t size{};
+	std::shared_ptr<unsigned char> data;
+
+	if (IsShared())
+	{
+		data = env->MapSharedMemory(name, size, m_AllUsers);
+	}
+	else
+	{
+		const auto filePath{ env->ConcatPathes(m_Directory, name) };
+
+		if (env->PathExists(filePath))
+		{
+			data = env->MapFile(filePath, size);
+
+			// Mark the file as the most recently used.
+			if (data)
+			{
+				env->TouchFile(filePath);
+			}
+		}
+	}
+
+	if (!data || size < sizeof(Header))
+	{
+		return nullptr;
+	}
+
+	const auto header{ ReadHeader(data.get()) };
+
+	// The file may have been written by another version or another machine,
+	// or it may belong to a different document describing the same point data.
+	if (memcmp(header.magic, _OPENGPS_SURFACE_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != _OPENGPS_SURFACE_CACHE_VERSION ||
+		header.byteOrder != _OPENGPS_SURFACE_CACHE_BYTE_ORDER ||
+		memcmp(header.dataMd5, dataMd5.data(), dataMd5.size()) != 0 ||
+		memcmp(header.validMd5, validMd5.data(), validMd5.size()) != 0 ||
+		header.count != count)
+	{
+		return nullptr;
+	}
+
+	for (size_t n = 0; n < types.size(); ++n)
+	{
+		if (header.types[n] != types[n])
+		{
+			return nullptr;
+		}
+	}
+
+	// Segments may be rounded up to whole pages.
+	const auto expectedSize{ GetFileSize(count, types, static_cast<size_t>(header.validSize)) };
+	if ((header.validSize != 0 && header.validSize != count / 8 + (count % 8 != 0 ? 1 : 0)) ||
+		expectedSize > size || (!IsShared() && expectedSize != size))
+	{
+		return nullptr;
+	}
+
+	validSize = static_cast<size_t>(header.validSize);
+
+	return std::make_shared<MappedStorage>(data, size, sizeof(Header), _OPENGPS_SURFACE_CACHE_ALIGNMENT);
+}
+
+std::shared_ptr<MappedStorage> SurfaceCache::Store(const Md5& dataMd5, const Md5& validMd5, VectorBuffer& buffer, size_t& validSize) const
+{
+	assert(buffer.GetZ());
+
+	validSize = 0;
+
+	const std::vector<std::shared_ptr<PointBuffer>> axes{ buffer.GetX(), buffer.GetY(), buffer.GetZ() };
+	const auto count{ axes[2]->GetSize() };
+
+	std::array<OGPS_DataPointType, 3> types{};
+	for (size_t n = 0; n < axes.size(); ++n)
+	{
+		types[n] = axes[n] ? axes[n]->GetPointType() : OGPS_MissingPointType;
+	}
+
+	// Another process may have cached the same point data meanwhile.
+	auto mapped{ Load(dataMd5, validMd5, count, types, validSize) };
+	if (mapped)
+	{
+		return mapped;
+	}
+
+	// Everything is valid unless the bit array has been allocated.
+	const auto valid{ buffer.HasValidityBuffer() && buffer.GetValidityBuffer()->IsAllocated() ? buffer.GetValidityBuffer() : nullptr };
+	const size_t bitArraySize{ valid ? count / 8 + (count % 8 != 0 ? 1 : 0) : 0 };
+
+	const auto size{ GetFileSize(count, types, bitArraySize) };
+	if (size > m_Budget)
+	{
+		return nullptr;
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.magic, _OPENGPS_SURFACE_CACHE_MAGIC, sizeof(header.magic));
+	header.version = _OPENGPS_SURFACE_CACHE_VERSION;
+	header.byteOrder = _OPENGPS_SURFACE_CACHE_BYTE_ORDER;
+	memcpy(header.dataMd5, dataMd5.data(), dataMd5.size());
+	memcpy(header.validMd5, validMd5.data(), validMd5.size());
+	header.count = count;
+	for (size_t n = 0; n < types.size(); ++n)
+	{
+		header.types[n] = types[n];
+	}
+	header.validSize = bitArraySize;
+	header.created = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	const auto name{ GetEntryName(dataMd5, validMd5) };
+
+	// A new segment vanishes where it is not kept by anyone.
+	std::shared_ptr<unsigned char> segment;
+
+	if (IsShared())
+	{
+		// A segment abandoned by a publisher that has died is replaced once.
+		if (!PublishSegment(name, header, axes, valid, size, segment) &&
+			!(RemoveStaleSegment(name) && PublishSegment(name, header, axes, valid, size, segment)))
+		{
+			return nullptr;
+		}
+	}
+	else if (!PublishFile(name, header, axes, valid))
+	{
+		return nullptr;
+	}
+
+	mapped = Load(dataMd5, validMd5, count, types, validSize);
+
+	Evict();
+
+	return mapped;
+}
+
+bool SurfaceCache::IsShared() const
+{
+	return (m_Directory.length() == 0);
+}
+
+bool SurfaceCache::PublishFile(const String& name, const Header& header, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid) const
+{
+	const auto env{ Environment::GetInstance() };
+
+	// Write to a temporary file first, so that others never see incomplete files.
+	String tempName{ _T("x3p") };
+	tempName += env->GetUniqueName();
+	tempName += _T(".tmp");
+	auto tempPath{ env->ConcatPathes(m_Directory, tempName) };
+
+	bool success{};
+
+	try
+	{
+		std::ofstream file(tempPath.ToChar(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		WriteContent(file, axes, valid);
+
+		file.close();
+		success = !file.fail();
+	}
+	catch (const Exception&)
+	{
+		success = false;
+	}
+
+	success = success && env->RenameFile(tempPath, env->ConcatPathes(m_Directory, name));
+
+	if (!success)
+	{
+		env->RemoveFile(tempPath);
+	}
+
+	return success;
+}
+
+bool SurfaceCache::PublishSegment(const String& name, const Header& header, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid, unsigned long long size, std::shared_ptr<unsigned char>& segment) const
+{
+	const auto env{ Environment::GetInstance() };
+
+	// Fails if another process publishes the same point data right now.
+	segment = env->CreateSharedMemory(name, static_cast<size_t>(size), m_AllUsers);
+	if (!segment)
+	{
+		return false;
+	}
+
+	bool success{};
+
+	try
+	{
+		// Others do not accept the segment before its magic has been written.
+		Header incomplete{ header };
+		memset(incomplete.magic, 0, sizeof(incomplete.magic));
+
+		SegmentStreamBuffer streamBuffer{ segment.get(), static_cast<size_t>(size) };
+		std::ostream stream{ &streamBuffer };
+
+		stream.write(reinterpret_cast<const char*>(&incomplete), sizeof(Header));
+		WriteContent(stream, axes, valid);
+
+		success = !stream.fail();
+	}
+	catch (const Exception&)
+	{
+		success = false;
+	}
+
+	if (!success)
+	{
+		segment.reset();
+		env->RemoveSharedMemory(name);
+		return false;
+	}
+
+	// Publishes everything written before to readers that see the magic, see SurfaceCache::ReadHeader.
+	unsigned long long magic{};
+	memcpy(&magic, header.magic, sizeof(header.magic));
+	reinterpret_cast<SegmentMagic*>(segment.get())->store(magic, std::memory_order_release);
+
+	return true;
+}
+
+bool SurfaceCache::RemoveStaleSegment(const String& name) const
+{
+	const auto env{ Environment::GetInstance() };
+
+	size_t size{};
+	const auto data{ env->MapSharedMemory(name, size, m_AllUsers) };
+
+	if (!data || size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const auto header{ ReadHeader(data.get()) };
+
+	// Segments of other versions are not touched, their layout is unknown.
+	const char incomplete[sizeof(header.magic)] = {};
+	if (memcmp(header.magic, incomplete, sizeof(header.magic)) != 0 || header.version != _OPENGPS_SURFACE_CACHE_VERSION)
+	{
+		return false;
+	}
+
+	const auto now{ std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() };
+	if (now - header.created < _OPENGPS_SURFACE_CACHE_STALE_SECONDS)
+	{
+		return false;
+	}
+
+	return env->RemoveSharedMemory(name);
+}
+
+SurfaceCache::Header SurfaceCache::ReadHeader(const unsigned char* data)
+{
+	static_assert(sizeof(Header::magic) == sizeof(SegmentMagic), "The magic must be a single word.");
+
+	// The magic of a segment is stored last, see SurfaceCache::PublishSegment. Once it has been
+	// loaded, the rest of the header and the point data following it are complete.
+	const auto magic{ reinterpret_cast<const SegmentMagic*>(data)->load(std::memory_order_acquire) };
+
+	Header header;
+	memcpy(header.magic, &magic, sizeof(header.magic));
+	memcpy(reinterpret_cast<unsigned char*>(&header) + sizeof(header.magic), data + sizeof(header.magic), sizeof(Header) - sizeof(header.magic));
+
+	return header;
+}
+
+void SurfaceCache::WriteContent(std::ostream& stream, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid)
+{
+	size_t offset{ sizeof(Header) };
+
+	for (const auto& axis : axes)
+	{
+		if (axis)
+		{
+			WritePadding(stream, offset);
+			WriteValues(stream, *axis);
+			offset += axis->GetSize() * GetDataTypeSize(axis->GetPointType());
+		}
+	}
+
+	if (valid)
+	{
+		WritePadding(stream, offset);
+		valid->Write(stream);
+	}
+}
+
+String SurfaceCache::GetEntryName(const Md5& dataMd5, const Md5& validMd5) const
+{
+	String name;
+	name.ConvertFromMd5(dataMd5);
+
+	if (std::any_of(validMd5.begin(), validMd5.end(), [](unsigned char c) { return c != 0; }))
+	{
+		String validName;
+		validName.ConvertFromMd5(validMd5);
+
+		name += _T("_");
+		name += validName;
+	}
+
+	if (IsShared())
+	{
+		String segmentName{ _OPENGPS_SURFACE_CACHE_SEGMENT_PREFIX };
+		segmentName += name;
+
+		return segmentName;
+	}
+
+	name += _OPENGPS_SURFACE_CACHE_EXTENSION;
+
+	return name;
+}
+
+bool SurfaceCache::IsEntryName(const String& name) const
+{
+	if (IsShared())
+	{
+		const String prefix{ _OPENGPS_SURFACE_CACHE_SEGMENT_PREFIX };
+		return name.length() > prefix.length() && name.compare(0, prefix.length(), prefix) == 0;
+	}
+
+	const String extension{ _OPENGPS_SURFACE_CACHE_EXTENSION };
+	return name.length() > extension.length() && name.compare(name.length() - extension.length(), extension.length(), extension) == 0;
+}
+
+void SurfaceCache::Evict() const
+{
+	const auto env{ Environment::GetInstance() };
+
+	std::vector<FileInfo> entries;
+	if (IsShared() ? !env->GetSharedMemory(entries) : !env->GetFiles(m_Directory, entries))
+	{
+		return;
+	}
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [this](const FileInfo& info) { return !IsEntryName(info.name); }), entries.end());
+
+	// Keep the entries used most recently.
+	std::sort(entries.begin(), entries.end(), [](const FileInfo& lhs, const FileInfo& rhs) { return lhs.modified > rhs.modified; });
+
+	unsigned long long total{};
+	for (const auto& info : entries)
+	{
+		total += info.size;
+
+		if (total > m_Budget)
+		{
+			if (IsShared())
+			{
+				env->RemoveSharedMemory(info.name);
+			}
+			else
+			{
+				env->RemoveFile(env->ConcatPathes(m_Directory, info.name));
+			}
+		}
+	}
+}
+
+void SurfaceCache::WriteValues(std::ostream& stream, const PointBuffer& buffer)
+{
+	const auto size{ buffer.GetSize() };
+	const auto typeSize{ GetDataTypeSize(buffer.GetPointType()) };
+	const auto chunk{ std::make_unique<unsigned char[]>(_OPENGPS_SURFACE_CACHE_CHUNK * typeSize) };
+
+	for (size_t first = 0; first < size; first += _OPENGPS_SURFACE_CACHE_CHUNK)
+	{
+		const auto last{ std::min(first + _OPENGPS_SURFACE_CACHE_CHUNK, size) };
+
+		for (size_t index = first; index < last; ++index)
+		{
+			const auto target{ chunk.get() + (index - first) * typeSize };
+
+			switch (buffer.GetPointType())
+			{
+			case OGPS_Int16PointType:
+				buffer.Get(index, *reinterpret_cast<OGPS_Int16*>(target));
+				break;
+			case OGPS_Int32PointType:
+				buffer.Get(index, *reinterpret_cast<OGPS_Int32*>(target));
+				break;
+			case OGPS_FloatPointType:
+				buffer.Get(index, *reinterpret_cast<OGPS_Float*>(target));
+				break;
+			case OGPS_DoublePointType:
+				buffer.Get(index, *reinterpret_cast<OGPS_Double*>(target));
+				break;
+			default:
+				assert(false);
+				break;
+			}
+		}
+
+		stream.write(reinterpret_cast<const char*>(chunk.get()), (last - first) * typeSize);
+	}
+}
+
+void SurfaceCache::WritePadding(std::ostream& stream, size_t& offset)
+{
+	const auto aligned{ MappedStorage::Align(offset, _OPENGPS_SURFACE_CACHE_ALIGNMENT) };
+
+	const char zeros[_OPENGPS_SURFACE_CACHE_ALIGNMENT] = {};
+	stream.write(zeros, aligned - offset);
+
+	offset = aligned;
+}
+
+unsigned long long SurfaceCache::GetFileSize(size_t count, const std::array<OGPS_DataPointType, 3>& types, size_t validSize)
+{
+	auto size{ static_cast<unsigned long long>(sizeof(Header)) };
+
+	for (const auto type : types)
+	{
+		if (type != OGPS_MissingPointType)
+		{
+			size = MappedStorage::Align(static_cast<size_t>(size), _OPENGPS_SURFACE_CACHE_ALIGNMENT) + static_cast<unsigned long long>(count) * GetDataTypeSize(type);
+		}
+	}
+
+	if (validSize > 0)
+	{
+		size = MappedStorage::Align(static_cast<size_t>(size), _OPENGPS_SURFACE_CACHE_ALIGNMENT) + validSize;
+	}
+
+	return size;
+}
+
+size_t SurfaceCache::GetDataTypeSize(OGPS_DataPointType type)
+{
+	switch (type)
+	{
+	case OGPS_Int16PointType:
+		return sizeof(OGPS_Int16);
+	case OGPS_Int32PointType:
+		return sizeof(OGPS_Int32);
+	case OGPS_FloatPointType:
+		return sizeof(OGPS_Float);
+	case OGPS_DoublePointType:
+		return sizeof(OGPS_Double);
+	default:
+		return 0;
+	}
+}
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Decoded point data kept in files or shared memory that can be mapped into memory.
+ */
+
+#ifndef _OPENGPS_SURFACE_CACHE_HXX
+#define _OPENGPS_SURFACE_CACHE_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/data_point_type.h>
+#include <array>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace OpenGPS
+{
+	class MappedStorage;
+	class PointBuffer;
+	class ValidBuffer;
+	class VectorBuffer;
+
+	/*!
+	 * Keeps the decoded point data of X3P archives in a directory.
+	 *
+	 * Every file of the cache contains the typed arrays of all axes stored explicitly
+	 * and the bit array of valid points of a single X3P archive in their raw layout
+	 * in memory. It is identified by the MD5 checksums of the binary point data and
+	 * the binary point validity data as declared by the main document. Instead of
+	 * decompressing and decoding the point data once more, the file gets mapped into
+	 * memory when the same point data is opened again.
+	 *
+	 * Files are published atomically by renaming them, so several processes may share
+	 * a cache. Whenever a file is added, the files used least recently are removed until
+	 * the total size of the cache fits into its budget.
+	 *
+	 * Alternatively the same content is kept in named segments of shared memory, so that
+	 * all processes of a machine map a single copy of the decoded point data. A segment
+	 * is published by writing its header last. A segment left incomplete by a process that
+	 * has died while publishing it is removed once it is older than a timeout. Segments are
+	 * private to the current user unless they are shared with all users explicitly. Where
+	 * segments cannot be enumerated, they vanish as soon as no process maps them anymore
+	 * and the budget limits a single segment.
+	 */
+	class SurfaceCache
+	{
+	public:
+		/*! The MD5 checksum identifying cached point data. */
+		typedef std::array<unsigned char, 16> Md5;
+
+		/*!
+		 * Creates a new instance.
+		 * @param directory The directory of the cache, which must exist.
+		 * @param budget The maximum total size of the files of the cache in bytes.
+		 */
+		SurfaceCache(const String& directory, unsigned long long budget);
+
+		/*!
+		 * Creates a new instance that keeps point data in named segments of shared memory.
+		 * @param budget The maximum total size of the segments of the cache in bytes.
+		 * @param allUsers Whether segments are shared with all users of the machine rather
+		 * than with processes of the current user only.
+		 */
+		SurfaceCache(unsigned long long budget, bool allUsers);
+
+		/*!
+		 * Maps cached point data into memory.
+		 * @param dataMd5 The checksum of the binary point data.
+		 * @param validMd5 The checksum of the binary point validity data or zeros if there is none.
+		 * @param count The amount of point vectors.
+		 * @param types The data types of the X, Y and Z axis.
+		 * @param validSize Gets the size of the bit array of valid points in bytes, which follows the Z axis.
+		 * @returns Returns the storage of the axes in the order X, Y and Z or nullptr if
+		 * the point data is not cached or the cached file does not match.
+		 */
+		std::shared_ptr<MappedStorage> Load(const Md5& dataMd5, const Md5& validMd5, size_t count, const std::array<OGPS_DataPointType, 3>& types, size_t& validSize) const;
+
+		/*!
+		 * Adds decoded point data to the cache and removes the entries used least recently
+		 * if the cache exceeds its budget.
+		 * @param dataMd5 The checksum of the binary point data.
+		 * @param validMd5 The checksum of the binary point validity data or zeros if there is none.
+		 * @param buffer The point data to be cached.
+		 * @param validSize Gets the size of the bit array of valid points in bytes, which follows the Z axis.
+		 * @returns Returns the cached point data mapped as by SurfaceCache::Load, so that it
+		 * may replace the given buffer, or nullptr if the point data could not be cached.
+		 */
+		std::shared_ptr<MappedStorage> Store(const Md5& dataMd5, const Md5& validMd5, VectorBuffer& buffer, size_t& validSize) const;
+
+	private:
+		/*! Describes the content of a cached file. */
+		struct Header
+		{
+			/*!
+			 * Identifies the file format. The magic of a segment is published
+			 * atomically after everything else has been written.
+			 */
+			char magic[8];
+
+			/*! The version of the file format. */
+			OGPS_Int32 version;
+
+			/*! Identifies the byte order of the machine that has written the file. */
+			OGPS_Int32 byteOrder;
+
+			/*! The checksum of the binary point data. */
+			unsigned char dataMd5[16];
+
+			/*! The checksum of the binary point validity data. */
+			unsigned char validMd5[16];
+
+			/*! The amount of point vectors. */
+			unsigned long long count;
+
+			/*! The data types of the X, Y and Z axis. */
+			OGPS_Int32 types[3];
+
+			/*! Unused. */
+			OGPS_Int32 reserved;
+
+			/*! The size of the bit array of valid points in bytes. */
+			unsigned long long validSize;
+
+			/*! The time the segment has been created at in seconds since the epoch. */
+			long long created;
+		};
+
+		/*! Whether point data is kept in shared memory rather than files. */
+		bool IsShared() const;
+
+		/*!
+		 * Gets the name of the file or the segment caching the point data identified by the given checksums.
+		 * @param dataMd5 The checksum of the binary point data.
+		 * @param validMd5 The checksum of the binary point validity data or zeros if there is none.
+		 */
+		String GetEntryName(const Md5& dataMd5, const Md5& validMd5) const;
+
+		/*!
+		 * Checks whether a file or a segment is an entry of the cache.
+		 * @param name The name of the file or the segment.
+		 */
+		bool IsEntryName(const String& name) const;
+
+		/*!
+		 * Writes a new file and renames it to its final name.
+		 * @param name The name of the file.
+		 * @param header The header of the file.
+		 * @param axes The point data of the X, Y and Z axis, where missing axes are nullptr.
+		 * @param valid The bit array of valid points or nullptr if all points are valid.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool PublishFile(const String& name, const Header& header, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid) const;
+
+		/*!
+		 * Creates a new segment of shared memory and writes its header last.
+		 * @param name The name of the segment.
+		 * @param header The header of the segment.
+		 * @param axes The point data of the X, Y and Z axis, where missing axes are nullptr.
+		 * @param valid The bit array of valid points or nullptr if all points are valid.
+		 * @param size The size of the segment in bytes.
+		 * @param segment Gets the memory of the segment, which must be kept until the
+		 * segment has been mapped once more, since it might vanish otherwise.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool PublishSegment(const String& name, const Header& header, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid, unsigned long long size, std::shared_ptr<unsigned char>& segment) const;
+
+		/*!
+		 * Removes a segment that has not been published completely for longer than a timeout.
+		 * Its publisher is assumed to have died, the segment would block the point data from being cached otherwise.
+		 * @param name The name of the segment.
+		 * @returns Returns true if the segment has been removed, false otherwise.
+		 */
+		bool RemoveStaleSegment(const String& name) const;
+
+		/*!
+		 * Reads the header of a file or a segment.
+		 * Point data following the header is complete if the magic read has been set.
+		 * @param data The file or segment mapped into memory.
+		 * @returns Returns a copy of the header.
+		 */
+		static Header ReadHeader(const unsigned char* data);
+
+		/*! Removes the entries used least recently until the cache fits into its budget. */
+		void Evict() const;
+
+		/*!
+		 * Writes the content of a file or a segment following its header.
+		 * @param stream The cached file or segment.
+		 * @param axes The point data of the X, Y and Z axis, where missing axes are nullptr.
+		 * @param valid The bit array of valid points or nullptr if all points are valid.
+		 */
+		static void WriteContent(std::ostream& stream, const std::vector<std::shared_ptr<PointBuffer>>& axes, ValidBuffer* valid);
+
+		/*!
+		 * Writes the point data of an axis.
+		 * @param stream The cached file.
+		 * @param buffer The point data of the axis.
+		 */
+		static void WriteValues(std::ostream& stream, const PointBuffer& buffer);
+
+		/*!
+		 * Writes zeros up to the next aligned offset.
+		 * @param stream The cached file.
+		 * @param offset The current offset in bytes, which gets aligned.
+		 */
+		static void WritePadding(std::ostream& stream, size_t& offset);
+
+		/*!
+		 * Gets the size of a cached file.
+		 * @param count The amount of point vectors.
+		 * @param types The data types of the X, Y and Z axis.
+		 * @param validSize The size of the bit array of valid points in bytes.
+		 */
+		static unsigned long long GetFileSize(size_t count, const std::array<OGPS_DataPointType, 3>& types, size_t validSize);
+
+		/*! Gets the size of a single value of the given type in bytes. */
+		static size_t GetDataTypeSize(OGPS_DataPointType type);
+
+		/*! The directory of the cache or an empty string if point data is kept in shared memory. */
+		String m_Directory;
+
+		/*! The maximum total size of the files of the cache in bytes. */
+		unsigned long long m_Budget;
+
+		/*! Whether segments of shared memory are shared with all users of the machine. */
+		bool m_AllUsers{};
+	};
+}
+
+#endif
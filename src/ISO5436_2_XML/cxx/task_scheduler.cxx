@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "task_scheduler.hxx"
+#include "thread_pool.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <thread>
+
+TaskScheduler& TaskScheduler::GetInstance()
+{
+	static TaskScheduler instance;
+	return instance;
+}
+
+TaskScheduler::TaskScheduler() = default;
+
+TaskScheduler::~TaskScheduler() = default;
+
+void TaskScheduler::Post(std::function<void()> task)
+{
+	assert(task);
+
+	TaskExecutor executor;
+	std::shared_ptr<ThreadPool> pool;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Executor)
+		{
+			executor = m_Executor;
+		}
+		else
+		{
+			if (!m_Pool)
+			{
+				m_Pool = std::make_shared<ThreadPool>(m_MaxThreads);
+			}
+
+			pool = m_Pool;
+		}
+	}
+
+	// The executor may run the task right away, so no lock is held here
+	if (executor)
+	{
+		executor(std::move(task));
+	}
+	else
+	{
+		pool->Post(std::move(task));
+	}
+}
+
+bool TaskScheduler::RunPending()
+{
+	std::shared_ptr<ThreadPool> pool;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		pool = m_Pool;
+	}
+
+	return pool && pool->RunPending();
+}
+
+void TaskScheduler::SetMaxThreads(size_t count)
+{
+	std::shared_ptr<ThreadPool> previous;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (count == m_MaxThreads)
+		{
+			return;
+		}
+
+		m_MaxThreads = count;
+		previous = std::move(m_Pool);
+	}
+
+	// The previous pool finishes the tasks queued before its threads are stopped.
+	// A new pool is created on demand.
+	previous.reset();
+}
+
+size_t TaskScheduler::GetMaxThreads() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_MaxThreads;
+}
+
+size_t TaskScheduler::GetThreadCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_MaxThreads > 0 ? m_MaxThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void TaskScheduler::SetExecutor(TaskExecutor executor)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Executor = std::move(executor);
+}
+
+bool TaskScheduler::AllowsDedicatedThreads() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return !m_Executor && m_MaxThreads != 1;
+}
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * The scheduler all parallel work of the library is executed by.
+ */
+
+#ifndef _OPENGPS_TASK_SCHEDULER_HXX
+#define _OPENGPS_TASK_SCHEDULER_HXX
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/scheduler.hxx>
+
+namespace OpenGPS
+{
+	class ThreadPool;
+
+	/*!
+	 * Executes all parallel work of the library, see OpenGPS::Scheduler.
+	 *
+	 * Tasks are run by a work-stealing OpenGPS::ThreadPool which is created on first use
+	 * with the maximum number of threads set, or by an executor of the application.
+	 */
+	class TaskScheduler
+	{
+	public:
+		/*! Gets the single instance. */
+		static TaskScheduler& GetInstance();
+
+		/*!
+		 * Queues a task to be executed by the next thread available.
+		 * @param task The task to be executed. It must not throw.
+		 */
+		void Post(std::function<void()> task);
+
+		/*!
+		 * Executes a single queued task on the calling thread, see ThreadPool::RunPending.
+		 * Tasks passed to an executor of the application are never run by this.
+		 * @returns Returns true if a task has been executed, false otherwise.
+		 */
+		bool RunPending();
+
+		/*! Implements Scheduler::SetMaxThreads. */
+		void SetMaxThreads(size_t count);
+
+		/*! Implements Scheduler::GetMaxThreads. */
+		size_t GetMaxThreads() const;
+
+		/*! Implements Scheduler::GetThreadCount. */
+		size_t GetThreadCount() const;
+
+		/*! Implements Scheduler::SetExecutor. */
+		void SetExecutor(TaskExecutor executor);
+
+		/*!
+		 * Whether the library may start threads of its own besides the scheduler, like
+		 * pipelines of compressed archive entries or the threads of a batch of files.
+		 * Their work is done single-threaded instead if an executor of the application
+		 * is set or the maximum number of threads is 1.
+		 */
+		bool AllowsDedicatedThreads() const;
+
+	private:
+		/*! Creates the single instance. */
+		TaskScheduler();
+
+		/*! Destroys the single instance. Waits for all tasks queued to be finished. */
+		~TaskScheduler();
+
+		/*! Serializes access to the settings and the thread pool. */
+		mutable std::mutex m_Mutex;
+
+		/*! The maximum number of worker threads or 0 for one thread per processor core. */
+		size_t m_MaxThreads{};
+
+		/*! The thread pool or nullptr if it has not been used yet. */
+		std::shared_ptr<ThreadPool> m_Pool;
+
+		/*! The executor of the application or empty to use the thread pool. */
+		TaskExecutor m_Executor;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		TaskScheduler(const TaskScheduler& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		TaskScheduler& operator=(const TaskScheduler& src) = delete;
+	};
+}
+
+#endif
@@ -0,0 +1,184 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "thread_pool.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+
+thread_local ThreadPool* ThreadPool::s_CurrentPool{ nullptr };
+thread_local size_t ThreadPool::s_CurrentQueue{ 0 };
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+	}
+
+	m_Queues.reserve(threadCount);
+
+	for (size_t n = 0; n < threadCount; ++n)
+	{
+		m_Queues.push_back(std::make_unique<TaskQueue>());
+	}
+
+	m_Threads.reserve(threadCount);
+
+	for (size_t n = 0; n < threadCount; ++n)
+	{
+		m_Threads.emplace_back(&ThreadPool::Run, this, n);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+
+	m_Condition.notify_all();
+
+	for (auto& thread : m_Threads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::Post(std::function<void()> task)
+{
+	assert(task);
+
+	size_t index{};
+
+	// Count the task before queueing it, so it is never taken before it is counted
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		++m_Pending;
+
+		index = s_CurrentPool == this ? s_CurrentQueue : m_NextQueue++ % m_Queues.size();
+	}
+
+	{
+		auto& queue{ *m_Queues[index] };
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	m_Condition.notify_one();
+}
+
+bool ThreadPool::RunPending()
+{
+	std::function<void()> task;
+
+	if (!Take(s_CurrentPool == this ? s_CurrentQueue : 0, task))
+	{
+		return false;
+	}
+
+	task();
+
+	return true;
+}
+
+size_t ThreadPool::GetThreadCount() const
+{
+	return m_Threads.size();
+}
+
+void ThreadPool::Run(size_t index)
+{
+	s_CurrentPool = this;
+	s_CurrentQueue = index;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_IsStopping || m_Pending > 0; });
+
+			if (m_Pending == 0)
+			{
+				return;
+			}
+		}
+
+		std::function<void()> task;
+
+		if (Take(index, task))
+		{
+			task();
+		}
+		else
+		{
+			// The task counted is just being queued
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool ThreadPool::Take(size_t index, std::function<void()>& task)
+{
+	const auto count{ m_Queues.size() };
+
+	for (size_t n = 0; n < count; ++n)
+	{
+		auto& queue{ *m_Queues[(index + n) % count] };
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.tasks.empty())
+		{
+			if (n == 0)
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+
+			break;
+		}
+	}
+
+	if (!task)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	--m_Pending;
+
+	return true;
+}
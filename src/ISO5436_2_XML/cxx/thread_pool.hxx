@@ -0,0 +1,148 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * A fixed number of worker threads executing queued tasks.
+ */
+
+#ifndef _OPENGPS_THREAD_POOL_HXX
+#define _OPENGPS_THREAD_POOL_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opengps/cxx/opengps.hxx>
+
+namespace OpenGPS
+{
+	/*!
+	 * Executes tasks on a fixed number of worker threads.
+	 *
+	 * Every worker thread owns a queue of tasks. Tasks posted from outside are distributed
+	 * over these queues in turn, tasks posted by a worker thread are queued by itself and
+	 * executed last in first out. A worker thread whose queue runs empty steals the oldest
+	 * task of another queue. So tasks may be executed in any order. Tasks must not throw.
+	 */
+	class ThreadPool
+	{
+	public:
+		/*!
+		 * Creates a new instance and starts its worker threads.
+		 * @param threadCount The number of worker threads. If this is 0 there is one
+		 * thread per processor core.
+		 */
+		ThreadPool(size_t threadCount);
+
+		/*! Destroys this instance. Waits for all tasks posted to be finished. */
+		~ThreadPool();
+
+		/*!
+		 * Queues a task to be executed by the next worker thread available.
+		 * @param task The task to be executed.
+		 */
+		void Post(std::function<void()> task);
+
+		/*!
+		 * Executes a single queued task on the calling thread, if there is any.
+		 * A thread waiting for tasks it has posted should call this rather than block,
+		 * so that waiting within a task does not starve the pool.
+		 * @returns Returns true if a task has been executed, false if no task is queued.
+		 */
+		bool RunPending();
+
+		/*! Gets the number of worker threads. */
+		size_t GetThreadCount() const;
+
+	private:
+		/*! The tasks queued for a single worker thread. */
+		struct TaskQueue
+		{
+			/*! Serializes access to the tasks. */
+			std::mutex mutex;
+
+			/*! Tasks not yet started. */
+			std::deque<std::function<void()>> tasks;
+		};
+
+		/*!
+		 * Executes tasks until the pool is stopped and no task is left.
+		 * @param index The index of the queue owned by the worker thread.
+		 */
+		void Run(size_t index);
+
+		/*!
+		 * Takes the next task to be executed.
+		 * The newest task of the given queue is taken first, then the oldest task of any other queue.
+		 * @param index The index of the queue to start with.
+		 * @param task Gets the task taken.
+		 * @returns Returns true if a task has been taken, false if all queues are empty.
+		 */
+		bool Take(size_t index, std::function<void()>& task);
+
+		/*! Serializes access to the number of pending tasks. */
+		std::mutex m_Mutex;
+
+		/*! Signals that a task has been queued or the pool is to be stopped. */
+		std::condition_variable m_Condition;
+
+		/*! The number of tasks queued but not yet taken. */
+		size_t m_Pending{};
+
+		/*! The queue the next task posted from outside is put into. */
+		size_t m_NextQueue{};
+
+		/*! true if the worker threads are to be stopped. */
+		bool m_IsStopping{};
+
+		/*! One queue per worker thread. */
+		std::vector<std::unique_ptr<TaskQueue>> m_Queues;
+
+		/*! The worker threads. */
+		std::vector<std::thread> m_Threads;
+
+		/*! The pool the calling thread works for or nullptr. */
+		static thread_local ThreadPool* s_CurrentPool;
+
+		/*! The index of the queue owned by the calling worker thread. */
+		static thread_local size_t s_CurrentQueue;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ThreadPool(const ThreadPool& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ThreadPool& operator=(const ThreadPool& src) = delete;
+	};
+}
+
+#endif
@@ -37,6 +37,9 @@
 
 #include <opengps/cxx/exceptions.hxx>
 
+#include <iterator>
+#include <vector>
+
 ValidBuffer::ValidBuffer(std::shared_ptr<PointBuffer> value)
 	:PointValidityProvider{ value }
 {
@@ -154,7 +157,19 @@ void ValidBuffer::Read(std::basic_istream<char>& stream)
 
 	// get length of file:
 	stream.seekg(0, std::ios::end);
-	if (!stream.fail())
+	if (stream.fail())
+	{
+		// Archive entries decompressed while being read cannot seek, so they are read up to their end.
+		stream.clear();
+
+		const std::vector<char> data{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+		if (!stream.bad())
+		{
+			Read(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+			success = true;
+		}
+	}
+	else
 	{
 		const auto length{ stream.tellg() };
 		if (!stream.fail())
@@ -186,6 +201,19 @@ void ValidBuffer::Read(std::basic_istream<char>& stream)
 	}
 }
 
+void ValidBuffer::Read(const unsigned char* data, size_t size)
+{
+	assert(data || size == 0);
+
+	Reset();
+
+	if (size > 0)
+	{
+		AllocateRaw(size);
+		memcpy(m_ValidityBuffer.get(), data, size);
+	}
+}
+
 void ValidBuffer::Write(std::ostream& stream)
 {
 	assert(m_ValidityBuffer);
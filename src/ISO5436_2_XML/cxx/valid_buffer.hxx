@@ -64,6 +64,13 @@ namespace OpenGPS
 		 */
 		void Read(std::basic_istream<char>& stream);
 
+		/*!
+		 * Copies the bit buffer from memory.
+		 * @param data The bit array gets copied from here.
+		 * @param size The size of the bit array in bytes.
+		 */
+		void Read(const unsigned char* data, size_t size);
+
 		/*!
 		 * Maps the bit buffer to a binary stream.
 		 * @param stream The internal bit array gets written to the given stream.
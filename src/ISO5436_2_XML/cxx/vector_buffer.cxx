@@ -29,6 +29,7 @@
  ***************************************************************************/
 
 #include "vector_buffer.hxx"
+#include <opengps/cxx/data_point.hxx>
 #include "point_vector_proxy.hxx"
 #include "point_buffer.hxx"
 
@@ -100,3 +101,80 @@ std::shared_ptr<PointVectorBase> VectorBuffer::CreatePointVectorProxy(std::share
 {
 	return std::make_shared<PointVectorProxy>(context, *this);
 }
+
+void VectorBuffer::GetPoint(size_t index, PointVectorBase& value) const
+{
+	assert(value.GetX() && value.GetY() && value.GetZ());
+
+	std::unique_lock<std::mutex> lock(m_PagedMutex, std::defer_lock);
+	if (m_IsPaged)
+	{
+		lock.lock();
+	}
+
+	GetValue(m_X.get(), index, *value.GetX());
+	GetValue(m_Y.get(), index, *value.GetY());
+	GetValue(m_Z.get(), index, *value.GetZ());
+}
+
+bool VectorBuffer::IsValid(size_t index) const
+{
+	assert(m_ValidityProvider);
+
+	std::unique_lock<std::mutex> lock(m_PagedMutex, std::defer_lock);
+	if (m_IsPaged)
+	{
+		lock.lock();
+	}
+
+	return m_ValidityProvider->IsValid(index);
+}
+
+void VectorBuffer::SetPaged()
+{
+	m_IsPaged = true;
+}
+
+void VectorBuffer::GetValue(const PointBuffer* buffer, size_t index, DataPoint& point)
+{
+	if (!buffer)
+	{
+		point.Reset();
+		return;
+	}
+
+	switch (buffer->GetPointType())
+	{
+	case OGPS_Int16PointType:
+	{
+		OGPS_Int16 value{};
+		buffer->Get(index, value);
+		point.Set(value);
+		break;
+	}
+	case OGPS_Int32PointType:
+	{
+		OGPS_Int32 value{};
+		buffer->Get(index, value);
+		point.Set(value);
+		break;
+	}
+	case OGPS_FloatPointType:
+	{
+		OGPS_Float value{};
+		buffer->Get(index, value);
+		point.Set(value);
+		break;
+	}
+	case OGPS_DoublePointType:
+	{
+		OGPS_Double value{};
+		buffer->Get(index, value);
+		point.Set(value);
+		break;
+	}
+	default:
+		point.Reset();
+		break;
+	}
+}
@@ -40,6 +40,8 @@
 
 #include "valid_buffer.hxx"
 
+#include <mutex>
+
 namespace OpenGPS
 {
 	class PointBuffer;
@@ -60,6 +62,10 @@ namespace OpenGPS
 	 *
 	 * Also information
 	 * about the validity of point vectors is provided based on indexes.
+	 *
+	 * VectorBuffer::GetPoint and VectorBuffer::IsValid do not change any state
+	 * and may be called from several threads at once. Only point data
+	 * that is paged in from a temporary file is read in turn.
 	 */
 	class VectorBuffer
 	{
@@ -141,7 +147,40 @@ namespace OpenGPS
 		 */
 		std::shared_ptr<PointVectorBase> CreatePointVectorProxy(std::shared_ptr<PointVectorProxyContext> context);
 
+		/*!
+		 * Gets the values of a single point vector.
+		 * Other than a proxied point vector this keeps no current index and
+		 * may be called concurrently.
+		 * @param index The index of the point vector.
+		 * @param value Gets the values stored. Components of axes without explicit
+		 * point values get reset.
+		 */
+		void GetPoint(size_t index, PointVectorBase& value) const;
+
+		/*!
+		 * Returns true if the point vector at the given index is valid.
+		 * May be called concurrently.
+		 * @param index The index of the point vector.
+		 */
+		bool IsValid(size_t index) const;
+
+		/*!
+		 * Marks the point data as paged, see OpenGPS::PagedStorage.
+		 * Reading paged point data swaps the pages held in memory, so
+		 * concurrent calls of VectorBuffer::GetPoint and VectorBuffer::IsValid
+		 * are serialized then.
+		 */
+		void SetPaged();
+
 	private:
+		/*!
+		 * Gets a single value of an axis.
+		 * @param buffer The values of the axis or nullptr if the axis has none.
+		 * @param index The index of the value.
+		 * @param point Gets the value or gets reset if the axis has none.
+		 */
+		static void GetValue(const PointBuffer* buffer, size_t index, DataPoint& point);
+
 		/*! Buffer for measurements of the X component of all point vectors. */
 		std::shared_ptr<PointBuffer> m_X;
 
@@ -156,6 +195,12 @@ namespace OpenGPS
 
 		/*! Interface to retrieve/provide point validity information.  */
 		std::shared_ptr<PointValidityProvider> m_ValidityProvider;
+
+		/*! true if point data is paged and must be read in turn. */
+		bool m_IsPaged{};
+
+		/*! Serializes reading of paged point data. */
+		mutable std::mutex m_PagedMutex;
 	};
 }
 
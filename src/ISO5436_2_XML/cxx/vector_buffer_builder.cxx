@@ -34,6 +34,8 @@
 #include "inline_validity.hxx"
 
 #include "point_buffer_impl.hxx"
+#include "paged_point_buffer.hxx"
+#include "mapped_point_buffer.hxx"
 
 #include <opengps/cxx/exceptions.hxx>
 
@@ -48,6 +50,30 @@ bool VectorBufferBuilder::BuildBuffer()
 	return true;
 }
 
+bool VectorBufferBuilder::BuildBuffer(std::shared_ptr<PagedStorage> storage)
+{
+	m_Storage = storage;
+
+	if (!BuildBuffer())
+	{
+		return false;
+	}
+
+	if (storage)
+	{
+		m_Buffer->SetPaged();
+	}
+
+	return true;
+}
+
+bool VectorBufferBuilder::BuildBuffer(std::shared_ptr<MappedStorage> storage)
+{
+	m_Mapped = storage;
+
+	return BuildBuffer();
+}
+
 bool VectorBufferBuilder::BuildX(OGPS_DataPointType dataType, size_t size)
 {
 	assert(m_Buffer);
@@ -146,19 +172,19 @@ std::shared_ptr<PointBuffer> VectorBufferBuilder::CreatePointBuffer(OGPS_DataPoi
 	switch (dataType)
 	{
 	case OGPS_Int16PointType:
-		point = std::make_shared<Int16PointBuffer>();
+		point = m_Mapped ? std::make_shared<Int16MappedPointBuffer>(m_Mapped) : m_Storage ? std::static_pointer_cast<PointBuffer>(std::make_shared<Int16PagedPointBuffer>(m_Storage)) : std::make_shared<Int16PointBuffer>();
 		retval = true;
 		break;
 	case OGPS_Int32PointType:
-		point = std::make_shared<Int32PointBuffer>();
+		point = m_Mapped ? std::make_shared<Int32MappedPointBuffer>(m_Mapped) : m_Storage ? std::static_pointer_cast<PointBuffer>(std::make_shared<Int32PagedPointBuffer>(m_Storage)) : std::make_shared<Int32PointBuffer>();
 		retval = true;
 		break;
 	case OGPS_FloatPointType:
-		point = std::make_shared<FloatPointBuffer>();
+		point = m_Mapped ? std::make_shared<FloatMappedPointBuffer>(m_Mapped) : m_Storage ? std::static_pointer_cast<PointBuffer>(std::make_shared<FloatPagedPointBuffer>(m_Storage)) : std::make_shared<FloatPointBuffer>();
 		retval = true;
 		break;
 	case OGPS_DoublePointType:
-		point = std::make_shared<DoublePointBuffer>();
+		point = m_Mapped ? std::make_shared<DoubleMappedPointBuffer>(m_Mapped) : m_Storage ? std::static_pointer_cast<PointBuffer>(std::make_shared<DoublePagedPointBuffer>(m_Storage)) : std::make_shared<DoublePointBuffer>();
 		retval = true;
 		break;
 	case OGPS_MissingPointType:
@@ -43,6 +43,8 @@ namespace OpenGPS
 {
 	class PointBuffer;
 	class VectorBuffer;
+	class PagedStorage;
+	class MappedStorage;
 
 	/*!
 	 * Creates an object which is able to assemble a OpenGPS::VectorBuffer instance.
@@ -56,6 +58,22 @@ namespace OpenGPS
 		 */
 		bool BuildBuffer();
 
+		/*!
+		 * Creates the initial OpenGPS::VectorBuffer to be assembled whose point data is paged.
+		 * @remarks This must preceed all other steps of the building process.
+		 * @param storage The storage which keeps point data of all axes. Point data is kept
+		 * in memory as a whole if this is nullptr.
+		 */
+		bool BuildBuffer(std::shared_ptr<PagedStorage> storage);
+
+		/*!
+		 * Creates the initial OpenGPS::VectorBuffer to be assembled whose point data is mapped from a file.
+		 * @remarks This must preceed all other steps of the building process.
+		 * @param storage The storage which keeps point data of all axes. The regions of the
+		 * axes are reserved in the order X, Y and Z.
+		 */
+		bool BuildBuffer(std::shared_ptr<MappedStorage> storage);
+
 		/*!
 		 * Connects the appropriate OpenGPS::PointBuffer connected with the X axis description.
 		 * @param dataType The type of point data connected to the X axis. A value of
@@ -107,6 +125,12 @@ namespace OpenGPS
 
 		/*! The vector buffer object to be assembled. */
 		std::shared_ptr<VectorBuffer> m_Buffer;
+
+		/*! The storage of paged point data or nullptr. */
+		std::shared_ptr<PagedStorage> m_Storage;
+
+		/*! The storage of mapped point data or nullptr. */
+		std::shared_ptr<MappedStorage> m_Mapped;
 	};
 }
 
@@ -39,6 +39,8 @@
 
 #include <opengps/cxx/string.hxx>
 
+#include <atomic>
+#include <random>
 #include <sstream>
 
 #ifdef _UNICODE
@@ -66,8 +68,6 @@ Win32Environment::~Win32Environment()
 {
 }
 
-bool Win32Environment::m_InitRandom = true;
-
 OGPS_Character Win32Environment::GetDirectorySeparator() const
 {
 	return _T('\\');
@@ -282,21 +282,15 @@ bool Win32Environment::RemoveFile(const String& file) const
 	return (DeleteFile(file.c_str()) != 0);
 }
 
-#define GETRANDOM(min, max) ((rand()%(int)(((max) + 1)-(min)))+ (min))
-
 String Win32Environment::GetUniqueName() const
 {
-	if (m_InitRandom)
-	{
-		srand((unsigned int)time(nullptr));
-		m_InitRandom = false;
-	}
-
-	// random positive number with max. 8 digits
-	int randNum = GETRANDOM(0, 10000000);
+	// The counter makes names unique within this process, the process id and
+	// a random number distinguish them from names used by other processes.
+	static std::atomic<unsigned long long> counter{};
+	thread_local std::mt19937 random{ std::random_device{}() };
 
 	OutStringStream os;
-	os << randNum;
+	os << GetCurrentProcessId() << _T('-') << ++counter << _T('-') << random() % 10000000;
 
 	return os.str();
 }
@@ -310,6 +304,34 @@ bool Win32Environment::CreateDir(const String& path) const
 	return (CreateDirectory(path.c_str(), nullptr) != 0);
 }
 
+String Win32Environment::CreateUniqueDir(const String& base) const
+{
+	assert(base.length() > 0);
+
+	// CreateDirectory fails for existing directories, then another name is tried
+	for (int attempt = 0; attempt < 100; ++attempt)
+	{
+		String name{ _T("x3p") };
+		name += GetUniqueName();
+
+		const auto path{ ConcatPathes(base, name) };
+
+		ResetLastErrorCode();
+
+		if (CreateDirectory(path.c_str(), nullptr) != 0)
+		{
+			return path;
+		}
+
+		if (GetLastError() != ERROR_ALREADY_EXISTS)
+		{
+			break;
+		}
+	}
+
+	return String();
+}
+
 bool Win32Environment::RemoveDir(const String& path) const
 {
 	assert(path.length() > 0);
@@ -365,6 +387,229 @@ bool Win32Environment::RenameFile(const String& src, const String& dst) const
 	return (MoveFileEx(src.c_str(), dst.c_str(), MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
 }
 
+bool Win32Environment::GetFiles(const String& path, std::vector<FileInfo>& files) const
+{
+	assert(path.length() > 0);
+
+	ResetLastErrorCode();
+
+	const String pattern = ConcatPathes(path, _T("*"));
+
+	WIN32_FIND_DATA found;
+	HANDLE handle = FindFirstFile(pattern.c_str(), &found);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return (GetLastError() == ERROR_FILE_NOT_FOUND);
+	}
+
+	do
+	{
+		if ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+		{
+			FileInfo info;
+			info.name = found.cFileName;
+			info.size = (static_cast<unsigned long long>(found.nFileSizeHigh) << 32) | found.nFileSizeLow;
+			info.modified = static_cast<long long>((static_cast<unsigned long long>(found.ftLastWriteTime.dwHighDateTime) << 32) | found.ftLastWriteTime.dwLowDateTime);
+			files.push_back(info);
+		}
+	} while (FindNextFile(handle, &found));
+
+	FindClose(handle);
+
+	ResetLastErrorCode();
+
+	return true;
+}
+
+bool Win32Environment::GetFileInfo(const String& file, FileInfo& info) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesEx(file.c_str(), GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+	{
+		return false;
+	}
+
+	info.name = GetFileName(file);
+	info.size = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+	info.modified = static_cast<long long>((static_cast<unsigned long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime);
+
+	return true;
+}
+
+bool Win32Environment::TouchFile(const String& file) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	HANDLE handle = CreateFile(file.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	const bool success = (SetFileTime(handle, nullptr, nullptr, &now) != 0);
+	CloseHandle(handle);
+
+	return success;
+}
+
+std::shared_ptr<unsigned char> Win32Environment::MapFile(const String& file, size_t& size) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+	size = 0;
+
+	HANDLE handle = CreateFile(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+
+	LARGE_INTEGER length;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(handle, &length) && length.QuadPart > 0)
+	{
+		mapping = CreateFileMapping(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	}
+	CloseHandle(handle);
+
+	if (mapping == nullptr)
+	{
+		return nullptr;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+	{
+		return nullptr;
+	}
+
+	size = static_cast<size_t>(length.QuadPart);
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [](unsigned char* p) { UnmapViewOfFile(p); });
+}
+
+bool Win32Environment::PrefetchFile(const String& file) const
+{
+	assert(file.length() > 0);
+
+	ResetLastErrorCode();
+
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+	size_t size = 0;
+	const auto data{ MapFile(file, size) };
+	if (!data)
+	{
+		return false;
+	}
+
+	// The pages read stay in the standby list of the file cache after the view is unmapped
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = data.get();
+	range.NumberOfBytes = size;
+	return (PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0);
+#else
+	// PrefetchVirtualMemory requires Windows 8
+	return false;
+#endif
+}
+
+std::shared_ptr<unsigned char> Win32Environment::CreateSharedMemory(const String& name, size_t size, bool allUsers) const
+{
+	assert(name.length() > 0 && size > 0);
+
+	ResetLastErrorCode();
+
+	// Visible to all processes of the current session, which belongs to a single user.
+	// The default security descriptor grants access to the current user only.
+	String tempName(_T("Local\\"));
+	tempName += name;
+
+	const unsigned long long length = size;
+	HANDLE mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(length >> 32), static_cast<DWORD>(length & 0xFFFFFFFF), tempName.c_str());
+	if (mapping == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		CloseHandle(mapping);
+		return nullptr;
+	}
+
+	// The segment exists as long as any view of it.
+	void* data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+	{
+		return nullptr;
+	}
+
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [](unsigned char* p) { UnmapViewOfFile(p); });
+}
+
+std::shared_ptr<unsigned char> Win32Environment::MapSharedMemory(const String& name, size_t& size, bool allUsers) const
+{
+	assert(name.length() > 0);
+
+	ResetLastErrorCode();
+
+	size = 0;
+
+	String tempName(_T("Local\\"));
+	tempName += name;
+
+	HANDLE mapping = OpenFileMapping(FILE_MAP_COPY, FALSE, tempName.c_str());
+	if (mapping == nullptr)
+	{
+		return nullptr;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+	{
+		return nullptr;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	if (VirtualQuery(data, &info, sizeof(info)) == 0)
+	{
+		UnmapViewOfFile(data);
+		return nullptr;
+	}
+
+	size = info.RegionSize;
+	return std::shared_ptr<unsigned char>(static_cast<unsigned char*>(data), [](unsigned char* p) { UnmapViewOfFile(p); });
+}
+
+bool Win32Environment::RemoveSharedMemory(const String& name) const
+{
+	assert(name.length() > 0);
+
+	// Segments vanish as soon as the last view has been unmapped.
+	return false;
+}
+
+bool Win32Environment::GetSharedMemory(std::vector<FileInfo>& segments) const
+{
+	// Named segments cannot be enumerated.
+	return false;
+}
+
 bool Win32Environment::GetVariable(const String& varName, String& value) const
 {
 	ResetLastErrorCode();
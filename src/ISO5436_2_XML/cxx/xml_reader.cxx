@@ -0,0 +1,464 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "xml_reader.hxx"
+#include "stdafx.hxx"
+
+#include <opengps/cxx/exceptions.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+/* The maximum nesting depth of elements, which protects the stack. */
+#define _OPENGPS_XML_READER_MAX_DEPTH 256
+
+/* The characters considered white space by XML. */
+#define _OPENGPS_XML_READER_WHITE_SPACE " \t\r\n"
+
+const XmlElement* XmlElement::FindChild(const char* childName) const
+{
+	assert(childName);
+
+	for (const auto& child : children)
+	{
+		if (child.name == childName)
+		{
+			return &child;
+		}
+	}
+
+	return nullptr;
+}
+
+std::string XmlElement::GetTrimmedText() const
+{
+	const auto first{ text.find_first_not_of(_OPENGPS_XML_READER_WHITE_SPACE) };
+	if (first == std::string::npos)
+	{
+		return std::string();
+	}
+
+	const auto last{ text.find_last_not_of(_OPENGPS_XML_READER_WHITE_SPACE) };
+	return text.substr(first, last - first + 1);
+}
+
+String XmlElement::GetString() const
+{
+	const auto utf8{ GetTrimmedText() };
+
+#ifdef _UNICODE
+	String result;
+
+	for (size_t n = 0; n < utf8.length();)
+	{
+		const auto lead{ static_cast<unsigned char>(utf8[n]) };
+		const size_t length{ lead < 0x80 ? 1u : lead < 0xE0 ? 2u : lead < 0xF0 ? 3u : 4u };
+
+		unsigned long codePoint{ length == 1 ? lead : length == 2 ? lead & 0x1Fu : length == 3 ? lead & 0x0Fu : lead & 0x07u };
+		for (size_t k = 1; k < length && n + k < utf8.length(); ++k)
+		{
+			codePoint = (codePoint << 6) | (static_cast<unsigned char>(utf8[n + k]) & 0x3Fu);
+		}
+		n += length;
+
+		// Wide characters of two bytes need surrogate pairs
+		if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF)
+		{
+			codePoint -= 0x10000;
+			result += static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+			result += static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+		}
+		else
+		{
+			result += static_cast<wchar_t>(codePoint);
+		}
+	}
+
+	return result;
+#else
+	return String(utf8);
+#endif
+}
+
+XmlElement XmlReader::Read(std::istream& stream)
+{
+	const std::string document{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+	XmlReader reader(document.data(), document.data() + document.size());
+	return reader.ReadDocument();
+}
+
+XmlReader::XmlReader(const char* begin, const char* end)
+	:m_Begin{ begin },
+	m_Position{ begin },
+	m_End{ end }
+{
+}
+
+XmlElement XmlReader::ReadDocument()
+{
+	// Byte order mark of UTF-8
+	if (LookingAt("\xEF\xBB\xBF"))
+	{
+		m_Position += 3;
+	}
+
+	SkipMisc();
+
+	if (!LookingAt("<"))
+	{
+		Fail("The root element is missing.");
+	}
+
+	++m_Position;
+
+	XmlElement root;
+	ReadElement(root, 0);
+
+	SkipMisc();
+
+	if (m_Position != m_End)
+	{
+		Fail("Content follows the root element.");
+	}
+
+	return root;
+}
+
+void XmlReader::ReadElement(XmlElement& element, size_t depth)
+{
+	if (depth > _OPENGPS_XML_READER_MAX_DEPTH)
+	{
+		Fail("Elements are nested too deeply.");
+	}
+
+	// Qualified name as written, needed to match the end tag
+	const auto qualifiedBegin{ m_Position };
+	element.name = ReadName();
+	const std::string qualifiedName(qualifiedBegin, m_Position);
+
+	SkipAttributes();
+
+	if (LookingAt("/>"))
+	{
+		m_Position += 2;
+		return;
+	}
+
+	if (!LookingAt(">"))
+	{
+		Fail("A start tag is not closed.");
+	}
+
+	++m_Position;
+
+	while (m_Position < m_End)
+	{
+		const auto c{ *m_Position };
+
+		if (c == '&')
+		{
+			++m_Position;
+			ReadReference(element.text);
+		}
+		else if (c != '<')
+		{
+			const auto next{ std::find_if(m_Position, m_End, [](char x) { return x == '<' || x == '&'; }) };
+			element.text.append(m_Position, next);
+			m_Position = next;
+		}
+		else if (LookingAt("</"))
+		{
+			m_Position += 2;
+
+			if (static_cast<size_t>(m_End - m_Position) < qualifiedName.length() ||
+				qualifiedName.compare(0, qualifiedName.length(), m_Position, qualifiedName.length()) != 0)
+			{
+				Fail("An end tag does not match its start tag.");
+			}
+
+			m_Position += qualifiedName.length();
+			SkipWhiteSpace();
+
+			if (!LookingAt(">"))
+			{
+				Fail("An end tag is not closed.");
+			}
+
+			++m_Position;
+			return;
+		}
+		else if (LookingAt("<!--"))
+		{
+			SkipPast("-->");
+		}
+		else if (LookingAt("<?"))
+		{
+			SkipPast("?>");
+		}
+		else if (LookingAt("<![CDATA["))
+		{
+			m_Position += 9;
+
+			const auto next{ std::search(m_Position, m_End, "]]>", "]]>" + 3) };
+			if (next == m_End)
+			{
+				Fail("A CDATA section is not closed.");
+			}
+
+			element.text.append(m_Position, next);
+			m_Position = next + 3;
+		}
+		else
+		{
+			++m_Position;
+
+			element.children.emplace_back();
+			ReadElement(element.children.back(), depth + 1);
+		}
+	}
+
+	Fail("An element is not closed.");
+}
+
+void XmlReader::SkipMisc()
+{
+	for (;;)
+	{
+		SkipWhiteSpace();
+
+		if (LookingAt("<?"))
+		{
+			SkipPast("?>");
+		}
+		else if (LookingAt("<!--"))
+		{
+			SkipPast("-->");
+		}
+		else if (LookingAt("<!DOCTYPE"))
+		{
+			// Internal subsets are skipped as a whole, their declarations are not applied
+			size_t brackets{};
+			for (; m_Position < m_End && (*m_Position != '>' || brackets > 0); ++m_Position)
+			{
+				brackets += (*m_Position == '[') ? 1 : 0;
+				brackets -= (*m_Position == ']' && brackets > 0) ? 1 : 0;
+			}
+
+			SkipPast(">");
+		}
+		else
+		{
+			return;
+		}
+	}
+}
+
+void XmlReader::SkipAttributes()
+{
+	for (;;)
+	{
+		SkipWhiteSpace();
+
+		if (m_Position >= m_End || *m_Position == '>' || *m_Position == '/')
+		{
+			return;
+		}
+
+		ReadName();
+		SkipWhiteSpace();
+
+		if (!LookingAt("="))
+		{
+			Fail("An attribute has no value.");
+		}
+
+		++m_Position;
+		SkipWhiteSpace();
+
+		if (m_Position >= m_End || (*m_Position != '"' && *m_Position != '\''))
+		{
+			Fail("An attribute value is not quoted.");
+		}
+
+		const char quote[2] = { *m_Position, 0 };
+		++m_Position;
+		SkipPast(quote);
+	}
+}
+
+std::string XmlReader::ReadName()
+{
+	const auto begin{ m_Position };
+	auto local{ m_Position };
+
+	for (; m_Position < m_End; ++m_Position)
+	{
+		const auto c{ *m_Position };
+
+		if (c == ':')
+		{
+			local = m_Position + 1;
+		}
+		else if (strchr(_OPENGPS_XML_READER_WHITE_SPACE "/>=<&\"'", c) || c == 0)
+		{
+			break;
+		}
+	}
+
+	if (m_Position == begin || local == m_Position)
+	{
+		Fail("A name is missing.");
+	}
+
+	return std::string(local, m_Position);
+}
+
+void XmlReader::ReadReference(std::string& text)
+{
+	const auto end{ std::find(m_Position, m_End, ';') };
+	if (end == m_End)
+	{
+		Fail("A reference is not terminated.");
+	}
+
+	const std::string name(m_Position, end);
+	m_Position = end + 1;
+
+	if (name == "lt")
+	{
+		text += '<';
+	}
+	else if (name == "gt")
+	{
+		text += '>';
+	}
+	else if (name == "amp")
+	{
+		text += '&';
+	}
+	else if (name == "quot")
+	{
+		text += '"';
+	}
+	else if (name == "apos")
+	{
+		text += '\'';
+	}
+	else if (name.length() > 1 && name[0] == '#')
+	{
+		const auto hex{ name[1] == 'x' };
+		const auto digits{ name.substr(hex ? 2 : 1) };
+
+		if (digits.empty() || digits.find_first_not_of(hex ? "0123456789abcdefABCDEF" : "0123456789") != std::string::npos || digits.length() > 8)
+		{
+			Fail("A character reference is invalid.");
+		}
+
+		const auto codePoint{ std::stoul(digits, nullptr, hex ? 16 : 10) };
+		if (codePoint == 0 || codePoint > 0x10FFFF)
+		{
+			Fail("A character reference is out of range.");
+		}
+
+		// Encoded as UTF-8 like the rest of the document
+		if (codePoint < 0x80)
+		{
+			text += static_cast<char>(codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			text += static_cast<char>(0xC0 | (codePoint >> 6));
+			text += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000)
+		{
+			text += static_cast<char>(0xE0 | (codePoint >> 12));
+			text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			text += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			text += static_cast<char>(0xF0 | (codePoint >> 18));
+			text += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			text += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+	else
+	{
+		Fail("An entity is not defined.");
+	}
+}
+
+void XmlReader::SkipPast(const char* delimiter)
+{
+	assert(delimiter);
+
+	const auto length{ strlen(delimiter) };
+	const auto next{ std::search(m_Position, m_End, delimiter, delimiter + length) };
+
+	if (next == m_End)
+	{
+		Fail("The document ends unexpectedly.");
+	}
+
+	m_Position = next + length;
+}
+
+bool XmlReader::LookingAt(const char* text) const
+{
+	assert(text);
+
+	const auto length{ strlen(text) };
+	return static_cast<size_t>(m_End - m_Position) >= length && memcmp(m_Position, text, length) == 0;
+}
+
+void XmlReader::SkipWhiteSpace()
+{
+	while (m_Position < m_End && strchr(_OPENGPS_XML_READER_WHITE_SPACE, *m_Position) && *m_Position != 0)
+	{
+		++m_Position;
+	}
+}
+
+void XmlReader::Fail(const char* reason) const
+{
+	std::ostringstream details;
+	details << reason << " Error at byte offset " << (m_Position - m_Begin) << " of the XML document.";
+
+	throw Exception(
+		OGPS_ExGeneral,
+		_EX_T("The XML document is not well-formed."),
+		details.str().c_str(),
+		_EX_T("OpenGPS::XmlReader::Fail"));
+}
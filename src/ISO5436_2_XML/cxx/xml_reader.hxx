@@ -0,0 +1,148 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Minimal non-validating reader of XML documents.
+ */
+
+#ifndef _OPENGPS_XML_READER_HXX
+#define _OPENGPS_XML_READER_HXX
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+
+namespace OpenGPS
+{
+	/*! An element of an XML document as read by OpenGPS::XmlReader. */
+	struct XmlElement
+	{
+		/*! The name of the element without its namespace prefix. */
+		std::string name;
+
+		/*! The character data directly contained in the element, encoded as UTF-8. */
+		std::string text;
+
+		/*! The child elements in document order. */
+		std::vector<XmlElement> children;
+
+		/*!
+		 * Gets the first child element of the given name.
+		 * @param childName The name of the child element without its namespace prefix.
+		 * @returns Returns the child element or nullptr if there is none.
+		 */
+		const XmlElement* FindChild(const char* childName) const;
+
+		/*! Gets the character data with leading and trailing white space removed. */
+		std::string GetTrimmedText() const;
+
+		/*! Gets the trimmed character data converted to the character type of the library. */
+		String GetString() const;
+	};
+
+	/*!
+	 * Reads the element tree of a UTF-8 encoded XML document.
+	 *
+	 * Only well-formedness is checked. There is no validation against a schema, no
+	 * external entities and no document type definitions. Attributes, comments and
+	 * processing instructions are skipped. The predefined entities and character
+	 * references are resolved.
+	 */
+	class XmlReader
+	{
+	public:
+		/*!
+		 * Reads a complete XML document.
+		 * @remarks Throws an OpenGPS::Exception if the document is not well-formed.
+		 * @param stream The XML document.
+		 * @returns Returns the root element.
+		 */
+		static XmlElement Read(std::istream& stream);
+
+	private:
+		/*!
+		 * Creates a new instance.
+		 * @param begin The first character of the document.
+		 * @param end Behind the last character of the document.
+		 */
+		XmlReader(const char* begin, const char* end);
+
+		/*! Reads the root element and everything around it. */
+		XmlElement ReadDocument();
+
+		/*!
+		 * Reads an element including its children once its start tag has been entered.
+		 * @param element Gets the element read.
+		 * @param depth The nesting depth of the element.
+		 */
+		void ReadElement(XmlElement& element, size_t depth);
+
+		/*! Skips white space, comments, processing instructions and document type declarations. */
+		void SkipMisc();
+
+		/*! Skips the attributes of a start tag. */
+		void SkipAttributes();
+
+		/*! Reads a name and returns it without its namespace prefix. */
+		std::string ReadName();
+
+		/*!
+		 * Resolves an entity or character reference once its ampersand has been passed.
+		 * @param text Gets the character referenced.
+		 */
+		void ReadReference(std::string& text);
+
+		/*! Skips everything up to and including the given delimiter. */
+		void SkipPast(const char* delimiter);
+
+		/*! Checks whether the document continues with the given characters. */
+		bool LookingAt(const char* text) const;
+
+		/*! Skips white space. */
+		void SkipWhiteSpace();
+
+		/*! Throws an exception describing the current position. */
+		void Fail(const char* reason) const;
+
+		/*! The first character of the document. */
+		const char* m_Begin;
+
+		/*! The current position within the document. */
+		const char* m_Position;
+
+		/*! Behind the last character of the document. */
+		const char* m_End;
+	};
+}
+
+#endif
@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zip_codec.hxx"
+#include "zlib_codec.hxx"
+#include "libdeflate_codec.hxx"
+#include "environment.hxx"
+
+#include <opengps/cxx/string.hxx>
+
+#include <algorithm>
+#include <cstring>
+
+/* zlib */
+#include <zlib.h>
+
+#include "stdafx.hxx"
+
+ZipDeflater::~ZipDeflater() = default;
+
+ZipInflater::~ZipInflater() = default;
+
+ZipCodec::~ZipCodec() = default;
+
+const ZipCodec* ZipCodec::GetInstance(const OGPS_Character* name)
+{
+	assert(name);
+
+	static const ZlibCodec zlib;
+	if (String(name) == zlib.GetName())
+	{
+		return &zlib;
+	}
+
+#ifdef _OPENGPS_HAVE_LIBDEFLATE
+	static const LibdeflateCodec libdeflate;
+	if (String(name) == libdeflate.GetName())
+	{
+		return &libdeflate;
+	}
+#endif
+
+	return nullptr;
+}
+
+const ZipCodec& ZipCodec::GetInstance()
+{
+	auto env = Environment::GetInstance();
+
+	String name;
+	if (env && env->GetVariable(_OPENGPS_ENV_ZIP_CODEC, name))
+	{
+		auto codec = GetInstance(name.c_str());
+		if (codec)
+		{
+			return *codec;
+		}
+	}
+
+#ifdef _OPENGPS_HAVE_LIBDEFLATE
+	return *GetInstance(_T("libdeflate"));
+#else
+	return *GetInstance(_T("zlib"));
+#endif
+}
+
+std::unique_ptr<ZipInflater> ZipCodec::CreateEntryInflater(int method, unsigned long long compressedSize, unsigned long long uncompressedSize)
+{
+	if (method == 0)
+	{
+		return std::make_unique<ZipStoreInflater>(uncompressedSize);
+	}
+
+	if (method == Z_DEFLATED)
+	{
+		return GetInstance().CreateInflater(compressedSize, uncompressedSize);
+	}
+
+	return nullptr;
+}
+
+ZipStoreInflater::ZipStoreInflater(unsigned long long size)
+	:m_Remaining{ size }
+{
+}
+
+ZipStoreInflater::~ZipStoreInflater() = default;
+
+void ZipStoreInflater::SetInput(const char* data, size_t size)
+{
+	m_Input = data;
+	m_Available = size;
+}
+
+bool ZipStoreInflater::NeedsInput() const
+{
+	return m_Available == 0 && m_Remaining > 0;
+}
+
+size_t ZipStoreInflater::Read(char* data, size_t size)
+{
+	auto chunk{ std::min(size, m_Available) };
+	if (chunk > m_Remaining)
+	{
+		chunk = static_cast<size_t>(m_Remaining);
+	}
+
+	memcpy(data, m_Input, chunk);
+
+	m_Input += chunk;
+	m_Available -= chunk;
+	m_Remaining -= chunk;
+
+	return chunk;
+}
+
+bool ZipStoreInflater::IsFinished() const
+{
+	return m_Remaining == 0;
+}
+
+bool ZipStoreInflater::IsGood() const
+{
+	return true;
+}
@@ -0,0 +1,210 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Exchangeable implementations of the deflate algorithm used to compress X3P archives.
+ */
+
+#ifndef _OPENGPS_ZIP_CODEC_HXX
+#define _OPENGPS_ZIP_CODEC_HXX
+
+#include <opengps/cxx/opengps.hxx>
+#include <functional>
+#include <memory>
+
+namespace OpenGPS
+{
+	/*!
+	 * Receives data produced by an OpenGPS::ZipDeflater.
+	 * Returns false if the data could not be processed, which aborts compression.
+	 */
+	typedef std::function<bool(const char* data, size_t size)> ZipCodecSink;
+
+	/*!
+	 * Compresses a stream of bytes into raw deflate data as stored within zip archives.
+	 * Compressed data is handed to an OpenGPS::ZipCodecSink as soon as it becomes available.
+	 */
+	class ZipDeflater
+	{
+	public:
+		/*! Destroys this instance. */
+		virtual ~ZipDeflater();
+
+		/*!
+		 * Compresses the next chunk of uncompressed data.
+		 * @param data Pointer to the uncompressed data.
+		 * @param size The number of bytes to compress.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool Write(const char* data, size_t size) = 0;
+
+		/*!
+		 * Flushes all pending data and terminates the deflate stream.
+		 * No more data can be written afterwards.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		virtual bool Finish() = 0;
+	};
+
+	/*!
+	 * Decompresses raw deflate data as stored within zip archives.
+	 *
+	 * Compressed input is pushed with ZipInflater::SetInput whenever
+	 * ZipInflater::NeedsInput becomes true and uncompressed data is pulled
+	 * with ZipInflater::Read until ZipInflater::IsFinished is reached.
+	 */
+	class ZipInflater
+	{
+	public:
+		/*! Destroys this instance. */
+		virtual ~ZipInflater();
+
+		/*!
+		 * Supplies the next chunk of compressed data.
+		 * @remarks The data must stay valid until ZipInflater::NeedsInput returns true again.
+		 * @param data Pointer to the compressed data.
+		 * @param size The number of bytes available.
+		 */
+		virtual void SetInput(const char* data, size_t size) = 0;
+
+		/*! Returns true if all compressed data supplied so far has been consumed. */
+		virtual bool NeedsInput() const = 0;
+
+		/*!
+		 * Decompresses data.
+		 * @param data Target buffer of the uncompressed data.
+		 * @param size The size of the target buffer in bytes.
+		 * @returns Returns the number of bytes written to the target buffer. This
+		 * may be less than requested if more compressed input is needed first.
+		 */
+		virtual size_t Read(char* data, size_t size) = 0;
+
+		/*! Returns true if the end of the deflate stream has been reached. */
+		virtual bool IsFinished() const = 0;
+
+		/*! Returns false if the compressed data has been found to be corrupted. */
+		virtual bool IsGood() const = 0;
+	};
+
+	/*!
+	 * Factory of a specific implementation of the deflate algorithm.
+	 *
+	 * The implementation based on zlib is always available. Faster implementations
+	 * may be compiled in (see the USE_LIBDEFLATE build option). Which one is used
+	 * can be chosen at run time with the environment variable OPENGPS_ZIP_CODEC, which
+	 * is evaluated for every archive entry. Since all of them produce standard deflate
+	 * streams, archives written with one codec can be read with any other.
+	 */
+	class ZipCodec
+	{
+	public:
+		/*! Destroys this instance. */
+		virtual ~ZipCodec();
+
+		/*! Gets the name of the codec as used with the OPENGPS_ZIP_CODEC environment variable. */
+		virtual const OGPS_Character* GetName() const = 0;
+
+		/*!
+		 * Creates a new compressor.
+		 * @param level The level of compression as known from zlib, i.e. 0 to 9 or Z_DEFAULT_COMPRESSION.
+		 * @param length The size of the uncompressed data if it is known in advance, otherwise 0.
+		 * @param sink Receives the compressed data.
+		 * @returns Returns the new instance.
+		 */
+		virtual std::unique_ptr<ZipDeflater> CreateDeflater(int level, unsigned long long length, ZipCodecSink sink) const = 0;
+
+		/*!
+		 * Creates a new decompressor.
+		 * @param compressedSize The size of the compressed data as stored in the zip directory.
+		 * @param uncompressedSize The size of the uncompressed data as stored in the zip directory.
+		 * @returns Returns the new instance.
+		 */
+		virtual std::unique_ptr<ZipInflater> CreateInflater(unsigned long long compressedSize, unsigned long long uncompressedSize) const = 0;
+
+		/*!
+		 * Gets the codec selected for the current process.
+		 * This is the codec named by the OPENGPS_ZIP_CODEC environment variable if it
+		 * is available, otherwise the fastest one that has been compiled in.
+		 */
+		static const ZipCodec& GetInstance();
+
+		/*!
+		 * Gets a codec by its name.
+		 * @param name The name of the codec, e.g. "zlib".
+		 * @returns Returns the codec or nullptr if it is unknown or has not been compiled in.
+		 */
+		static const ZipCodec* GetInstance(const OGPS_Character* name);
+
+		/*!
+		 * Creates a decompressor suitable for a zip archive entry.
+		 * @param method The compression method of the entry. Only stored and deflated
+		 * entries are supported.
+		 * @param compressedSize The size of the compressed data as stored in the zip directory.
+		 * @param uncompressedSize The size of the uncompressed data as stored in the zip directory.
+		 * @returns Returns the new instance or nullptr if the compression method is not supported.
+		 */
+		static std::unique_ptr<ZipInflater> CreateEntryInflater(int method, unsigned long long compressedSize, unsigned long long uncompressedSize);
+	};
+
+	/*!
+	 * Implements OpenGPS::ZipInflater for zip archive entries that
+	 * were stored without compression. Input is passed through as is.
+	 */
+	class ZipStoreInflater : public ZipInflater
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param size The size of the stored data.
+		 */
+		ZipStoreInflater(unsigned long long size);
+
+		/*! Destroys this instance. */
+		~ZipStoreInflater() override;
+
+		void SetInput(const char* data, size_t size) override;
+		bool NeedsInput() const override;
+		size_t Read(char* data, size_t size) override;
+		bool IsFinished() const override;
+		bool IsGood() const override;
+
+	private:
+		/*! The current input. */
+		const char* m_Input{};
+
+		/*! The amount of input left. */
+		size_t m_Available{};
+
+		/*! The amount of data not yet read. */
+		unsigned long long m_Remaining;
+	};
+}
+
+#endif
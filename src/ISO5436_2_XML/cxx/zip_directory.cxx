@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zip_directory.hxx"
+#include "byte_source_reader.hxx"
+#include "stdafx.hxx"
+
+#include <cctype>
+
+ZipDirectory::ZipDirectory(std::shared_ptr<const ByteSource> source)
+	:m_Source{ std::move(source) }
+{
+	assert(m_Source);
+}
+
+ZipDirectory::~ZipDirectory()
+{
+	for (auto handle : m_Handles)
+	{
+		unzClose(handle);
+	}
+}
+
+const std::shared_ptr<const ByteSource>& ZipDirectory::GetSource() const
+{
+	return m_Source;
+}
+
+unzFile ZipDirectory::Open(const String& name)
+{
+	auto entryName{ name };
+	const auto key{ GetKey(entryName.ToChar()) };
+
+	unzFile handle{};
+	unz64_file_pos position{};
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (!m_Handles.empty())
+		{
+			handle = m_Handles.back();
+			m_Handles.pop_back();
+		}
+		else
+		{
+			handle = ByteSourceReader::Open(m_Source);
+			if (!handle)
+			{
+				return nullptr;
+			}
+		}
+
+		if (!m_HasEntries)
+		{
+			m_HasEntries = ReadDirectory(handle);
+		}
+
+		const auto entry{ m_Entries.find(key) };
+		if (!m_HasEntries || entry == m_Entries.end())
+		{
+			m_Handles.push_back(handle);
+			return nullptr;
+		}
+
+		position = entry->second;
+	}
+
+	// Jump right to the entry instead of searching the directory.
+	if (unzGoToFilePos64(handle, &position) != UNZ_OK)
+	{
+		Close(handle);
+		return nullptr;
+	}
+
+	return handle;
+}
+
+void ZipDirectory::Close(unzFile handle)
+{
+	if (!handle)
+	{
+		return;
+	}
+
+	// Fails if no archive entry is open, which is fine here.
+	unzCloseCurrentFile(handle);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Handles.push_back(handle);
+}
+
+bool ZipDirectory::ReadDirectory(unzFile handle)
+{
+	m_Entries.clear();
+
+	std::vector<char> name;
+
+	for (auto status = unzGoToFirstFile(handle); status != UNZ_END_OF_LIST_OF_FILE; status = unzGoToNextFile(handle))
+	{
+		unz_file_info64 fileInfo;
+		unz64_file_pos position;
+
+		if (status != UNZ_OK ||
+			unzGetCurrentFileInfo64(handle, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+		{
+			return false;
+		}
+
+		name.resize(fileInfo.size_filename + 1);
+
+		if (unzGetCurrentFileInfo64(handle, nullptr, name.data(), static_cast<uLong>(name.size()), nullptr, 0, nullptr, 0) != UNZ_OK ||
+			unzGetFilePos64(handle, &position) != UNZ_OK)
+		{
+			return false;
+		}
+
+		// The first of several entries with the same name is found, as with unzLocateFile.
+		m_Entries.emplace(GetKey(name.data()), position);
+	}
+
+	return true;
+}
+
+std::string ZipDirectory::GetKey(const char* name)
+{
+	std::string key(name);
+
+	for (auto& c : key)
+	{
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	}
+
+	return key;
+}
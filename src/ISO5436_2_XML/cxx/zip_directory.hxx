@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Central directory of Info-Zip archives indexed by entry name.
+ */
+
+#ifndef _OPENGPS_ZIP_DIRECTORY_HXX
+#define _OPENGPS_ZIP_DIRECTORY_HXX
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* zlib/minizip */
+#include <unzip.h>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/cxx/byte_source.hxx>
+
+namespace OpenGPS
+{
+	/*!
+	 * Provides access to the entries of a zip archive read from a byte source.
+	 *
+	 * The central directory is read once and indexed by entry name, so locating an entry
+	 * does not need a linear search. Handles to the zip archive are kept open and reused
+	 * once released. Several entries may be read at the same time, each through its own handle.
+	 */
+	class ZipDirectory
+	{
+	public:
+		/*!
+		 * Creates a new instance. The zip archive is opened on first use.
+		 * @param source The byte source of the zip archive.
+		 */
+		ZipDirectory(std::shared_ptr<const ByteSource> source);
+
+		/*! Destroys this instance. Closes all handles that have been released. */
+		~ZipDirectory();
+
+		/*! Gets the byte source of the zip archive. */
+		const std::shared_ptr<const ByteSource>& GetSource() const;
+
+		/*!
+		 * Gets a handle to the zip archive positioned at an entry.
+		 * @remarks The handle must be released by ZipDirectory::Close instead of unzClose.
+		 * @param name The name of the archive entry. The search is case insensitive.
+		 * @returns The handle or nullptr if either the archive could not be opened or the entry does not exist.
+		 */
+		unzFile Open(const String& name);
+
+		/*!
+		 * Releases a handle obtained from ZipDirectory::Open for reuse.
+		 * The archive entry currently open gets closed.
+		 * @param handle The handle to be released.
+		 */
+		void Close(unzFile handle);
+
+	private:
+		/*!
+		 * Reads the central directory of the zip archive into the index.
+		 * @param handle Handle to the zip archive.
+		 * @returns Returns false if the central directory could not be read.
+		 */
+		bool ReadDirectory(unzFile handle);
+
+		/*! Gets the key of the index for the name of an archive entry. */
+		static std::string GetKey(const char* name);
+
+		/*! The byte source of the zip archive. */
+		std::shared_ptr<const ByteSource> m_Source;
+
+		/*! Serializes access to the index and the handles. */
+		std::mutex m_Mutex;
+
+		/*! Handles to the zip archive that have been released. */
+		std::vector<unzFile> m_Handles;
+
+		/*! Positions of the archive entries by lower case name. */
+		std::unordered_map<std::string, unz64_file_pos> m_Entries;
+
+		/*! true if the central directory has been read. */
+		bool m_HasEntries{};
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ZipDirectory(const ZipDirectory& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ZipDirectory& operator=(const ZipDirectory& src) = delete;
+	};
+}
+
+#endif
@@ -0,0 +1,462 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zip_entry_index.hxx"
+#include "byte_source_reader.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+
+/* zlib/minizip */
+#include <unzip.h>
+#include <zlib.h>
+
+#define _OPENGPS_ZIP_INDEX_CHUNK_MAX (256*1024)
+#define _OPENGPS_ZIP_INDEX_WINDOW_SIZE (32*1024)
+#define _OPENGPS_ZIP_INDEX_CACHE_MAX 8
+
+namespace OpenGPS
+{
+	/*!
+	 * Reads the uncompressed data of an archive entry starting
+	 * at an access point of an OpenGPS::ZipEntryIndex.
+	 */
+	class ZipIndexedInputStreamBuffer : public std::streambuf
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param index The index of the archive entry to be read.
+		 * @param source The byte source of the zip archive.
+		 */
+		ZipIndexedInputStreamBuffer(const ZipEntryIndex& index, std::shared_ptr<const ByteSource> source);
+
+		/*! Destroys this instance. */
+		~ZipIndexedInputStreamBuffer() override;
+
+		/*!
+		 * Prepares reading at the given offset.
+		 * @param offset Offset into the uncompressed data of the archive entry.
+		 * @returns Returns true on success, false if the archive could not be read.
+		 */
+		bool Open(unsigned long long offset);
+
+	protected:
+		/*! Overrides the super class. */
+		int_type underflow() override;
+
+	private:
+		/*! Reads the next chunk of compressed data from the archive. */
+		size_t ReadInput();
+
+		/*! The index of the archive entry. */
+		const ZipEntryIndex& m_Index;
+
+		/*! Reads the zip archive. */
+		ByteSourceReader m_Reader;
+
+		/*! The state of decompression. */
+		z_stream m_Stream{};
+
+		/*! true if the decompressor has been initialized. */
+		bool m_HasStream{};
+
+		/*! Buffer of compressed data. */
+		std::unique_ptr<char[]> m_Input;
+
+		/*! Buffer of uncompressed data. */
+		std::unique_ptr<char[]> m_Output;
+
+		/*! The size of the compressed data not read from the archive yet. */
+		unsigned long long m_Remaining{};
+
+		/*! The size of the uncompressed data to be discarded in front of the offset requested. */
+		unsigned long long m_Skip{};
+
+		/*! true if the end of the archive entry has been reached or reading failed. */
+		bool m_IsFinished{};
+	};
+}
+
+ZipIndexedInputStreamBuffer::ZipIndexedInputStreamBuffer(const ZipEntryIndex& index, std::shared_ptr<const ByteSource> source)
+	:m_Index(index),
+	m_Reader(std::move(source))
+{
+}
+
+ZipIndexedInputStreamBuffer::~ZipIndexedInputStreamBuffer()
+{
+	if (m_HasStream)
+	{
+		inflateEnd(&m_Stream);
+	}
+}
+
+bool ZipIndexedInputStreamBuffer::Open(unsigned long long offset)
+{
+	assert(!m_HasStream && offset <= m_Index.m_Length);
+
+	m_Input = std::make_unique<char[]>(_OPENGPS_ZIP_INDEX_CHUNK_MAX);
+	m_Output = std::make_unique<char[]>(_OPENGPS_ZIP_INDEX_CHUNK_MAX);
+
+	setg(m_Output.get(), m_Output.get(), m_Output.get());
+
+	// Stored data is read right from the offset requested.
+	if (m_Index.m_IsStored)
+	{
+		m_Remaining = m_Index.m_CompressedSize - offset;
+		m_Reader.Seek(m_Index.m_DataOffset + offset);
+		return true;
+	}
+
+	const auto& point{ m_Index.GetAccessPoint(offset) };
+
+	if (inflateInit2(&m_Stream, -MAX_WBITS) != Z_OK)
+	{
+		return false;
+	}
+
+	m_HasStream = true;
+	m_Skip = offset - point.output;
+	m_Remaining = m_Index.m_CompressedSize - point.input;
+
+	// An access point may start within a byte of compressed data.
+	m_Reader.Seek(m_Index.m_DataOffset + point.input - (point.bits ? 1 : 0));
+
+	if (point.bits)
+	{
+		unsigned char c{};
+		if (m_Reader.Read(&c, 1) != 1 || inflatePrime(&m_Stream, point.bits, c >> (8 - point.bits)) != Z_OK)
+		{
+			return false;
+		}
+	}
+
+	if (!point.window.empty() &&
+		inflateSetDictionary(&m_Stream, point.window.data(), static_cast<uInt>(point.window.size())) != Z_OK)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+size_t ZipIndexedInputStreamBuffer::ReadInput()
+{
+	const auto size{ static_cast<size_t>(std::min<unsigned long long>(m_Remaining, _OPENGPS_ZIP_INDEX_CHUNK_MAX)) };
+
+	if (m_Reader.Read(m_Input.get(), size) != size)
+	{
+		return 0;
+	}
+
+	m_Remaining -= size;
+
+	return size;
+}
+
+ZipIndexedInputStreamBuffer::int_type ZipIndexedInputStreamBuffer::underflow()
+{
+	if (gptr() < egptr())
+	{
+		return traits_type::to_int_type(*gptr());
+	}
+
+	while (!m_IsFinished && m_Input)
+	{
+		size_t size{};
+
+		if (m_Index.m_IsStored)
+		{
+			size = ReadInput();
+			std::copy(m_Input.get(), m_Input.get() + size, m_Output.get());
+			m_IsFinished = (size == 0);
+		}
+		else
+		{
+			if (m_Stream.avail_in == 0)
+			{
+				m_Stream.avail_in = static_cast<uInt>(ReadInput());
+				m_Stream.next_in = reinterpret_cast<Bytef*>(m_Input.get());
+			}
+
+			m_Stream.avail_out = _OPENGPS_ZIP_INDEX_CHUNK_MAX;
+			m_Stream.next_out = reinterpret_cast<Bytef*>(m_Output.get());
+
+			const auto ret{ inflate(&m_Stream, Z_NO_FLUSH) };
+
+			size = _OPENGPS_ZIP_INDEX_CHUNK_MAX - m_Stream.avail_out;
+			m_IsFinished = (ret != Z_OK || (size == 0 && m_Stream.avail_in == 0 && m_Remaining == 0));
+		}
+
+		// Discard data in front of the offset requested.
+		const auto skip{ static_cast<size_t>(std::min<unsigned long long>(m_Skip, size)) };
+		m_Skip -= skip;
+
+		if (size > skip)
+		{
+			setg(m_Output.get(), m_Output.get() + skip, m_Output.get() + size);
+			return traits_type::to_int_type(*gptr());
+		}
+	}
+
+	return traits_type::eof();
+}
+
+/*!
+ * Locates an archive entry and gets its position within the zip archive.
+ * @param directory The directory of the zip archive.
+ * @param name The name of the archive entry.
+ * @param dataOffset Gets the absolute offset of the compressed data.
+ * @param compressedSize Gets the size of the compressed data.
+ * @param length Gets the size of the uncompressed data.
+ * @param crc Gets the crc32 checksum as stored in the zip directory.
+ * @param isStored Gets whether the archive entry is stored without compression.
+ * @returns Returns false if the archive entry could not be found or is not supported.
+ */
+static bool LocateEntry(ZipDirectory& directory, const String& name, unsigned long long& dataOffset, unsigned long long& compressedSize, unsigned long long& length, unsigned long& crc, bool& isStored)
+{
+	auto handle{ directory.Open(name) };
+	if (!handle)
+	{
+		return false;
+	}
+
+	int method{};
+	int level{};
+	unz_file_info64 fileInfo;
+	const auto success{
+		unzOpenCurrentFile2(handle, &method, &level, 1) == UNZ_OK &&
+		unzGetCurrentFileInfo64(handle, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK };
+
+	if (success)
+	{
+		dataOffset = unzGetCurrentFileZStreamPos64(handle);
+		compressedSize = fileInfo.compressed_size;
+		length = fileInfo.uncompressed_size;
+		crc = fileInfo.crc;
+		isStored = (method == 0);
+	}
+
+	directory.Close(handle);
+
+	return success && (method == 0 || method == Z_DEFLATED);
+}
+
+std::shared_ptr<const ZipEntryIndex> ZipEntryIndex::Build(ZipDirectory& directory, const String& name, unsigned long long span)
+{
+	std::shared_ptr<ZipEntryIndex> index(new ZipEntryIndex());
+	index->m_SourceName = directory.GetSource()->GetName();
+	index->m_Name = name;
+	index->m_Span = std::max<unsigned long long>(span, 1);
+
+	if (!LocateEntry(directory, name, index->m_DataOffset, index->m_CompressedSize, index->m_Length, index->m_Crc, index->m_IsStored))
+	{
+		return nullptr;
+	}
+
+	// Decompression may always start right at the beginning.
+	index->m_AccessPoints.push_back(AccessPoint{ 0, 0, 0, {} });
+
+	if (index->m_IsStored)
+	{
+		return index;
+	}
+
+	ByteSourceReader reader(directory.GetSource());
+	reader.Seek(index->m_DataOffset);
+
+	z_stream stream{};
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+	{
+		return nullptr;
+	}
+
+	auto input{ std::make_unique<unsigned char[]>(_OPENGPS_ZIP_INDEX_CHUNK_MAX) };
+	auto window{ std::make_unique<unsigned char[]>(_OPENGPS_ZIP_INDEX_WINDOW_SIZE) };
+
+	auto remaining{ index->m_CompressedSize };
+	unsigned long long totalIn{};
+	unsigned long long totalOut{};
+	unsigned long long last{};
+	auto ret{ Z_OK };
+
+	// The window buffer is used circularly, so it always holds the most recent uncompressed data.
+	while (ret == Z_OK)
+	{
+		// The end of the last block may be detected without further input.
+		if (stream.avail_in == 0 && remaining > 0)
+		{
+			const auto size{ static_cast<size_t>(std::min<unsigned long long>(remaining, _OPENGPS_ZIP_INDEX_CHUNK_MAX)) };
+			if (reader.Read(input.get(), size) != size)
+			{
+				break;
+			}
+
+			remaining -= size;
+			stream.avail_in = static_cast<uInt>(size);
+			stream.next_in = input.get();
+		}
+
+		if (stream.avail_out == 0)
+		{
+			stream.avail_out = _OPENGPS_ZIP_INDEX_WINDOW_SIZE;
+			stream.next_out = window.get();
+		}
+
+		totalIn += stream.avail_in;
+		totalOut += stream.avail_out;
+		ret = inflate(&stream, Z_BLOCK);
+		totalIn -= stream.avail_in;
+		totalOut -= stream.avail_out;
+
+		// Save an access point at the end of a block unless it is the last one.
+		if (ret == Z_OK && (stream.data_type & 128) && !(stream.data_type & 64) && totalOut - last >= index->m_Span)
+		{
+			const size_t left{ stream.avail_out };
+			const auto size{ static_cast<size_t>(std::min<unsigned long long>(totalOut, _OPENGPS_ZIP_INDEX_WINDOW_SIZE)) };
+
+			std::vector<unsigned char> recent;
+			recent.reserve(_OPENGPS_ZIP_INDEX_WINDOW_SIZE);
+			recent.insert(recent.end(), window.get() + _OPENGPS_ZIP_INDEX_WINDOW_SIZE - left, window.get() + _OPENGPS_ZIP_INDEX_WINDOW_SIZE);
+			recent.insert(recent.end(), window.get(), window.get() + _OPENGPS_ZIP_INDEX_WINDOW_SIZE - left);
+			recent.erase(recent.begin(), recent.end() - size);
+
+			index->m_AccessPoints.push_back(AccessPoint{ totalIn, totalOut, stream.data_type & 7, std::move(recent) });
+			last = totalOut;
+		}
+	}
+
+	inflateEnd(&stream);
+
+	if (ret != Z_STREAM_END || totalOut != index->m_Length)
+	{
+		return nullptr;
+	}
+
+	return index;
+}
+
+std::shared_ptr<const ZipEntryIndex> ZipEntryIndex::Get(ZipDirectory& directory, const String& name, unsigned long long span)
+{
+	static std::mutex mutex;
+	static std::list<std::shared_ptr<const ZipEntryIndex>> cache;
+
+	unsigned long long dataOffset{};
+	unsigned long long compressedSize{};
+	unsigned long long length{};
+	unsigned long crc{};
+	bool isStored{};
+
+	if (!LocateEntry(directory, name, dataOffset, compressedSize, length, crc, isStored))
+	{
+		return nullptr;
+	}
+
+	const auto sourceName{ directory.GetSource()->GetName() };
+	if (sourceName.empty())
+	{
+		return Build(directory, name, span);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (auto entry = cache.begin(); entry != cache.end(); ++entry)
+		{
+			const auto& index{ **entry };
+			if (index.m_SourceName == sourceName && index.m_Name == name && index.m_Span == span)
+			{
+				const auto found{ *entry };
+				cache.erase(entry);
+
+				// The archive has been rewritten since.
+				if (found->m_DataOffset != dataOffset || found->m_CompressedSize != compressedSize ||
+					found->m_Length != length || found->m_Crc != crc)
+				{
+					break;
+				}
+
+				cache.push_front(found);
+				return found;
+			}
+		}
+	}
+
+	// Decompression is not serialized.
+	auto index{ Build(directory, name, span) };
+
+	if (index)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		cache.push_front(index);
+		if (cache.size() > _OPENGPS_ZIP_INDEX_CACHE_MAX)
+		{
+			cache.pop_back();
+		}
+	}
+
+	return index;
+}
+
+std::unique_ptr<std::streambuf> ZipEntryIndex::CreateStreamBuffer(std::shared_ptr<const ByteSource> source, unsigned long long offset) const
+{
+	auto buffer{ std::make_unique<ZipIndexedInputStreamBuffer>(*this, std::move(source)) };
+
+	if (!buffer->Open(std::min(offset, m_Length)))
+	{
+		return nullptr;
+	}
+
+	return buffer;
+}
+
+unsigned long long ZipEntryIndex::GetLength() const
+{
+	return m_Length;
+}
+
+size_t ZipEntryIndex::GetAccessPointCount() const
+{
+	return m_AccessPoints.size();
+}
+
+const ZipEntryIndex::AccessPoint& ZipEntryIndex::GetAccessPoint(unsigned long long offset) const
+{
+	assert(!m_AccessPoints.empty());
+
+	const auto next{ std::upper_bound(m_AccessPoints.begin(), m_AccessPoints.end(), offset,
+		[](unsigned long long value, const AccessPoint& point) { return value < point.output; }) };
+
+	return *(next - 1);
+}
@@ -0,0 +1,157 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Random access to the uncompressed data of single entries of Info-Zip archives.
+ */
+
+#ifndef _OPENGPS_ZIP_ENTRY_INDEX_HXX
+#define _OPENGPS_ZIP_ENTRY_INDEX_HXX
+
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+#include <opengps/cxx/byte_source.hxx>
+
+#include "zip_directory.hxx"
+
+namespace OpenGPS
+{
+	/*!
+	 * Index of access points into the deflated data of a single entry of a zip archive.
+	 *
+	 * Deflated data can only be decompressed from its very beginning. The index is built
+	 * by decompressing an archive entry once. Every time another span of uncompressed data
+	 * has passed, the state of the decompressor is saved at the following block boundary,
+	 * which mainly consists of the last 32KB of uncompressed data. Later on decompression may
+	 * start at the access point nearest to any offset of the uncompressed data.
+	 *
+	 * Entries that are stored without compression do not need any access points.
+	 *
+	 * @remarks Decompression from an access point is done by zlib regardless of the
+	 * OpenGPS::ZipCodec currently selected. Data read through the index is not verified
+	 * against the crc32 checksum of the archive entry.
+	 */
+	class ZipEntryIndex
+	{
+	public:
+		/*!
+		 * Builds the index of an archive entry.
+		 * @param directory The directory of the zip archive.
+		 * @param name The name of the archive entry. The search is case insensitive.
+		 * @param span The least amount of uncompressed data in bytes between two access points.
+		 * @returns Returns the index or nullptr if the archive entry could not be read or its
+		 * compression method is not supported.
+		 */
+		static std::shared_ptr<const ZipEntryIndex> Build(ZipDirectory& directory, const String& name, unsigned long long span);
+
+		/*!
+		 * Gets the index of an archive entry from the indices built most recently.
+		 * Builds the index if it has not been built before or if the archive entry has changed.
+		 * Indices of byte sources without a name are not kept.
+		 * @param directory The directory of the zip archive.
+		 * @param name The name of the archive entry. The search is case insensitive.
+		 * @param span The least amount of uncompressed data in bytes between two access points.
+		 * @returns Returns the index or nullptr if the archive entry could not be read or its
+		 * compression method is not supported.
+		 */
+		static std::shared_ptr<const ZipEntryIndex> Get(ZipDirectory& directory, const String& name, unsigned long long span);
+
+		/*!
+		 * Creates a buffer reading uncompressed data starting at the given offset.
+		 * Decompression starts at the nearest access point in front of it.
+		 * The index must outlive the buffer.
+		 * @param source The byte source of the zip archive the index has been built from.
+		 * @param offset Offset into the uncompressed data of the archive entry.
+		 * @returns Returns the buffer or nullptr if the archive could not be opened.
+		 */
+		std::unique_ptr<std::streambuf> CreateStreamBuffer(std::shared_ptr<const ByteSource> source, unsigned long long offset) const;
+
+		/*! Gets the size of the uncompressed data of the archive entry. */
+		unsigned long long GetLength() const;
+
+		/*! Gets the number of access points. */
+		size_t GetAccessPointCount() const;
+
+	private:
+		/*! Creates a new instance. */
+		ZipEntryIndex() = default;
+
+		/*! State of decompression at a block boundary. */
+		struct AccessPoint
+		{
+			/*! Offset of the first byte of the block within the compressed data. */
+			unsigned long long input;
+			/*! Offset within the uncompressed data. */
+			unsigned long long output;
+			/*! Number of bits of the byte preceding input which belong to the block. */
+			int bits;
+			/*! The uncompressed data preceding output, 32KB at most. */
+			std::vector<unsigned char> window;
+		};
+
+		friend class ZipIndexedInputStreamBuffer;
+
+		/*! Gets the last access point in front of the given offset into the uncompressed data. */
+		const AccessPoint& GetAccessPoint(unsigned long long offset) const;
+
+		/*! The name of the byte source of the zip archive. */
+		String m_SourceName;
+
+		/*! Name of the archive entry. */
+		String m_Name;
+
+		/*! The least amount of uncompressed data in bytes between two access points. */
+		unsigned long long m_Span{};
+
+		/*! Absolute offset of the compressed data within the zip archive. */
+		unsigned long long m_DataOffset{};
+
+		/*! The size of the compressed data. */
+		unsigned long long m_CompressedSize{};
+
+		/*! The size of the uncompressed data. */
+		unsigned long long m_Length{};
+
+		/*! The crc32 checksum as stored in the zip directory. */
+		unsigned long m_Crc{};
+
+		/*! true if the archive entry is stored without compression. */
+		bool m_IsStored{};
+
+		/*! Access points ordered by their offset. */
+		std::vector<AccessPoint> m_AccessPoints;
+	};
+}
+
+#endif
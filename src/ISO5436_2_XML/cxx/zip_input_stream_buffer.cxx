@@ -0,0 +1,366 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zip_input_stream_buffer.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <limits>
+
+#define _OPENGPS_ZIP_INPUT_CHUNK_MAX (256*1024)
+
+ZipInputStreamBuffer::ZipInputStreamBuffer(std::shared_ptr<ZipDirectory> directory, size_t pipelineDepth)
+	:m_Directory{ std::move(directory) },
+	m_PipelineDepth{ pipelineDepth }
+{
+	md5_starts(&m_Md5Context);
+}
+
+ZipInputStreamBuffer::~ZipInputStreamBuffer()
+{
+	Close();
+}
+
+void ZipInputStreamBuffer::Close()
+{
+	StopPipeline();
+
+	if (m_Handle)
+	{
+		m_Directory->Close(m_Handle);
+		m_Handle = nullptr;
+	}
+
+	m_Inflater.reset();
+}
+
+bool ZipInputStreamBuffer::Open(const String& name)
+{
+	assert(!m_Handle);
+
+	m_Handle = m_Directory->Open(name);
+	if (!m_Handle)
+	{
+		return false;
+	}
+
+	// Open the entry for reading raw data. Decompression is done by the codec.
+	int method{};
+	int level{};
+	unz_file_info64 fileInfo;
+	if (unzOpenCurrentFile2(m_Handle, &method, &level, 1) != UNZ_OK ||
+		unzGetCurrentFileInfo64(m_Handle, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	{
+		Close();
+		return false;
+	}
+
+	m_Inflater = ZipCodec::CreateEntryInflater(method, fileInfo.compressed_size, fileInfo.uncompressed_size);
+	if (!m_Inflater)
+	{
+		Close();
+		return false;
+	}
+
+	m_Input = std::make_unique<char[]>(_OPENGPS_ZIP_INPUT_CHUNK_MAX);
+	m_Length = fileInfo.uncompressed_size;
+	m_ExpectedCrc = fileInfo.crc;
+	m_Crc = crc32(0L, Z_NULL, 0);
+	m_Size = 0;
+	m_IsGood = true;
+
+	if (m_PipelineDepth > 0)
+	{
+		setg(nullptr, nullptr, nullptr);
+		StartPipeline();
+	}
+	else
+	{
+		m_Output = std::make_unique<char[]>(_OPENGPS_ZIP_INPUT_CHUNK_MAX);
+		setg(m_Output.get(), m_Output.get(), m_Output.get());
+	}
+
+	return true;
+}
+
+ZipInputStreamBuffer::int_type ZipInputStreamBuffer::underflow()
+{
+	if (gptr() < egptr())
+	{
+		return traits_type::to_int_type(*gptr());
+	}
+
+	if (m_PipelineDepth > 0)
+	{
+		return PipelineUnderflow();
+	}
+
+	const auto size{ Inflate(m_Output.get(), _OPENGPS_ZIP_INPUT_CHUNK_MAX) };
+	if (size > 0)
+	{
+		UpdateChecksums(m_Output.get(), size);
+
+		setg(m_Output.get(), m_Output.get(), m_Output.get() + size);
+		return traits_type::to_int_type(*gptr());
+	}
+
+	return traits_type::eof();
+}
+
+size_t ZipInputStreamBuffer::Inflate(char* output, size_t capacity)
+{
+	if (!m_Inflater || !m_IsGood)
+	{
+		return 0;
+	}
+
+	while (!m_Inflater->IsFinished())
+	{
+		if (m_Inflater->NeedsInput())
+		{
+			const auto bytesRead{ unzReadCurrentFile(m_Handle, m_Input.get(), _OPENGPS_ZIP_INPUT_CHUNK_MAX) };
+			if (bytesRead <= 0)
+			{
+				m_IsGood = false;
+				return 0;
+			}
+
+			m_Inflater->SetInput(m_Input.get(), static_cast<size_t>(bytesRead));
+		}
+
+		const auto size{ m_Inflater->Read(output, capacity) };
+		if (!m_Inflater->IsGood() || (size == 0 && !m_Inflater->NeedsInput() && !m_Inflater->IsFinished()))
+		{
+			m_IsGood = false;
+			return 0;
+		}
+
+		if (size > 0)
+		{
+			m_Size += size;
+
+			if (m_Size > m_Length)
+			{
+				m_IsGood = false;
+				return 0;
+			}
+
+			return size;
+		}
+	}
+
+	return 0;
+}
+
+void ZipInputStreamBuffer::UpdateChecksums(const char* data, size_t size)
+{
+	m_Crc = crc32(m_Crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+	md5_update(&m_Md5Context, reinterpret_cast<const unsigned char*>(data), static_cast<int>(size));
+}
+
+void ZipInputStreamBuffer::StartPipeline()
+{
+	m_Free = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+	m_Inflated = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+	m_Hashed = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+
+	for (size_t index = 0; index < m_PipelineDepth; ++index)
+	{
+		Chunk chunk;
+		chunk.data = std::make_unique<char[]>(_OPENGPS_ZIP_INPUT_CHUNK_MAX);
+		m_Free->TryPush(chunk);
+	}
+
+	m_Current = Chunk{};
+	m_IsPipelineFinished = false;
+	m_IsCancelled = false;
+
+	m_InflateThread = std::thread{ &ZipInputStreamBuffer::RunInflate, this };
+	m_HashThread = std::thread{ &ZipInputStreamBuffer::RunHash, this };
+}
+
+void ZipInputStreamBuffer::StopPipeline()
+{
+	if (!m_InflateThread.joinable() && !m_HashThread.joinable())
+	{
+		return;
+	}
+
+	// Either both stages have already passed the last buffer or they are interrupted.
+	m_IsCancelled = true;
+
+	if (m_InflateThread.joinable())
+	{
+		m_InflateThread.join();
+	}
+
+	if (m_HashThread.joinable())
+	{
+		m_HashThread.join();
+	}
+
+	setg(nullptr, nullptr, nullptr);
+
+	m_Current = Chunk{};
+	m_Free.reset();
+	m_Inflated.reset();
+	m_Hashed.reset();
+}
+
+void ZipInputStreamBuffer::RunInflate()
+{
+	try
+	{
+		for (;;)
+		{
+			Chunk chunk;
+			if (!m_Free->Pop(chunk, m_IsCancelled))
+			{
+				return;
+			}
+
+			// Fill the whole buffer to keep the number of hand-overs low.
+			chunk.size = 0;
+			chunk.isLast = false;
+			while (chunk.size < _OPENGPS_ZIP_INPUT_CHUNK_MAX)
+			{
+				const auto size{ Inflate(chunk.data.get() + chunk.size, _OPENGPS_ZIP_INPUT_CHUNK_MAX - chunk.size) };
+				if (size == 0)
+				{
+					chunk.isLast = true;
+					break;
+				}
+
+				chunk.size += size;
+			}
+
+			const auto isLast{ chunk.isLast };
+			if (!m_Inflated->Push(chunk, m_IsCancelled) || isLast)
+			{
+				return;
+			}
+		}
+	}
+	catch (...)
+	{
+		m_IsGood = false;
+		m_IsCancelled = true;
+	}
+}
+
+void ZipInputStreamBuffer::RunHash()
+{
+	for (;;)
+	{
+		Chunk chunk;
+		if (!m_Inflated->Pop(chunk, m_IsCancelled))
+		{
+			return;
+		}
+
+		UpdateChecksums(chunk.data.get(), chunk.size);
+
+		const auto isLast{ chunk.isLast };
+		if (!m_Hashed->Push(chunk, m_IsCancelled) || isLast)
+		{
+			return;
+		}
+	}
+}
+
+ZipInputStreamBuffer::int_type ZipInputStreamBuffer::PipelineUnderflow()
+{
+	if (!m_Hashed)
+	{
+		return traits_type::eof();
+	}
+
+	// Hand the buffer read so far back to the first stage.
+	if (m_Current.data)
+	{
+		setg(nullptr, nullptr, nullptr);
+		m_Free->TryPush(m_Current);
+		m_Current = Chunk{};
+	}
+
+	while (!m_IsPipelineFinished)
+	{
+		if (!m_Hashed->Pop(m_Current, m_IsCancelled))
+		{
+			return traits_type::eof();
+		}
+
+		m_IsPipelineFinished = m_Current.isLast;
+
+		if (m_Current.size > 0)
+		{
+			setg(m_Current.data.get(), m_Current.data.get(), m_Current.data.get() + m_Current.size);
+			return traits_type::to_int_type(*gptr());
+		}
+
+		m_Free->TryPush(m_Current);
+		m_Current = Chunk{};
+	}
+
+	return traits_type::eof();
+}
+
+bool ZipInputStreamBuffer::Finish()
+{
+	if (!m_Inflater)
+	{
+		return false;
+	}
+
+	// Skip what has not been read yet, so that checksums cover the whole entry.
+	while (!traits_type::eq_int_type(underflow(), traits_type::eof()))
+	{
+		setg(eback(), egptr(), egptr());
+	}
+
+	// The stages of a pipeline must have finished before their results are inspected.
+	StopPipeline();
+
+	const auto success{ m_IsGood && m_Inflater->IsFinished() && m_Size == m_Length && m_Crc == m_ExpectedCrc };
+
+	if (success)
+	{
+		md5_finish(&m_Md5Context, m_Md5.data());
+	}
+
+	Close();
+
+	return success;
+}
+
+void ZipInputStreamBuffer::GetMd5(std::array<unsigned char, 16>& md5) const
+{
+	md5 = m_Md5;
+}
@@ -0,0 +1,229 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Reads single entries of Info-Zip archives through the common standard io framework.
+ */
+
+#ifndef _OPENGPS_ZIP_INPUT_STREAM_BUFFER_HXX
+#define _OPENGPS_ZIP_INPUT_STREAM_BUFFER_HXX
+
+#include <istream>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/* zlib/minizip */
+#include <unzip.h>
+
+#include "../xyssl/md5.h"
+
+#include "zip_codec.hxx"
+#include "zip_directory.hxx"
+#include "spsc_queue.hxx"
+
+#include <opengps/cxx/opengps.hxx>
+#include <opengps/cxx/string.hxx>
+
+namespace OpenGPS
+{
+	/*!
+	 * Provides a buffer interface suitable for streaming a single entry
+	 * of a zip archive without extracting it to a file first.
+	 *
+	 * Data is decompressed chunk by chunk by the OpenGPS::ZipCodec currently
+	 * selected while it is read, so memory usage does not depend on the size
+	 * of the archive entry. The crc32 and md5 checksums of the uncompressed
+	 * data are computed on the fly.
+	 *
+	 * Optionally the work is pipelined: one thread inflates the archive entry into a ring
+	 * of buffers, a second thread computes the checksums and the thread reading from this
+	 * buffer decodes the data. The stages are connected by lock-free queues, so reading
+	 * a single large archive entry makes use of several cores.
+	 *
+	 * @see ZipStreamBuffer
+	 */
+	class ZipInputStreamBuffer : public std::streambuf
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param directory The directory of the zip archive to be read.
+		 * @param pipelineDepth The number of buffers in the ring of a pipeline. If this is
+		 * 0 everything is done by the thread reading from this buffer.
+		 */
+		ZipInputStreamBuffer(std::shared_ptr<ZipDirectory> directory, size_t pipelineDepth = 0);
+
+		/*! Destroys this instance. Releases the handle to the zip archive. */
+		~ZipInputStreamBuffer() override;
+
+		/*!
+		 * Locates an entry of the zip archive and prepares it for reading.
+		 * @param name The name of the archive entry. The search is case insensitive.
+		 * @returns Returns true on success, false if either the archive could not be
+		 * opened, the entry does not exist or its compression method is not supported.
+		 */
+		bool Open(const String& name);
+
+		/*!
+		 * Reads and discards any data left in the archive entry and verifies it.
+		 * @returns Returns true if the archive entry has been decompressed completely and
+		 * its size and crc32 checksum match the zip directory, false otherwise.
+		 */
+		bool Finish();
+
+		/*!
+		 * Gets the md5 checksum of the uncompressed data.
+		 * @remarks Valid only after ZipInputStreamBuffer::Finish returned true.
+		 * @param md5 Gets the 128-bit md5 data.
+		 */
+		void GetMd5(std::array<unsigned char, 16>& md5) const;
+
+	protected:
+		/*! Overrides the super class. */
+		int_type underflow() override;
+
+	private:
+		/*! A buffer of uncompressed data passed through the pipeline. */
+		struct Chunk
+		{
+			/*! The buffer. */
+			std::unique_ptr<char[]> data;
+			/*! The number of bytes used. */
+			size_t size{};
+			/*! true if no more data follows. */
+			bool isLast{};
+		};
+
+		/*! Releases the handle to the zip archive. */
+		void Close();
+
+		/*!
+		 * Decompresses the next piece of the archive entry.
+		 * @param output Gets the uncompressed data.
+		 * @param capacity The size of the output buffer.
+		 * @returns The number of bytes decompressed or 0 at the end of the archive entry or on failure.
+		 */
+		size_t Inflate(char* output, size_t capacity);
+
+		/*!
+		 * Updates the checksums of the uncompressed data.
+		 * @param data The uncompressed data.
+		 * @param size The number of bytes.
+		 */
+		void UpdateChecksums(const char* data, size_t size);
+
+		/*! Starts the threads of the pipeline. */
+		void StartPipeline();
+
+		/*! Stops the threads of the pipeline and waits for them to finish. */
+		void StopPipeline();
+
+		/*! Inflates the archive entry into free buffers. Executed by the first stage of the pipeline. */
+		void RunInflate();
+
+		/*! Computes the checksums of inflated buffers. Executed by the second stage of the pipeline. */
+		void RunHash();
+
+		/*! Implements underflow by taking the next buffer from the pipeline. */
+		int_type PipelineUnderflow();
+
+		/*! The directory of the zip archive. */
+		std::shared_ptr<ZipDirectory> m_Directory;
+
+		/*! Handle to the zip archive. */
+		unzFile m_Handle{};
+
+		/*! Decompresses the data of the currently open archive entry. */
+		std::unique_ptr<ZipInflater> m_Inflater;
+
+		/*! Buffer of compressed data. */
+		std::unique_ptr<char[]> m_Input;
+
+		/*! Buffer of uncompressed data. */
+		std::unique_ptr<char[]> m_Output;
+
+		/*! The size of the uncompressed data as stored in the zip directory. */
+		unsigned long long m_Length{};
+
+		/*! The crc32 checksum as stored in the zip directory. */
+		unsigned long m_ExpectedCrc{};
+
+		/*! The crc32 checksum of the uncompressed data read so far. */
+		unsigned long m_Crc{};
+
+		/*! The size of the uncompressed data read so far. */
+		unsigned long long m_Size{};
+
+		/*! false if reading from the current archive entry failed. */
+		bool m_IsGood{ true };
+
+		/*! The current state of md5 checksum processing. */
+		md5_context m_Md5Context;
+
+		/*! The md5 checksum when all data has been read. */
+		std::array<unsigned char, 16> m_Md5{};
+
+		/*! The number of buffers in the ring of the pipeline or 0 if there is no pipeline. */
+		size_t m_PipelineDepth{};
+
+		/*! Buffers to be filled by the first stage of the pipeline. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Free;
+
+		/*! Buffers inflated, but not yet hashed. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Inflated;
+
+		/*! Buffers ready to be read. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Hashed;
+
+		/*! The buffer currently being read. */
+		Chunk m_Current;
+
+		/*! true if the last buffer has been taken from the pipeline. */
+		bool m_IsPipelineFinished{};
+
+		/*! Stops all stages of the pipeline, either on failure or when this buffer is closed. */
+		std::atomic<bool> m_IsCancelled{};
+
+		/*! The first stage of the pipeline. */
+		std::thread m_InflateThread;
+
+		/*! The second stage of the pipeline. */
+		std::thread m_HashThread;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ZipInputStreamBuffer(const ZipInputStreamBuffer& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ZipInputStreamBuffer& operator=(const ZipInputStreamBuffer& src) = delete;
+	};
+}
+
+#endif
@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zip_memory_archive.hxx"
+#include "stdafx.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+namespace OpenGPS
+{
+	struct ZipMemoryArchive::File
+	{
+		/*! The archive opened. */
+		ZipMemoryArchive* archive;
+
+		/*! The current position within the archive. */
+		ZPOS64_T position;
+	};
+}
+
+ZipMemoryArchive::ZipMemoryArchive()
+{
+}
+
+ZipMemoryArchive::ZipMemoryArchive(std::vector<unsigned char> data)
+	:m_Data{ std::move(data) }
+{
+}
+
+ZipMemoryArchive::~ZipMemoryArchive()
+{
+}
+
+void ZipMemoryArchive::Fill(zlib_filefunc64_def& functions)
+{
+	functions.zopen64_file = OpenFile;
+	functions.zread_file = ReadFile;
+	functions.zwrite_file = WriteFile;
+	functions.ztell64_file = TellFile;
+	functions.zseek64_file = SeekFile;
+	functions.zclose_file = CloseFile;
+	functions.zerror_file = TestError;
+	functions.opaque = this;
+}
+
+std::vector<unsigned char>& ZipMemoryArchive::GetData()
+{
+	return m_Data;
+}
+
+voidpf ZCALLBACK ZipMemoryArchive::OpenFile(voidpf opaque, const void* /* filename */, int mode)
+{
+	auto archive{ static_cast<ZipMemoryArchive*>(opaque) };
+
+	if (mode & ZLIB_FILEFUNC_MODE_CREATE)
+	{
+		archive->m_Data.clear();
+	}
+
+	return new File{ archive, 0 };
+}
+
+uLong ZCALLBACK ZipMemoryArchive::ReadFile(voidpf /* opaque */, voidpf stream, void* buf, uLong size)
+{
+	auto file{ static_cast<File*>(stream) };
+	const auto& data{ file->archive->m_Data };
+
+	if (file->position >= data.size())
+	{
+		return 0;
+	}
+
+	const auto count{ static_cast<uLong>(std::min<ZPOS64_T>(size, data.size() - file->position)) };
+	memcpy(buf, data.data() + file->position, count);
+	file->position += count;
+
+	return count;
+}
+
+uLong ZCALLBACK ZipMemoryArchive::WriteFile(voidpf /* opaque */, voidpf stream, const void* buf, uLong size)
+{
+	auto file{ static_cast<File*>(stream) };
+	auto& data{ file->archive->m_Data };
+
+	// minizip seeks back to complete the local header of an entry, which overwrites data.
+	const auto end{ static_cast<size_t>(file->position + size) };
+	if (end > data.size())
+	{
+		data.resize(end);
+	}
+
+	memcpy(data.data() + file->position, buf, size);
+	file->position = end;
+
+	return size;
+}
+
+ZPOS64_T ZCALLBACK ZipMemoryArchive::TellFile(voidpf /* opaque */, voidpf stream)
+{
+	return static_cast<File*>(stream)->position;
+}
+
+long ZCALLBACK ZipMemoryArchive::SeekFile(voidpf /* opaque */, voidpf stream, ZPOS64_T offset, int origin)
+{
+	auto file{ static_cast<File*>(stream) };
+
+	switch (origin)
+	{
+	case ZLIB_FILEFUNC_SEEK_SET:
+		file->position = offset;
+		return 0;
+	case ZLIB_FILEFUNC_SEEK_CUR:
+		file->position += offset;
+		return 0;
+	case ZLIB_FILEFUNC_SEEK_END:
+		file->position = file->archive->m_Data.size() + offset;
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+int ZCALLBACK ZipMemoryArchive::CloseFile(voidpf /* opaque */, voidpf stream)
+{
+	delete static_cast<File*>(stream);
+	return 0;
+}
+
+int ZCALLBACK ZipMemoryArchive::TestError(voidpf /* opaque */, voidpf /* stream */)
+{
+	return 0;
+}
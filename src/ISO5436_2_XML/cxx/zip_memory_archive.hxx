@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Zip archives held in memory for use with Info-Zip.
+ */
+
+#ifndef _OPENGPS_ZIP_MEMORY_ARCHIVE_HXX
+#define _OPENGPS_ZIP_MEMORY_ARCHIVE_HXX
+
+#include <vector>
+
+/* zlib/minizip */
+#include <ioapi.h>
+
+#include <opengps/cxx/opengps.hxx>
+
+namespace OpenGPS
+{
+	/*!
+	 * A zip archive held in a buffer in memory.
+	 *
+	 * Provides the I/O functions minizip uses to read and write a zip archive,
+	 * so that archives can be read from and written to memory without any access
+	 * to the filesystem. Any number of handles may read the archive at the same
+	 * time, each of which maintains its own position.
+	 */
+	class ZipMemoryArchive
+	{
+	public:
+		/*! Creates a new instance of an empty archive. */
+		ZipMemoryArchive();
+
+		/*!
+		 * Creates a new instance.
+		 * @param data The content of the zip archive.
+		 */
+		ZipMemoryArchive(std::vector<unsigned char> data);
+
+		/*! Destroys this instance. */
+		~ZipMemoryArchive();
+
+		/*!
+		 * Sets the I/O functions to be passed to unzOpen2_64 or zipOpen2_64.
+		 * @remarks The current instance must outlive any handle opened with these functions.
+		 * The file name passed to minizip is ignored. Opening the archive for creation
+		 * discards its current content.
+		 * @param functions Gets the I/O functions operating on the current instance.
+		 */
+		void Fill(zlib_filefunc64_def& functions);
+
+		/*! Gets the content of the zip archive. */
+		std::vector<unsigned char>& GetData();
+
+	private:
+		/*! The position of a handle opened on the archive. */
+		struct File;
+
+		/*! Opens the archive. Implements open64_file_func. */
+		static voidpf ZCALLBACK OpenFile(voidpf opaque, const void* filename, int mode);
+
+		/*! Reads from the current position. Implements read_file_func. */
+		static uLong ZCALLBACK ReadFile(voidpf opaque, voidpf stream, void* buf, uLong size);
+
+		/*! Writes at the current position. Implements write_file_func. */
+		static uLong ZCALLBACK WriteFile(voidpf opaque, voidpf stream, const void* buf, uLong size);
+
+		/*! Gets the current position. Implements tell64_file_func. */
+		static ZPOS64_T ZCALLBACK TellFile(voidpf opaque, voidpf stream);
+
+		/*! Moves the current position. Implements seek64_file_func. */
+		static long ZCALLBACK SeekFile(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin);
+
+		/*! Closes a handle. Implements close_file_func. */
+		static int ZCALLBACK CloseFile(voidpf opaque, voidpf stream);
+
+		/*! Reports errors of a handle, which never occur. Implements testerror_file_func. */
+		static int ZCALLBACK TestError(voidpf opaque, voidpf stream);
+
+		/*! The content of the zip archive. */
+		std::vector<unsigned char> m_Data;
+
+		/*! The copy-ctor is not implemented. This prevents its usage. */
+		ZipMemoryArchive(const ZipMemoryArchive& src) = delete;
+		/*! The assignment-operator is not implemented. This prevents its usage. */
+		ZipMemoryArchive& operator=(const ZipMemoryArchive& src) = delete;
+	};
+}
+
+#endif
@@ -34,8 +34,15 @@
 
 #include <opengps/cxx/string.hxx>
 
-ZipStreamBuffer::ZipStreamBuffer(zipFile handle, bool enable_md5)
-	:m_Handle{ handle }
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#define _OPENGPS_ZIP_OUTPUT_CHUNK_MAX (256*1024)
+
+ZipStreamBuffer::ZipStreamBuffer(zipFile handle, bool enable_md5, size_t pipelineDepth)
+	:m_Handle{ handle },
+	m_PipelineDepth{ pipelineDepth }
 {
 	if (enable_md5)
 	{
@@ -44,23 +51,379 @@ ZipStreamBuffer::ZipStreamBuffer(zipFile handle, bool enable_md5)
 	}
 }
 
+ZipStreamBuffer::~ZipStreamBuffer()
+{
+	if (m_IsOpen)
+	{
+		Close();
+	}
+}
+
+bool ZipStreamBuffer::RequiresZip64(unsigned long long length)
+{
+	return length + length / 1024 + 1024 >= 0xffffffffULL;
+}
+
+bool ZipStreamBuffer::Open(const String& name, int compressionLevel, unsigned long long length)
+{
+	assert(m_Handle && !m_IsOpen);
+
+	String entryName(name);
+
+	// Write raw data, compression is done by the codec.
+	if (zipOpenNewFileInZip2_64(m_Handle,
+		entryName.ToChar(),
+		nullptr,
+		nullptr,
+		0,
+		nullptr,
+		0,
+		nullptr,
+		Z_DEFLATED,
+		compressionLevel,
+		1,
+		RequiresZip64(length) ? 1 : 0) != ZIP_OK)
+	{
+		return false;
+	}
+
+	// The deflate stage of a pipeline compresses data as it flows, so the size is not passed on
+	// and the codec streams the data instead of collecting it for a single compression at the end.
+	auto handle{ m_Handle };
+	m_Deflater = ZipCodec::GetInstance().CreateDeflater(compressionLevel, m_PipelineDepth > 0 ? 0 : length, [handle](const char* data, size_t size)
+	{
+		return zipWriteInFileInZip(handle, data, static_cast<unsigned int>(size)) == ZIP_OK;
+	});
+
+	m_Crc = crc32(0L, Z_NULL, 0);
+	m_Size = 0;
+	m_IsOpen = true;
+	m_IsGood = true;
+
+	if (m_PipelineDepth > 0)
+	{
+		StartPipeline();
+	}
+
+	return true;
+}
+
+bool ZipStreamBuffer::Close()
+{
+	assert(m_IsOpen);
+
+	m_IsOpen = false;
+
+	// All data must have passed the pipeline before the deflate stream is terminated.
+	const auto drained{ m_PipelineDepth == 0 || Drain() };
+	StopPipeline();
+
+	const auto finished{ drained && m_IsGood && m_Deflater->Finish() };
+	m_Deflater.reset();
+
+	const auto closed{ zipCloseFileInZipRaw64(m_Handle, m_Size, m_Crc) == ZIP_OK };
+
+	return finished && closed;
+}
+
 std::streamsize ZipStreamBuffer::xsputn(const char_type* s, std::streamsize count)
 {
+	if (m_IsOpen && m_PipelineDepth > 0)
+	{
+		// Only copy to the current buffer, the pipeline does the rest.
+		auto data{ s };
+		auto remaining{ static_cast<size_t>(count) };
+		while (remaining > 0)
+		{
+			if (pptr() == epptr() && !Submit())
+			{
+				return count - static_cast<std::streamsize>(remaining);
+			}
+
+			const auto chunk{ std::min(remaining, static_cast<size_t>(epptr() - pptr())) };
+			memcpy(pptr(), data, chunk);
+			pbump(static_cast<int>(chunk));
+			data += chunk;
+			remaining -= chunk;
+		}
+
+		return count;
+	}
+
+	if (m_IsOpen)
+	{
+		UpdateChecksums(s, static_cast<size_t>(count));
+
+		m_IsGood = m_IsGood && m_Deflater->Write(s, static_cast<size_t>(count));
+
+		return m_IsGood ? count : 0;
+	}
+
 	if (m_Md5Context)
 	{
-		md5_update(m_Md5Context.get(), reinterpret_cast<const unsigned char*>(s), static_cast<int>(count));
+		auto data{ reinterpret_cast<const unsigned char*>(s) };
+		auto remaining{ static_cast<size_t>(count) };
+		while (remaining > 0)
+		{
+			const auto chunk{ std::min(remaining, static_cast<size_t>(std::numeric_limits<int>::max())) };
+			md5_update(m_Md5Context.get(), data, static_cast<int>(chunk));
+			data += chunk;
+			remaining -= chunk;
+		}
 	}
 
-	if (zipWriteInFileInZip(m_Handle, s, static_cast<unsigned int>(count)) == ZIP_OK)
+	auto data{ s };
+	auto remaining{ static_cast<size_t>(count) };
+	while (remaining > 0)
 	{
-		return count;
+		const auto chunk{ std::min(remaining, static_cast<size_t>(std::numeric_limits<unsigned int>::max())) };
+		if (zipWriteInFileInZip(m_Handle, data, static_cast<unsigned int>(chunk)) != ZIP_OK)
+		{
+			return 0;
+		}
+
+		data += chunk;
+		remaining -= chunk;
+	}
+
+	return count;
+}
+
+ZipStreamBuffer::int_type ZipStreamBuffer::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		return sync() == 0 ? traits_type::not_eof(c) : traits_type::eof();
+	}
+
+	if (m_IsOpen && m_PipelineDepth > 0)
+	{
+		if (!Submit())
+		{
+			return traits_type::eof();
+		}
+
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+
+		return c;
+	}
+
+	const auto ch{ traits_type::to_char_type(c) };
+	return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+}
+
+int ZipStreamBuffer::sync()
+{
+	if (m_IsOpen && m_PipelineDepth > 0 && pptr() > pbase())
+	{
+		return Submit() ? 0 : -1;
 	}
 
 	return 0;
 }
 
+void ZipStreamBuffer::UpdateChecksums(const char* data, size_t size)
+{
+	if (m_Md5Context)
+	{
+		auto md5Data{ reinterpret_cast<const unsigned char*>(data) };
+		auto remaining{ size };
+		while (remaining > 0)
+		{
+			const auto chunk{ std::min(remaining, static_cast<size_t>(std::numeric_limits<int>::max())) };
+			md5_update(m_Md5Context.get(), md5Data, static_cast<int>(chunk));
+			md5Data += chunk;
+			remaining -= chunk;
+		}
+	}
+
+	auto crcData{ reinterpret_cast<const Bytef*>(data) };
+	auto remaining{ size };
+	while (remaining > 0)
+	{
+		const auto chunk{ std::min(remaining, static_cast<size_t>(std::numeric_limits<uInt>::max())) };
+		m_Crc = crc32(m_Crc, crcData, static_cast<uInt>(chunk));
+		crcData += chunk;
+		remaining -= chunk;
+	}
+
+	m_Size += static_cast<unsigned long long>(size);
+}
+
+void ZipStreamBuffer::StartPipeline()
+{
+	m_Free = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+	m_Filled = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+	m_Hashed = std::make_unique<SpscQueueT<Chunk>>(m_PipelineDepth);
+
+	for (size_t index = 0; index < m_PipelineDepth; ++index)
+	{
+		Chunk chunk;
+		chunk.data = std::make_unique<char[]>(_OPENGPS_ZIP_OUTPUT_CHUNK_MAX);
+		m_Free->TryPush(chunk);
+	}
+
+	m_IsCancelled = false;
+
+	m_Current = Chunk{};
+	m_Free->TryPop(m_Current);
+	setp(m_Current.data.get(), m_Current.data.get() + _OPENGPS_ZIP_OUTPUT_CHUNK_MAX);
+
+	m_HashThread = std::thread{ &ZipStreamBuffer::RunHash, this };
+	m_DeflateThread = std::thread{ &ZipStreamBuffer::RunDeflate, this };
+}
+
+void ZipStreamBuffer::StopPipeline()
+{
+	if (!m_HashThread.joinable() && !m_DeflateThread.joinable())
+	{
+		return;
+	}
+
+	m_IsCancelled = true;
+
+	if (m_HashThread.joinable())
+	{
+		m_HashThread.join();
+	}
+
+	if (m_DeflateThread.joinable())
+	{
+		m_DeflateThread.join();
+	}
+
+	setp(nullptr, nullptr);
+
+	m_Current = Chunk{};
+	m_Free.reset();
+	m_Filled.reset();
+	m_Hashed.reset();
+}
+
+bool ZipStreamBuffer::Submit()
+{
+	if (!m_Current.data || m_IsCancelled)
+	{
+		return false;
+	}
+
+	m_Current.size = static_cast<size_t>(pptr() - pbase());
+	if (m_Current.size == 0)
+	{
+		return true;
+	}
+
+	setp(nullptr, nullptr);
+
+	if (!m_Filled->Push(m_Current, m_IsCancelled))
+	{
+		return false;
+	}
+
+	m_Current = Chunk{};
+	if (!m_Free->Pop(m_Current, m_IsCancelled))
+	{
+		return false;
+	}
+
+	setp(m_Current.data.get(), m_Current.data.get() + _OPENGPS_ZIP_OUTPUT_CHUNK_MAX);
+
+	return true;
+}
+
+bool ZipStreamBuffer::Drain()
+{
+	if (!Submit())
+	{
+		return false;
+	}
+
+	// Once every other buffer has come back, all stages are idle.
+	std::vector<Chunk> idle(m_PipelineDepth - 1);
+	for (auto& chunk : idle)
+	{
+		if (!m_Free->Pop(chunk, m_IsCancelled))
+		{
+			return false;
+		}
+	}
+
+	for (auto& chunk : idle)
+	{
+		m_Free->TryPush(chunk);
+	}
+
+	return true;
+}
+
+void ZipStreamBuffer::RunHash()
+{
+	try
+	{
+		for (;;)
+		{
+			Chunk chunk;
+			if (!m_Filled->Pop(chunk, m_IsCancelled))
+			{
+				return;
+			}
+
+			UpdateChecksums(chunk.data.get(), chunk.size);
+
+			if (!m_Hashed->Push(chunk, m_IsCancelled))
+			{
+				return;
+			}
+		}
+	}
+	catch (...)
+	{
+		m_IsCancelled = true;
+	}
+}
+
+void ZipStreamBuffer::RunDeflate()
+{
+	try
+	{
+		for (;;)
+		{
+			Chunk chunk;
+			if (!m_Hashed->Pop(chunk, m_IsCancelled))
+			{
+				return;
+			}
+
+			if (!m_Deflater->Write(chunk.data.get(), chunk.size))
+			{
+				m_IsGood = false;
+				m_IsCancelled = true;
+				return;
+			}
+
+			chunk.size = 0;
+			if (!m_Free->Push(chunk, m_IsCancelled))
+			{
+				return;
+			}
+		}
+	}
+	catch (...)
+	{
+		m_IsGood = false;
+		m_IsCancelled = true;
+	}
+}
+
 bool ZipStreamBuffer::GetMd5(std::array<unsigned char, 16>& md5)
 {
+	// The checksum is complete once all data written so far has been hashed.
+	if (m_IsOpen && m_PipelineDepth > 0 && !Drain())
+	{
+		return false;
+	}
+
 	if (m_Md5Context)
 	{
 		md5_finish(m_Md5Context.get(), md5.data());
@@ -37,13 +37,18 @@
 
 #include <ostream>
 #include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 /* zlib/minizip */
 #include <zip.h>
 
 #include "../xyssl/md5.h"
 
+#include "zip_codec.hxx"
+#include "spsc_queue.hxx"
+
 #include <opengps/cxx/opengps.hxx>
 
 namespace OpenGPS
@@ -53,6 +58,12 @@ namespace OpenGPS
 	/*!
 	 * Provides a buffer interface suitable for streaming the zipFile
 	 * handle defined in the zlib/minizip package.
+	 *
+	 * Optionally writing to an archive entry is pipelined: data is collected in a
+	 * ring of large buffers, one thread computes the checksums of full buffers and
+	 * a second thread compresses them, while the thread writing to this buffer
+	 * goes on filling the next one.
+	 *
 	 * @see ZipOutputStream
 	 */
 	class ZipStreamBuffer : public std::streambuf
@@ -63,8 +74,40 @@ namespace OpenGPS
 		 * @param handle The Info-Zip file handle buffered binary data is written to.
 		 * @param enable_md5 When set to true generates md5 checksums of the buffered
 		 * binary data, if false no cheksum data will be generated.
+		 * @param pipelineDepth The number of buffers in the ring of a pipeline used while
+		 * an archive entry is open. If this is 0 everything is done by the thread writing
+		 * to this buffer.
+		 */
+		ZipStreamBuffer(zipFile handle, bool enable_md5, size_t pipelineDepth = 0);
+
+		/*! Destroys this instance. Closes the archive entry if it is still open. */
+		~ZipStreamBuffer() override;
+
+		/*!
+		 * Creates a new entry in the zip archive and directs all buffered data to it.
+		 * Data is compressed by the OpenGPS::ZipCodec currently selected rather than by
+		 * Info-Zip itself, which only receives the ready-made deflate stream.
+		 * @param name The name of the new archive entry.
+		 * @param compressionLevel The level of compression as known from zlib.
+		 * @param length The expected size of the uncompressed data. If the entry might exceed
+		 * 4GB it is stored in Zip64 format, which not all zip utilities support.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool Open(const String& name, int compressionLevel, unsigned long long length = 0);
+
+		/*!
+		 * Returns true if an archive entry of the given size must be stored in Zip64 format.
+		 * Leaves some headroom for data that does not compress and grows instead.
+		 * @param length The size of the uncompressed or compressed data.
+		 */
+		static bool RequiresZip64(unsigned long long length);
+
+		/*!
+		 * Flushes all pending data and closes the archive entry
+		 * opened with ZipStreamBuffer::Open.
+		 * @returns Returns true on success, false otherwise.
 		 */
-		ZipStreamBuffer(zipFile handle, bool enable_md5);
+		bool Close();
 
 		/*!
 		 * Gets the current md5 checksum. Also resets the computed md5 data internally.
@@ -77,12 +120,98 @@ namespace OpenGPS
 		/*! Overrides the super class. */
 		std::streamsize xsputn(const char_type* s, std::streamsize count) override;
 
+		/*! Overrides the super class. */
+		int_type overflow(int_type c) override;
+
+		/*! Overrides the super class. */
+		int sync() override;
+
 	private:
+		/*! A buffer of uncompressed data passed through the pipeline. */
+		struct Chunk
+		{
+			/*! The buffer. */
+			std::unique_ptr<char[]> data;
+			/*! The number of bytes used. */
+			size_t size{};
+		};
+
+		/*!
+		 * Updates the checksums and the size of the uncompressed data.
+		 * @param data The uncompressed data.
+		 * @param size The number of bytes.
+		 */
+		void UpdateChecksums(const char* data, size_t size);
+
+		/*! Starts the threads of the pipeline. */
+		void StartPipeline();
+
+		/*! Stops the threads of the pipeline and waits for them to finish. */
+		void StopPipeline();
+
+		/*!
+		 * Passes the buffer filled so far to the pipeline and takes a free one.
+		 * @returns Returns false if the pipeline has failed.
+		 */
+		bool Submit();
+
+		/*!
+		 * Passes the buffer filled so far to the pipeline and waits until all buffers
+		 * have been processed.
+		 * @returns Returns false if the pipeline has failed.
+		 */
+		bool Drain();
+
+		/*! Computes the checksums of full buffers. Executed by the first stage of the pipeline. */
+		void RunHash();
+
+		/*! Compresses buffers already hashed. Executed by the second stage of the pipeline. */
+		void RunDeflate();
+
 		/*! Handle to the zipFile where buffered data gets written to. */
 		zipFile m_Handle;
 
+		/*! Compresses the data of the currently open archive entry. */
+		std::unique_ptr<ZipDeflater> m_Deflater;
+
+		/*! The crc32 checksum of the uncompressed data of the current archive entry. */
+		unsigned long m_Crc{};
+
+		/*! The size of the uncompressed data of the current archive entry. */
+		unsigned long long m_Size{};
+
+		/*! true while an archive entry is open. */
+		bool m_IsOpen{};
+
+		/*! false if writing to the current archive entry failed. */
+		bool m_IsGood{ true };
+
 		/*! The current state of md5 checksum processing. */
 		std::unique_ptr<md5_context> m_Md5Context;
+
+		/*! The number of buffers in the ring of the pipeline or 0 if there is no pipeline. */
+		size_t m_PipelineDepth{};
+
+		/*! Buffers to be filled by the thread writing to this buffer. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Free;
+
+		/*! Buffers filled, but not yet hashed. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Filled;
+
+		/*! Buffers hashed, but not yet compressed. */
+		std::unique_ptr<SpscQueueT<Chunk>> m_Hashed;
+
+		/*! The buffer currently being filled. */
+		Chunk m_Current;
+
+		/*! Stops all stages of the pipeline, either on failure or when the archive entry is closed. */
+		std::atomic<bool> m_IsCancelled{};
+
+		/*! The first stage of the pipeline. */
+		std::thread m_HashThread;
+
+		/*! The second stage of the pipeline. */
+		std::thread m_DeflateThread;
 	};
 
 	/*!
@@ -0,0 +1,226 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+#include "zlib_codec.hxx"
+
+#include <algorithm>
+#include <limits>
+
+#include "stdafx.hxx"
+
+/* Size of the chunks of compressed data passed to the sink. */
+#define _OPENGPS_ZLIB_CHUNK_SIZE (256*1024)
+
+/*
+ * zlib counts bytes with unsigned int only, so larger blocks are passed in pieces.
+ */
+#define _OPENGPS_ZLIB_MAX_INPUT (static_cast<size_t>(std::numeric_limits<uInt>::max()))
+
+ZlibDeflater::ZlibDeflater(int level, ZipCodecSink sink)
+	:m_Sink{ std::move(sink) },
+	m_Buffer(_OPENGPS_ZLIB_CHUNK_SIZE)
+{
+	// Raw deflate streams (negative window bits) with the same settings minizip uses.
+	m_IsInitialized = (deflateInit2(&m_Stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+}
+
+ZlibDeflater::~ZlibDeflater()
+{
+	if (m_IsInitialized)
+	{
+		deflateEnd(&m_Stream);
+	}
+}
+
+bool ZlibDeflater::Deflate(int flush)
+{
+	do
+	{
+		m_Stream.next_out = reinterpret_cast<Bytef*>(m_Buffer.data());
+		m_Stream.avail_out = static_cast<uInt>(m_Buffer.size());
+
+		const auto result{ deflate(&m_Stream, flush) };
+
+		if (result == Z_STREAM_ERROR)
+		{
+			return false;
+		}
+
+		const auto size{ m_Buffer.size() - m_Stream.avail_out };
+		if (size > 0 && !m_Sink(m_Buffer.data(), size))
+		{
+			return false;
+		}
+
+		if (result == Z_STREAM_END)
+		{
+			return true;
+		}
+	} while (m_Stream.avail_out == 0 || (flush == Z_FINISH));
+
+	return true;
+}
+
+bool ZlibDeflater::Write(const char* data, size_t size)
+{
+	if (!m_IsInitialized)
+	{
+		return false;
+	}
+
+	while (size > 0)
+	{
+		const auto chunk{ std::min(size, _OPENGPS_ZLIB_MAX_INPUT) };
+
+		m_Stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+		m_Stream.avail_in = static_cast<uInt>(chunk);
+
+		if (!Deflate(Z_NO_FLUSH))
+		{
+			return false;
+		}
+
+		assert(m_Stream.avail_in == 0);
+
+		data += chunk;
+		size -= chunk;
+	}
+
+	return true;
+}
+
+bool ZlibDeflater::Finish()
+{
+	if (!m_IsInitialized)
+	{
+		return false;
+	}
+
+	m_Stream.next_in = nullptr;
+	m_Stream.avail_in = 0;
+
+	return Deflate(Z_FINISH);
+}
+
+ZlibInflater::ZlibInflater()
+{
+	m_IsInitialized = (inflateInit2(&m_Stream, -MAX_WBITS) == Z_OK);
+	m_IsGood = m_IsInitialized;
+}
+
+ZlibInflater::~ZlibInflater()
+{
+	if (m_IsInitialized)
+	{
+		inflateEnd(&m_Stream);
+	}
+}
+
+void ZlibInflater::SetInput(const char* data, size_t size)
+{
+	assert(NeedsInput());
+
+	const auto chunk{ std::min(size, _OPENGPS_ZLIB_MAX_INPUT) };
+
+	m_Stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	m_Stream.avail_in = static_cast<uInt>(chunk);
+	m_Pending = size - chunk;
+}
+
+bool ZlibInflater::NeedsInput() const
+{
+	return m_Stream.avail_in == 0 && m_Pending == 0;
+}
+
+size_t ZlibInflater::Read(char* data, size_t size)
+{
+	size_t produced{};
+
+	while (m_IsGood && !m_IsFinished && produced < size)
+	{
+		if (m_Stream.avail_in == 0)
+		{
+			if (m_Pending == 0)
+			{
+				break;
+			}
+
+			const auto chunk{ std::min(m_Pending, _OPENGPS_ZLIB_MAX_INPUT) };
+			m_Stream.avail_in = static_cast<uInt>(chunk);
+			m_Pending -= chunk;
+		}
+
+		const auto available{ std::min(size - produced, _OPENGPS_ZLIB_MAX_INPUT) };
+		m_Stream.next_out = reinterpret_cast<Bytef*>(data + produced);
+		m_Stream.avail_out = static_cast<uInt>(available);
+
+		const auto result{ inflate(&m_Stream, Z_NO_FLUSH) };
+
+		produced += available - m_Stream.avail_out;
+
+		if (result == Z_STREAM_END)
+		{
+			m_IsFinished = true;
+		}
+		else if (result != Z_OK && result != Z_BUF_ERROR)
+		{
+			m_IsGood = false;
+		}
+	}
+
+	return produced;
+}
+
+bool ZlibInflater::IsFinished() const
+{
+	return m_IsFinished;
+}
+
+bool ZlibInflater::IsGood() const
+{
+	return m_IsGood;
+}
+
+ZlibCodec::~ZlibCodec() = default;
+
+const OGPS_Character* ZlibCodec::GetName() const
+{
+	return _T("zlib");
+}
+
+std::unique_ptr<ZipDeflater> ZlibCodec::CreateDeflater(int level, unsigned long long, ZipCodecSink sink) const
+{
+	return std::make_unique<ZlibDeflater>(level, std::move(sink));
+}
+
+std::unique_ptr<ZipInflater> ZlibCodec::CreateInflater(unsigned long long, unsigned long long) const
+{
+	return std::make_unique<ZlibInflater>();
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright by Johannes Herwig (NanoFocus AG) 2007                      *
+ *   Copyright by Georg Wiora (NanoFocus AG) 2007                          *
+ *                                                                         *
+ *   This file is part of the openGPS (R)[TM] software library.            *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+ *   as published by the Free Software Foundation; either version 3 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the files "licence_LGPL-3.0.txt" and                   *
+ *   "licence_GPL-3.0.txt".                                                *
+ *                                                                         *
+ *   openGPS is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Lesser General Public License for more details.                   *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ *   The name "openGPS" and the logo are registered as                     *
+ *   European trade mark No. 006178354 for                                 *
+ *   Physikalisch Technische Bundesanstalt (PTB)                           *
+ *   http://www.ptb.de/                                                    *
+ *                                                                         *
+ *   More information about openGPS can be found at                        *
+ *   http://www.opengps.eu/                                                *
+ ***************************************************************************/
+
+/*! @file
+ * Implementation of the deflate codec based on zlib.
+ */
+
+#ifndef _OPENGPS_ZLIB_CODEC_HXX
+#define _OPENGPS_ZLIB_CODEC_HXX
+
+#include "zip_codec.hxx"
+
+#include <vector>
+
+/* zlib */
+#include <zlib.h>
+
+namespace OpenGPS
+{
+	/*!
+	 * Implements OpenGPS::ZipDeflater based on zlib.
+	 * Compressed data is passed to the sink in chunks of limited size,
+	 * so the memory used does not depend on the amount of data written.
+	 */
+	class ZlibDeflater : public ZipDeflater
+	{
+	public:
+		/*!
+		 * Creates a new instance.
+		 * @param level The level of compression, i.e. 0 to 9 or Z_DEFAULT_COMPRESSION.
+		 * @param sink Receives the compressed data.
+		 */
+		ZlibDeflater(int level, ZipCodecSink sink);
+
+		/*! Destroys this instance. */
+		~ZlibDeflater() override;
+
+		bool Write(const char* data, size_t size) override;
+		bool Finish() override;
+
+	private:
+		/*!
+		 * Runs the deflate algorithm on the current input.
+		 * @param flush The zlib flush mode.
+		 * @returns Returns true on success, false otherwise.
+		 */
+		bool Deflate(int flush);
+
+		/*! The state of the zlib stream. */
+		z_stream m_Stream{};
+
+		/*! true if the zlib stream has been initialized successfully. */
+		bool m_IsInitialized{};
+
+		/*! Target of compressed data. */
+		ZipCodecSink m_Sink;
+
+		/*! Buffers compressed data before it is passed to the sink. */
+		std::vector<char> m_Buffer;
+	};
+
+	/*!
+	 * Implements OpenGPS::ZipInflater based on zlib.
+	 */
+	class ZlibInflater : public ZipInflater
+	{
+	public:
+		/*! Creates a new instance. */
+		ZlibInflater();
+
+		/*! Destroys this instance. */
+		~ZlibInflater() override;
+
+		void SetInput(const char* data, size_t size) override;
+		bool NeedsInput() const override;
+		size_t Read(char* data, size_t size) override;
+		bool IsFinished() const override;
+		bool IsGood() const override;
+
+	private:
+		/*! The state of the zlib stream. */
+		z_stream m_Stream{};
+
+		/*! The amount of input that did not fit into the zlib stream at once. */
+		size_t m_Pending{};
+
+		/*! true if the zlib stream has been initialized successfully. */
+		bool m_IsInitialized{};
+
+		/*! true if the end of the deflate stream has been reached. */
+		bool m_IsFinished{};
+
+		/*! false if the zlib stream is unusable. */
+		bool m_IsGood{};
+	};
+
+	/*!
+	 * Creates instances of the zlib based codec.
+	 * This is the reference implementation which is always available.
+	 */
+	class ZlibCodec : public ZipCodec
+	{
+	public:
+		/*! Destroys this instance. */
+		~ZlibCodec() override;
+
+		const OGPS_Character* GetName() const override;
+		std::unique_ptr<ZipDeflater> CreateDeflater(int level, unsigned long long length, ZipCodecSink sink) const override;
+		std::unique_ptr<ZipInflater> CreateInflater(unsigned long long compressedSize, unsigned long long uncompressedSize) const override;
+	};
+}
+
+#endif
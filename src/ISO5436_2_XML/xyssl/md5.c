@@ -61,6 +61,108 @@
 }
 #endif
 
+/*
+ * The state is processed in 32-bit words, so that rotations
+ * need no masking on platforms with 64-bit longs.
+ */
+typedef unsigned int md5_word;
+
+/*
+ * Loads a block of 16 words. Little endian platforms
+ * copy the block as is.
+ */
+#if ( defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ) || \
+    defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64)
+#define MD5_LOAD(X,b) memcpy( (void *) (X), (const void *) (b), 64 )
+#else
+#define MD5_LOAD(X,b)                                   \
+{                                                       \
+    int j;                                              \
+    for( j = 0; j < 16; j++ )                           \
+        GET_ULONG_LE( (X)[j], b, j * 4 );               \
+}
+#endif
+
+#define S(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define F1(x,y,z) (z ^ (x & (y ^ z)))
+#define F2(x,y,z) (y ^ (z & (x ^ y)))
+#define F3(x,y,z) (x ^ y ^ z)
+#define F4(x,y,z) (y ^ (x | ~z))
+
+/*
+ * The 64 steps of a block, expanded with the
+ * step P defined by the caller
+ */
+#define MD5_STEPS                                       \
+    P( F1, A, B, C, D,  0,  7, 0xD76AA478 );            \
+    P( F1, D, A, B, C,  1, 12, 0xE8C7B756 );            \
+    P( F1, C, D, A, B,  2, 17, 0x242070DB );            \
+    P( F1, B, C, D, A,  3, 22, 0xC1BDCEEE );            \
+    P( F1, A, B, C, D,  4,  7, 0xF57C0FAF );            \
+    P( F1, D, A, B, C,  5, 12, 0x4787C62A );            \
+    P( F1, C, D, A, B,  6, 17, 0xA8304613 );            \
+    P( F1, B, C, D, A,  7, 22, 0xFD469501 );            \
+    P( F1, A, B, C, D,  8,  7, 0x698098D8 );            \
+    P( F1, D, A, B, C,  9, 12, 0x8B44F7AF );            \
+    P( F1, C, D, A, B, 10, 17, 0xFFFF5BB1 );            \
+    P( F1, B, C, D, A, 11, 22, 0x895CD7BE );            \
+    P( F1, A, B, C, D, 12,  7, 0x6B901122 );            \
+    P( F1, D, A, B, C, 13, 12, 0xFD987193 );            \
+    P( F1, C, D, A, B, 14, 17, 0xA679438E );            \
+    P( F1, B, C, D, A, 15, 22, 0x49B40821 );            \
+                                                        \
+    P( F2, A, B, C, D,  1,  5, 0xF61E2562 );            \
+    P( F2, D, A, B, C,  6,  9, 0xC040B340 );            \
+    P( F2, C, D, A, B, 11, 14, 0x265E5A51 );            \
+    P( F2, B, C, D, A,  0, 20, 0xE9B6C7AA );            \
+    P( F2, A, B, C, D,  5,  5, 0xD62F105D );            \
+    P( F2, D, A, B, C, 10,  9, 0x02441453 );            \
+    P( F2, C, D, A, B, 15, 14, 0xD8A1E681 );            \
+    P( F2, B, C, D, A,  4, 20, 0xE7D3FBC8 );            \
+    P( F2, A, B, C, D,  9,  5, 0x21E1CDE6 );            \
+    P( F2, D, A, B, C, 14,  9, 0xC33707D6 );            \
+    P( F2, C, D, A, B,  3, 14, 0xF4D50D87 );            \
+    P( F2, B, C, D, A,  8, 20, 0x455A14ED );            \
+    P( F2, A, B, C, D, 13,  5, 0xA9E3E905 );            \
+    P( F2, D, A, B, C,  2,  9, 0xFCEFA3F8 );            \
+    P( F2, C, D, A, B,  7, 14, 0x676F02D9 );            \
+    P( F2, B, C, D, A, 12, 20, 0x8D2A4C8A );            \
+                                                        \
+    P( F3, A, B, C, D,  5,  4, 0xFFFA3942 );            \
+    P( F3, D, A, B, C,  8, 11, 0x8771F681 );            \
+    P( F3, C, D, A, B, 11, 16, 0x6D9D6122 );            \
+    P( F3, B, C, D, A, 14, 23, 0xFDE5380C );            \
+    P( F3, A, B, C, D,  1,  4, 0xA4BEEA44 );            \
+    P( F3, D, A, B, C,  4, 11, 0x4BDECFA9 );            \
+    P( F3, C, D, A, B,  7, 16, 0xF6BB4B60 );            \
+    P( F3, B, C, D, A, 10, 23, 0xBEBFBC70 );            \
+    P( F3, A, B, C, D, 13,  4, 0x289B7EC6 );            \
+    P( F3, D, A, B, C,  0, 11, 0xEAA127FA );            \
+    P( F3, C, D, A, B,  3, 16, 0xD4EF3085 );            \
+    P( F3, B, C, D, A,  6, 23, 0x04881D05 );            \
+    P( F3, A, B, C, D,  9,  4, 0xD9D4D039 );            \
+    P( F3, D, A, B, C, 12, 11, 0xE6DB99E5 );            \
+    P( F3, C, D, A, B, 15, 16, 0x1FA27CF8 );            \
+    P( F3, B, C, D, A,  2, 23, 0xC4AC5665 );            \
+                                                        \
+    P( F4, A, B, C, D,  0,  6, 0xF4292244 );            \
+    P( F4, D, A, B, C,  7, 10, 0x432AFF97 );            \
+    P( F4, C, D, A, B, 14, 15, 0xAB9423A7 );            \
+    P( F4, B, C, D, A,  5, 21, 0xFC93A039 );            \
+    P( F4, A, B, C, D, 12,  6, 0x655B59C3 );            \
+    P( F4, D, A, B, C,  3, 10, 0x8F0CCC92 );            \
+    P( F4, C, D, A, B, 10, 15, 0xFFEFF47D );            \
+    P( F4, B, C, D, A,  1, 21, 0x85845DD1 );            \
+    P( F4, A, B, C, D,  8,  6, 0x6FA87E4F );            \
+    P( F4, D, A, B, C, 15, 10, 0xFE2CE6E0 );            \
+    P( F4, C, D, A, B,  6, 15, 0xA3014314 );            \
+    P( F4, B, C, D, A, 13, 21, 0x4E0811A1 );            \
+    P( F4, A, B, C, D,  4,  6, 0xF7537E82 );            \
+    P( F4, D, A, B, C, 11, 10, 0xBD3AF235 );            \
+    P( F4, C, D, A, B,  2, 15, 0x2AD7D2BB );            \
+    P( F4, B, C, D, A,  9, 21, 0xEB86D391 );
+
 /*
  * MD5 context setup
  */
@@ -75,127 +177,117 @@ void md5_starts( md5_context *ctx )
     ctx->state[3] = 0x10325476;
 }
 
-static void md5_process( md5_context *ctx, const unsigned char data[64] )
+/*
+ * Processes consecutive blocks, keeping the state in registers
+ */
+static void md5_process( md5_context *ctx, const unsigned char *data, int blocks )
+{
+    md5_word X[16], A, B, C, D;
+
+#define P(f,a,b,c,d,k,s,t)                              \
+{                                                       \
+    a += f(b,c,d) + X[k] + t; a = S(a,s) + b;           \
+}
+
+    A = (md5_word) ctx->state[0];
+    B = (md5_word) ctx->state[1];
+    C = (md5_word) ctx->state[2];
+    D = (md5_word) ctx->state[3];
+
+    while( blocks-- > 0 )
+    {
+        md5_word AA = A, BB = B, CC = C, DD = D;
+
+        MD5_LOAD( X, data );
+
+        MD5_STEPS
+
+        A += AA;
+        B += BB;
+        C += CC;
+        D += DD;
+
+        data += 64;
+    }
+
+#undef P
+
+    ctx->state[0] = A;
+    ctx->state[1] = B;
+    ctx->state[2] = C;
+    ctx->state[3] = D;
+}
+
+/*
+ * Processes consecutive blocks of two independent messages at once.
+ * A single message leaves most execution units idle, since each step
+ * depends on the previous one, so the steps of both are interleaved.
+ */
+static void md5_process2( md5_context *ctx0, const unsigned char *data0,
+                          md5_context *ctx1, const unsigned char *data1,
+                          int blocks )
 {
-    unsigned long X[16], A, B, C, D;
-
-    GET_ULONG_LE( X[ 0], data,  0 );
-    GET_ULONG_LE( X[ 1], data,  4 );
-    GET_ULONG_LE( X[ 2], data,  8 );
-    GET_ULONG_LE( X[ 3], data, 12 );
-    GET_ULONG_LE( X[ 4], data, 16 );
-    GET_ULONG_LE( X[ 5], data, 20 );
-    GET_ULONG_LE( X[ 6], data, 24 );
-    GET_ULONG_LE( X[ 7], data, 28 );
-    GET_ULONG_LE( X[ 8], data, 32 );
-    GET_ULONG_LE( X[ 9], data, 36 );
-    GET_ULONG_LE( X[10], data, 40 );
-    GET_ULONG_LE( X[11], data, 44 );
-    GET_ULONG_LE( X[12], data, 48 );
-    GET_ULONG_LE( X[13], data, 52 );
-    GET_ULONG_LE( X[14], data, 56 );
-    GET_ULONG_LE( X[15], data, 60 );
-
-#define S(x,n) ((x << n) | ((x & 0xFFFFFFFF) >> (32 - n)))
-
-#define P(a,b,c,d,k,s,t)                                \
+    md5_word X0[16], A0, B0, C0, D0;
+    md5_word X1[16], A1, B1, C1, D1;
+
+#define P(f,a,b,c,d,k,s,t)                              \
 {                                                       \
-    a += F(b,c,d) + X[k] + t; a = S(a,s) + b;           \
+    a##0 += f(b##0,c##0,d##0) + X0[k] + t;              \
+    a##1 += f(b##1,c##1,d##1) + X1[k] + t;              \
+    a##0 = S(a##0,s) + b##0;                            \
+    a##1 = S(a##1,s) + b##1;                            \
+}
+
+    A0 = (md5_word) ctx0->state[0];
+    B0 = (md5_word) ctx0->state[1];
+    C0 = (md5_word) ctx0->state[2];
+    D0 = (md5_word) ctx0->state[3];
+
+    A1 = (md5_word) ctx1->state[0];
+    B1 = (md5_word) ctx1->state[1];
+    C1 = (md5_word) ctx1->state[2];
+    D1 = (md5_word) ctx1->state[3];
+
+    while( blocks-- > 0 )
+    {
+        md5_word AA0 = A0, BB0 = B0, CC0 = C0, DD0 = D0;
+        md5_word AA1 = A1, BB1 = B1, CC1 = C1, DD1 = D1;
+
+        MD5_LOAD( X0, data0 );
+        MD5_LOAD( X1, data1 );
+
+        MD5_STEPS
+
+        A0 += AA0; B0 += BB0; C0 += CC0; D0 += DD0;
+        A1 += AA1; B1 += BB1; C1 += CC1; D1 += DD1;
+
+        data0 += 64;
+        data1 += 64;
+    }
+
+#undef P
+
+    ctx0->state[0] = A0;
+    ctx0->state[1] = B0;
+    ctx0->state[2] = C0;
+    ctx0->state[3] = D0;
+
+    ctx1->state[0] = A1;
+    ctx1->state[1] = B1;
+    ctx1->state[2] = C1;
+    ctx1->state[3] = D1;
 }
 
-    A = ctx->state[0];
-    B = ctx->state[1];
-    C = ctx->state[2];
-    D = ctx->state[3];
-
-#define F(x,y,z) (z ^ (x & (y ^ z)))
-
-    P( A, B, C, D,  0,  7, 0xD76AA478 );
-    P( D, A, B, C,  1, 12, 0xE8C7B756 );
-    P( C, D, A, B,  2, 17, 0x242070DB );
-    P( B, C, D, A,  3, 22, 0xC1BDCEEE );
-    P( A, B, C, D,  4,  7, 0xF57C0FAF );
-    P( D, A, B, C,  5, 12, 0x4787C62A );
-    P( C, D, A, B,  6, 17, 0xA8304613 );
-    P( B, C, D, A,  7, 22, 0xFD469501 );
-    P( A, B, C, D,  8,  7, 0x698098D8 );
-    P( D, A, B, C,  9, 12, 0x8B44F7AF );
-    P( C, D, A, B, 10, 17, 0xFFFF5BB1 );
-    P( B, C, D, A, 11, 22, 0x895CD7BE );
-    P( A, B, C, D, 12,  7, 0x6B901122 );
-    P( D, A, B, C, 13, 12, 0xFD987193 );
-    P( C, D, A, B, 14, 17, 0xA679438E );
-    P( B, C, D, A, 15, 22, 0x49B40821 );
-
-#undef F
-
-#define F(x,y,z) (y ^ (z & (x ^ y)))
-
-    P( A, B, C, D,  1,  5, 0xF61E2562 );
-    P( D, A, B, C,  6,  9, 0xC040B340 );
-    P( C, D, A, B, 11, 14, 0x265E5A51 );
-    P( B, C, D, A,  0, 20, 0xE9B6C7AA );
-    P( A, B, C, D,  5,  5, 0xD62F105D );
-    P( D, A, B, C, 10,  9, 0x02441453 );
-    P( C, D, A, B, 15, 14, 0xD8A1E681 );
-    P( B, C, D, A,  4, 20, 0xE7D3FBC8 );
-    P( A, B, C, D,  9,  5, 0x21E1CDE6 );
-    P( D, A, B, C, 14,  9, 0xC33707D6 );
-    P( C, D, A, B,  3, 14, 0xF4D50D87 );
-    P( B, C, D, A,  8, 20, 0x455A14ED );
-    P( A, B, C, D, 13,  5, 0xA9E3E905 );
-    P( D, A, B, C,  2,  9, 0xFCEFA3F8 );
-    P( C, D, A, B,  7, 14, 0x676F02D9 );
-    P( B, C, D, A, 12, 20, 0x8D2A4C8A );
-
-#undef F
-    
-#define F(x,y,z) (x ^ y ^ z)
-
-    P( A, B, C, D,  5,  4, 0xFFFA3942 );
-    P( D, A, B, C,  8, 11, 0x8771F681 );
-    P( C, D, A, B, 11, 16, 0x6D9D6122 );
-    P( B, C, D, A, 14, 23, 0xFDE5380C );
-    P( A, B, C, D,  1,  4, 0xA4BEEA44 );
-    P( D, A, B, C,  4, 11, 0x4BDECFA9 );
-    P( C, D, A, B,  7, 16, 0xF6BB4B60 );
-    P( B, C, D, A, 10, 23, 0xBEBFBC70 );
-    P( A, B, C, D, 13,  4, 0x289B7EC6 );
-    P( D, A, B, C,  0, 11, 0xEAA127FA );
-    P( C, D, A, B,  3, 16, 0xD4EF3085 );
-    P( B, C, D, A,  6, 23, 0x04881D05 );
-    P( A, B, C, D,  9,  4, 0xD9D4D039 );
-    P( D, A, B, C, 12, 11, 0xE6DB99E5 );
-    P( C, D, A, B, 15, 16, 0x1FA27CF8 );
-    P( B, C, D, A,  2, 23, 0xC4AC5665 );
-
-#undef F
-
-#define F(x,y,z) (y ^ (x | ~z))
-
-    P( A, B, C, D,  0,  6, 0xF4292244 );
-    P( D, A, B, C,  7, 10, 0x432AFF97 );
-    P( C, D, A, B, 14, 15, 0xAB9423A7 );
-    P( B, C, D, A,  5, 21, 0xFC93A039 );
-    P( A, B, C, D, 12,  6, 0x655B59C3 );
-    P( D, A, B, C,  3, 10, 0x8F0CCC92 );
-    P( C, D, A, B, 10, 15, 0xFFEFF47D );
-    P( B, C, D, A,  1, 21, 0x85845DD1 );
-    P( A, B, C, D,  8,  6, 0x6FA87E4F );
-    P( D, A, B, C, 15, 10, 0xFE2CE6E0 );
-    P( C, D, A, B,  6, 15, 0xA3014314 );
-    P( B, C, D, A, 13, 21, 0x4E0811A1 );
-    P( A, B, C, D,  4,  6, 0xF7537E82 );
-    P( D, A, B, C, 11, 10, 0xBD3AF235 );
-    P( C, D, A, B,  2, 15, 0x2AD7D2BB );
-    P( B, C, D, A,  9, 21, 0xEB86D391 );
-
-#undef F
-
-    ctx->state[0] += A;
-    ctx->state[1] += B;
-    ctx->state[2] += C;
-    ctx->state[3] += D;
+/*
+ * Counts the bytes processed
+ */
+static void md5_count( md5_context *ctx, int ilen )
+{
+    ctx->total[0] += ilen;
+    ctx->total[0] &= 0xFFFFFFFF;
+
+    if( ctx->total[0] < (unsigned long) ilen )
+        ctx->total[1]++;
 }
 
 /*
@@ -212,27 +304,23 @@ void md5_update( md5_context *ctx, const unsigned char *input, int ilen )
     left = ctx->total[0] & 0x3F;
     fill = 64 - left;
 
-    ctx->total[0] += ilen;
-    ctx->total[0] &= 0xFFFFFFFF;
-
-    if( ctx->total[0] < (unsigned long) ilen )
-        ctx->total[1]++;
+    md5_count( ctx, ilen );
 
     if( left && ilen >= fill )
     {
         memcpy( (void *) (ctx->buffer + left),
                 (void *) input, fill );
-        md5_process( ctx, ctx->buffer );
+        md5_process( ctx, ctx->buffer, 1 );
         input += fill;
         ilen  -= fill;
         left = 0;
     }
 
-    while( ilen >= 64 )
+    if( ilen >= 64 )
     {
-        md5_process( ctx, input );
-        input += 64;
-        ilen  -= 64;
+        md5_process( ctx, input, ilen / 64 );
+        input += ilen & ~0x3F;
+        ilen  &= 0x3F;
     }
 
     if( ilen > 0 )
@@ -242,6 +330,63 @@ void md5_update( md5_context *ctx, const unsigned char *input, int ilen )
     }
 }
 
+/*
+ * MD5 process two buffers at once
+ */
+static void md5_update2( md5_context *ctx0, const unsigned char *input0, int ilen0,
+                         md5_context *ctx1, const unsigned char *input1, int ilen1 )
+{
+    int fill, blocks;
+
+    /* Complete pending blocks, so that both inputs start at a block boundary */
+    fill = (int) ( ( 64 - ( ctx0->total[0] & 0x3F ) ) & 0x3F );
+    fill = fill < ilen0 ? fill : ilen0;
+    md5_update( ctx0, input0, fill );
+    input0 += fill;
+    ilen0  -= fill;
+
+    fill = (int) ( ( 64 - ( ctx1->total[0] & 0x3F ) ) & 0x3F );
+    fill = fill < ilen1 ? fill : ilen1;
+    md5_update( ctx1, input1, fill );
+    input1 += fill;
+    ilen1  -= fill;
+
+    blocks = ( ilen0 < ilen1 ? ilen0 : ilen1 ) / 64;
+
+    if( blocks > 0 &&
+        ( ctx0->total[0] & 0x3F ) == 0 &&
+        ( ctx1->total[0] & 0x3F ) == 0 )
+    {
+        md5_process2( ctx0, input0, ctx1, input1, blocks );
+        md5_count( ctx0, blocks * 64 );
+        md5_count( ctx1, blocks * 64 );
+        input0 += blocks * 64;
+        input1 += blocks * 64;
+        ilen0  -= blocks * 64;
+        ilen1  -= blocks * 64;
+    }
+
+    /* The longer input continues on its own */
+    md5_update( ctx0, input0, ilen0 );
+    md5_update( ctx1, input1, ilen1 );
+}
+
+/*
+ * MD5 process multiple buffers
+ */
+void md5_update_multi( md5_context *ctx[], const unsigned char *input[],
+                       const int ilen[], int count )
+{
+    int i;
+
+    for( i = 0; i + 1 < count; i += 2 )
+        md5_update2( ctx[i], input[i], ilen[i],
+                     ctx[i + 1], input[i + 1], ilen[i + 1] );
+
+    if( i < count )
+        md5_update( ctx[i], input[i], ilen[i] );
+}
+
 static const unsigned char md5_padding[64] =
 {
  0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -300,7 +445,7 @@ int md5_file( const char *path, unsigned char output[16] )
     FILE *f;
     size_t n;
     md5_context ctx;
-    unsigned char buf[1024];
+    unsigned char buf[16384];
 
     if( ( f = fopen( path, "rb" ) ) == NULL )
         return( 1 );
@@ -324,6 +469,84 @@ int md5_file( const char *path, unsigned char output[16] )
     return( 0 );
 }
 
+/*
+ * output = MD5( contents of two files ), hashed at once
+ */
+static int md5_file2( const char *path[2], unsigned char *output[2] )
+{
+    FILE *f[2];
+    size_t n;
+    md5_context ctx[2];
+    md5_context *pctx[2];
+    const unsigned char *input[2];
+    int ilen[2];
+    unsigned char buf[2][16384];
+    int i, count, ret = 0;
+
+    if( ( f[0] = fopen( path[0], "rb" ) ) == NULL )
+        return( 1 );
+
+    if( ( f[1] = fopen( path[1], "rb" ) ) == NULL )
+    {
+        fclose( f[0] );
+        return( 1 );
+    }
+
+    md5_starts( &ctx[0] );
+    md5_starts( &ctx[1] );
+
+    /* the longer file continues on its own once the shorter one is done */
+    do
+    {
+        count = 0;
+
+        for( i = 0; i < 2; i++ )
+        {
+            if( ( n = fread( buf[i], 1, sizeof( buf[i] ), f[i] ) ) > 0 )
+            {
+                pctx[count]  = &ctx[i];
+                input[count] = buf[i];
+                ilen[count]  = (int) n;
+                count++;
+            }
+        }
+
+        md5_update_multi( pctx, input, ilen, count );
+    }
+    while( count > 0 );
+
+    for( i = 0; i < 2; i++ )
+    {
+        md5_finish( &ctx[i], output[i] );
+
+        if( ferror( f[i] ) != 0 )
+            ret = 2;
+
+        fclose( f[i] );
+    }
+
+    memset( ctx, 0, sizeof( ctx ) );
+
+    return( ret );
+}
+
+/*
+ * output = MD5( file contents ) for several files at once
+ */
+int md5_file_multi( const char *path[], unsigned char *output[], int count )
+{
+    int i, ret;
+
+    for( i = 0; i + 1 < count; i += 2 )
+        if( ( ret = md5_file2( path + i, output + i ) ) != 0 )
+            return( ret );
+
+    if( i < count )
+        return( md5_file( path[i], output[i] ) );
+
+    return( 0 );
+}
+
 /*
  * MD5 HMAC context setup
  */
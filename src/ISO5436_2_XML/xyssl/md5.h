@@ -31,6 +31,11 @@
 #ifndef XYSSL_MD5_H
 #define XYSSL_MD5_H
 
+/*
+ * The library exports the functions checked and benchmarked by its demo
+ */
+#include <opengps/opengps.h>
+
 /**
  * \brief          MD5 context structure
  */
@@ -54,7 +59,7 @@ extern "C" {
  *
  * \param ctx      context to be initialized
  */
-void md5_starts( md5_context *ctx );
+_OPENGPS_EXPORT void md5_starts( md5_context *ctx );
 
 /**
  * \brief          MD5 process buffer
@@ -63,7 +68,19 @@ void md5_starts( md5_context *ctx );
  * \param input    buffer holding the  data
  * \param ilen     length of the input data
  */
-void md5_update( md5_context *ctx, const unsigned char *input, int ilen );
+_OPENGPS_EXPORT void md5_update( md5_context *ctx, const unsigned char *input, int ilen );
+
+/**
+ * \brief          MD5 process multiple independent buffers at once,
+ *                 which is faster than processing one after another
+ *
+ * \param ctx      MD5 contexts, one for each buffer
+ * \param input    buffers holding the data
+ * \param ilen     lengths of the input data
+ * \param count    number of buffers
+ */
+_OPENGPS_EXPORT void md5_update_multi( md5_context *ctx[], const unsigned char *input[],
+                                       const int ilen[], int count );
 
 /**
  * \brief          MD5 final digest
@@ -71,7 +88,7 @@ void md5_update( md5_context *ctx, const unsigned char *input, int ilen );
  * \param ctx      MD5 context
  * \param output   MD5 checksum result
  */
-void md5_finish( md5_context *ctx, unsigned char output[16] );
+_OPENGPS_EXPORT void md5_finish( md5_context *ctx, unsigned char output[16] );
 
 /**
  * \brief          Output = MD5( input buffer )
@@ -93,6 +110,19 @@ void md5( unsigned char *input, int ilen, unsigned char output[16] );
  */
 int md5_file( const char *path, unsigned char output[16] );
 
+/**
+ * \brief          Output = MD5( file contents ) for several files at once,
+ *                 which is faster than hashing one after another
+ *
+ * \param path     input file names
+ * \param output   MD5 checksum results, one for each file
+ * \param count    number of files
+ *
+ * \return         0 if successful, 1 if fopen failed,
+ *                 or 2 if fread failed
+ */
+int md5_file_multi( const char *path[], unsigned char *output[], int count );
+
 /**
  * \brief          MD5 HMAC context setup
  *
@@ -137,7 +167,7 @@ void md5_hmac( unsigned char *key, int keylen,
  *
  * \return         0 if successful, or 1 if the test failed
  */
-int md5_self_test( int verbose );
+_OPENGPS_EXPORT int md5_self_test( int verbose );
 
 #ifdef __cplusplus
 }
@@ -34,16 +34,23 @@
 #include <opengps/cxx/opengps.hxx>
 
 #include <opengps/iso5436_2.h>
+#include <opengps/scheduler.h>
 #include <opengps/cxx/iso5436_2.hxx>
 #include <opengps/cxx/iso5436_2_handle.hxx>
+#include <opengps/cxx/iso5436_2_batch.hxx>
+#include <opengps/cxx/iso5436_2_cache.hxx>
+#include <opengps/cxx/iso5436_2_reader.hxx>
 #include <opengps/cxx/iso5436_2_xsd.hxx>
 #include <opengps/cxx/point_iterator.hxx>
 #include <opengps/cxx/point_vector.hxx>
 #include <opengps/cxx/data_point.hxx>
+#include <opengps/cxx/scheduler.hxx>
 #include <opengps/cxx/string.hxx>
 #include <opengps/cxx/info.hxx>
 #include <opengps/cxx/iso5436_2_xsd_utils.hxx>
 
+#include "../ISO5436_2_XML/xyssl/md5.h"
+
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -52,9 +59,19 @@
 #include <ostream>
 #include <fstream>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <limits>
 #include <cmath>
+#include <vector>
+#include <iterator>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <set>
 
 #ifdef _WIN32
 #include <tchar.h>
@@ -1283,157 +1300,2525 @@ static void performanceDouble(OpenGPS::String fileName, size_t dimension, bool b
 		<< " seconds." << std::endl << std::endl;
 }
 
-// Converts a given X3P file either to binary or text format (if dstFormatIsBinary parameter equals false).
-static void convertFormat(const OpenGPS::String& srcFileName, const OpenGPS::String& dstFileName, bool dstFormatIsBinary)
+/*!
+   * @brief Selects the deflate codec used for all subsequent archive operations.
+   *
+   * @param name Name of the codec, e.g. "zlib" or "libdeflate". An empty name restores the default.
+   */
+static void SetZipCodec(const char* name)
 {
-	std::wcout << endl << endl << "convertFormat(\"" << srcFileName.c_str() << "\") to \"" << dstFileName.c_str() << "\"" << endl;
-	// We want to read in some file regardless whether it was written
-	// in text or binary format and then copy its contents into
-	// a newly created file to ensure binary format of X3P.
-	// The original file will be overwritten! 
+#ifdef _WIN32
+	_putenv_s("OPENGPS_ZIP_CODEC", name);
+#else
+	setenv("OPENGPS_ZIP_CODEC", name, 1);
+#endif
+}
 
-	auto src_handle{ ogps_OpenISO5436_2(srcFileName.c_str(), nullptr) };
+/*!
+   * @brief Creates RECORD1 of a synthetic surface with two incremental
+   * axes and an absolute z-axis of double precision.
+   */
+static Record1Type CreateSyntheticRecord1()
+{
+	Record1Type::Revision_type revision{ OGPS_ISO5436_2000_REVISION_NAME };
+	Record1Type::FeatureType_type featureType{ OGPS_FEATURE_TYPE_SURFACE_NAME };
 
-	if (!src_handle)
-		return;
+	Record1Type::Axes_type::CX_type::AxisType_type xaxisType{ Record1Type::Axes_type::CX_type::AxisType_type::I }; // incremental
+	Record1Type::Axes_type::CX_type xaxis{ xaxisType };
+	xaxis.Increment(1E-6);
+	xaxis.Offset(0.0);
 
-	PrintMetaData(src_handle);
-	PrintDimensions(src_handle);
+	Record1Type::Axes_type::CY_type::AxisType_type yaxisType{ Record1Type::Axes_type::CY_type::AxisType_type::I }; // incremental
+	Record1Type::Axes_type::CY_type yaxis{ yaxisType };
+	yaxis.Increment(1E-6);
+	yaxis.Offset(0.0);
 
-	auto document{ ogps_GetDocument(src_handle) };
+	Record1Type::Axes_type::CZ_type::AxisType_type zaxisType{ Record1Type::Axes_type::CZ_type::AxisType_type::A }; // absolute
+	Record1Type::Axes_type::CZ_type::DataType_type zdataType{ Record1Type::Axes_type::CZ_type::DataType_type::D }; // double
+	Record1Type::Axes_type::CZ_type zaxis{ zaxisType };
+	zaxis.DataType(zdataType);
 
-	// Check whether it is matrix or list format and allocate the new file handle accordingly.
-	OGPS_ISO5436_2Handle dst_handle{};
-	if (ogps_IsMatrix(src_handle) && !ogps_HasError())
+	Record1Type::Axes_type axis{ xaxis, yaxis, zaxis };
+
+	return Record1Type{ revision, featureType, axis };
+}
+
+/*!
+   * @brief Creates RECORD2 of a synthetic surface.
+   *
+   * @param text The user comment to add.
+   */
+static Record2Type CreateSyntheticRecord2(const OpenGPS::String& text)
+{
+	Record2Type::Date_type date{ TimeStamp(), 0 };
+
+	Record2Type::Instrument_type::Manufacturer_type manufacturer{ _T("NanoFocus AG") };
+	Record2Type::Instrument_type::Model_type model{ _T("ISO5436_2_XML_Demo Software") };
+	Record2Type::Instrument_type::Serial_type serial{ _T("not available") };
+	Record2Type::Instrument_type::Version_type version{ _OPENGPS_VERSIONSTRING };
+	Record2Type::Instrument_type instrument{ manufacturer, model, serial, version };
+
+	Record2Type::CalibrationDate_type calibrationDate{ _T("2007-04-30T13:58:02.6+02:00"), 0 };
+
+	Record2Type::ProbingSystem_type::Type_type type{ Record2Type::ProbingSystem_type::Type_type::Software };
+	Record2Type::ProbingSystem_type::Identification_type id{ _T("Synthetic surface generator") };
+	Record2Type::ProbingSystem_type probingSystem{ type, id };
+
+	Record2Type::Comment_type comment{ text };
+
+	Record2Type record2{ date, instrument, calibrationDate, probingSystem };
+	record2.Comment(comment);
+
+	return record2;
+}
+
+/*!
+   * @brief Gets the height of a smooth synthetic surface, which compresses like typical measurement data.
+   */
+static double SyntheticHeight(size_t u, size_t v)
+{
+	return 1E-6 * (std::sin(static_cast<double>(u) * 0.01) * std::cos(static_cast<double>(v) * 0.013) + static_cast<double>((u * 7 + v * 13) % 17) * 1E-3);
+}
+
+/*!
+   * @brief Measures how fast an existing X3P file is opened with the given codec.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to read.
+   * @param codec Name of the deflate codec.
+   */
+static void performanceCodecRead(const OpenGPS::String& fileName, const char* codec)
+{
+	const size_t repetitions{ 5 };
+
+	SetZipCodec(codec);
+
+	OpenGPS::String filePath(fileName);
+	std::ifstream file(filePath.ToChar(), std::ios::in | std::ios::binary | std::ios::ate);
+	const auto size{ static_cast<double>(file.tellg()) };
+	file.close();
+
+	const auto start{ clock() };
+
+	for (size_t n = 0; n < repetitions; ++n)
 	{
-		dst_handle = ogps_CreateMatrixISO5436_2(dstFileName.c_str(), nullptr, document->Record1(), document->Record2().present() ? &*document->Record2() : nullptr, *document->Record3().MatrixDimension(), dstFormatIsBinary);
+		auto handle{ ogps_OpenISO5436_2(fileName.c_str(), nullptr) };
+
+		if (!handle || ogps_HasError())
+		{
+			std::cerr << "Error opening file \"" << fileName << "\"" << endl;
+			return;
+		}
+
+		ogps_CloseISO5436_2(&handle);
 	}
-	else
+
+	const auto seconds{ static_cast<double>(clock() - start) / CLOCKS_PER_SEC };
+
+	std::wcout << "Opening \"" << fileName.c_str() << "\" with " << codec << " took "
+		<< seconds / repetitions << " seconds (" << (seconds > 0.0 ? size * repetitions / seconds / 1E6 : 0.0)
+		<< " MB/s compressed)." << std::endl;
+}
+
+/*!
+   * @brief Measures how fast a large synthetic surface is written and read back with the given codec.
+   *
+   * The surface is written once with the pipeline of the write options disabled, where small point
+   * data is compressed by the codec at once, and once through the pipeline, which compresses and
+   * checksums the point data on threads of their own and always streams it through zlib.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to write.
+   * @param dimension Number of points along both axes of the surface.
+   * @param codec Name of the deflate codec.
+   * @returns Returns true if the surface read back equals the one written, false otherwise.
+   */
+static bool performanceCodecSurface(const OpenGPS::String& fileName, size_t dimension, const char* codec)
+{
+	SetZipCodec(codec);
+
+	const auto record1{ CreateSyntheticRecord1() };
+	const auto record2{ CreateSyntheticRecord2(_T("This file is a synthetic surface written as performance test of the deflate codec.")) };
+	const MatrixDimensionType mdim{ dimension, dimension, 1 };
+	const auto size{ static_cast<double>(dimension * dimension * sizeof(OGPS_Double)) };
+
+	auto handle{ ogps_CreateMatrixISO5436_2(fileName.c_str(), nullptr, record1, &record2, mdim, true) };
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t v = 0; v < dimension; ++v)
 	{
-		dst_handle = ogps_CreateListISO5436_2(dstFileName.c_str(), nullptr, document->Record1(), document->Record2().present() ? &*document->Record2() : nullptr, static_cast<size_t>(*document->Record3().ListDimension()), dstFormatIsBinary);
+		for (size_t u = 0; u < dimension; ++u)
+		{
+			ogps_SetDoubleZ(vector, SyntheticHeight(u, v));
+			ogps_SetMatrixPoint(handle, u, v, 0, vector);
+		}
 	}
 
-	if (dst_handle)
+	OGPS_WriteOptions options;
+	ogps_InitWriteOptions(&options);
+
+	auto success{ !ogps_HasError() };
+	double writeSeconds[2]{};
+
+	for (size_t pass = 0; success && pass < 2; ++pass)
 	{
-		auto vector{ ogps_CreatePointVector() };
-		auto src{ ogps_CreateNextPointIterator(src_handle) };
-		auto dst{ ogps_CreateNextPointIterator(dst_handle) };
+		options.pipelineBuffers = pass == 0 ? 0 : OGPS_DEFAULT_WRITE_PIPELINE_BUFFERS;
+		options.pipelineMinimum = 0;
+		ogps_SetWriteOptions(handle, &options);
 
-		while (ogps_MoveNextPoint(src) && ogps_MoveNextPoint(dst))
-		{
-			ogps_GetCurrentPoint(src, vector);
+		// Processor time would add up the time spent by all stages, so measure the elapsed time.
+		const auto writeStart{ std::chrono::steady_clock::now() };
+		ogps_WriteISO5436_2(handle);
+		writeSeconds[pass] = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
 
-			if (!ogps_HasError())
-			{
-				ogps_SetCurrentPoint(dst, (!ogps_IsValidPoint(vector) || ogps_HasError()) ? nullptr : vector);
-			}
+		success = !ogps_HasError();
+	}
 
-			if (ogps_HasError())
-			{
-				break;
-			}
-		}
+	ogps_CloseISO5436_2(&handle);
 
-		assert(!ogps_HasNextPoint(src));
-		assert(!ogps_HasNextPoint(dst));
+	const auto readStart{ std::chrono::steady_clock::now() };
+	handle = ogps_OpenISO5436_2(fileName.c_str(), nullptr);
+	const auto readSeconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count() };
 
-		ogps_FreePointIterator(&src);
-		ogps_FreePointIterator(&dst);
-		ogps_FreePointVector(&vector);
+	success = success && handle && !ogps_HasError();
+
+	// Compare some points along the diagonal
+	for (size_t n = 0; success && n < dimension; n += 97)
+	{
+		ogps_GetMatrixPoint(handle, n, dimension - n - 1, 0, vector);
+		success = !ogps_HasError() && ogps_IsValidPoint(vector) && ogps_GetDoubleZ(vector) == SyntheticHeight(n, dimension - n - 1);
 	}
 
-	ogps_CloseISO5436_2(&src_handle);
+	ogps_FreePointVector(&vector);
+	ogps_CloseISO5436_2(&handle);
 
-	if (dst_handle)
+	if (!success)
 	{
-		ogps_WriteISO5436_2(dst_handle);
-		ogps_CloseISO5436_2(&dst_handle);
+		std::cerr << "Synthetic surface \"" << fileName << "\" written with " << codec << " could not be read back correctly." << endl;
+		return false;
 	}
+
+	std::wcout << "Synthetic surface of " << dimension << "x" << dimension << " points with " << codec << ": writing one stage after another took "
+		<< writeSeconds[0] << " seconds (" << (writeSeconds[0] > 0.0 ? size / writeSeconds[0] / 1E6 : 0.0) << " MB/s), writing through a pipeline of "
+		<< OGPS_DEFAULT_WRITE_PIPELINE_BUFFERS << " buffers took " << writeSeconds[1] << " seconds (" << (writeSeconds[1] > 0.0 ? size / writeSeconds[1] / 1E6 : 0.0)
+		<< " MB/s), reading took " << readSeconds << " seconds (" << (readSeconds > 0.0 ? size / readSeconds / 1E6 : 0.0) << " MB/s)." << std::endl;
+
+	return true;
 }
 
-#if defined _WIN32 && defined _UNICODE
-int _cdecl _tmain(int argc, _TCHAR* argv[])
-#else
-int main(int argc, char* argv[])
-#endif
+/*!
+   * @brief Validates the md5 implementation used for checksums and measures its throughput.
+   *
+   * Two buffers are hashed one after another and at once, which must give the same checksums.
+   *
+   * @param size Number of bytes hashed.
+   * @returns Returns true if all checksums are correct, false otherwise.
+   */
+static bool performanceMd5(size_t size)
 {
-	// Number of points to generate for performance counter
-	const size_t performanceCounter{ 1000 };
-	if (argc != 2)
+	std::wcout << endl << endl << "performanceMd5(" << size << ")" << endl;
+
+	// RFC 1321 test vectors
+	if (md5_self_test(0) != 0)
 	{
-		std::wcout << "Usage: ISO5436_2_XML_demo <full path to sample files>/" << std::endl << std::endl <<
-			"Please specify the full path to the directory where the *.x3p sample files reside. The path should also contain the terminating directory separator. Ensure that you have write access to that path." << std::endl << std::endl <<
-			"This simple demo program parses the sample files and prints its contents onto the console. Do not change the names of the sample files, since these are hard coded herein. The purpose of the demo is to get you familiar with the openGPS(R) API." << std::endl;
-		return 1;
+		std::cerr << "The md5 implementation does not pass the RFC 1321 test vectors." << endl;
+		return false;
 	}
 
-	// Print version and copyright information
-	OpenGPS::String LibName;
-	OpenGPS::String LibVersion;
-	OpenGPS::String LibAbout;
+	std::vector<unsigned char> data(size);
+	for (size_t n = 0; n < size; ++n)
+	{
+		data[n] = static_cast<unsigned char>((n * 2654435761U) >> 13);
+	}
 
-	// get Info strings from Library
-	OpenGPS::Info::GetName(&LibName);
-	OpenGPS::Info::GetVersion(&LibVersion);
-	OpenGPS::Info::GetAbout(&LibAbout);
+	// Uneven lengths, so that the longer buffer continues on its own.
+	const auto half{ static_cast<int>(size / 2) };
+	const unsigned char* input[2]{ data.data(), data.data() + half };
+	const int length[2]{ half, half - 13 };
+	unsigned char single[2][16]{};
+	unsigned char multi[2][16]{};
 
-	std::wcout << "This programm uses the Library \"" << LibName.c_str()
-		<< "\" Version " << LibVersion.c_str() << endl
-		<< LibAbout.c_str() << endl;
-	OpenGPS::Info::PrintVersion();
-	OpenGPS::Info::PrintCopyright();
-	OpenGPS::Info::PrintLicense();
+	const auto singleStart{ std::chrono::steady_clock::now() };
 
-#ifdef _UNICODE
-	#ifdef _WIN32
-		OpenGPS::String path = argv[1];
-	#else
-		OpenGPS::String wpath;
-		wpath.FromChar(argv[1]);
-		OpenGPS::String path = wpath;
-	#endif
-#else
-	OpenGPS::String path = argv[1];
-#endif
-	OpenGPS::String tmp;
+	for (size_t n = 0; n < 2; ++n)
+	{
+		md5_context context;
+		md5_starts(&context);
+		md5_update(&context, input[n], length[n]);
+		md5_finish(&context, single[n]);
+	}
 
-	tmp = path; tmp += _T("ISO5436-sample1.x3p");
-	readonlyExample(tmp);
+	const auto singleSeconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - singleStart).count() };
+	const auto multiStart{ std::chrono::steady_clock::now() };
 
-	tmp = path; tmp += _T("ISO5436-sample4_bin.x3p");
-	readonlyExample2(tmp);
+	md5_context contexts[2];
+	md5_context* context[2]{ &contexts[0], &contexts[1] };
+	md5_starts(context[0]);
+	md5_starts(context[1]);
+	md5_update_multi(context, input, length, 2);
+	md5_finish(context[0], multi[0]);
+	md5_finish(context[1], multi[1]);
 
-	tmp = path; tmp += _T("ISO5436-sample3.x3p");
-	readonlyExample2(tmp);
+	const auto multiSeconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - multiStart).count() };
 
-	tmp = path; tmp += _T("ISO5436-sample3.x3p");
-	readonlyExample3(tmp);
+	if (memcmp(single, multi, sizeof(single)) != 0)
+	{
+		std::cerr << "Buffers hashed at once do not give the same md5 checksums as hashed one after another." << endl;
+		return false;
+	}
 
-	tmp = path; tmp += _T("ISO5436-sample2.x3p");
-	readonlyExample4(tmp);
+	const auto bytes{ static_cast<double>(length[0] + length[1]) };
+	std::wcout << "Hashing " << size << " bytes took " << singleSeconds << " seconds (" << (singleSeconds > 0.0 ? bytes / singleSeconds / 1E6 : 0.0)
+		<< " MB/s) one buffer after another and " << multiSeconds << " seconds (" << (multiSeconds > 0.0 ? bytes / multiSeconds / 1E6 : 0.0)
+		<< " MB/s) for two buffers at once." << std::endl;
 
-	tmp = path; tmp += _T("simple.x3p");
-	simpleExample(tmp);
+	return true;
+}
 
-	tmp = path; tmp += _T("medium.x3p");
-	mediumComplexExample(tmp);
+/*!
+   * @brief Gets the height of a streamed synthetic surface in int16 precision.
+   * Every eleventh point of the surface is invalid.
+   *
+   * @returns Returns false if there is no valid point at the given position.
+   */
+static bool StreamedHeight(size_t u, size_t v, OGPS_Int16& z)
+{
+	z = static_cast<OGPS_Int16>((u * 7 + v * 13) % 1000);
+	return (u + v * 3) % 11 != 0;
+}
 
-	tmp = path; tmp += _T("medium_invalid_points.x3p");
-	mediumComplexExampleWInvalid(tmp);
+/*!
+   * @brief Streams a synthetic surface row by row to an X3P file and reads it back.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to write.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface read back equals the one streamed, false otherwise.
+   */
+static bool streamingExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "streamingExample(\"" << fileName.c_str() << "\")" << endl;
 
-	std::wcout << std::endl << "Starting performance tests..." << std::endl;
+	auto record1{ CreateSyntheticRecord1() };
+	record1.Axes().CZ().DataType(Record1Type::Axes_type::CZ_type::DataType_type::I); // int16
+	record1.Axes().CZ().Increment(1E-9);
 
-	tmp = path; tmp += _T("performance_int16_bin.x3p");
-	performanceInt16(tmp, performanceCounter, true);
+	const auto record2{ CreateSyntheticRecord2(_T("This file is a synthetic surface streamed row by row.")) };
+	const MatrixDimensionType mdim{ sizeU, sizeV, 1 };
 
-	tmp = path; tmp += _T("performance_int16.x3p");
-	performanceInt16(tmp, performanceCounter, false);
+	auto handle{ ogps_CreateMatrixStreamISO5436_2(fileName.c_str(), nullptr, record1, &record2, mdim) };
+	auto vector{ ogps_CreatePointVector() };
 
-	tmp = path; tmp += _T("performance_double_bin.x3p");
-	performanceDouble(tmp, performanceCounter, true);
+	auto success{ handle && !ogps_HasError() };
 
-	tmp = path; tmp += _T("performance_double.x3p");
-	performanceDouble(tmp, performanceCounter, false);
+	for (size_t v = 0; success && v < sizeV; ++v)
+	{
+		for (size_t u = 0; u < sizeU; ++u)
+		{
+			OGPS_Int16 z{};
+			if (StreamedHeight(u, v, z))
+			{
+				ogps_SetInt16Z(vector, z);
+				ogps_AppendMatrixPoint(handle, vector);
+			}
+			else
+			{
+				ogps_AppendMatrixPoint(handle, nullptr);
+			}
+		}
+
+		success = !ogps_HasError();
+	}
+
+	// The matrix is complete, so this must fail.
+	if (success)
+	{
+		ogps_AppendMatrixPoint(handle, vector);
+		success = ogps_HasError();
+	}
+
+	if (success)
+	{
+		ogps_WriteISO5436_2(handle);
+		success = !ogps_HasError();
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	if (success)
+	{
+		handle = ogps_OpenISO5436_2(fileName.c_str(), nullptr);
+		success = handle && !ogps_HasError();
+
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	ogps_FreePointVector(&vector);
+
+	if (!success)
+	{
+		std::cerr << "Streamed surface \"" << fileName << "\" could not be written or read back correctly." << endl;
+		return false;
+	}
+
+	std::wcout << "Streamed a surface of " << sizeU << "x" << sizeV << " points." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Reads a synthetic surface back with a memory budget smaller than its point data.
+   * The points are paged through a spill file in the temporary directory.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::performanceCodecSurface.
+   * @param dimension Number of points along both axes of the surface.
+   * @returns Returns true if the surface read back equals the one written, false otherwise.
+   */
+static bool pagedExample(const OpenGPS::String& fileName, size_t dimension)
+{
+	std::wcout << endl << endl << "pagedExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.pagedMemoryBudget = 1024 * 1024;
+	options.pageSize = 64 * 1024;
+
+	const auto start{ clock() };
+	auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+	auto vector{ ogps_CreatePointVector() };
+
+	auto success{ handle && !ogps_HasError() };
+
+	// Random access along the columns touches a different page with every point.
+	for (size_t u = 0; success && u < dimension; u += 31)
+	{
+		for (size_t v = 0; success && v < dimension; ++v)
+		{
+			ogps_GetMatrixPoint(handle, u, v, 0, vector);
+			success = !ogps_HasError() && ogps_IsValidPoint(vector) && ogps_GetDoubleZ(vector) == SyntheticHeight(u, v);
+		}
+	}
+
+	// Sequential access is served by read-ahead.
+	if (success)
+	{
+		auto iterator{ ogps_CreateNextPointIterator(handle) };
+		size_t count{ 0 };
+
+		while (success && ogps_MoveNextPoint(iterator))
+		{
+			size_t u{ 0 }, v{ 0 };
+			ogps_GetCurrentPoint(iterator, vector);
+			success = ogps_GetMatrixPosition(iterator, &u, &v, nullptr) && ogps_GetDoubleZ(vector) == SyntheticHeight(u, v);
+			++count;
+		}
+
+		success = success && !ogps_HasError() && count == dimension * dimension;
+		ogps_FreePointIterator(&iterator);
+	}
+
+	ogps_FreePointVector(&vector);
+	ogps_CloseISO5436_2(&handle);
+
+	const auto seconds{ static_cast<double>(clock() - start) / CLOCKS_PER_SEC };
+
+	if (!success)
+	{
+		std::cerr << "Synthetic surface \"" << fileName << "\" could not be read back correctly with paged point buffers." << endl;
+		return false;
+	}
+
+	std::wcout << "Reading " << dimension << "x" << dimension << " points with a memory budget of "
+		<< options.pagedMemoryBudget << " bytes took " << seconds << " seconds." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief State of ::VisitStreamedBlock.
+   */
+struct VisitStreamedState
+{
+	/*! Number of points along the u-direction. */
+	size_t sizeU;
+	/*! Number of blocks after which visiting is stopped, 0 visits all. */
+	size_t stopAfter;
+	/*! Number of blocks visited so far. */
+	size_t blocks;
+	/*! Number of point vectors visited so far. */
+	size_t points;
+	/*! Number of invalid point vectors visited so far. */
+	size_t invalid;
+	/*! false if a point vector does not equal the one streamed. */
+	bool success;
+};
+
+/*!
+   * @brief Compares a block of point vectors with the surface streamed by ::streamingExample.
+   */
+static OGPS_Boolean VisitStreamedBlock(const OGPS_PointBlock* block, void* userData)
+{
+	auto state{ static_cast<VisitStreamedState*>(userData) };
+	const auto z{ static_cast<const OGPS_Int16*>(block->z) };
+
+	state->success = state->success && block->index == state->points && block->zType == OGPS_Int16PointType && z;
+
+	for (size_t n = 0; state->success && n < block->count; ++n)
+	{
+		const auto index{ block->index + n };
+
+		OGPS_Int16 height{};
+		const auto valid{ StreamedHeight(index % state->sizeU, index / state->sizeU, height) };
+
+		state->success = block->valid[n] == valid && (!valid || z[n] == height);
+		state->invalid += valid ? 0 : 1;
+	}
+
+	state->points += block->count;
+
+	return ++state->blocks != state->stopAfter;
+}
+
+/*!
+   * @brief Visits the surface streamed by ::streamingExample without loading its point data.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface visited equals the one streamed, false otherwise.
+   */
+static bool visitExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "visitExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.loadPoints = false;
+
+	auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+	auto success{ handle && !ogps_HasError() };
+
+	// Point data is not available for random access.
+	if (success)
+	{
+		auto vector{ ogps_CreatePointVector() };
+		ogps_GetMatrixPoint(handle, 0, 0, 0, vector);
+		ogps_FreePointVector(&vector);
+
+		success = ogps_HasError();
+	}
+
+	// Stop after the second block.
+	VisitStreamedState state{ sizeU, 2, 0, 0, 0, true };
+	if (success)
+	{
+		success = !ogps_VisitPoints(handle, VisitStreamedBlock, &state, 1000) && !ogps_HasError() && state.success && state.points == 2000;
+	}
+
+	// Visit all blocks, checksums get verified at the end.
+	state = VisitStreamedState{ sizeU, 0, 0, 0, 0, true };
+	if (success)
+	{
+		success = ogps_VisitPoints(handle, VisitStreamedBlock, &state, 1000) && !ogps_HasError() && state.success && state.points == sizeU * sizeV;
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	if (!success)
+	{
+		std::cerr << "Streamed surface \"" << fileName << "\" could not be visited correctly." << endl;
+		return false;
+	}
+
+	std::wcout << "Visited " << state.points << " points in " << state.blocks << " blocks, "
+		<< state.invalid << " of them invalid." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Loads only the first rows of the surface streamed by ::streamingExample.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param rows Number of rows to be loaded.
+   * @returns Returns true if the rows loaded equal the ones streamed, false otherwise.
+   */
+static bool partialExample(const OpenGPS::String& fileName, size_t sizeU, size_t rows)
+{
+	std::wcout << endl << endl << "partialExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.rowCount = rows;
+
+	auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+	auto success{ handle && !ogps_HasError() };
+
+	if (success)
+	{
+		size_t size_u{}, size_v{}, size_w{};
+		ogps_GetMatrixDimensions(handle, &size_u, &size_v, &size_w);
+		success = !ogps_HasError() && size_u == sizeU && size_v == rows && size_w == 1;
+	}
+
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t v = 0; success && v < rows; ++v)
+	{
+		for (size_t u = 0; success && u < sizeU; ++u)
+		{
+			OGPS_Int16 z{};
+			const auto valid{ StreamedHeight(u, v, z) };
+
+			ogps_GetMatrixPoint(handle, u, v, 0, vector);
+			success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+		}
+	}
+
+	ogps_FreePointVector(&vector);
+
+	// A partial document must not overwrite the complete one.
+	if (success)
+	{
+		ogps_WriteISO5436_2(handle);
+		success = ogps_HasError();
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	if (!success)
+	{
+		std::cerr << "The first rows of surface \"" << fileName << "\" could not be loaded correctly." << endl;
+		return false;
+	}
+
+	std::wcout << "Loaded the first " << rows << " rows." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Loads some of the last rows of the surface streamed by ::streamingExample through a random-access index.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the rows loaded equal the ones streamed, false otherwise.
+   */
+static bool indexExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "indexExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.firstRow = sizeV - 12;
+	options.rowCount = 10;
+	options.indexSpan = 16 * 1024;
+
+	auto success{ true };
+	auto vector{ ogps_CreatePointVector() };
+
+	// The index is built when opening the first time and reused afterwards.
+	for (size_t pass = 0; success && pass < 2; ++pass)
+	{
+		const auto start{ clock() };
+
+		auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+		success = handle && !ogps_HasError();
+
+		if (success)
+		{
+			size_t size_u{}, size_v{}, size_w{};
+			ogps_GetMatrixDimensions(handle, &size_u, &size_v, &size_w);
+			success = !ogps_HasError() && size_u == sizeU && size_v == options.rowCount && size_w == 1;
+		}
+
+		for (size_t v = 0; success && v < options.rowCount; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, options.firstRow + v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+
+		ogps_CloseISO5436_2(&handle);
+
+		const auto seconds{ static_cast<double>(clock() - start) / CLOCKS_PER_SEC };
+		std::wcout << "Loading rows " << options.firstRow << " to " << options.firstRow + options.rowCount - 1
+			<< (pass == 0 ? " while building the index" : " from the index") << " took " << seconds << " seconds." << std::endl;
+	}
+
+	ogps_FreePointVector(&vector);
+
+	if (!success)
+	{
+		std::cerr << "Rows of surface \"" << fileName << "\" could not be loaded correctly through a random-access index." << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+   * @brief Changes the comment of the surface streamed by ::streamingExample without loading its point data.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the point data has been copied unchanged, false otherwise.
+   */
+static bool rewriteExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "rewriteExample(\"" << fileName.c_str() << "\")" << endl;
+
+	const Record2Type::Comment_type comment{ _T("This file is a synthetic surface whose comment has been changed.") };
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.loadPoints = false;
+
+	auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+	auto success{ handle && !ogps_HasError() };
+
+	// Compressed point data is copied as it is, so its checksum does not change.
+	DataLinkType::MD5ChecksumPointData_type checksum;
+	if (success)
+	{
+		auto document{ ogps_GetDocument(handle) };
+		checksum = document->Record3().DataLink()->MD5ChecksumPointData();
+		document->Record2()->Comment(comment);
+
+		ogps_WriteISO5436_2(handle);
+		success = !ogps_HasError();
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	if (success)
+	{
+		handle = ogps_OpenISO5436_2(fileName.c_str(), nullptr);
+		success = handle && !ogps_HasError();
+
+		auto document{ success ? ogps_GetDocument(handle) : nullptr };
+		success = success && document->Record2()->Comment().get() == comment &&
+			document->Record3().DataLink()->MD5ChecksumPointData() == checksum;
+
+		auto vector{ ogps_CreatePointVector() };
+
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+
+		ogps_FreePointVector(&vector);
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be rewritten with its point data unchanged." << endl;
+		return false;
+	}
+
+	std::wcout << "Changed the comment and copied the compressed point data unchanged." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Appends the X3P written by ::ogps_WriteISO5436_2Buffer to a std::vector.
+   */
+static OGPS_Boolean AppendMemoryArchive(const void* data, size_t size, void* userData)
+{
+	auto target{ static_cast<std::vector<unsigned char>*>(userData) };
+	const auto bytes{ static_cast<const unsigned char*>(data) };
+
+	target->insert(target->end(), bytes, bytes + size);
+
+	return true;
+}
+
+/*!
+   * @brief Opens the surface streamed by ::streamingExample from memory and writes it back to memory.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface read from memory equals the one written, false otherwise.
+   */
+static bool memoryExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "memoryExample(\"" << fileName.c_str() << "\")" << endl;
+
+	const Record2Type::Comment_type comment{ _T("This file is a synthetic surface that has been written to memory.") };
+
+	OpenGPS::String filePath(fileName);
+	std::ifstream file(filePath.ToChar(), std::ios::binary);
+	const std::vector<unsigned char> source{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	auto success{ !file.bad() && !source.empty() };
+
+	std::vector<unsigned char> target;
+
+	if (success)
+	{
+		auto handle{ ogps_OpenISO5436_2Buffer(source.data(), source.size(), nullptr, nullptr) };
+		success = handle && !ogps_HasError();
+
+		if (success)
+		{
+			ogps_GetDocument(handle)->Record2()->Comment(comment);
+			success = ogps_WriteISO5436_2Buffer(handle, AppendMemoryArchive, &target) && !ogps_HasError();
+		}
+
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	// The X3P written to memory is read back through the C++ interface.
+	try
+	{
+		if (success)
+		{
+			OpenGPS::ISO5436_2 iso5436_2(std::move(target));
+			iso5436_2.Open();
+
+			success = iso5436_2.GetDocument()->Record2()->Comment().get() == comment;
+
+			OpenGPS::PointVector vector;
+
+			for (size_t v = 0; success && v < sizeV; ++v)
+			{
+				for (size_t u = 0; success && u < sizeU; ++u)
+				{
+					OGPS_Int16 z{};
+					const auto valid{ StreamedHeight(u, v, z) };
+
+					OGPS_Int16 zs{};
+					iso5436_2.GetMatrixPoint(u, v, 0, vector);
+					vector.GetZ()->Get(&zs);
+					success = vector.IsValid() == valid && (!valid || zs == z);
+				}
+			}
+		}
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be read from and written to memory." << endl;
+		return false;
+	}
+
+	std::wcout << "Read the surface from memory and wrote it back to memory with its comment changed." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Reads an X3P file and collects metrics about the reads issued.
+   */
+class CountingByteSource : public OpenGPS::FileByteSource
+{
+public:
+	/*! Creates a new instance. */
+	CountingByteSource(const OpenGPS::String& filePath)
+		:OpenGPS::FileByteSource(filePath)
+	{
+	}
+
+	size_t Read(unsigned long long offset, void* buffer, size_t size) const override
+	{
+		++m_Reads;
+		m_Bytes += size;
+
+		// Small reads issued by minizip must not reach the byte source.
+		if (offset % 4096 != 0)
+		{
+			m_IsAligned = false;
+		}
+
+		return OpenGPS::FileByteSource::Read(offset, buffer, size);
+	}
+
+	/*! The number of reads issued. */
+	mutable std::atomic<size_t> m_Reads{};
+	/*! The number of bytes requested. */
+	mutable std::atomic<unsigned long long> m_Bytes{};
+	/*! false if any read did not start at an aligned offset. */
+	mutable std::atomic<bool> m_IsAligned{ true };
+};
+
+/*!
+   * @brief Reads the surface streamed by ::streamingExample through a custom byte source.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface read equals the one written and all reads were aligned, false otherwise.
+   */
+static bool byteSourceExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "byteSourceExample(\"" << fileName.c_str() << "\")" << endl;
+
+	const auto source{ std::make_shared<CountingByteSource>(fileName) };
+	auto success{ source->GetSize() > 0 };
+
+	try
+	{
+		if (success)
+		{
+			OpenGPS::ISO5436_2 iso5436_2(source);
+			iso5436_2.Open();
+
+			OpenGPS::PointVector vector;
+
+			for (size_t v = 0; success && v < sizeV; ++v)
+			{
+				for (size_t u = 0; success && u < sizeU; ++u)
+				{
+					OGPS_Int16 z{};
+					const auto valid{ StreamedHeight(u, v, z) };
+
+					OGPS_Int16 zs{};
+					iso5436_2.GetMatrixPoint(u, v, 0, vector);
+					vector.GetZ()->Get(&zs);
+					success = vector.IsValid() == valid && (!valid || zs == z);
+				}
+			}
+		}
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	if (!success || source->m_Reads == 0 || !source->m_IsAligned)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be read through a byte source." << endl;
+		return false;
+	}
+
+	std::wcout << "Read the surface through a byte source issuing " << source->m_Reads << " aligned reads of " << source->m_Bytes << " bytes in total." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief State of ::ReceiveBatchFile.
+   */
+struct BatchState
+{
+	/*! Number of points of a single row. */
+	size_t sizeU;
+	/*! Number of rows. */
+	size_t sizeV;
+	/*! The position of the file that does not exist. */
+	size_t missing;
+	/*! true for every file received so far. */
+	std::vector<bool> received;
+	/*! false if a file has been received twice or does not equal the one written. */
+	bool success;
+};
+
+/*!
+   * @brief Compares a file opened by ::ogps_OpenISO5436_2Batch with the surface written by ::streamingExample.
+   */
+static OGPS_Boolean ReceiveBatchFile(size_t index, OGPS_ISO5436_2Handle handle, void* userData)
+{
+	auto state{ static_cast<BatchState*>(userData) };
+
+	state->success = state->success && index < state->received.size() && !state->received[index];
+
+	if (state->success)
+	{
+		state->received[index] = true;
+
+		if (index == state->missing)
+		{
+			state->success = !handle && ogps_GetErrorMessage();
+		}
+		else if (handle)
+		{
+			OGPS_Int16 z{};
+			const auto valid{ StreamedHeight(state->sizeU - 1, state->sizeV - 1, z) };
+
+			auto vector{ ogps_CreatePointVector() };
+			ogps_GetMatrixPoint(handle, state->sizeU - 1, state->sizeV - 1, 0, vector);
+			state->success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			ogps_FreePointVector(&vector);
+		}
+		else
+		{
+			state->success = false;
+		}
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	return state->success;
+}
+
+/*!
+   * @brief Opens copies of the surface streamed by ::streamingExample on a pool of worker threads.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if every file has been received once and equals the one written, false otherwise.
+   */
+static bool batchExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "batchExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OpenGPS::String missing(fileName);
+	missing += _T(".missing");
+
+	// A single file does not exist, which must not stop the others from being opened.
+	std::vector<const OGPS_Character*> files(8, fileName.c_str());
+	files[5] = missing.c_str();
+
+	BatchState state{ sizeU, sizeV, 5, std::vector<bool>(files.size()), true };
+
+	const auto success{ ogps_OpenISO5436_2Batch(files.data(), files.size(), nullptr, nullptr, 3, 4, ReceiveBatchFile, &state) &&
+		!ogps_HasError() && state.success && std::find(state.received.begin(), state.received.end(), false) == state.received.end() };
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be opened in a batch." << endl;
+		return false;
+	}
+
+	std::wcout << "Opened " << files.size() << " files on 3 worker threads with at most 4 files in flight." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Loads the surface streamed by ::streamingExample with and without pipelined decompression.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface loaded both ways equals the one streamed, false otherwise.
+   */
+static bool pipelineExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "pipelineExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+
+	auto success{ true };
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t pass = 0; success && pass < 2; ++pass)
+	{
+		options.pipelineBuffers = pass == 0 ? 0 : 4;
+
+		// Processor time would add up the time spent by all stages, so measure the elapsed time.
+		const auto start{ std::chrono::steady_clock::now() };
+
+		auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+		success = handle && !ogps_HasError();
+
+		const auto seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+
+		ogps_CloseISO5436_2(&handle);
+
+		std::wcout << "Loading " << (pass == 0 ? "one stage after another" : "through a pipeline of 4 buffers") << " took " << seconds << " seconds." << std::endl;
+	}
+
+	ogps_FreePointVector(&vector);
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be loaded correctly through a pipeline." << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+   * @brief Loads the surface written by ::streamingExample through a cache of decoded point data.
+   *
+   * The surface is loaded once without the cache and twice with it. The first load through the
+   * cache stores the decoded point data unless a previous run has done so already, the second
+   * one maps the cached file instead of decompressing and decoding the point data. Then the
+   * surface is loaded twice through a cache in shared memory. The first of these loads changes
+   * a point afterwards, which must not affect the segment mapped by the second one.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param cacheDirectory Existing directory that keeps the cached files.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface loaded every time equals the one streamed, false otherwise.
+   */
+static bool cacheExample(const OpenGPS::String& fileName, const OpenGPS::String& cacheDirectory, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "cacheExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.cacheBudget = 64 * 1024 * 1024;
+
+	auto success{ true };
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t pass = 0; success && pass < 5; ++pass)
+	{
+		options.cacheDirectory = pass == 0 ? nullptr : cacheDirectory.c_str();
+		options.cacheSharedMemory = pass > 2;
+
+		const auto start{ std::chrono::steady_clock::now() };
+
+		auto handle{ ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options) };
+		success = handle && !ogps_HasError();
+
+		const auto seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+
+		// Changes a private copy of the point data only
+		if (success && pass == 3)
+		{
+			OGPS_Int16 z{};
+			StreamedHeight(0, 0, z);
+
+			ogps_SetInt16Z(vector, static_cast<OGPS_Int16>(z + 1));
+			ogps_SetMatrixPoint(handle, 0, 0, 0, vector);
+			success = !ogps_HasError();
+		}
+
+		ogps_CloseISO5436_2(&handle);
+
+		std::wcout << "Loading " << (pass == 0 ? "without the cache" : pass == 1 ? "through the cache" : pass == 2 ? "from the cache" : pass == 3 ? "through shared memory" : "from shared memory") << " took " << seconds << " seconds." << std::endl;
+	}
+
+	ogps_FreePointVector(&vector);
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be loaded correctly through the cache." << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+   * @brief Opens the surface streamed by ::streamingExample from several threads through a cache of opened files.
+   *
+   * All threads must get the same instance, which is opened only once. A cache whose budget
+   * is too small for the surface returns it without keeping it.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if the surface is shared as expected and equals the one streamed, false otherwise.
+   */
+static bool containerCacheExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "containerCacheExample(\"" << fileName.c_str() << "\")" << endl;
+
+	OpenGPS::ISO5436_2Cache cache(64 * 1024 * 1024);
+
+	std::vector<std::shared_ptr<const OpenGPS::ISO5436_2>> documents(8);
+	std::vector<std::thread> threads;
+
+	for (size_t n = 0; n < documents.size(); ++n)
+	{
+		threads.emplace_back([&cache, &documents, &fileName, n]()
+		{
+			try
+			{
+				documents[n] = cache.Open(fileName);
+			}
+			catch (...)
+			{
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	auto success{ documents[0] && std::all_of(documents.begin(), documents.end(), [&documents](const std::shared_ptr<const OpenGPS::ISO5436_2>& document) { return document == documents[0]; }) &&
+		cache.GetCount() == 1 && cache.GetMemoryUsage() == documents[0]->GetPointDataSize() && cache.GetMemoryUsage() > 0 };
+
+	OpenGPS::PointVector vector;
+
+	for (size_t v = 0; success && v < sizeV; ++v)
+	{
+		for (size_t u = 0; success && u < sizeU; ++u)
+		{
+			OGPS_Int16 z{};
+			const auto valid{ StreamedHeight(u, v, z) };
+
+			documents[0]->GetMatrixPoint(u, v, 0, vector);
+
+			OGPS_Int16 value{};
+			if (valid)
+			{
+				vector.GetZ(&value);
+			}
+
+			success = vector.IsValid() == valid && (!valid || value == z);
+		}
+	}
+
+	// Opening the file once more returns the instance kept, unless the cache has been cleared.
+	success = success && cache.Open(fileName) == documents[0];
+
+	cache.Clear();
+
+	success = success && cache.GetCount() == 0 && cache.GetMemoryUsage() == 0 && cache.Open(fileName) != documents[0];
+
+	OpenGPS::ISO5436_2Cache small(1);
+	success = success && small.Open(fileName) && small.GetCount() == 0;
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be shared through a cache of opened files." << endl;
+		return false;
+	}
+
+	std::wcout << "Opened the file once for " << documents.size() << " threads." << std::endl;
+
+	return true;
+}
+
+static bool errorStateExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "errorStateExample(\"" << fileName.c_str() << "\")" << endl;
+
+	auto handle{ ogps_OpenISO5436_2(fileName.c_str(), nullptr) };
+	if (!handle || ogps_HasError())
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be opened." << endl;
+		return false;
+	}
+
+	auto missing{ fileName };
+	missing += _T(".missing");
+
+	std::atomic<bool> failing{ true };
+	std::atomic<size_t> failures{};
+
+	// Provokes failures while the other thread reads points without any
+	std::thread thread([&missing, &failing, &failures]()
+	{
+		while (failing)
+		{
+			auto other{ ogps_OpenISO5436_2(missing.c_str(), nullptr) };
+			if (!other && ogps_HasError() && ogps_GetErrorId() != OGPS_ExNone)
+			{
+				++failures;
+			}
+			else
+			{
+				ogps_CloseISO5436_2(&other);
+				failing = false;
+			}
+		}
+	});
+
+	auto success{ true };
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t pass = 0; success && pass < 4; ++pass)
+	{
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				ogps_GetMatrixPoint(handle, u, v, 0, vector);
+				success = !ogps_HasError() && ogps_GetErrorId() == OGPS_ExNone && ogps_GetErrorMessage() == nullptr &&
+					ogps_IsValidPoint(vector) == valid && (!valid || ogps_GetInt16Z(vector) == z);
+			}
+		}
+	}
+
+	while (success && failing && failures == 0)
+	{
+		std::this_thread::yield();
+	}
+
+	success = success && failing;
+
+	failing = false;
+	thread.join();
+
+	ogps_FreePointVector(&vector);
+	ogps_CloseISO5436_2(&handle);
+
+	if (!success || failures == 0)
+	{
+		std::cerr << "Errors of one thread were reported to another one using a different handle." << endl;
+		return false;
+	}
+
+	std::wcout << "Read the surface while another thread trapped " << failures << " errors." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Reads the surface streamed by ::streamingExample from several threads through one opened instance.
+   *
+   * Each thread uses its own point vector and no locks. The surface is read once held in
+   * memory and once paged from a temporary file, where reads are serialized internally.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if all threads read the surface streamed, false otherwise.
+   */
+static bool concurrentReadExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "concurrentReadExample(\"" << fileName.c_str() << "\")" << endl;
+
+	std::atomic<size_t> failures{ 0 };
+	const size_t threadCount{ 8 };
+
+	for (const auto paged : { false, true })
+	{
+		OGPS_OpenOptions options;
+		ogps_InitOpenOptions(&options);
+
+		if (paged)
+		{
+			options.pagedMemoryBudget = 64 * 1024;
+			options.pageSize = 4 * 1024;
+		}
+
+		try
+		{
+			OpenGPS::ISO5436_2 iso5436_2(fileName);
+			iso5436_2.Open(options);
+
+			const auto& document{ iso5436_2 };
+			std::vector<std::thread> threads;
+
+			for (size_t n = 0; n < threadCount; ++n)
+			{
+				threads.emplace_back([&document, &failures, sizeU, sizeV, n]()
+				{
+					OpenGPS::PointVector vector;
+
+					try
+					{
+						// Threads start at different rows to read different points at once.
+						for (size_t k = 0; k < sizeV; ++k)
+						{
+							const auto v{ (k + n * sizeV / threadCount) % sizeV };
+
+							for (size_t u = 0; u < sizeU; ++u)
+							{
+								OGPS_Int16 z{};
+								const auto valid{ StreamedHeight(u, v, z) };
+
+								document.GetMatrixPoint(u, v, 0, vector);
+
+								OGPS_Int16 value{};
+								if (valid)
+								{
+									vector.GetZ()->Get(&value);
+								}
+
+								OGPS_Double x{}, y{};
+								document.GetMatrixCoord(u, v, 0, &x, &y, nullptr);
+
+								if (vector.IsValid() != valid || document.IsMatrixCoordValid(u, v, 0) != valid || (valid && value != z) || std::isnan(x) || std::isnan(y))
+								{
+									++failures;
+								}
+							}
+						}
+					}
+					catch (...)
+					{
+						++failures;
+					}
+				});
+			}
+
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
+
+			iso5436_2.Close();
+		}
+		catch (OpenGPS::Exception& e)
+		{
+			std::cerr << e.details() << endl;
+			++failures;
+		}
+	}
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " points of \"" << fileName << "\" were not read correctly by " << threadCount << " threads at once." << endl;
+		return false;
+	}
+
+	std::wcout << "Read the surface from " << threadCount << " threads at once without locks." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Processes the surface streamed by ::streamingExample partition by partition on the thread pool of the library.
+   *
+   * The partitions must cover all rows without gaps and differ in size by one row at most. An
+   * exception thrown by a callback must reach the caller.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if all partitions are processed as expected, false otherwise.
+   */
+static bool partitionExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "partitionExample(\"" << fileName.c_str() << "\")" << endl;
+
+	auto success{ true };
+	std::atomic<size_t> points{ 0 };
+	std::atomic<size_t> failures{ 0 };
+
+	try
+	{
+		OpenGPS::ISO5436_2 iso5436_2(fileName);
+		iso5436_2.Open();
+
+		const auto partitions{ iso5436_2.GetPartitions(7) };
+
+		size_t next{ 0 };
+		for (const auto& partition : partitions)
+		{
+			success = success && partition.IsMatrix() && partition.GetFirst() == next && partition.GetCount() >= sizeV / 7 && partition.GetCount() <= sizeV / 7 + 1 &&
+				partition.GetPointCount() == partition.GetCount() * sizeU;
+			next += partition.GetCount();
+		}
+
+		success = success && partitions.size() == 7 && next == sizeV && iso5436_2.GetPartitions(2 * sizeV).size() == sizeV;
+
+		iso5436_2.ParallelForEach([&points, &failures](OpenGPS::PointPartition& partition)
+		{
+			OpenGPS::PointVector vector;
+
+			while (partition.MoveNext())
+			{
+				size_t u{}, v{};
+				partition.GetPosition(&u, &v, nullptr);
+				partition.GetCurrent(vector);
+
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				OGPS_Int16 value{};
+				if (valid)
+				{
+					vector.GetZ()->Get(&value);
+				}
+
+				if (vector.IsValid() != valid || partition.IsCurrentValid() != valid || (valid && value != z))
+				{
+					++failures;
+				}
+
+				++points;
+			}
+		});
+
+		success = success && points == sizeU * sizeV && failures == 0;
+
+		try
+		{
+			iso5436_2.ParallelForEach([](OpenGPS::PointPartition& partition)
+			{
+				if (partition.GetFirst() == 0)
+				{
+					throw OpenGPS::Exception(OGPS_ExGeneral, _EX_T("Stopped."), _EX_T("The callback stops processing the first partition."), _EX_T("partitionExample"));
+				}
+			});
+
+			success = false;
+		}
+		catch (OpenGPS::Exception& e)
+		{
+			success = success && e.id() == OGPS_ExGeneral;
+		}
+
+		iso5436_2.Close();
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be processed partition by partition." << endl;
+		return false;
+	}
+
+	std::wcout << "Processed " << points << " points partition by partition." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief State of ::ExecuteOnThread.
+   */
+struct ExecutorState
+{
+	/*! Serializes access to the threads. */
+	std::mutex mutex;
+	/*! One thread per task executed. */
+	std::vector<std::thread> threads;
+};
+
+/*!
+   * @brief Executes a task of the library on a thread of the application.
+   */
+static void ExecuteOnThread(OGPS_TaskCallback run, void* task, void* userData)
+{
+	auto state{ static_cast<ExecutorState*>(userData) };
+
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->threads.emplace_back(run, task);
+}
+
+/*!
+   * @brief Limits the threads of the library and passes its work to an executor of the application.
+   *
+   * With a limit of two threads, partitions are processed by two worker threads and the calling thread
+   * at most. With an executor, both partitions and files opened in a batch run on threads of the application,
+   * even if the batch asks for threads of its own. Pipelines then load point data single-threaded.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P written by ::streamingExample.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @returns Returns true if all work has been executed as configured, false otherwise.
+   */
+static bool schedulerExample(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "schedulerExample(\"" << fileName.c_str() << "\")" << endl;
+
+	auto success{ true };
+	ExecutorState executor;
+
+	try
+	{
+		OpenGPS::ISO5436_2 iso5436_2(fileName);
+		iso5436_2.Open();
+
+		ogps_SetMaxThreads(2);
+		success = ogps_GetMaxThreads() == 2 && OpenGPS::Scheduler::GetThreadCount() == 2 && iso5436_2.GetPartitions(0).size() == 2;
+
+		std::mutex mutex;
+		std::set<std::thread::id> threads;
+		std::atomic<size_t> points{ 0 };
+
+		const auto visit{ [&mutex, &threads, &points](OpenGPS::PointPartition& partition)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				threads.insert(std::this_thread::get_id());
+			}
+
+			while (partition.MoveNext())
+			{
+				++points;
+			}
+		} };
+
+		iso5436_2.ParallelForEach(visit, 64);
+		success = success && points == sizeU * sizeV && threads.size() <= 3;
+
+		// All partitions run on threads of the application now
+		ogps_SetExecutor(&ExecuteOnThread, &executor);
+
+		threads.clear();
+		points = 0;
+
+		iso5436_2.ParallelForEach(visit, 16);
+		success = success && points == sizeU * sizeV && threads.size() == 16 && threads.count(std::this_thread::get_id()) == 0;
+
+		// So do the files opened in a batch
+		const std::vector<OpenGPS::String> files(4, fileName);
+		OpenGPS::ISO5436_2Batch batch(files);
+
+		OpenGPS::ISO5436_2BatchResult result;
+		size_t opened{ 0 };
+		while (batch.Next(result))
+		{
+			opened += result.document ? 1 : 0;
+		}
+
+		success = success && opened == files.size();
+
+		// The library starts no threads of its own, an explicit number of threads is ignored
+		OGPS_OpenOptions options;
+		ogps_InitOpenOptions(&options);
+		options.pipelineBuffers = 4;
+
+		OpenGPS::ISO5436_2Batch threadBatch(files, &options, 2, 1);
+
+		opened = 0;
+		while (threadBatch.Next(result))
+		{
+			if (!result.document)
+			{
+				continue;
+			}
+
+			OGPS_Int16 z{};
+			const auto valid{ StreamedHeight(sizeU - 1, sizeV - 1, z) };
+
+			OpenGPS::PointVector vector;
+			result.document->GetMatrixPoint(sizeU - 1, sizeV - 1, 0, vector);
+
+			OGPS_Int16 value{};
+			if (valid)
+			{
+				vector.GetZ()->Get(&value);
+			}
+
+			opened += vector.IsValid() == valid && value == (valid ? z : 0) ? 1 : 0;
+		}
+
+		success = success && opened == files.size();
+
+		iso5436_2.Close();
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	ogps_SetExecutor(nullptr, nullptr);
+	ogps_SetMaxThreads(0);
+
+	for (auto& thread : executor.threads)
+	{
+		thread.join();
+	}
+
+	success = success && executor.threads.size() == 16 + 4 + 4 && ogps_GetMaxThreads() == 0;
+
+	if (!success)
+	{
+		std::cerr << "Work of the library could not be executed as configured." << endl;
+		return false;
+	}
+
+	std::wcout << "Executed " << executor.threads.size() << " tasks of the library on threads of the application." << std::endl;
+
+	return true;
+}
+
+static bool concurrentExample(const OpenGPS::String& path, size_t count, size_t threadCount)
+{
+	std::wcout << endl << endl << "concurrentExample(" << count << ")" << endl;
+
+	const size_t dimension{ 32 };
+	std::atomic<size_t> next{};
+	std::atomic<size_t> failures{};
+	std::vector<std::thread> threads;
+
+	// Every file gets temporary directories of its own while being written and read
+	for (size_t n = 0; n < threadCount; ++n)
+	{
+		threads.emplace_back([&path, &next, &failures, count, dimension]()
+		{
+			const auto record1{ CreateSyntheticRecord1() };
+			const MatrixDimensionType mdim{ dimension, dimension, 1 };
+
+			for (auto index = next++; index < count; index = next++)
+			{
+				std::wostringstream name;
+				name << path.c_str() << _T("concurrent") << index << _T(".x3p");
+				const OpenGPS::String fileName{ name.str() };
+
+				auto handle{ ogps_CreateMatrixISO5436_2(fileName.c_str(), nullptr, record1, nullptr, mdim, true) };
+				auto vector{ ogps_CreatePointVector() };
+
+				for (size_t v = 0; handle && v < dimension; ++v)
+				{
+					for (size_t u = 0; u < dimension; ++u)
+					{
+						ogps_SetDoubleZ(vector, SyntheticHeight(u + index, v));
+						ogps_SetMatrixPoint(handle, u, v, 0, vector);
+					}
+				}
+
+				ogps_WriteISO5436_2(handle);
+				auto success{ handle && !ogps_HasError() };
+				ogps_CloseISO5436_2(&handle);
+
+				handle = ogps_OpenISO5436_2(fileName.c_str(), nullptr);
+				success = success && handle && !ogps_HasError();
+
+				for (size_t k = 0; success && k < dimension; ++k)
+				{
+					ogps_GetMatrixPoint(handle, k, dimension - k - 1, 0, vector);
+					success = !ogps_HasError() && ogps_IsValidPoint(vector) && ogps_GetDoubleZ(vector) == SyntheticHeight(k + index, dimension - k - 1);
+				}
+
+				ogps_FreePointVector(&vector);
+				ogps_CloseISO5436_2(&handle);
+
+				if (!success)
+				{
+					++failures;
+				}
+
+				OpenGPS::String file{ fileName };
+				std::remove(file.ToChar());
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " of " << count << " files written and read by " << threadCount << " threads at once failed." << endl;
+		return false;
+	}
+
+	std::wcout << "Wrote and read " << count << " files from " << threadCount << " threads at once." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Writes a matrix of several layers in binary format and compares every point read by OpenGPS::ISO5436_2Reader with OpenGPS::ISO5436_2.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to write.
+   * @param sizeU Number of points of a single row.
+   * @param sizeV Number of rows.
+   * @param sizeW Number of layers.
+   * @returns Returns true if both yield the same points, false otherwise.
+   */
+static bool readLayers(const OpenGPS::String& fileName, size_t sizeU, size_t sizeV, size_t sizeW)
+{
+	auto record1{ CreateSyntheticRecord1() };
+	record1.Axes().CZ().DataType(Record1Type::Axes_type::CZ_type::DataType_type::I); // int16
+	record1.Axes().CZ().Increment(1E-9);
+
+	const MatrixDimensionType mdim{ sizeU, sizeV, sizeW };
+
+	auto handle{ ogps_CreateMatrixISO5436_2(fileName.c_str(), nullptr, record1, nullptr, mdim, true) };
+	auto vector{ ogps_CreatePointVector() };
+
+	for (size_t w = 0; handle && w < sizeW; ++w)
+	{
+		for (size_t v = 0; v < sizeV; ++v)
+		{
+			for (size_t u = 0; u < sizeU; ++u)
+			{
+				// Each layer holds a surface shifted along u
+				OGPS_Int16 z{};
+				if (StreamedHeight(u + w * 5, v, z))
+				{
+					ogps_SetInt16Z(vector, z);
+					ogps_SetMatrixPoint(handle, u, v, w, vector);
+				}
+				else
+				{
+					ogps_SetMatrixPoint(handle, u, v, w, nullptr);
+				}
+			}
+		}
+	}
+
+	ogps_WriteISO5436_2(handle);
+	auto success{ handle && !ogps_HasError() };
+
+	ogps_FreePointVector(&vector);
+	ogps_CloseISO5436_2(&handle);
+
+	if (!success)
+	{
+		return false;
+	}
+
+	OpenGPS::ISO5436_2Reader reader(fileName);
+	reader.Open();
+
+	const auto& metadata{ reader.GetMetadata() };
+	success = metadata.isMatrix && metadata.sizeX == sizeU && metadata.sizeY == sizeV && metadata.sizeZ == sizeW;
+
+	OpenGPS::ISO5436_2 iso5436_2(fileName);
+	iso5436_2.Open();
+
+	OpenGPS::PointVector vector1;
+	OpenGPS::PointVector vector2;
+
+	for (size_t w = 0; success && w < sizeW; ++w)
+	{
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u + w * 5, v, z) };
+
+				reader.GetMatrixPoint(u, v, w, vector1);
+				iso5436_2.GetMatrixPoint(u, v, w, vector2);
+
+				OGPS_Int16 value1{}, value2{};
+				if (valid)
+				{
+					vector1.GetZ()->Get(&value1);
+					vector2.GetZ()->Get(&value2);
+				}
+
+				OGPS_Double x1{}, y1{}, z1{}, x2{}, y2{}, z2{};
+				reader.GetMatrixCoord(u, v, w, &x1, &y1, &z1);
+				iso5436_2.GetMatrixCoord(u, v, w, &x2, &y2, &z2);
+
+				success = vector1.IsValid() == valid && vector2.IsValid() == valid && reader.IsMatrixCoordValid(u, v, w) == valid &&
+					(!valid || (value1 == z && value2 == z)) && x1 == x2 && y1 == y2 && (valid ? z1 == z2 : std::isnan(z1) && std::isnan(z2));
+			}
+		}
+	}
+
+	iso5436_2.Close();
+
+	return success;
+}
+
+static bool readerExample(const OpenGPS::String& fileName, const OpenGPS::String& listFileName, const OpenGPS::String& layerFileName, size_t sizeU, size_t sizeV)
+{
+	std::wcout << endl << endl << "readerExample(\"" << fileName.c_str() << "\")" << endl;
+
+	auto success{ true };
+
+	try
+	{
+		OpenGPS::ISO5436_2Reader reader(fileName);
+		reader.Open();
+
+		const auto& metadata{ reader.GetMetadata() };
+		success = metadata.isMatrix && metadata.sizeX == sizeU && metadata.sizeY == sizeV && metadata.sizeZ == 1 &&
+			metadata.featureType == OGPS_FEATURE_TYPE_SURFACE_NAME && metadata.z.dataType == OGPS_Int16PointType &&
+			metadata.x.isIncremental && metadata.y.isIncremental && !metadata.z.isIncremental;
+
+		// The reader yields the same coordinates as the full implementation
+		OpenGPS::ISO5436_2 iso5436_2(fileName);
+		iso5436_2.Open();
+
+		OpenGPS::PointVector vector;
+
+		for (size_t v = 0; success && v < sizeV; ++v)
+		{
+			for (size_t u = 0; success && u < sizeU; ++u)
+			{
+				OGPS_Int16 z{};
+				const auto valid{ StreamedHeight(u, v, z) };
+
+				reader.GetMatrixPoint(u, v, 0, vector);
+
+				OGPS_Int16 value{};
+				if (valid)
+				{
+					vector.GetZ()->Get(&value);
+				}
+
+				OGPS_Double x1{}, y1{}, z1{}, x2{}, y2{}, z2{};
+				reader.GetMatrixCoord(u, v, 0, &x1, &y1, &z1);
+				iso5436_2.GetMatrixCoord(u, v, 0, &x2, &y2, &z2);
+
+				success = vector.IsValid() == valid && reader.IsMatrixCoordValid(u, v, 0) == valid && (!valid || value == z) &&
+					x1 == x2 && y1 == y2 && (valid ? z1 == z2 : std::isnan(z1) && std::isnan(z2));
+			}
+		}
+
+		iso5436_2.Close();
+
+		// Matrices of several layers are stored in a different order than read from the archive
+		success = success && readLayers(layerFileName, 7, 5, 3);
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	// Point data stored within main.xml is not supported
+	try
+	{
+		OpenGPS::ISO5436_2Reader reader(listFileName);
+		reader.Open();
+		success = false;
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		success = success && e.id() == OGPS_ExNotImplemented;
+	}
+
+	if (!success)
+	{
+		std::cerr << "Surface \"" << fileName << "\" could not be read without the XML schema runtime." << endl;
+		return false;
+	}
+
+	std::wcout << "Read the surface without the XML schema runtime." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief State of ::VisitLargeBlock.
+   */
+struct VisitLargeState
+{
+	/*! Number of points along the u-direction. */
+	size_t sizeU;
+	/*! Number of point vectors visited so far. */
+	size_t points;
+	/*! false if a point vector does not equal the one written. */
+	bool success;
+};
+
+/*!
+   * @brief Compares a block of point vectors with the surface written by ::largeExample.
+   */
+static OGPS_Boolean VisitLargeBlock(const OGPS_PointBlock* block, void* userData)
+{
+	auto state{ static_cast<VisitLargeState*>(userData) };
+	const auto z{ static_cast<const OGPS_Double*>(block->z) };
+
+	state->success = state->success && block->index == state->points && block->zType == OGPS_DoublePointType && z;
+
+	for (size_t n = 0; state->success && n < block->count; ++n)
+	{
+		const auto index{ block->index + n };
+		state->success = block->valid[n] && z[n] == SyntheticHeight(index % state->sizeU, index / state->sizeU);
+	}
+
+	state->points += block->count;
+
+	return state->success;
+}
+
+/*!
+   * @brief Writes and reads back a synthetic surface whose X3P archive exceeds 4GB.
+   *
+   * Point data is stored without compression, so the archive needs the Zip64 format. The
+   * file is rewritten once, which copies the point data, and is removed afterwards.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to be written.
+   * @param size Number of points along both axes, at least 23200 to exceed 4GB.
+   * @returns Returns true if the surface read back equals the one written, false otherwise.
+   */
+static bool largeExample(const OpenGPS::String& fileName, size_t size)
+{
+	std::wcout << endl << endl << "largeExample(\"" << fileName.c_str() << "\")" << endl;
+
+	const auto start{ clock() };
+
+	const auto record1{ CreateSyntheticRecord1() };
+	const auto record2{ CreateSyntheticRecord2(_T("This file is a synthetic surface exceeding 4GB.")) };
+	const MatrixDimensionType mdim{ size, size, 1 };
+
+	auto handle{ ogps_CreateMatrixStreamISO5436_2(fileName.c_str(), nullptr, record1, &record2, mdim, 0) };
+	auto vector{ ogps_CreatePointVector() };
+
+	auto success{ handle && !ogps_HasError() };
+
+	for (size_t v = 0; success && v < size; ++v)
+	{
+		for (size_t u = 0; u < size; ++u)
+		{
+			ogps_SetDoubleZ(vector, SyntheticHeight(u, v));
+			ogps_AppendMatrixPoint(handle, vector);
+		}
+
+		success = !ogps_HasError();
+	}
+
+	if (success)
+	{
+		ogps_WriteISO5436_2(handle);
+		success = !ogps_HasError();
+	}
+
+	ogps_CloseISO5436_2(&handle);
+	ogps_FreePointVector(&vector);
+
+	// Rewriting copies the point data to a new archive.
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.loadPoints = false;
+
+	if (success)
+	{
+		handle = ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options);
+		success = handle && !ogps_HasError();
+
+		if (success)
+		{
+			ogps_GetDocument(handle)->Record2()->Comment(_T("This file is a synthetic surface exceeding 4GB, rewritten."));
+			ogps_WriteISO5436_2(handle);
+			success = !ogps_HasError();
+		}
+
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	// Checksums get verified at the end.
+	VisitLargeState state{ size, 0, true };
+	if (success)
+	{
+		handle = ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options);
+		success = handle && !ogps_HasError() &&
+			ogps_VisitPoints(handle, VisitLargeBlock, &state, 0) && !ogps_HasError() && state.success && state.points == size * size;
+
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	auto filePath{ fileName };
+	std::remove(filePath.ToChar());
+
+	const auto seconds{ static_cast<double>(clock() - start) / CLOCKS_PER_SEC };
+
+	if (!success)
+	{
+		std::cerr << "Synthetic surface \"" << fileName << "\" exceeding 4GB could not be written or read back correctly." << endl;
+		return false;
+	}
+
+	std::wcout << "Writing, rewriting and reading " << size << "x" << size << " points took " << seconds << " seconds." << std::endl;
+
+	return true;
+}
+
+/*!
+   * @brief Height of the point at position u of the profile written by ::largeProfileExample.
+   */
+static OGPS_Int16 LargeProfileHeight(size_t u)
+{
+	return static_cast<OGPS_Int16>(u % 30011);
+}
+
+/*!
+   * @brief Checks a point of the profile written by ::largeProfileExample.
+   *
+   * The x-component is derived from the position along the incremental x-axis. It is of type
+   * OGPS_Int32 up to the range of a signed 32-bit integer and of type OGPS_Double beyond.
+   *
+   * @param x The x-component of the point.
+   * @param u The position of the point.
+   * @returns Returns true if the x-component has the type and value expected, false otherwise.
+   */
+static bool IsLargeProfileX(const OpenGPS::DataPoint& x, size_t u)
+{
+	if (u <= static_cast<size_t>(std::numeric_limits<OGPS_Int32>::max()))
+	{
+		OGPS_Int32 value{};
+		x.Get(&value);
+		return x.GetPointType() == OGPS_Int32PointType && static_cast<size_t>(value) == u;
+	}
+
+	OGPS_Double value{};
+	x.Get(&value);
+	return x.GetPointType() == OGPS_DoublePointType && value == static_cast<OGPS_Double>(u);
+}
+
+/*!
+   * @brief Writes and reads back a profile of more than 2^31 points along an incremental x-axis.
+   *
+   * The points just below and above 2^31 are read through the C and the C++ interface, whose
+   * x-components switch from OGPS_Int32 to OGPS_Double. Point data is paged, so it does not
+   * need to fit into memory. The file is removed afterwards.
+   *
+   * @param fileName Full path to the ISO5436-2 XML X3P to be written.
+   * @param size Number of points of the profile, more than 2^31.
+   * @returns Returns true if the points read back equal the ones written, false otherwise.
+   */
+static bool largeProfileExample(const OpenGPS::String& fileName, size_t size)
+{
+	std::wcout << endl << endl << "largeProfileExample(\"" << fileName.c_str() << "\")" << endl;
+
+	const size_t limit{ static_cast<size_t>(std::numeric_limits<OGPS_Int32>::max()) };
+	assert(size > limit + 1);
+
+	const auto start{ std::chrono::steady_clock::now() };
+
+	Record1Type::Revision_type revision{ OGPS_ISO5436_2000_REVISION_NAME };
+	Record1Type::FeatureType_type featureType{ OGPS_FEATURE_TYPE_PROFILE_NAME };
+
+	Record1Type::Axes_type::CX_type::AxisType_type xaxisType{ Record1Type::Axes_type::CX_type::AxisType_type::I }; // incremental
+	Record1Type::Axes_type::CX_type xaxis{ xaxisType };
+	xaxis.Increment(1E-9);
+	xaxis.Offset(0.0);
+
+	Record1Type::Axes_type::CY_type::AxisType_type yaxisType{ Record1Type::Axes_type::CY_type::AxisType_type::I }; // incremental
+	Record1Type::Axes_type::CY_type yaxis{ yaxisType };
+	yaxis.Increment(1E-9);
+	yaxis.Offset(0.0);
+
+	Record1Type::Axes_type::CZ_type::AxisType_type zaxisType{ Record1Type::Axes_type::CZ_type::AxisType_type::A }; // absolute
+	Record1Type::Axes_type::CZ_type::DataType_type zdataType{ Record1Type::Axes_type::CZ_type::DataType_type::I }; // int16
+	Record1Type::Axes_type::CZ_type zaxis{ zaxisType };
+	zaxis.DataType(zdataType);
+	zaxis.Increment(1E-9);
+	zaxis.Offset(0.0);
+
+	Record1Type::Axes_type axis{ xaxis, yaxis, zaxis };
+
+	const Record1Type record1{ revision, featureType, axis };
+	const auto record2{ CreateSyntheticRecord2(_T("This file is a synthetic profile of more than 2^31 points.")) };
+	const MatrixDimensionType mdim{ size, 1, 1 };
+
+	auto handle{ ogps_CreateMatrixStreamISO5436_2(fileName.c_str(), nullptr, record1, &record2, mdim, 0) };
+	auto vector{ ogps_CreatePointVector() };
+
+	auto success{ handle && !ogps_HasError() };
+
+	for (size_t u = 0; success && u < size; ++u)
+	{
+		ogps_SetInt16Z(vector, LargeProfileHeight(u));
+		ogps_AppendMatrixPoint(handle, vector);
+
+		if (u % (1024 * 1024) == 0)
+		{
+			success = !ogps_HasError();
+		}
+	}
+
+	if (success)
+	{
+		ogps_WriteISO5436_2(handle);
+		success = !ogps_HasError();
+	}
+
+	ogps_CloseISO5436_2(&handle);
+
+	OGPS_OpenOptions options;
+	ogps_InitOpenOptions(&options);
+	options.pagedMemoryBudget = 256 * 1024 * 1024;
+
+	// Read the points next to 2^31 through the C interface.
+	if (success)
+	{
+		handle = ogps_OpenISO5436_2Ex(fileName.c_str(), nullptr, &options);
+		success = handle && !ogps_HasError();
+
+		for (auto u = limit - 1; success && u <= limit + 1; ++u)
+		{
+			ogps_GetMatrixPoint(handle, u, 0, 0, vector);
+			success = !ogps_HasError() && ogps_IsValidPoint(vector) && ogps_GetInt16Z(vector) == LargeProfileHeight(u);
+
+			const auto x{ ogps_GetX(vector) };
+			const auto isInt32{ u <= limit };
+
+			success = success && ogps_GetPointType(x) == (isInt32 ? OGPS_Int32PointType : OGPS_DoublePointType) &&
+				(isInt32 ? static_cast<size_t>(ogps_GetInt32(x)) == u : ogps_GetDouble(x) == static_cast<OGPS_Double>(u));
+		}
+
+		ogps_CloseISO5436_2(&handle);
+	}
+
+	ogps_FreePointVector(&vector);
+
+	// Read the same points through the C++ interface.
+	try
+	{
+		if (success)
+		{
+			OpenGPS::ISO5436_2 iso5436_2(fileName);
+			iso5436_2.Open(options);
+
+			OpenGPS::PointVector point;
+
+			for (auto u = limit - 1; success && u <= limit + 1; ++u)
+			{
+				OGPS_Int16 z{};
+				iso5436_2.GetMatrixPoint(u, 0, 0, point);
+				point.GetZ(&z);
+				success = point.IsValid() && z == LargeProfileHeight(u) && IsLargeProfileX(*point.GetX(), u);
+			}
+		}
+	}
+	catch (OpenGPS::Exception& e)
+	{
+		std::cerr << e.details() << endl;
+		success = false;
+	}
+
+	auto filePath{ fileName };
+	std::remove(filePath.ToChar());
+
+	const auto seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+
+	if (!success)
+	{
+		std::cerr << "Synthetic profile \"" << fileName << "\" of more than 2^31 points could not be written or read back correctly." << endl;
+		return false;
+	}
+
+	std::wcout << "Writing and reading a profile of " << size << " points took " << seconds << " seconds." << std::endl;
+
+	return true;
+}
+
+// Converts a given X3P file either to binary or text format (if dstFormatIsBinary parameter equals false).
+static void convertFormat(const OpenGPS::String& srcFileName, const OpenGPS::String& dstFileName, bool dstFormatIsBinary)
+{
+	std::wcout << endl << endl << "convertFormat(\"" << srcFileName.c_str() << "\") to \"" << dstFileName.c_str() << "\"" << endl;
+	// We want to read in some file regardless whether it was written
+	// in text or binary format and then copy its contents into
+	// a newly created file to ensure binary format of X3P.
+	// The original file will be overwritten! 
+
+	auto src_handle{ ogps_OpenISO5436_2(srcFileName.c_str(), nullptr) };
+
+	if (!src_handle)
+		return;
+
+	PrintMetaData(src_handle);
+	PrintDimensions(src_handle);
+
+	auto document{ ogps_GetDocument(src_handle) };
+
+	// Check whether it is matrix or list format and allocate the new file handle accordingly.
+	OGPS_ISO5436_2Handle dst_handle{};
+	if (ogps_IsMatrix(src_handle) && !ogps_HasError())
+	{
+		dst_handle = ogps_CreateMatrixISO5436_2(dstFileName.c_str(), nullptr, document->Record1(), document->Record2().present() ? &*document->Record2() : nullptr, *document->Record3().MatrixDimension(), dstFormatIsBinary);
+	}
+	else
+	{
+		dst_handle = ogps_CreateListISO5436_2(dstFileName.c_str(), nullptr, document->Record1(), document->Record2().present() ? &*document->Record2() : nullptr, static_cast<size_t>(*document->Record3().ListDimension()), dstFormatIsBinary);
+	}
+
+	if (dst_handle)
+	{
+		auto vector{ ogps_CreatePointVector() };
+		auto src{ ogps_CreateNextPointIterator(src_handle) };
+		auto dst{ ogps_CreateNextPointIterator(dst_handle) };
+
+		while (ogps_MoveNextPoint(src) && ogps_MoveNextPoint(dst))
+		{
+			ogps_GetCurrentPoint(src, vector);
+
+			if (!ogps_HasError())
+			{
+				ogps_SetCurrentPoint(dst, (!ogps_IsValidPoint(vector) || ogps_HasError()) ? nullptr : vector);
+			}
+
+			if (ogps_HasError())
+			{
+				break;
+			}
+		}
+
+		assert(!ogps_HasNextPoint(src));
+		assert(!ogps_HasNextPoint(dst));
+
+		ogps_FreePointIterator(&src);
+		ogps_FreePointIterator(&dst);
+		ogps_FreePointVector(&vector);
+	}
+
+	ogps_CloseISO5436_2(&src_handle);
+
+	if (dst_handle)
+	{
+		ogps_WriteISO5436_2(dst_handle);
+		ogps_CloseISO5436_2(&dst_handle);
+	}
+}
+
+#if defined _WIN32 && defined _UNICODE
+int _cdecl _tmain(int argc, _TCHAR* argv[])
+#else
+int main(int argc, char* argv[])
+#endif
+{
+	// Number of points to generate for performance counter
+	const size_t performanceCounter{ 1000 };
+	// Number of points along both axes of the synthetic surface used to compare deflate codecs,
+	// whose point data stays below the 4MB that are compressed by libdeflate at once
+	const size_t codecCounter{ 704 };
+#if defined _WIN32 && defined _UNICODE
+	const auto large{ argc == 3 && OpenGPS::String(argv[2]) == _T("--large") };
+#else
+	const auto large{ argc == 3 && std::string(argv[2]) == "--large" };
+#endif
+	if (argc < 2 || argc > 3 || (argc == 3 && !large))
+	{
+		std::wcout << "Usage: ISO5436_2_XML_demo <full path to sample files>/ [--large]" << std::endl << std::endl <<
+			"Please specify the full path to the directory where the *.x3p sample files reside. The path should also contain the terminating directory separator. Ensure that you have write access to that path." << std::endl << std::endl <<
+			"With --large only an X3P archive exceeding 4GB and a profile of more than 2^31 points are written and read back, which takes a while and needs enough space left on the device." << std::endl << std::endl <<
+			"This simple demo program parses the sample files and prints its contents onto the console. Do not change the names of the sample files, since these are hard coded herein. The purpose of the demo is to get you familiar with the openGPS(R) API." << std::endl;
+		return 1;
+	}
+
+	// Print version and copyright information
+	OpenGPS::String LibName;
+	OpenGPS::String LibVersion;
+	OpenGPS::String LibAbout;
+
+	// get Info strings from Library
+	OpenGPS::Info::GetName(&LibName);
+	OpenGPS::Info::GetVersion(&LibVersion);
+	OpenGPS::Info::GetAbout(&LibAbout);
+
+	std::wcout << "This programm uses the Library \"" << LibName.c_str()
+		<< "\" Version " << LibVersion.c_str() << endl
+		<< LibAbout.c_str() << endl;
+	OpenGPS::Info::PrintVersion();
+	OpenGPS::Info::PrintCopyright();
+	OpenGPS::Info::PrintLicense();
+
+#ifdef _UNICODE
+	#ifdef _WIN32
+		OpenGPS::String path = argv[1];
+	#else
+		OpenGPS::String wpath;
+		wpath.FromChar(argv[1]);
+		OpenGPS::String path = wpath;
+	#endif
+#else
+	OpenGPS::String path = argv[1];
+#endif
+	OpenGPS::String tmp;
+
+	if (large)
+	{
+		tmp = path; tmp += _T("large.x3p");
+		if (!largeExample(tmp, 24576))
+		{
+			return 1;
+		}
+
+		tmp = path; tmp += _T("large_profile.x3p");
+		return largeProfileExample(tmp, (static_cast<size_t>(1) << 31) + 4096) ? 0 : 1;
+	}
+
+	tmp = path; tmp += _T("ISO5436-sample1.x3p");
+	readonlyExample(tmp);
+
+	tmp = path; tmp += _T("ISO5436-sample4_bin.x3p");
+	readonlyExample2(tmp);
+
+	tmp = path; tmp += _T("ISO5436-sample3.x3p");
+	readonlyExample2(tmp);
+
+	tmp = path; tmp += _T("ISO5436-sample3.x3p");
+	readonlyExample3(tmp);
+
+	tmp = path; tmp += _T("ISO5436-sample2.x3p");
+	readonlyExample4(tmp);
+
+	tmp = path; tmp += _T("simple.x3p");
+	simpleExample(tmp);
+
+	tmp = path; tmp += _T("medium.x3p");
+	mediumComplexExample(tmp);
+
+	tmp = path; tmp += _T("medium_invalid_points.x3p");
+	mediumComplexExampleWInvalid(tmp);
+
+	std::wcout << std::endl << "Starting performance tests..." << std::endl;
+
+	tmp = path; tmp += _T("performance_int16_bin.x3p");
+	performanceInt16(tmp, performanceCounter, true);
+
+	tmp = path; tmp += _T("performance_int16.x3p");
+	performanceInt16(tmp, performanceCounter, false);
+
+	tmp = path; tmp += _T("performance_double_bin.x3p");
+	performanceDouble(tmp, performanceCounter, true);
+
+	tmp = path; tmp += _T("performance_double.x3p");
+	performanceDouble(tmp, performanceCounter, false);
+
+	std::wcout << std::endl << "Comparing deflate codecs (libdeflate falls back to zlib if not compiled in)..." << std::endl;
+
+	for (const auto codec : { "zlib", "libdeflate" })
+	{
+		tmp = path; tmp += _T("KautschukInfiniteFocus.x3p");
+		performanceCodecRead(tmp, codec);
+
+		tmp = path; tmp += _T("SkiInfiniteFocus.x3p");
+		performanceCodecRead(tmp, codec);
+
+		tmp = path; tmp += _T("performance_codec.x3p");
+		if (!performanceCodecSurface(tmp, codecCounter, codec))
+		{
+			SetZipCodec("");
+			return 1;
+		}
+	}
+
+	SetZipCodec("");
+
+	if (!performanceMd5(64 * 1024 * 1024))
+	{
+		return 1;
+	}
+
+	if (!concurrentExample(path, 256, 16))
+	{
+		return 1;
+	}
+
+	auto list{ path }; list += _T("ISO5436-sample1.x3p");
+	auto layers{ path }; layers += _T("layers.x3p");
+
+	tmp = path; tmp += _T("streaming.x3p");
+	if (!streamingExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!visitExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!partialExample(tmp, 300, 10))
+	{
+		return 1;
+	}
+
+	if (!indexExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!rewriteExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!memoryExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!byteSourceExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!batchExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!pipelineExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!cacheExample(tmp, path, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!containerCacheExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!readerExample(tmp, list, layers, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!errorStateExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!concurrentReadExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!partitionExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	if (!schedulerExample(tmp, 300, 512))
+	{
+		return 1;
+	}
+
+	tmp = path; tmp += _T("performance_codec.x3p");
+	if (!pagedExample(tmp, codecCounter))
+	{
+		return 1;
+	}
 
 	return 0;
 }